@@ -0,0 +1,325 @@
+/*
+ * Airtime Accounting — see airtime.h
+ *
+ * The socket wraps run in the LwM2M engine thread; the Object 33001
+ * read callback and the shell copy counters out under the same
+ * spinlock. New classes are turned into object instances from the
+ * Thread metrics work queue, never from inside the send path.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/shell/shell.h>
+
+#include "airtime.h"
+#include "thread_metrics.h"
+
+/* Internal headers for custom object creation */
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+LOG_MODULE_REGISTER(airtime, LOG_LEVEL_INF);
+
+static struct airtime_acct acct;
+static struct k_spinlock acct_lock;
+static struct lwm2m_ctx *acct_ctx;
+
+/* ================================================================
+ * Socket hooks (-Wl,--wrap, see CMakeLists.txt)
+ * ================================================================ */
+
+static struct k_work inst_sync_work;
+static uint8_t inst_count;
+
+ssize_t __real_z_impl_zsock_sendto(int sock, const void *buf, size_t len,
+				   int flags, const struct sockaddr *dest_addr,
+				   socklen_t addrlen);
+ssize_t __real_z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len,
+				     int flags, struct sockaddr *src_addr,
+				     socklen_t *addrlen);
+
+static void account(enum airtime_dir dir, const void *buf, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&acct_lock);
+	bool grown;
+
+	airtime_acct_packet(&acct, dir, buf, len);
+	grown = (acct.class_count > inst_count);
+	k_spin_unlock(&acct_lock, key);
+
+	if (grown) {
+		thread_metrics_submit(&inst_sync_work);
+	}
+}
+
+static bool is_lwm2m_sock(int sock)
+{
+	return acct_ctx && sock >= 0 && acct_ctx->sock_fd == sock;
+}
+
+ssize_t __wrap_z_impl_zsock_sendto(int sock, const void *buf, size_t len,
+				   int flags, const struct sockaddr *dest_addr,
+				   socklen_t addrlen)
+{
+	ssize_t ret = __real_z_impl_zsock_sendto(sock, buf, len, flags,
+						 dest_addr, addrlen);
+
+	if (ret > 0 && is_lwm2m_sock(sock)) {
+		account(AIRTIME_TX, buf, (size_t)ret);
+	}
+	return ret;
+}
+
+ssize_t __wrap_z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len,
+				     int flags, struct sockaddr *src_addr,
+				     socklen_t *addrlen)
+{
+	ssize_t ret = __real_z_impl_zsock_recvfrom(sock, buf, max_len, flags,
+						   src_addr, addrlen);
+
+	if (ret > 0 && !(flags & ZSOCK_MSG_PEEK) && is_lwm2m_sock(sock)) {
+		account(AIRTIME_RX, buf, (size_t)ret);
+	}
+	return ret;
+}
+
+void airtime_init(struct lwm2m_ctx *ctx)
+{
+	acct_ctx = ctx;
+	LOG_INF("Airtime accounting on the LwM2M socket (%d classes)",
+		AIRTIME_MAX_CLASSES);
+}
+
+void airtime_hint_send(uint16_t obj_id)
+{
+	k_spinlock_key_t key = k_spin_lock(&acct_lock);
+
+	airtime_acct_hint_send(&acct, obj_id);
+	k_spin_unlock(&acct_lock, key);
+}
+
+int airtime_get(int index, struct airtime_class *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&acct_lock);
+	int ret = -ENOENT;
+
+	if (index >= 0 && index < acct.class_count) {
+		*out = acct.classes[index];
+		ret = 0;
+	}
+	k_spin_unlock(&acct_lock, key);
+	return ret;
+}
+
+void airtime_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&acct_lock);
+
+	airtime_acct_reset_counters(&acct);
+	k_spin_unlock(&acct_lock, key);
+}
+
+/* ================================================================
+ * Object 33001 — one instance per class, values served on read
+ * ================================================================ */
+
+static uint32_t at_vals[AIRTIME_MAX_CLASSES][AT_RES_INST_COUNT];
+
+static struct lwm2m_engine_obj airtime_obj;
+
+static struct lwm2m_engine_obj_field airtime_fields[] = {
+	OBJ_FIELD_DATA(AT_OBJECT_ID_RID, R, U32),
+	OBJ_FIELD_DATA(AT_TX_MSGS_RID, R, U32),
+	OBJ_FIELD_DATA(AT_TX_BYTES_RID, R, U32),
+	OBJ_FIELD_DATA(AT_TX_FRAMES_RID, R, U32),
+	OBJ_FIELD_DATA(AT_RX_MSGS_RID, R, U32),
+	OBJ_FIELD_DATA(AT_RX_BYTES_RID, R, U32),
+	OBJ_FIELD_DATA(AT_RX_FRAMES_RID, R, U32),
+	OBJ_FIELD_DATA(AT_AIRTIME_MS_RID, R, U32),
+	OBJ_FIELD(AT_RESET_RID, X_OPT, NONE),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(airtime_fields) == AT_NUM_FIELDS,
+	     "airtime_fields[] size mismatch with AT_NUM_FIELDS");
+
+static struct lwm2m_engine_obj_inst airtime_inst[AIRTIME_MAX_CLASSES];
+static struct lwm2m_engine_res airtime_res[AIRTIME_MAX_CLASSES][AT_NUM_FIELDS];
+static struct lwm2m_engine_res_inst
+	airtime_ri[AIRTIME_MAX_CLASSES][AT_RES_INST_COUNT];
+
+static void *airtime_read_cb(uint16_t obj_inst_id, uint16_t res_id,
+			     uint16_t res_inst_id, size_t *data_len)
+{
+	struct airtime_class c;
+	uint32_t *v;
+
+	ARG_UNUSED(res_inst_id);
+
+	if (obj_inst_id >= AIRTIME_MAX_CLASSES || res_id >= AT_RES_INST_COUNT ||
+	    airtime_get(obj_inst_id, &c) < 0) {
+		*data_len = 0;
+		return NULL;
+	}
+
+	v = &at_vals[obj_inst_id][res_id];
+	switch (res_id) {
+	case AT_OBJECT_ID_RID:  *v = c.id; break;
+	case AT_TX_MSGS_RID:    *v = c.tx_msgs; break;
+	case AT_TX_BYTES_RID:   *v = c.tx_bytes; break;
+	case AT_TX_FRAMES_RID:  *v = c.tx_frames; break;
+	case AT_RX_MSGS_RID:    *v = c.rx_msgs; break;
+	case AT_RX_BYTES_RID:   *v = c.rx_bytes; break;
+	case AT_RX_FRAMES_RID:  *v = c.rx_frames; break;
+	case AT_AIRTIME_MS_RID: *v = (uint32_t)(c.airtime_us / 1000); break;
+	default: break;
+	}
+
+	*data_len = sizeof(*v);
+	return v;
+}
+
+static int airtime_reset_cb(uint16_t obj_inst_id, uint8_t *args,
+			    uint16_t args_len)
+{
+	ARG_UNUSED(obj_inst_id);
+	ARG_UNUSED(args);
+	ARG_UNUSED(args_len);
+
+	airtime_reset();
+	LOG_INF("Airtime counters reset by server");
+	return 0;
+}
+
+static struct lwm2m_engine_obj_inst *airtime_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+	int idx = obj_inst_id;
+
+	if (idx >= AIRTIME_MAX_CLASSES || airtime_inst[idx].obj) {
+		LOG_ERR("Airtime: cannot create instance %u", obj_inst_id);
+		return NULL;
+	}
+
+	(void)memset(airtime_res[idx], 0, sizeof(airtime_res[idx]));
+	init_res_instance(airtime_ri[idx], ARRAY_SIZE(airtime_ri[idx]));
+
+	for (int rid = 0; rid < AT_RES_INST_COUNT; rid++) {
+		INIT_OBJ_RES_DATA(rid, airtime_res[idx], i, airtime_ri[idx], j,
+				  &at_vals[idx][rid], sizeof(uint32_t));
+	}
+	INIT_OBJ_RES_EXECUTE(AT_RESET_RID, airtime_res[idx], i,
+			      airtime_reset_cb);
+
+	airtime_inst[idx].resources = airtime_res[idx];
+	airtime_inst[idx].resource_count = i;
+
+	LOG_DBG("Created Airtime instance %u", obj_inst_id);
+	return &airtime_inst[idx];
+}
+
+/* Create instances for classes that appeared since the last run */
+static void inst_sync_work_handler(struct k_work *work)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct airtime_class c;
+
+	ARG_UNUSED(work);
+
+	while (inst_count < AIRTIME_MAX_CLASSES &&
+	       airtime_get(inst_count, &c) == 0) {
+		uint16_t id = inst_count;
+
+		if (lwm2m_create_obj_inst(AIRTIME_OBJECT_ID, id, &obj_inst) < 0) {
+			LOG_ERR("Airtime: instance %u create failed", id);
+			return;
+		}
+		for (int rid = 0; rid < AT_RES_INST_COUNT; rid++) {
+			lwm2m_register_read_callback(
+				&LWM2M_OBJ(AIRTIME_OBJECT_ID, id, rid),
+				airtime_read_cb);
+		}
+		inst_count++;
+		LOG_INF("Obj33001: instance %u for object %u", id, c.id);
+	}
+}
+
+void init_airtime_object(void)
+{
+	airtime_acct_init(&acct);
+	k_work_init(&inst_sync_work, inst_sync_work_handler);
+
+	airtime_obj.obj_id = AIRTIME_OBJECT_ID;
+	airtime_obj.version_major = 1;
+	airtime_obj.version_minor = 0;
+	airtime_obj.is_core = false;
+	airtime_obj.fields = airtime_fields;
+	airtime_obj.field_count = ARRAY_SIZE(airtime_fields);
+	airtime_obj.max_instance_count = AIRTIME_MAX_CLASSES;
+	airtime_obj.create_cb = airtime_create;
+	lwm2m_register_obj(&airtime_obj);
+
+	LOG_INF("Object 33001 (Airtime Accounting) registered");
+}
+
+/* ==== Shell ==== */
+
+static const char *class_name(uint16_t id, char *buf, size_t len)
+{
+	switch (id) {
+	case AIRTIME_ID_SEND:     return "send";
+	case AIRTIME_ID_REGISTER: return "register";
+	case AIRTIME_ID_OTHER:    return "other";
+	default:
+		snprintf(buf, len, "%u", id);
+		return buf;
+	}
+}
+
+static int cmd_airtime(const struct shell *sh, size_t argc, char **argv)
+{
+	struct airtime_class c;
+	uint64_t total_us = 0;
+	char name[8];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	for (int i = 0; airtime_get(i, &c) == 0; i++) {
+		total_us += c.airtime_us;
+	}
+
+	shell_print(sh, "%-9s %7s %8s %6s %7s %8s %6s %9s %5s", "object",
+		    "tx_msg", "tx_B", "tx_fr", "rx_msg", "rx_B", "rx_fr",
+		    "air_ms", "%");
+	for (int i = 0; airtime_get(i, &c) == 0; i++) {
+		shell_print(sh, "%-9s %7u %8u %6u %7u %8u %6u %9u %5.1f",
+			    class_name(c.id, name, sizeof(name)),
+			    c.tx_msgs, c.tx_bytes, c.tx_frames,
+			    c.rx_msgs, c.rx_bytes, c.rx_frames,
+			    (uint32_t)(c.airtime_us / 1000),
+			    total_us ? (double)c.airtime_us * 100.0 / total_us
+				     : 0.0);
+	}
+	return 0;
+}
+
+static int cmd_airtime_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	airtime_reset();
+	shell_print(sh, "Airtime counters reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_airtime,
+	SHELL_CMD(reset, NULL, "Zero all airtime counters", cmd_airtime_reset),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(airtime, &sub_airtime,
+		   "Show LwM2M bytes, frames and airtime per object ID",
+		   cmd_airtime);
@@ -0,0 +1,77 @@
+/*
+ * Airtime Accounting — LwM2M Object 33001 and "airtime" shell command
+ *
+ * Attributes every CoAP datagram on the LwM2M socket to the object it
+ * concerns (see airtime_acct.h) and reports per object ID: messages,
+ * bytes and estimated 802.15.4 frames in each direction, plus the
+ * estimated local airtime. The numbers drive pmin/pmax and batching
+ * decisions per telemetry class.
+ *
+ * Datagrams are seen through linker wraps of the socket send/receive
+ * implementations (CMakeLists.txt), filtered on the LwM2M context's
+ * socket, so the engine itself is untouched.
+ *
+ * One Object 33001 instance exists per object ID seen, in order of
+ * first appearance; pseudo IDs 65533 (Send), 65534 (registration) and
+ * 65535 (other) cover traffic without an object.
+ */
+
+#ifndef AIRTIME_H_
+#define AIRTIME_H_
+
+#include <stdint.h>
+#include <zephyr/net/lwm2m.h>
+
+#include "airtime_acct.h"
+
+#define AIRTIME_OBJECT_ID        33001
+
+/* Resource IDs */
+#define AT_OBJECT_ID_RID         0   /* U32: LwM2M object ID (or pseudo ID) */
+#define AT_TX_MSGS_RID           1   /* U32: CoAP messages sent */
+#define AT_TX_BYTES_RID          2   /* U32: CoAP bytes sent */
+#define AT_TX_FRAMES_RID         3   /* U32: estimated 802.15.4 frames sent */
+#define AT_RX_MSGS_RID           4   /* U32: CoAP messages received */
+#define AT_RX_BYTES_RID          5   /* U32: CoAP bytes received */
+#define AT_RX_FRAMES_RID         6   /* U32: estimated 802.15.4 frames received */
+#define AT_AIRTIME_MS_RID        7   /* U32: estimated airtime, TX + RX (ms) */
+#define AT_RESET_RID             8   /* Execute: zero all counters */
+
+#define AT_NUM_FIELDS            9
+#define AT_RES_INST_COUNT        8   /* data resources (execute has none) */
+
+/**
+ * @brief Register Object 33001
+ *
+ * Call from lwm2m_setup(); instances are created as traffic appears.
+ */
+void init_airtime_object(void);
+
+/**
+ * @brief Start accounting datagrams on the LwM2M context's socket
+ *
+ * @param ctx  Client context passed to lwm2m_rd_client_start()
+ */
+void airtime_init(struct lwm2m_ctx *ctx);
+
+/**
+ * @brief Charge the next LwM2M Send to @p obj_id
+ *
+ * Call right before lwm2m_send_cb(); without a hint the Send is
+ * charged to AIRTIME_ID_SEND.
+ */
+void airtime_hint_send(uint16_t obj_id);
+
+/**
+ * @brief Copy the counters of class @p index
+ *
+ * @return 0 on success, -ENOENT past the last class
+ */
+int airtime_get(int index, struct airtime_class *out);
+
+/**
+ * @brief Zero all counters (classes and instances are kept)
+ */
+void airtime_reset(void);
+
+#endif /* AIRTIME_H_ */
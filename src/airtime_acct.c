@@ -0,0 +1,398 @@
+/*
+ * Airtime Accounting — see airtime_acct.h
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "airtime_acct.h"
+
+/* CoAP (RFC 7252) */
+#define COAP_OPT_OBSERVE   6
+#define COAP_OPT_URI_PATH  11
+#define COAP_CODE_EMPTY    0
+#define COAP_CLASS(code)   ((code) >> 5)
+
+/*
+ * 802.15.4 / 6LoWPAN sizing (O-QPSK 250 kbit/s: 32 us per byte)
+ *   MAC: FC 2 + seq 1 + PAN 2 + short dst 2 + short src 2
+ *        + aux security 6 + MIC 4 + FCS 2            = 21
+ *   IPHC + UDP NHC with mesh-local IIDs inline       ~ 25
+ *   SHR + PHR                                        =  6
+ *   MAC ACK: turnaround 192 us + 11 bytes on air     = 544 us
+ */
+#define PSDU_MAX           127
+#define MAC_OVERHEAD       21
+#define LOWPAN_OVERHEAD    25
+#define PHY_OVERHEAD       6
+#define FRAME_CAPACITY     (PSDU_MAX - MAC_OVERHEAD)
+#define FRAG1_HDR          4
+#define FRAGN_HDR          5
+/* Fragment payloads are multiples of 8 bytes (RFC 4944) */
+#define FRAG1_CAPACITY     ((FRAME_CAPACITY - FRAG1_HDR) & ~7)
+#define FRAGN_CAPACITY     ((FRAME_CAPACITY - FRAGN_HDR) & ~7)
+#define US_PER_BYTE        32
+#define MAC_ACK_US         544
+
+/* ==== CoAP parsing ==== */
+
+int airtime_coap_parse(const uint8_t *buf, size_t len, struct coap_meta *m)
+{
+	size_t pos = 4;
+	uint16_t opt = 0;
+
+	if (!buf || !m || len < 4 || (buf[0] >> 6) != 1) {
+		return -EINVAL;
+	}
+
+	memset(m, 0, sizeof(*m));
+	m->type = (buf[0] >> 4) & 0x03;
+	m->tkl = buf[0] & 0x0F;
+	m->code = buf[1];
+	m->mid = ((uint16_t)buf[2] << 8) | buf[3];
+
+	if (m->tkl > 8 || len < pos + m->tkl) {
+		return -EINVAL;
+	}
+	memcpy(m->token, &buf[pos], m->tkl);
+	pos += m->tkl;
+
+	while (pos < len && buf[pos] != 0xFF) {
+		uint16_t delta = buf[pos] >> 4;
+		uint16_t olen = buf[pos] & 0x0F;
+
+		pos++;
+		/* 13: one extension byte, 14: two, 15: reserved */
+		if (delta == 15 || olen == 15) {
+			return -EINVAL;
+		}
+		if (delta == 13) {
+			if (pos + 1 > len) {
+				return -EINVAL;
+			}
+			delta = 13 + buf[pos++];
+		} else if (delta == 14) {
+			if (pos + 2 > len) {
+				return -EINVAL;
+			}
+			delta = 269 + (((uint16_t)buf[pos] << 8) | buf[pos + 1]);
+			pos += 2;
+		}
+		if (olen == 13) {
+			if (pos + 1 > len) {
+				return -EINVAL;
+			}
+			olen = 13 + buf[pos++];
+		} else if (olen == 14) {
+			if (pos + 2 > len) {
+				return -EINVAL;
+			}
+			olen = 269 + (((uint16_t)buf[pos] << 8) | buf[pos + 1]);
+			pos += 2;
+		}
+		if (pos + olen > len) {
+			return -EINVAL;
+		}
+
+		opt += delta;
+		if (opt == COAP_OPT_OBSERVE && olen <= 3) {
+			m->has_observe = true;
+			m->observe = 0;
+			for (int i = 0; i < olen; i++) {
+				m->observe = (m->observe << 8) | buf[pos + i];
+			}
+		} else if (opt == COAP_OPT_URI_PATH && !m->has_path) {
+			size_t n = MIN((size_t)olen, sizeof(m->path0) - 1);
+
+			memcpy(m->path0, &buf[pos], n);
+			m->path0[n] = '\0';
+			m->has_path = true;
+		}
+		pos += olen;
+	}
+
+	return 0;
+}
+
+/* ==== Airtime model ==== */
+
+uint16_t airtime_frames(size_t len)
+{
+	size_t total = len + LOWPAN_OVERHEAD;
+
+	if (total <= FRAME_CAPACITY) {
+		return 1;
+	}
+	total -= FRAG1_CAPACITY;
+	return (uint16_t)(1 + (total + FRAGN_CAPACITY - 1) / FRAGN_CAPACITY);
+}
+
+uint32_t airtime_estimate_us(size_t len)
+{
+	uint32_t frames = airtime_frames(len);
+	uint32_t bytes = len + LOWPAN_OVERHEAD +
+			 frames * (MAC_OVERHEAD + PHY_OVERHEAD);
+
+	if (frames > 1) {
+		bytes += FRAG1_HDR + (frames - 1) * FRAGN_HDR;
+	}
+	return bytes * US_PER_BYTE + frames * MAC_ACK_US;
+}
+
+/* ==== Tables ==== */
+
+void airtime_acct_init(struct airtime_acct *a)
+{
+	memset(a, 0, sizeof(*a));
+}
+
+void airtime_acct_reset_counters(struct airtime_acct *a)
+{
+	for (int i = 0; i < a->class_count; i++) {
+		uint16_t id = a->classes[i].id;
+
+		memset(&a->classes[i], 0, sizeof(a->classes[i]));
+		a->classes[i].id = id;
+	}
+}
+
+void airtime_acct_hint_send(struct airtime_acct *a, uint16_t obj_id)
+{
+	if (a->hint_count == AIRTIME_MAX_HINTS) {
+		a->hint_head = (a->hint_head + 1) % AIRTIME_MAX_HINTS;
+		a->hint_count--;
+	}
+	a->hints[(a->hint_head + a->hint_count) % AIRTIME_MAX_HINTS] = obj_id;
+	a->hint_count++;
+}
+
+static uint16_t hint_pop(struct airtime_acct *a)
+{
+	uint16_t id;
+
+	if (a->hint_count == 0) {
+		return AIRTIME_ID_SEND;
+	}
+	id = a->hints[a->hint_head];
+	a->hint_head = (a->hint_head + 1) % AIRTIME_MAX_HINTS;
+	a->hint_count--;
+	return id;
+}
+
+static bool token_eq(uint8_t tkl_a, const uint8_t *a, uint8_t tkl_b,
+		     const uint8_t *b)
+{
+	return tkl_a == tkl_b && memcmp(a, b, tkl_a) == 0;
+}
+
+static struct airtime_token *token_find(struct airtime_acct *a,
+					const struct coap_meta *m)
+{
+	for (int i = 0; i < a->token_count; i++) {
+		if (token_eq(a->tokens[i].tkl, a->tokens[i].token,
+			     m->tkl, m->token)) {
+			return &a->tokens[i];
+		}
+	}
+	return NULL;
+}
+
+static void token_add(struct airtime_acct *a, const struct coap_meta *m,
+		      uint16_t id)
+{
+	struct airtime_token *t = token_find(a, m);
+
+	if (!t) {
+		if (a->token_count == AIRTIME_MAX_TOKENS) {
+			/* Observer limit reached in the engine as well */
+			return;
+		}
+		t = &a->tokens[a->token_count++];
+	}
+	t->tkl = m->tkl;
+	memcpy(t->token, m->token, m->tkl);
+	t->id = id;
+}
+
+static void token_remove(struct airtime_acct *a, const struct coap_meta *m)
+{
+	struct airtime_token *t = token_find(a, m);
+
+	if (t) {
+		*t = a->tokens[--a->token_count];
+	}
+}
+
+/*
+ * Exchanges remember the direction they were seen in: an ACK matches a
+ * message from the other side, a retransmission one from the same side.
+ */
+static struct airtime_exchange *exchange_by_mid(struct airtime_acct *a,
+						uint16_t mid, bool tx)
+{
+	for (int i = 0; i < AIRTIME_MAX_EXCHANGES; i++) {
+		struct airtime_exchange *e = &a->exchanges[i];
+
+		if (e->used && e->mid == mid && e->tx == tx) {
+			return e;
+		}
+	}
+	return NULL;
+}
+
+static struct airtime_exchange *exchange_by_token(struct airtime_acct *a,
+						  const struct coap_meta *m)
+{
+	for (int i = 0; i < AIRTIME_MAX_EXCHANGES; i++) {
+		struct airtime_exchange *e = &a->exchanges[i];
+
+		if (e->used && m->tkl &&
+		    token_eq(e->tkl, e->token, m->tkl, m->token)) {
+			return e;
+		}
+	}
+	return NULL;
+}
+
+static void exchange_record(struct airtime_acct *a, const struct coap_meta *m,
+			    bool tx, uint16_t id)
+{
+	struct airtime_exchange *e = &a->exchanges[a->exchange_next];
+
+	a->exchange_next = (a->exchange_next + 1) % AIRTIME_MAX_EXCHANGES;
+	e->used = true;
+	e->mid = m->mid;
+	e->tx = tx;
+	e->tkl = m->tkl;
+	memcpy(e->token, m->token, m->tkl);
+	e->id = id;
+}
+
+/* ==== Classification ==== */
+
+static uint16_t path_to_id(struct airtime_acct *a, const struct coap_meta *m,
+			   bool tx)
+{
+	uint32_t id = 0;
+
+	if (!m->has_path) {
+		return AIRTIME_ID_OTHER;
+	}
+	if (strcmp(m->path0, "rd") == 0) {
+		return AIRTIME_ID_REGISTER;
+	}
+	if (strcmp(m->path0, "dp") == 0) {
+		return tx ? hint_pop(a) : AIRTIME_ID_SEND;
+	}
+
+	for (const char *p = m->path0; *p; p++) {
+		if (*p < '0' || *p > '9') {
+			return AIRTIME_ID_OTHER;
+		}
+		id = id * 10 + (uint32_t)(*p - '0');
+	}
+	return (m->path0[0] && id < AIRTIME_ID_SEND) ? (uint16_t)id
+						     : AIRTIME_ID_OTHER;
+}
+
+static uint16_t classify(struct airtime_acct *a, enum airtime_dir dir,
+			 const struct coap_meta *m)
+{
+	bool tx = (dir == AIRTIME_TX);
+	struct airtime_exchange *e;
+	struct airtime_token *t;
+	uint16_t id;
+
+	if (COAP_CLASS(m->code) == 0 && m->code != COAP_CODE_EMPTY) {
+		/* Request — a retransmission keeps its first attribution */
+		e = exchange_by_mid(a, m->mid, tx);
+		if (e && token_eq(e->tkl, e->token, m->tkl, m->token)) {
+			return e->id;
+		}
+
+		id = path_to_id(a, m, tx);
+		if (!tx && m->has_observe && id < AIRTIME_ID_SEND) {
+			if (m->observe == 0) {
+				token_add(a, m, id);
+			} else if (m->observe == 1) {
+				token_remove(a, m);
+			}
+		}
+		exchange_record(a, m, tx, id);
+		return id;
+	}
+
+	/* ACK, RST or response: piggy-backed on the peer's message ID */
+	e = exchange_by_mid(a, m->mid, !tx);
+	if (e) {
+		return e->id;
+	}
+
+	/* Notification, or a separate response to an earlier request */
+	t = m->tkl ? token_find(a, m) : NULL;
+	if (t) {
+		id = t->id;
+	} else {
+		e = exchange_by_token(a, m);
+		id = e ? e->id : AIRTIME_ID_OTHER;
+	}
+
+	/* A confirmable notification or response gets its own ACK */
+	if (m->code != COAP_CODE_EMPTY && !exchange_by_mid(a, m->mid, tx)) {
+		exchange_record(a, m, tx, id);
+	}
+	return id;
+}
+
+static struct airtime_class *class_get(struct airtime_acct *a, uint16_t id)
+{
+	struct airtime_class *other = NULL;
+
+	for (int i = 0; i < a->class_count; i++) {
+		if (a->classes[i].id == id) {
+			return &a->classes[i];
+		}
+		if (a->classes[i].id == AIRTIME_ID_OTHER) {
+			other = &a->classes[i];
+		}
+	}
+
+	/* Keep the last slot for "other" so overflow is still counted */
+	if (a->class_count < AIRTIME_MAX_CLASSES - 1 ||
+	    (a->class_count == AIRTIME_MAX_CLASSES - 1 && !other &&
+	     id == AIRTIME_ID_OTHER)) {
+		struct airtime_class *c = &a->classes[a->class_count++];
+
+		memset(c, 0, sizeof(*c));
+		c->id = id;
+		return c;
+	}
+
+	return other ? other : class_get(a, AIRTIME_ID_OTHER);
+}
+
+uint16_t airtime_acct_packet(struct airtime_acct *a, enum airtime_dir dir,
+			     const uint8_t *buf, size_t len)
+{
+	struct coap_meta m;
+	uint16_t id = AIRTIME_ID_OTHER;
+	struct airtime_class *c;
+
+	if (airtime_coap_parse(buf, len, &m) == 0) {
+		id = classify(a, dir, &m);
+	}
+
+	c = class_get(a, id);
+	if (dir == AIRTIME_TX) {
+		c->tx_msgs++;
+		c->tx_bytes += len;
+		c->tx_frames += airtime_frames(len);
+	} else {
+		c->rx_msgs++;
+		c->rx_bytes += len;
+		c->rx_frames += airtime_frames(len);
+	}
+	c->airtime_us += airtime_estimate_us(len);
+
+	return id;
+}
@@ -0,0 +1,156 @@
+/*
+ * Airtime Accounting — CoAP bytes, 802.15.4 frames and airtime per
+ * LwM2M object ID
+ *
+ * Every LwM2M datagram the client sends or receives is classified by
+ * the object it concerns:
+ *   - requests carry the object in their first Uri-Path segment;
+ *   - notifications reuse the token of the Observe request that set
+ *     them up, so tokens seen in an Observe register are remembered;
+ *   - ACKs and responses match the request by message ID or token.
+ * Registration traffic ("rd") and Sends ("dp") get pseudo IDs unless
+ * the caller names the Send's object with airtime_acct_hint_send().
+ *
+ * Frames and airtime are estimates for the local hop: 6LoWPAN and
+ * secured MAC overhead are constants, fragments follow RFC 4944
+ * sizing, and each frame is charged its link-layer ACK. Forwarding
+ * hops elsewhere in the mesh are not seen.
+ *
+ * Pure C with no locking, so it is unit-tested natively; airtime.c
+ * owns the lock and the socket hook.
+ */
+
+#ifndef AIRTIME_ACCT_H_
+#define AIRTIME_ACCT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(CONFIG_AMI_AIRTIME_MAX_CLASSES)
+#define AIRTIME_MAX_CLASSES    CONFIG_AMI_AIRTIME_MAX_CLASSES
+#else
+#define AIRTIME_MAX_CLASSES    12
+#endif
+
+#if defined(CONFIG_LWM2M_ENGINE_MAX_OBSERVER)
+#define AIRTIME_MAX_TOKENS     CONFIG_LWM2M_ENGINE_MAX_OBSERVER
+#else
+#define AIRTIME_MAX_TOKENS     24
+#endif
+
+/* Recent exchanges kept for matching ACKs and responses */
+#define AIRTIME_MAX_EXCHANGES  16
+/* Send hints waiting for their "dp" request */
+#define AIRTIME_MAX_HINTS      4
+
+/* Pseudo object IDs (above the OMA registry range) */
+#define AIRTIME_ID_SEND        0xFFFD  /* LwM2M Send without a hint */
+#define AIRTIME_ID_REGISTER    0xFFFE  /* Register, update, deregister */
+#define AIRTIME_ID_OTHER       0xFFFF  /* Pings, resets, unmatched, overflow */
+
+enum airtime_dir {
+	AIRTIME_TX,
+	AIRTIME_RX,
+};
+
+/* Counters for one object ID */
+struct airtime_class {
+	uint16_t id;
+	uint32_t tx_msgs;
+	uint32_t tx_bytes;     /* UDP payload (CoAP) bytes */
+	uint32_t tx_frames;    /* estimated 802.15.4 frames */
+	uint32_t rx_msgs;
+	uint32_t rx_bytes;
+	uint32_t rx_frames;
+	uint64_t airtime_us;   /* estimated, TX + RX incl. MAC ACKs */
+};
+
+struct airtime_token {
+	uint8_t  tkl;
+	uint8_t  token[8];
+	uint16_t id;
+};
+
+struct airtime_exchange {
+	uint16_t mid;
+	uint8_t  tkl;
+	uint8_t  token[8];
+	uint16_t id;
+	bool     tx;           /* sent by us */
+	bool     used;
+};
+
+struct airtime_acct {
+	struct airtime_class    classes[AIRTIME_MAX_CLASSES];
+	uint8_t                 class_count;
+	struct airtime_token    tokens[AIRTIME_MAX_TOKENS];
+	uint8_t                 token_count;
+	struct airtime_exchange exchanges[AIRTIME_MAX_EXCHANGES];
+	uint8_t                 exchange_next;
+	uint16_t                hints[AIRTIME_MAX_HINTS];
+	uint8_t                 hint_head;
+	uint8_t                 hint_count;
+};
+
+/* Fields of a CoAP message that classification needs */
+struct coap_meta {
+	uint8_t  type;         /* 0 CON, 1 NON, 2 ACK, 3 RST */
+	uint8_t  code;         /* class << 5 | detail */
+	uint16_t mid;
+	uint8_t  tkl;
+	uint8_t  token[8];
+	bool     has_observe;
+	uint32_t observe;
+	bool     has_path;
+	char     path0[8];     /* first Uri-Path segment, truncated */
+};
+
+/**
+ * @brief Parse the CoAP header and the options classification uses
+ *
+ * @return 0 on success, -EINVAL on a malformed message
+ */
+int airtime_coap_parse(const uint8_t *buf, size_t len, struct coap_meta *m);
+
+/**
+ * @brief Estimated 802.15.4 frames for a UDP payload of @p len bytes
+ */
+uint16_t airtime_frames(size_t len);
+
+/**
+ * @brief Estimated airtime in microseconds for a UDP payload of @p len
+ *        bytes, including the MAC ACK of every frame
+ */
+uint32_t airtime_estimate_us(size_t len);
+
+/**
+ * @brief Clear all counters, tokens, exchanges and hints
+ */
+void airtime_acct_init(struct airtime_acct *a);
+
+/**
+ * @brief Zero the counters
+ *
+ * Classes keep their slots (and LwM2M instance numbers) and tokens are
+ * kept, so live observations stay attributed.
+ */
+void airtime_acct_reset_counters(struct airtime_acct *a);
+
+/**
+ * @brief Name the object of the next LwM2M Send ("dp" request)
+ *
+ * Hints are consumed in order; when the queue is full the oldest one
+ * is dropped.
+ */
+void airtime_acct_hint_send(struct airtime_acct *a, uint16_t obj_id);
+
+/**
+ * @brief Account one datagram
+ *
+ * @return Object (or pseudo) ID the datagram was charged to
+ */
+uint16_t airtime_acct_packet(struct airtime_acct *a, enum airtime_dir dir,
+			     const uint8_t *buf, size_t len);
+
+#endif /* AIRTIME_ACCT_H_ */
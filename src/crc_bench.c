@@ -0,0 +1,119 @@
+/*
+ * CRC-16 Microbenchmark — "crc_bench" shell command
+ *
+ * Times every hdlc_crc16_*() implementation on the device with
+ * k_cycle_get_32(). Each call runs with interrupts locked (one call is
+ * at most a few hundred microseconds even bitwise), so radio and
+ * timer interrupts do not land inside a measurement. The first call
+ * of each implementation runs with its code and table likely out of
+ * the flash cache; the steady-state figure is the mean of the rest.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+
+#include "dlms_hdlc.h"
+
+#define CRC_BENCH_DEFAULT_LEN   128
+#define CRC_BENCH_DEFAULT_ITER  200
+
+struct crc_impl {
+	const char *name;
+	uint16_t (*fn)(const uint8_t *data, size_t len);
+	uint16_t table_bytes;
+};
+
+static const struct crc_impl impls[] = {
+	{ "table",   hdlc_crc16_table,   512 },
+	{ "slice4",  hdlc_crc16_slice4,  2048 },
+	{ "nibble",  hdlc_crc16_nibble,  32 },
+	{ "bitwise", hdlc_crc16_bitwise, 0 },
+#ifdef HDLC_CRC16_HAVE_ROM
+	{ "rom",     hdlc_crc16_rom,     0 },
+#endif
+};
+
+static uint8_t bench_buf[HDLC_MAX_FRAME_LEN];
+
+static uint32_t time_call(const struct crc_impl *impl, size_t len,
+			  uint16_t *crc)
+{
+	unsigned int key = irq_lock();
+	uint32_t t0 = k_cycle_get_32();
+
+	*crc = impl->fn(bench_buf, len);
+
+	uint32_t dt = k_cycle_get_32() - t0;
+
+	irq_unlock(key);
+	return dt;
+}
+
+static int cmd_crc_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	size_t len = CRC_BENCH_DEFAULT_LEN;
+	int iter = CRC_BENCH_DEFAULT_ITER;
+	uint16_t ref = 0;
+
+	if (argc > 1) {
+		len = strtoul(argv[1], NULL, 10);
+	}
+	if (argc > 2) {
+		iter = atoi(argv[2]);
+	}
+	if (len < 1 || len > sizeof(bench_buf) || iter < 1) {
+		shell_error(sh, "usage: crc_bench [len 1-%u] [iterations]",
+			    (unsigned)sizeof(bench_buf));
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < sizeof(bench_buf); i++) {
+		bench_buf[i] = (uint8_t)(i * 31 + 7);
+	}
+
+	shell_print(sh, "CRC-16/X.25, %u B x %d, %u cycles/s (selected: %s)",
+		    (unsigned)len, iter, sys_clock_hw_cycles_per_sec(),
+		    IS_ENABLED(CONFIG_AMI_HDLC_CRC_SLICE4) ? "slice4" :
+		    IS_ENABLED(CONFIG_AMI_HDLC_CRC_NIBBLE) ? "nibble" :
+		    IS_ENABLED(CONFIG_AMI_HDLC_CRC_BITWISE) ? "bitwise" :
+		    IS_ENABLED(CONFIG_AMI_HDLC_CRC_ROM) ? "rom" : "table");
+	shell_print(sh, "  impl     table  first(cyc)  cyc/B  best cyc/B");
+
+	for (size_t k = 0; k < ARRAY_SIZE(impls); k++) {
+		const struct crc_impl *impl = &impls[k];
+		uint64_t sum = 0;
+		uint32_t first, best = UINT32_MAX;
+		uint16_t crc;
+
+		first = time_call(impl, len, &crc);
+		if (k == 0) {
+			ref = crc;
+		} else if (crc != ref) {
+			shell_error(sh, "  %-7s  CRC 0x%04X != 0x%04X",
+				    impl->name, crc, ref);
+			continue;
+		}
+
+		for (int i = 0; i < iter; i++) {
+			uint32_t dt = time_call(impl, len, &crc);
+
+			sum += dt;
+			best = MIN(best, dt);
+		}
+
+		/* Hundredths of a cycle per byte */
+		uint32_t mean_x100 = (uint32_t)(sum * 100U / ((uint64_t)iter * len));
+		uint32_t best_x100 = (uint32_t)((uint64_t)best * 100U / len);
+
+		shell_print(sh, "  %-7s  %5u  %10u  %3u.%02u  %6u.%02u",
+			    impl->name, impl->table_bytes, first,
+			    mean_x100 / 100, mean_x100 % 100,
+			    best_x100 / 100, best_x100 % 100);
+	}
+	return 0;
+}
+
+SHELL_CMD_ARG_REGISTER(crc_bench, NULL,
+		       "Time CRC-16 implementations: crc_bench [len] [iterations]",
+		       cmd_crc_bench, 1, 2);
@@ -12,7 +12,7 @@
 
 #include "dlms_cosem.h"
 
-LOG_MODULE_REGISTER(dlms_cosem, LOG_LEVEL_DBG);
+LOG_MODULE_REGISTER(dlms_cosem, CONFIG_AMI_DLMS_LOG_LEVEL);
 
 /*
  * Application Context Name for LN referencing (no ciphering):
@@ -164,7 +164,7 @@ int cosem_parse_aare(const uint8_t *data, size_t len)
 	 *   A2 03 02 01 <result>
 	 * result: 0 = accepted, 1 = rejected-permanent, 2 = rejected-transient
 	 */
-	for (size_t i = 2; i < len - 4; i++) {
+	for (size_t i = 2; i + 4 < len; i++) {
 		if (data[i] == 0xA2 && data[i + 1] == 0x03 &&
 		    data[i + 2] == 0x02 && data[i + 3] == 0x01) {
 			uint8_t result = data[i + 4];
@@ -300,14 +300,17 @@ int cosem_decode_data(const uint8_t *data, size_t len,
 		consumed = 9;
 		break;
 
-	case COSEM_TYPE_INT64:
+	case COSEM_TYPE_INT64: {
 		if (len < 9) return -ENODATA;
-		result->value.i64 = 0;
+		/* Assemble unsigned: shifting a negative int64_t is undefined */
+		uint64_t bits = 0;
 		for (int i = 0; i < 8; i++) {
-			result->value.i64 = (result->value.i64 << 8) | data[1 + i];
+			bits = (bits << 8) | data[1 + i];
 		}
+		result->value.i64 = (int64_t)bits;
 		consumed = 9;
 		break;
+	}
 
 	case COSEM_TYPE_FLOAT32: {
 		if (len < 5) return -ENODATA;
@@ -11,9 +11,34 @@
 
 #include "dlms_hdlc.h"
 
-LOG_MODULE_REGISTER(dlms_hdlc, LOG_LEVEL_DBG);
+LOG_MODULE_REGISTER(dlms_hdlc, CONFIG_AMI_DLMS_LOG_LEVEL);
 
-/* ---- CRC-16/CCITT lookup table (polynomial 0x8408, bit-reversed) ---- */
+/*
+ * ---- CRC-16/X.25 (polynomial 0x8408 reflected, init/xorout 0xFFFF) ----
+ *
+ * hdlc_crc16() uses the implementation chosen with CONFIG_AMI_HDLC_CRC_*
+ * (byte-wise table when none is set, as on the host). Host builds and
+ * CONFIG_AMI_HDLC_CRC_BENCH compile every implementation so they can be
+ * compared; otherwise only the selected one (and its table) is linked.
+ */
+#if defined(UNIT_TEST) || defined(CONFIG_AMI_HDLC_CRC_BENCH)
+#define CRC_ALL  1
+#define CRC_FN
+#else
+#define CRC_FN   static inline
+#endif
+
+#if !defined(CONFIG_AMI_HDLC_CRC_SLICE4) && !defined(CONFIG_AMI_HDLC_CRC_NIBBLE) && \
+    !defined(CONFIG_AMI_HDLC_CRC_BITWISE) && !defined(CONFIG_AMI_HDLC_CRC_ROM)
+#define CRC_USE_TABLE  1
+#endif
+
+#if defined(CONFIG_AMI_HDLC_CRC_ROM) || defined(HDLC_CRC16_HAVE_ROM)
+#include <esp_rom_crc.h>
+#endif
+
+#if defined(CRC_ALL) || defined(CRC_USE_TABLE) || defined(CONFIG_AMI_HDLC_CRC_SLICE4)
+/* Byte-wise lookup table (T0 of slicing-by-4), 512 B */
 static const uint16_t crc16_table[256] = {
 	0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
 	0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
@@ -49,7 +74,10 @@ static const uint16_t crc16_table[256] = {
 	0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
 };
 
-uint16_t hdlc_crc16(const uint8_t *data, size_t len)
+#endif
+
+#if defined(CRC_ALL) || defined(CRC_USE_TABLE)
+CRC_FN uint16_t hdlc_crc16_table(const uint8_t *data, size_t len)
 {
 	uint16_t crc = 0xFFFF;
 
@@ -59,6 +87,111 @@ uint16_t hdlc_crc16(const uint8_t *data, size_t len)
 
 	return crc ^ 0xFFFF;
 }
+#endif
+
+#if defined(CRC_ALL) || defined(CONFIG_AMI_HDLC_CRC_SLICE4)
+#include "hdlc_crc16_slice.h"
+
+/* Four bytes per step: the 16-bit CRC overlaps the first two of them */
+CRC_FN uint16_t hdlc_crc16_slice4(const uint8_t *data, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	while (len >= 4) {
+		uint16_t x = crc ^ (uint16_t)(data[0] | (data[1] << 8));
+
+		crc = crc16_slice[2][x & 0xFF] ^ crc16_slice[1][x >> 8] ^
+		      crc16_slice[0][data[2]] ^ crc16_table[data[3]];
+		data += 4;
+		len -= 4;
+	}
+	while (len--) {
+		crc = (crc >> 8) ^ crc16_table[(crc ^ *data++) & 0xFF];
+	}
+
+	return crc ^ 0xFFFF;
+}
+#endif
+
+#if defined(CRC_ALL) || defined(CONFIG_AMI_HDLC_CRC_NIBBLE) || \
+    defined(CONFIG_AMI_HDLC_CRC_ROM)
+/* 4 bits per lookup, 32 B table */
+static const uint16_t crc16_nibble[16] = {
+	0x0000, 0x1081, 0x2102, 0x3183, 0x4204, 0x5285, 0x6306, 0x7387,
+	0x8408, 0x9489, 0xA50A, 0xB58B, 0xC60C, 0xD68D, 0xE70E, 0xF78F,
+};
+
+CRC_FN uint16_t hdlc_crc16_nibble(const uint8_t *data, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < len; i++) {
+		crc = (crc >> 4) ^ crc16_nibble[(crc ^ data[i]) & 0x0F];
+		crc = (crc >> 4) ^ crc16_nibble[(crc ^ (data[i] >> 4)) & 0x0F];
+	}
+
+	return crc ^ 0xFFFF;
+}
+#endif
+
+#if defined(CRC_ALL) || defined(CONFIG_AMI_HDLC_CRC_BITWISE)
+CRC_FN uint16_t hdlc_crc16_bitwise(const uint8_t *data, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+		}
+	}
+
+	return crc ^ 0xFFFF;
+}
+#endif
+
+#if defined(CONFIG_AMI_HDLC_CRC_ROM) || defined(HDLC_CRC16_HAVE_ROM)
+/* ROM crc16_le inverts on entry and exit: with 0 it is CRC-16/X.25 */
+CRC_FN uint16_t hdlc_crc16_rom(const uint8_t *data, size_t len)
+{
+	return esp_rom_crc16_le(0, data, (uint32_t)len);
+}
+#endif
+
+#ifdef CONFIG_AMI_HDLC_CRC_ROM
+/* Check the ROM routine once against the X.25 check value before
+ * trusting it with every frame; fall back to the nibble table.
+ */
+static uint16_t crc16_rom_checked(const uint8_t *data, size_t len)
+{
+	static const uint8_t check[] = "123456789";
+	static int rom_ok = -1;
+
+	if (rom_ok < 0) {
+		rom_ok = hdlc_crc16_rom(check, 9) == 0x906E;
+		if (!rom_ok) {
+			LOG_ERR("ROM CRC-16 mismatch — using nibble table");
+		}
+	}
+	return rom_ok ? hdlc_crc16_rom(data, len)
+		      : hdlc_crc16_nibble(data, len);
+}
+#endif
+
+uint16_t hdlc_crc16(const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_AMI_HDLC_CRC_SLICE4)
+	return hdlc_crc16_slice4(data, len);
+#elif defined(CONFIG_AMI_HDLC_CRC_NIBBLE)
+	return hdlc_crc16_nibble(data, len);
+#elif defined(CONFIG_AMI_HDLC_CRC_BITWISE)
+	return hdlc_crc16_bitwise(data, len);
+#elif defined(CONFIG_AMI_HDLC_CRC_ROM)
+	return crc16_rom_checked(data, len);
+#else
+	return hdlc_crc16_table(data, len);
+#endif
+}
 
 /* ---- Internal: build header (format + addresses) ---- */
 static int build_header(uint8_t *buf, size_t buf_size,
@@ -314,12 +447,22 @@ int hdlc_parse_frame(const uint8_t *data, size_t len, struct hdlc_frame *frame)
 	/* Frame without info: flag(1) + format(2) + dst(1) + src(1) + ctrl(1) + HCS(2) + flag(1) = 9 */
 	/* Frame with info: ... + info(N) + FCS(2) */
 	if (len > 9) {
-		/* Information field starts at offset 8, ends before FCS(2) + flag(1) */
-		frame->info_len = len - 9 - 2;  /* total - header(8) - flag(1) - FCS(2) */
-		if (frame->info_len > HDLC_MAX_INFO_LEN) {
-			LOG_WRN("HDLC: Info field too large: %u", frame->info_len);
+		/* Shortest frame with info: 1 info byte + FCS(2) = 12 bytes */
+		if (len < 12) {
+			LOG_WRN("HDLC: Truncated information field (%u bytes)",
+				(unsigned)len);
+			return -EINVAL;
+		}
+
+		/* Information field starts at offset 8, ends before FCS(2) + flag(1).
+		 * Check the size_t length before narrowing to uint16_t.
+		 */
+		size_t info_len = len - 9 - 2;  /* total - header(8) - flag(1) - FCS(2) */
+		if (info_len > HDLC_MAX_INFO_LEN) {
+			LOG_WRN("HDLC: Info field too large: %u", (unsigned)info_len);
 			return -ENOMEM;
 		}
+		frame->info_len = (uint16_t)info_len;
 
 		memcpy(frame->info, &data[8], frame->info_len);
 
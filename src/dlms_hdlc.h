@@ -65,6 +65,24 @@ struct hdlc_frame {
  */
 uint16_t hdlc_crc16(const uint8_t *data, size_t len);
 
+#if defined(UNIT_TEST) || defined(CONFIG_AMI_HDLC_CRC_BENCH)
+/*
+ * Every CRC-16 implementation behind hdlc_crc16(), exported for the
+ * unit tests and the CRC microbenchmarks (CONFIG_AMI_HDLC_CRC_*).
+ * Table footprints: table 512 B, slicing-by-4 2 KB, nibble 32 B,
+ * bitwise and ROM none.
+ */
+uint16_t hdlc_crc16_table(const uint8_t *data, size_t len);
+uint16_t hdlc_crc16_slice4(const uint8_t *data, size_t len);
+uint16_t hdlc_crc16_nibble(const uint8_t *data, size_t len);
+uint16_t hdlc_crc16_bitwise(const uint8_t *data, size_t len);
+
+#ifdef CONFIG_SOC_SERIES_ESP32C6
+#define HDLC_CRC16_HAVE_ROM  1
+uint16_t hdlc_crc16_rom(const uint8_t *data, size_t len);
+#endif
+#endif
+
 /**
  * @brief Build an SNRM frame (connection setup)
  *
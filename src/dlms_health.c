@@ -0,0 +1,234 @@
+/*
+ * DLMS Poll Health — see dlms_health.h
+ *
+ * The window is written by the DLMS thread and read by the shell, so
+ * it sits behind a spinlock; resources are published outside it.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <zephyr/shell/shell.h>
+
+#include "dlms_health.h"
+#include "dlms_meter.h"
+#include "poll_health.h"
+
+/* Internal headers for custom object creation */
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+LOG_MODULE_REGISTER(dlms_health, LOG_LEVEL_INF);
+
+static struct poll_health health;
+static struct k_spinlock health_lock;
+
+/* ================================================================
+ * Object 33004 — single instance, values set after each poll
+ * ================================================================ */
+
+static uint32_t dh_vals[DH_RES_INST_COUNT];
+static double dh_coverage;
+
+static struct lwm2m_engine_obj dh_obj;
+
+static struct lwm2m_engine_obj_field dh_fields[] = {
+	OBJ_FIELD_DATA(DH_POLLS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_FAILED_POLLS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_CONSEC_FAILURES_RID, R, U32),
+	OBJ_FIELD_DATA(DH_RECONNECTS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_LAST_CYCLE_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_MEAN_CYCLE_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_P95_CYCLE_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DH_COVERAGE_RID, R, FLOAT),
+	OBJ_FIELD_DATA(DH_BYTES_PER_POLL_RID, R, U32),
+	OBJ_FIELD(DH_RESET_RID, X_OPT, NONE),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(dh_fields) == DH_NUM_FIELDS,
+	     "dh_fields[] size mismatch with DH_NUM_FIELDS");
+
+static struct lwm2m_engine_obj_inst dh_inst;
+static struct lwm2m_engine_res dh_res[DH_NUM_FIELDS];
+static struct lwm2m_engine_res_inst dh_ri[DH_RES_INST_COUNT];
+
+#define DH_PATH(rid)  (&LWM2M_OBJ(DLMS_HEALTH_OBJECT_ID, 0, (rid)))
+
+/* lwm2m_set_*() notifies observers only when a value changed */
+static void publish(const struct poll_health_summary *s)
+{
+	lwm2m_set_u32(DH_PATH(DH_POLLS_RID), s->polls);
+	lwm2m_set_u32(DH_PATH(DH_FAILED_POLLS_RID), s->failures);
+	lwm2m_set_u32(DH_PATH(DH_CONSEC_FAILURES_RID), s->consec_failures);
+	lwm2m_set_u32(DH_PATH(DH_RECONNECTS_RID), s->reconnects);
+	lwm2m_set_u32(DH_PATH(DH_LAST_CYCLE_MS_RID), s->last_cycle_ms);
+	lwm2m_set_u32(DH_PATH(DH_MEAN_CYCLE_MS_RID), s->mean_cycle_ms);
+	lwm2m_set_u32(DH_PATH(DH_P95_CYCLE_MS_RID), s->p95_cycle_ms);
+	lwm2m_set_f64(DH_PATH(DH_COVERAGE_RID), s->coverage_pct);
+	lwm2m_set_u32(DH_PATH(DH_BYTES_PER_POLL_RID), s->bytes_per_poll);
+}
+
+void dlms_health_update(void)
+{
+	struct meter_poll_stats ps;
+	struct poll_health_sample smp;
+	struct poll_health_summary sum;
+	k_spinlock_key_t key;
+	int ret;
+
+	meter_get_last_poll(&ps);
+	smp = (struct poll_health_sample) {
+		.cycle_ms = ps.duration_ms,
+		.bytes = ps.tx_bytes + ps.rx_bytes,
+		.read = ps.read_count,
+		.target = ps.read_target,
+		.associated = ps.associated,
+		.ok = ps.result == 0,
+	};
+
+	key = k_spin_lock(&health_lock);
+	poll_health_record(&health, &smp);
+	ret = poll_health_summarize(&health, &sum);
+	k_spin_unlock(&health_lock, key);
+
+	if (ret == 0) {
+		publish(&sum);
+	}
+}
+
+static void health_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&health_lock);
+
+	poll_health_reset(&health);
+	k_spin_unlock(&health_lock, key);
+
+	/* Back to the values of a fresh boot */
+	publish(&(struct poll_health_summary) { 0 });
+}
+
+static int dh_reset_cb(uint16_t obj_inst_id, uint8_t *args, uint16_t args_len)
+{
+	ARG_UNUSED(obj_inst_id);
+	ARG_UNUSED(args);
+	ARG_UNUSED(args_len);
+
+	health_reset();
+	LOG_INF("DLMS poll health reset by server");
+	return 0;
+}
+
+static struct lwm2m_engine_obj_inst *dh_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+
+	init_res_instance(dh_ri, ARRAY_SIZE(dh_ri));
+
+	for (int rid = DH_POLLS_RID; rid < DH_RES_INST_COUNT; rid++) {
+		if (rid == DH_COVERAGE_RID) {
+			INIT_OBJ_RES_DATA(rid, dh_res, i, dh_ri, j,
+					  &dh_coverage, sizeof(dh_coverage));
+		} else {
+			INIT_OBJ_RES_DATA(rid, dh_res, i, dh_ri, j,
+					  &dh_vals[rid], sizeof(uint32_t));
+		}
+	}
+	INIT_OBJ_RES_EXECUTE(DH_RESET_RID, dh_res, i, dh_reset_cb);
+
+	dh_inst.resources = dh_res;
+	dh_inst.resource_count = i;
+
+	LOG_DBG("Created DLMS health instance %u", obj_inst_id);
+	return &dh_inst;
+}
+
+void init_dlms_health_object(struct lwm2m_ctx *ctx)
+{
+	const struct lwm2m_obj_path path = LWM2M_OBJ(DLMS_HEALTH_OBJECT_ID, 0);
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	int ret;
+
+	dh_obj.obj_id = DLMS_HEALTH_OBJECT_ID;
+	dh_obj.version_major = 1;
+	dh_obj.version_minor = 0;
+	dh_obj.is_core = false;
+	dh_obj.fields = dh_fields;
+	dh_obj.field_count = ARRAY_SIZE(dh_fields);
+	dh_obj.max_instance_count = 1;
+	dh_obj.create_cb = dh_create;
+	lwm2m_register_obj(&dh_obj);
+
+	ret = lwm2m_create_obj_inst(DLMS_HEALTH_OBJECT_ID, 0, &obj_inst);
+	if (ret < 0) {
+		LOG_ERR("Failed to create DLMS health instance: %d", ret);
+		return;
+	}
+
+	/* Instance-level attributes: every resource inherits them. One
+	 * poll changes several values, so pmin keeps the notifications
+	 * of a poll together; pmax refreshes a quiet dashboard.
+	 */
+	ret = lwm2m_update_observer_min_period(ctx, &path,
+					       CONFIG_AMI_DLMS_HEALTH_PMIN);
+	if (ret == 0) {
+		ret = lwm2m_update_observer_max_period(
+			ctx, &path, CONFIG_AMI_DLMS_HEALTH_PMAX);
+	}
+	if (ret < 0) {
+		LOG_WRN("DLMS health: default pmin/pmax not set: %d", ret);
+	}
+
+	LOG_INF("Object 33004 (DLMS Poll Health) registered, pmin %d s, "
+		"pmax %d s", CONFIG_AMI_DLMS_HEALTH_PMIN,
+		CONFIG_AMI_DLMS_HEALTH_PMAX);
+}
+
+/* ==== Shell ==== */
+
+static int cmd_dlms_health(const struct shell *sh, size_t argc, char **argv)
+{
+	struct poll_health_summary s;
+	k_spinlock_key_t key;
+	int ret;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	key = k_spin_lock(&health_lock);
+	ret = poll_health_summarize(&health, &s);
+	k_spin_unlock(&health_lock, key);
+
+	if (ret < 0) {
+		shell_print(sh, "No polls yet");
+		return 0;
+	}
+
+	shell_print(sh, "Polls %u, failed %u, consecutive %u, reconnects %u",
+		    s.polls, s.failures, s.consec_failures, s.reconnects);
+	shell_print(sh, "T_cycle last %u ms, mean %u ms, p95 %u ms "
+		    "(last %u polls)", s.last_cycle_ms, s.mean_cycle_ms,
+		    s.p95_cycle_ms, s.samples);
+	shell_print(sh, "Coverage %.1f %%, %u bytes/poll",
+		    s.coverage_pct, s.bytes_per_poll);
+	return 0;
+}
+
+static int cmd_dlms_health_reset(const struct shell *sh, size_t argc,
+				 char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	health_reset();
+	shell_print(sh, "DLMS poll health reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_dlms_health,
+	SHELL_CMD(reset, NULL, "Empty the window, zero the counters",
+		  cmd_dlms_health_reset),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(dlms_health, &sub_dlms_health,
+		   "DLMS poll service level (Object 33004)", cmd_dlms_health);
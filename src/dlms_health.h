@@ -0,0 +1,54 @@
+/*
+ * DLMS Poll Health — LwM2M Object 33004 and "dlms_health" shell command
+ *
+ * Summarizes the meter polling service level for fleet dashboards:
+ * T_cycle (last, mean and p95 over the last CONFIG_AMI_DLMS_HEALTH_WINDOW
+ * polls), the share of attempted OBIS values actually read, consecutive
+ * failed polls, reconnects after a lost meter link and RS485 bytes per
+ * poll (see poll_health.h).
+ *
+ * Values are set after every poll with lwm2m_set_*(), so observers are
+ * notified when they change. Default pmin/pmax write-attributes are
+ * applied to the object at start-up; a server's own attributes
+ * override them.
+ */
+
+#ifndef DLMS_HEALTH_H_
+#define DLMS_HEALTH_H_
+
+#include <zephyr/net/lwm2m.h>
+
+#define DLMS_HEALTH_OBJECT_ID    33004
+
+/* Resource IDs */
+#define DH_POLLS_RID             0   /* U32: polls since boot or reset */
+#define DH_FAILED_POLLS_RID      1   /* U32: polls that returned an error */
+#define DH_CONSEC_FAILURES_RID   2   /* U32: failed polls since the last good one */
+#define DH_RECONNECTS_RID        3   /* U32: associations after a failed one */
+#define DH_LAST_CYCLE_MS_RID     4   /* U32: last T_cycle (ms) */
+#define DH_MEAN_CYCLE_MS_RID     5   /* U32: window mean T_cycle (ms) */
+#define DH_P95_CYCLE_MS_RID      6   /* U32: window p95 T_cycle (ms) */
+#define DH_COVERAGE_RID          7   /* Float: window values read / attempted (%) */
+#define DH_BYTES_PER_POLL_RID    8   /* U32: window mean RS485 bytes per poll */
+#define DH_RESET_RID             9   /* Execute: empty window, zero counters */
+
+#define DH_NUM_FIELDS            10
+#define DH_RES_INST_COUNT        9   /* data resources (execute has none) */
+
+/**
+ * @brief Register Object 33004 and apply its default pmin/pmax
+ *
+ * Call from lwm2m_setup().
+ *
+ * @param ctx  Client context later passed to lwm2m_rd_client_start()
+ */
+void init_dlms_health_object(struct lwm2m_ctx *ctx);
+
+/**
+ * @brief Record the outcome of the last meter_poll() and publish it
+ *
+ * Call from the DLMS thread after every meter_poll().
+ */
+void dlms_health_update(void);
+
+#endif /* DLMS_HEALTH_H_ */
@@ -0,0 +1,282 @@
+/*
+ * DLMS Latency — see dlms_latency.h
+ *
+ * The histograms are written by the DLMS thread without a lock; a read
+ * copies one histogram, which at worst mixes two consecutive samples
+ * of the same poll. Values are computed on read, nothing is cached.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dlms_latency.h"
+#include "dlms_meter.h"
+#include "lat_hist.h"
+
+/* Internal headers for custom object creation */
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+LOG_MODULE_REGISTER(dlms_latency, LOG_LEVEL_INF);
+
+#ifdef CONFIG_AMI_DLMS_LATENCY_OBIS
+#define DL_MAX_INST  (DL_OBIS_INST_BASE + METER_FIELD_COUNT)
+#else
+#define DL_MAX_INST  DL_OBIS_INST_BASE
+#endif
+
+BUILD_ASSERT(DL_OBIS_INST_BASE == DLMS_PHASE_COUNT,
+	     "OBIS instances must follow the phase instances");
+
+/* Counts of one histogram: 16 × up to 10 digits, commas, NUL */
+#define BUCKETS_STR_LEN  (LAT_HIST_BUCKETS * 11)
+
+struct dl_stats {
+	const char *name;
+	struct lat_hist h;
+	uint32_t errors;
+	uint32_t retries;
+};
+
+static int dl_get(int inst, struct dl_stats *s)
+{
+	memset(s, 0, sizeof(*s));
+
+	if (inst < DL_OBIS_INST_BASE) {
+		s->name = meter_phase_name((enum dlms_phase)inst);
+		return meter_get_phase_latency((enum dlms_phase)inst, &s->h,
+					       &s->errors);
+	}
+
+	inst -= DL_OBIS_INST_BASE;
+	s->name = meter_field_name(inst);
+	meter_get_obis_diag(inst, NULL, &s->errors, &s->retries, NULL);
+	return meter_get_obis_latency(inst, &s->h);
+}
+
+/* ================================================================
+ * Object 33003 — one instance per histogram, values served on read
+ * ================================================================ */
+
+static uint32_t dl_vals[DL_MAX_INST][DL_RES_INST_COUNT];
+static char dl_buckets_str[BUCKETS_STR_LEN];
+
+static struct lwm2m_engine_obj dl_obj;
+
+static struct lwm2m_engine_obj_field dl_fields[] = {
+	OBJ_FIELD_DATA(DL_NAME_RID, R, STRING),
+	OBJ_FIELD_DATA(DL_SAMPLES_RID, R, U32),
+	OBJ_FIELD_DATA(DL_ERRORS_RID, R, U32),
+	OBJ_FIELD_DATA(DL_RETRIES_RID, R, U32),
+	OBJ_FIELD_DATA(DL_MEAN_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DL_P50_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DL_P95_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DL_MAX_MS_RID, R, U32),
+	OBJ_FIELD_DATA(DL_BUCKETS_RID, R, STRING),
+	OBJ_FIELD(DL_RESET_RID, X_OPT, NONE),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(dl_fields) == DL_NUM_FIELDS,
+	     "dl_fields[] size mismatch with DL_NUM_FIELDS");
+
+static struct lwm2m_engine_obj_inst dl_inst[DL_MAX_INST];
+static struct lwm2m_engine_res dl_res[DL_MAX_INST][DL_NUM_FIELDS];
+static struct lwm2m_engine_res_inst dl_ri[DL_MAX_INST][DL_RES_INST_COUNT];
+
+static void *dl_read_cb(uint16_t obj_inst_id, uint16_t res_id,
+			uint16_t res_inst_id, size_t *data_len)
+{
+	struct dl_stats s;
+	uint32_t *v;
+	int len;
+
+	ARG_UNUSED(res_inst_id);
+
+	if (obj_inst_id >= DL_MAX_INST || res_id >= DL_RES_INST_COUNT ||
+	    dl_get(obj_inst_id, &s) < 0) {
+		*data_len = 0;
+		return NULL;
+	}
+
+	switch (res_id) {
+	case DL_NAME_RID:
+		*data_len = strlen(s.name);
+		return (void *)s.name;
+	case DL_BUCKETS_RID:
+		/* Serialized before the next read reuses the buffer */
+		len = lat_hist_format(&s.h, dl_buckets_str,
+				      sizeof(dl_buckets_str));
+		*data_len = len > 0 ? (size_t)len : 0;
+		return dl_buckets_str;
+	default:
+		break;
+	}
+
+	v = &dl_vals[obj_inst_id][res_id];
+	switch (res_id) {
+	case DL_SAMPLES_RID: *v = s.h.count; break;
+	case DL_ERRORS_RID:  *v = s.errors; break;
+	case DL_RETRIES_RID: *v = s.retries; break;
+	case DL_MEAN_MS_RID: *v = lat_hist_mean_ms(&s.h); break;
+	case DL_P50_MS_RID:  *v = lat_hist_percentile_ms(&s.h, 50); break;
+	case DL_P95_MS_RID:  *v = lat_hist_percentile_ms(&s.h, 95); break;
+	case DL_MAX_MS_RID:  *v = s.h.max_ms; break;
+	default: break;
+	}
+
+	*data_len = sizeof(*v);
+	return v;
+}
+
+static int dl_reset_cb(uint16_t obj_inst_id, uint8_t *args, uint16_t args_len)
+{
+	ARG_UNUSED(obj_inst_id);
+	ARG_UNUSED(args);
+	ARG_UNUSED(args_len);
+
+	meter_reset_latency();
+	LOG_INF("DLMS latency histograms reset by server");
+	return 0;
+}
+
+static struct lwm2m_engine_obj_inst *dl_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+	int idx = obj_inst_id;
+
+	if (idx >= DL_MAX_INST || dl_inst[idx].obj) {
+		LOG_ERR("DLMS latency: cannot create instance %u", obj_inst_id);
+		return NULL;
+	}
+
+	(void)memset(dl_res[idx], 0, sizeof(dl_res[idx]));
+	init_res_instance(dl_ri[idx], ARRAY_SIZE(dl_ri[idx]));
+
+	/* Strings point at the shared buffer; the read callback fills it */
+	INIT_OBJ_RES_DATA(DL_NAME_RID, dl_res[idx], i, dl_ri[idx], j,
+			  dl_buckets_str, sizeof(dl_buckets_str));
+	for (int rid = DL_SAMPLES_RID; rid <= DL_MAX_MS_RID; rid++) {
+		INIT_OBJ_RES_DATA(rid, dl_res[idx], i, dl_ri[idx], j,
+				  &dl_vals[idx][rid], sizeof(uint32_t));
+	}
+	INIT_OBJ_RES_DATA(DL_BUCKETS_RID, dl_res[idx], i, dl_ri[idx], j,
+			  dl_buckets_str, sizeof(dl_buckets_str));
+	INIT_OBJ_RES_EXECUTE(DL_RESET_RID, dl_res[idx], i, dl_reset_cb);
+
+	dl_inst[idx].resources = dl_res[idx];
+	dl_inst[idx].resource_count = i;
+
+	LOG_DBG("Created DLMS latency instance %u", obj_inst_id);
+	return &dl_inst[idx];
+}
+
+void init_dlms_latency_object(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+
+	dl_obj.obj_id = DLMS_LATENCY_OBJECT_ID;
+	dl_obj.version_major = 1;
+	dl_obj.version_minor = 0;
+	dl_obj.is_core = false;
+	dl_obj.fields = dl_fields;
+	dl_obj.field_count = ARRAY_SIZE(dl_fields);
+	dl_obj.max_instance_count = DL_MAX_INST;
+	dl_obj.create_cb = dl_create;
+	lwm2m_register_obj(&dl_obj);
+
+	for (uint16_t id = 0; id < DL_MAX_INST; id++) {
+		if (lwm2m_create_obj_inst(DLMS_LATENCY_OBJECT_ID, id,
+					  &obj_inst) < 0) {
+			LOG_ERR("DLMS latency: instance %u create failed", id);
+			return;
+		}
+		for (int rid = 0; rid < DL_RES_INST_COUNT; rid++) {
+			lwm2m_register_read_callback(
+				&LWM2M_OBJ(DLMS_LATENCY_OBJECT_ID, id, rid),
+				dl_read_cb);
+		}
+	}
+
+	LOG_INF("Object 33003 (DLMS Latency) registered, %d instances",
+		DL_MAX_INST);
+}
+
+/* ==== Shell ==== */
+
+static int cmd_dlms_latency(const struct shell *sh, size_t argc, char **argv)
+{
+	struct dl_stats s;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(sh, "%3s %-20s %7s %5s %5s %7s %7s %7s %7s   (ms)",
+		    "#", "name", "n", "err", "retry", "mean", "p50", "p95",
+		    "max");
+	/* Every OBIS entry here, also without CONFIG_AMI_DLMS_LATENCY_OBIS */
+	for (int i = 0; dl_get(i, &s) == 0; i++) {
+		if (i >= DL_OBIS_INST_BASE && s.h.count == 0) {
+			continue;  /* Skipped register */
+		}
+		shell_print(sh, "%3d %-20s %7u %5u %5u %7u %7u %7u %7u",
+			    i, s.name, s.h.count, s.errors, s.retries,
+			    lat_hist_mean_ms(&s.h),
+			    lat_hist_percentile_ms(&s.h, 50),
+			    lat_hist_percentile_ms(&s.h, 95), s.h.max_ms);
+	}
+	return 0;
+}
+
+static int cmd_dlms_latency_hist(const struct shell *sh, size_t argc,
+				 char **argv)
+{
+	struct dl_stats s;
+	uint32_t lower = 0;
+
+	ARG_UNUSED(argc);
+
+	if (dl_get(atoi(argv[1]), &s) < 0) {
+		shell_error(sh, "No histogram %s (see dlms_latency)", argv[1]);
+		return -EINVAL;
+	}
+
+	shell_print(sh, "%s: %u samples", s.name, s.h.count);
+	for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+		uint32_t upper = lat_hist_bucket_upper_ms(b);
+
+		if (upper == UINT32_MAX) {
+			shell_print(sh, "  >= %5u ms  %7u", lower, s.h.bucket[b]);
+		} else {
+			shell_print(sh, "  %5u-%5u ms %7u", lower, upper - 1,
+				    s.h.bucket[b]);
+		}
+		lower = upper;
+	}
+	return 0;
+}
+
+static int cmd_dlms_latency_reset(const struct shell *sh, size_t argc,
+				  char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	meter_reset_latency();
+	shell_print(sh, "DLMS latency histograms reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_dlms_latency,
+	SHELL_CMD_ARG(hist, NULL, "Bucket counts of histogram <#>",
+		      cmd_dlms_latency_hist, 2, 0),
+	SHELL_CMD(reset, NULL, "Drop all samples", cmd_dlms_latency_reset),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(dlms_latency, &sub_dlms_latency,
+		   "DLMS latency per protocol phase and OBIS register",
+		   cmd_dlms_latency);
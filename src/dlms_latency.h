@@ -0,0 +1,46 @@
+/*
+ * DLMS Latency — LwM2M Object 33003 and "dlms_latency" shell command
+ *
+ * Publishes the latency histograms dlms_meter.c keeps (lat_hist.h):
+ * one per protocol phase (SNRM, AARQ, GET, RLRQ, DISC; one sample per
+ * transaction) and, with CONFIG_AMI_DLMS_LATENCY_OBIS, one per OBIS
+ * table entry (one sample per read, retries included). Slow registers
+ * and slow meters show up in the server's data without serial logs.
+ *
+ * Instances 0-4 are the phases in enum dlms_phase order; instance
+ * 5 + i is OBIS table entry i (resource 0 holds its name). Bucket
+ * counts are served as one comma-separated string; the bucket bounds
+ * are fixed (see lat_hist.h).
+ */
+
+#ifndef DLMS_LATENCY_H_
+#define DLMS_LATENCY_H_
+
+#define DLMS_LATENCY_OBJECT_ID   33003
+
+/* Resource IDs */
+#define DL_NAME_RID              0   /* String: phase or OBIS entry name */
+#define DL_SAMPLES_RID           1   /* U32: samples recorded */
+#define DL_ERRORS_RID            2   /* U32: failed transactions / reads */
+#define DL_RETRIES_RID           3   /* U32: read retries (OBIS only) */
+#define DL_MEAN_MS_RID           4   /* U32: mean latency (ms) */
+#define DL_P50_MS_RID            5   /* U32: estimated median (ms) */
+#define DL_P95_MS_RID            6   /* U32: estimated 95th percentile (ms) */
+#define DL_MAX_MS_RID            7   /* U32: largest sample (ms) */
+#define DL_BUCKETS_RID           8   /* String: "n0,n1,...,n15" */
+#define DL_RESET_RID             9   /* Execute: drop all samples */
+
+#define DL_NUM_FIELDS            10
+#define DL_RES_INST_COUNT        9   /* data resources (execute has none) */
+
+/* Instance of OBIS table entry i */
+#define DL_OBIS_INST_BASE        5
+
+/**
+ * @brief Register Object 33003 and create its instances
+ *
+ * Call from lwm2m_setup().
+ */
+void init_dlms_latency_object(void);
+
+#endif /* DLMS_LATENCY_H_ */
@@ -50,8 +50,11 @@
 #include "rs485_uart.h"
 #include "lwm2m_obj_power_meter.h"
 #include "lwm2m_observation.h"
+#include "telemetry_uplink.h"
+#include "trace.h"
+#include "lat_hist.h"
 
-LOG_MODULE_REGISTER(dlms_meter, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(dlms_meter, CONFIG_AMI_DLMS_LOG_LEVEL);
 
 /* ---- OBIS → Reading mapping entry ---- */
 struct obis_mapping {
@@ -59,9 +62,11 @@ struct obis_mapping {
 	uint16_t         class_id;      /* DLMS interface class (3=Register, 4=ExtRegister) */
 	const char      *name;          /* Human-readable name */
 	size_t           offset;        /* Offset into meter_readings struct */
+	uint16_t         rid;           /* Object 10242 resource ID */
+	uint8_t          rec_dec;       /* Decimals kept in struct meter_record */
 };
 
-/* Helper macro: offset of a double field in meter_readings */
+/* Helper macro: offset of an int32 raw field in meter_readings */
 #define MR_OFF(field) offsetof(struct meter_readings, field)
 
 /*
@@ -70,77 +75,113 @@ struct obis_mapping {
  * Class 4 = Extended Register (same attributes)
  *
  * We read instantaneous values (.7.0) and cumulative energy (.8.0).
+ *
+ * rec_dec is the fixed-point precision used when a reading is packed
+ * into a struct meter_record for store-and-forward: V/Hz keep 0.01,
+ * currents/powers/PF keep 0.001 (the meter's own resolution). Energy
+ * registers are cumulative Wh and keep whole units, so an int32 record
+ * holds up to ~2.1 GWh instead of clipping at ~21 MWh.
  */
 static const struct obis_mapping obis_table[] = {
 	/* Phase A (R) */
 	{ .obis = {1,1,32,7,0,255}, .class_id = 3, .name = "Voltage_R",
-	  .offset = MR_OFF(voltage_r) },
+	  .offset = MR_OFF(voltage_r),
+	  .rid = PM_TENSION_R_RID, .rec_dec = 2 },
 	{ .obis = {1,1,31,7,0,255}, .class_id = 3, .name = "Current_R",
-	  .offset = MR_OFF(current_r) },
+	  .offset = MR_OFF(current_r),
+	  .rid = PM_CURRENT_R_RID, .rec_dec = 3 },
 	{ .obis = {1,1,21,7,0,255}, .class_id = 3, .name = "ActivePower_R",
-	  .offset = MR_OFF(active_power_r) },
+	  .offset = MR_OFF(active_power_r),
+	  .rid = PM_ACTIVE_POWER_R_RID, .rec_dec = 3 },
 	{ .obis = {1,1,23,7,0,255}, .class_id = 3, .name = "ReactivePower_R",
-	  .offset = MR_OFF(reactive_power_r) },
+	  .offset = MR_OFF(reactive_power_r),
+	  .rid = PM_REACTIVE_POWER_R_RID, .rec_dec = 3 },
 	{ .obis = {1,1,29,7,0,255}, .class_id = 3, .name = "ApparentPower_R",
-	  .offset = MR_OFF(apparent_power_r) },
+	  .offset = MR_OFF(apparent_power_r),
+	  .rid = PM_APPARENT_POWER_R_RID, .rec_dec = 3 },
 	{ .obis = {1,1,33,7,0,255}, .class_id = 3, .name = "PowerFactor_R",
-	  .offset = MR_OFF(power_factor_r) },
+	  .offset = MR_OFF(power_factor_r),
+	  .rid = PM_POWER_FACTOR_R_RID, .rec_dec = 3 },
 
 	/* Phase B (S) */
 	{ .obis = {1,1,52,7,0,255}, .class_id = 3, .name = "Voltage_S",
-	  .offset = MR_OFF(voltage_s) },
+	  .offset = MR_OFF(voltage_s),
+	  .rid = PM_TENSION_S_RID, .rec_dec = 2 },
 	{ .obis = {1,1,51,7,0,255}, .class_id = 3, .name = "Current_S",
-	  .offset = MR_OFF(current_s) },
+	  .offset = MR_OFF(current_s),
+	  .rid = PM_CURRENT_S_RID, .rec_dec = 3 },
 	{ .obis = {1,1,41,7,0,255}, .class_id = 3, .name = "ActivePower_S",
-	  .offset = MR_OFF(active_power_s) },
+	  .offset = MR_OFF(active_power_s),
+	  .rid = PM_ACTIVE_POWER_S_RID, .rec_dec = 3 },
 	{ .obis = {1,1,43,7,0,255}, .class_id = 3, .name = "ReactivePower_S",
-	  .offset = MR_OFF(reactive_power_s) },
+	  .offset = MR_OFF(reactive_power_s),
+	  .rid = PM_REACTIVE_POWER_S_RID, .rec_dec = 3 },
 	{ .obis = {1,1,49,7,0,255}, .class_id = 3, .name = "ApparentPower_S",
-	  .offset = MR_OFF(apparent_power_s) },
+	  .offset = MR_OFF(apparent_power_s),
+	  .rid = PM_APPARENT_POWER_S_RID, .rec_dec = 3 },
 	{ .obis = {1,1,53,7,0,255}, .class_id = 3, .name = "PowerFactor_S",
-	  .offset = MR_OFF(power_factor_s) },
+	  .offset = MR_OFF(power_factor_s),
+	  .rid = PM_POWER_FACTOR_S_RID, .rec_dec = 3 },
 
 	/* Phase C (T) */
 	{ .obis = {1,1,72,7,0,255}, .class_id = 3, .name = "Voltage_T",
-	  .offset = MR_OFF(voltage_t) },
+	  .offset = MR_OFF(voltage_t),
+	  .rid = PM_TENSION_T_RID, .rec_dec = 2 },
 	{ .obis = {1,1,71,7,0,255}, .class_id = 3, .name = "Current_T",
-	  .offset = MR_OFF(current_t) },
+	  .offset = MR_OFF(current_t),
+	  .rid = PM_CURRENT_T_RID, .rec_dec = 3 },
 	{ .obis = {1,1,61,7,0,255}, .class_id = 3, .name = "ActivePower_T",
-	  .offset = MR_OFF(active_power_t) },
+	  .offset = MR_OFF(active_power_t),
+	  .rid = PM_ACTIVE_POWER_T_RID, .rec_dec = 3 },
 	{ .obis = {1,1,63,7,0,255}, .class_id = 3, .name = "ReactivePower_T",
-	  .offset = MR_OFF(reactive_power_t) },
+	  .offset = MR_OFF(reactive_power_t),
+	  .rid = PM_REACTIVE_POWER_T_RID, .rec_dec = 3 },
 	{ .obis = {1,1,69,7,0,255}, .class_id = 3, .name = "ApparentPower_T",
-	  .offset = MR_OFF(apparent_power_t) },
+	  .offset = MR_OFF(apparent_power_t),
+	  .rid = PM_APPARENT_POWER_T_RID, .rec_dec = 3 },
 	{ .obis = {1,1,73,7,0,255}, .class_id = 3, .name = "PowerFactor_T",
-	  .offset = MR_OFF(power_factor_t) },
+	  .offset = MR_OFF(power_factor_t),
+	  .rid = PM_POWER_FACTOR_T_RID, .rec_dec = 3 },
 
 	/* Totals */
 	{ .obis = {1,1,1,7,0,255}, .class_id = 3, .name = "TotalActivePower",
-	  .offset = MR_OFF(total_active_power) },
+	  .offset = MR_OFF(total_active_power),
+	  .rid = PM_3P_ACTIVE_POWER_RID, .rec_dec = 3 },
 	{ .obis = {1,1,3,7,0,255}, .class_id = 3, .name = "TotalReactivePower",
-	  .offset = MR_OFF(total_reactive_power) },
+	  .offset = MR_OFF(total_reactive_power),
+	  .rid = PM_3P_REACTIVE_POWER_RID, .rec_dec = 3 },
 	{ .obis = {1,1,9,7,0,255}, .class_id = 3, .name = "TotalApparentPower",
-	  .offset = MR_OFF(total_apparent_power) },
+	  .offset = MR_OFF(total_apparent_power),
+	  .rid = PM_3P_APPARENT_POWER_RID, .rec_dec = 3 },
 	{ .obis = {1,1,13,7,0,255}, .class_id = 3, .name = "TotalPowerFactor",
-	  .offset = MR_OFF(total_power_factor) },
+	  .offset = MR_OFF(total_power_factor),
+	  .rid = PM_3P_POWER_FACTOR_RID, .rec_dec = 3 },
 
 	/* Energy */
 	{ .obis = {1,1,1,8,0,255}, .class_id = 3, .name = "ActiveEnergy",
-	  .offset = MR_OFF(active_energy) },
+	  .offset = MR_OFF(active_energy),
+	  .rid = PM_ACTIVE_ENERGY_RID, .rec_dec = 0 },
 	{ .obis = {1,1,3,8,0,255}, .class_id = 3, .name = "ReactiveEnergy",
-	  .offset = MR_OFF(reactive_energy) },
+	  .offset = MR_OFF(reactive_energy),
+	  .rid = PM_REACTIVE_ENERGY_RID, .rec_dec = 0 },
 	{ .obis = {1,1,9,8,0,255}, .class_id = 3, .name = "ApparentEnergy",
-	  .offset = MR_OFF(apparent_energy) },
+	  .offset = MR_OFF(apparent_energy),
+	  .rid = PM_APPARENT_ENERGY_RID, .rec_dec = 0 },
 
 	/* Other */
 	{ .obis = {1,1,14,7,0,255}, .class_id = 3, .name = "Frequency",
-	  .offset = MR_OFF(frequency) },
+	  .offset = MR_OFF(frequency),
+	  .rid = PM_FREQUENCY_RID, .rec_dec = 2 },
 	{ .obis = {1,1,91,7,0,255}, .class_id = 3, .name = "NeutralCurrent",
-	  .offset = MR_OFF(neutral_current) },
+	  .offset = MR_OFF(neutral_current),
+	  .rid = PM_NEUTRAL_CURRENT_RID, .rec_dec = 3 },
 };
 
 #define OBIS_TABLE_SIZE  ARRAY_SIZE(obis_table)
 
+BUILD_ASSERT(ARRAY_SIZE(obis_table) == METER_FIELD_COUNT,
+	     "meter_record layout must match obis_table");
+
 /* ---- Module state ---- */
 static enum meter_state state = METER_DISCONNECTED;
 static struct meter_config cfg;
@@ -156,9 +197,54 @@ static uint8_t rx_buf[HDLC_MAX_FRAME_LEN];
 static uint8_t hdlc_client_addr;
 static uint8_t hdlc_server_addr;
 
-/* Scaler cache: 10^scaler for each OBIS entry (read once, reuse) */
-static double scaler_cache[ARRAY_SIZE(obis_table)];
+/*
+ * Scaler cache: DLMS scaler (power-of-ten exponent) for each OBIS entry
+ * (read once, reuse). Shared by every reading — meter_readings only
+ * carries raw integers. Uncached entries hold 0 (x1).
+ *
+ * An entry whose scaler is outside SCALER_MIN..SCALER_MAX is marked
+ * scaler_bad and left out of every reading (never in field_mask):
+ * any value for it would be off by powers of ten.
+ *
+ * Float registers keep FLOAT_DECIMALS decimals: on an entry's first
+ * float value its exponent is lowered by float_shift (FLOAT_DECIMALS,
+ * less if that would pass SCALER_MIN) and every value is stored as
+ * value × 10^float_shift.
+ */
+#define FLOAT_DECIMALS  3
+
+static int8_t scaler_exp[ARRAY_SIZE(obis_table)];
 static bool   scaler_cached[ARRAY_SIZE(obis_table)];
+static bool   scaler_bad[ARRAY_SIZE(obis_table)];
+static bool   scaler_float[ARRAY_SIZE(obis_table)];
+static int8_t float_shift[ARRAY_SIZE(obis_table)];
+
+/*
+ * Power-of-ten tables for the scaler path — no pow() and no soft-float
+ * library calls on the ESP32-C6 (RISC-V, no double-precision FPU).
+ *
+ * DLMS allows int8 scalers (-128..127) but real registers use -9..9
+ * (Microstar: -3..0); read_scaler_unit() rejects anything outside
+ * that range, so the lookups below are always in bounds and
+ * branch-free.
+ */
+#define SCALER_MIN  (-9)
+#define SCALER_MAX    9
+
+static const double pow10_f64[SCALER_MAX - SCALER_MIN + 1] = {
+	1e-9, 1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1,
+	1e0,
+	1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+};
+
+/* 10^n, n = 0..18 — integer rescaling (fits int64) */
+static const int64_t pow10_i64[19] = {
+	1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL,
+	10000000LL, 100000000LL, 1000000000LL, 10000000000LL,
+	100000000000LL, 1000000000000LL, 10000000000000LL,
+	100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+	100000000000000000LL, 1000000000000000000LL,
+};
 
 /*
  * Last-good-readings cache: when a DLMS read fails (timeout, error),
@@ -182,14 +268,34 @@ struct obis_diag {
 	uint32_t fail;       /* Cumulative failed reads (after all retries) */
 	uint32_t retries;    /* Cumulative retry attempts (not counting first try) */
 	uint32_t skip;       /* Cumulative times skipped (auto-skip or single-phase) */
+	uint32_t bad_scaler; /* scaler_unit reads with a scaler outside -9..9 */
 	int64_t  total_ms;   /* Cumulative read time (ms) for timing analysis */
 };
 
 static struct obis_diag obis_diag[ARRAY_SIZE(obis_table)];
+
+/*
+ * Latency histograms (lat_hist.h): one per OBIS entry (whole read,
+ * retries included) and one per protocol phase (one transaction,
+ * every GET in the GET phase). Published by Object 33003.
+ */
+static struct lat_hist obis_lat[ARRAY_SIZE(obis_table)];
+static struct lat_hist phase_lat[DLMS_PHASE_COUNT];
+static uint32_t phase_errors[DLMS_PHASE_COUNT];
+
+static const char *const phase_names[DLMS_PHASE_COUNT] = {
+	[DLMS_PHASE_SNRM] = "SNRM",
+	[DLMS_PHASE_AARQ] = "AARQ",
+	[DLMS_PHASE_GET]  = "GET",
+	[DLMS_PHASE_RLRQ] = "RLRQ",
+	[DLMS_PHASE_DISC] = "DISC",
+};
+
 static uint32_t poll_count;            /* Total polls executed */
 static int64_t  last_poll_duration_ms; /* Duration of last meter_poll() */
 static int64_t  poll_duration_sum_ms;  /* Sum of all poll durations */
 static int64_t  last_read_cycle_ms;    /* Duration of last meter_read_all() */
+static struct meter_poll_stats last_poll; /* Outcome of last meter_poll() */
 
 /*
  * Runtime skip bitmap: OBIS codes that return "data access error" (e.g.,
@@ -270,15 +376,16 @@ static void set_defaults(void)
 }
 
 /* ---- Send frame and receive response ---- */
-static int transact(const uint8_t *tx, int tx_len, struct hdlc_frame *resp)
+static int transact_frame(const uint8_t *tx, int tx_len,
+			  struct hdlc_frame *resp)
 {
 	int ret;
 
 	/* Flush RX before sending */
 	rs485_flush_rx();
 
+	/* Frame bytes go to the trace ring in rs485_send()/rs485_recv() */
 	LOG_DBG("TX %d bytes to meter", tx_len);
-	LOG_HEXDUMP_DBG(tx, tx_len, "HDLC TX");
 
 	/* Send frame */
 	ret = rs485_send(tx, tx_len);
@@ -286,6 +393,7 @@ static int transact(const uint8_t *tx, int tx_len, struct hdlc_frame *resp)
 		LOG_ERR("RS485 send failed: %d", ret);
 		return ret;
 	}
+	last_poll.tx_bytes += tx_len;
 
 	/* Wait for response */
 	k_sleep(K_MSEC(cfg.inter_frame_delay_ms));
@@ -295,8 +403,8 @@ static int transact(const uint8_t *tx, int tx_len, struct hdlc_frame *resp)
 		LOG_ERR("RS485 recv failed: %d (timeout=%dms)", ret, cfg.response_timeout_ms);
 		return ret < 0 ? ret : -ENODATA;
 	}
+	last_poll.rx_bytes += ret;
 	LOG_DBG("RX %d bytes from meter", ret);
-	LOG_HEXDUMP_DBG(rx_buf, ret, "HDLC RX");
 
 	if (ret < 9) {
 		LOG_WRN("Response too short: %d bytes", ret);
@@ -321,6 +429,22 @@ static int transact(const uint8_t *tx, int tx_len, struct hdlc_frame *resp)
 	return 0;
 }
 
+static int transact(enum dlms_phase phase, const uint8_t *tx, int tx_len,
+		    struct hdlc_frame *resp)
+{
+	int64_t t0 = k_uptime_get();
+
+	TRACE(TRANSACT_BEGIN, tx_len);
+	int ret = transact_frame(tx, tx_len, resp);
+	TRACE(TRANSACT_END, ret);
+
+	lat_hist_record(&phase_lat[phase], (uint32_t)(k_uptime_get() - t0));
+	if (ret < 0) {
+		phase_errors[phase]++;
+	}
+	return ret;
+}
+
 /* ---- Public API ---- */
 
 int meter_init(void)
@@ -336,6 +460,9 @@ int meter_init(void)
 	}
 
 	memset(scaler_cached, 0, sizeof(scaler_cached));
+	memset(scaler_exp, 0, sizeof(scaler_exp));
+	memset(scaler_bad, 0, sizeof(scaler_bad));
+	memset(scaler_float, 0, sizeof(scaler_float));
 	memset(obis_skip, 0, sizeof(obis_skip));
 
 #if IS_ENABLED(CONFIG_AMI_SINGLE_PHASE)
@@ -413,7 +540,7 @@ int meter_connect(void)
 		return ret;
 	}
 
-	ret = transact(tx_buf, ret, &resp);
+	ret = transact(DLMS_PHASE_SNRM, tx_buf, ret, &resp);
 	if (ret < 0) {
 		LOG_ERR("SNRM transaction failed: %d", ret);
 		state = METER_ERROR;
@@ -448,7 +575,7 @@ int meter_connect(void)
 		return ret;
 	}
 
-	ret = transact(tx_buf, ret, &resp);
+	ret = transact(DLMS_PHASE_AARQ, tx_buf, ret, &resp);
 	if (ret < 0) {
 		LOG_ERR("AARQ transaction failed: %d", ret);
 		state = METER_ERROR;
@@ -488,7 +615,7 @@ int meter_disconnect(void)
 		if (rlrq_len > 0) {
 			ret = build_cosem_iframe(rlrq_pdu, rlrq_len);
 			if (ret > 0) {
-				transact(tx_buf, ret, &resp);
+				transact(DLMS_PHASE_RLRQ, tx_buf, ret, &resp);
 				/* Ignore errors on disconnect */
 			}
 		}
@@ -498,7 +625,7 @@ int meter_disconnect(void)
 	ret = hdlc_build_disc(tx_buf, sizeof(tx_buf),
 			      hdlc_client_addr, hdlc_server_addr);
 	if (ret > 0) {
-		transact(tx_buf, ret, &resp);
+		transact(DLMS_PHASE_DISC, tx_buf, ret, &resp);
 		/* Ignore errors */
 	}
 
@@ -538,7 +665,7 @@ static int read_obis_value(const struct obis_mapping *entry,
 	}
 
 	/* Transact */
-	ret = transact(tx_buf, ret, &resp);
+	ret = transact(DLMS_PHASE_GET, tx_buf, ret, &resp);
 	if (ret < 0) {
 		return ret;
 	}
@@ -551,11 +678,42 @@ static int read_obis_value(const struct obis_mapping *entry,
 	return ret;
 }
 
-/* ---- Convert COSEM value to double, applying scaler ---- */
-static double value_to_double(const struct cosem_get_result *result,
-			      int table_idx)
+/*
+ * ---- Convert COSEM value to a raw int32 register value ----
+ *
+ * The scaler is NOT applied here; it stays in scaler_exp and is only
+ * applied by field_value() when the reading leaves for LwM2M.
+ * Out-of-range integers saturate. Float registers (not used by the
+ * Microstar) keep FLOAT_DECIMALS decimals through their exponent, see
+ * the scaler cache.
+ */
+static int32_t clamp_raw(int64_t v)
 {
-	double raw_val = 0.0;
+	if (v > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (v < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)v;
+}
+
+static int32_t float_to_raw(double v, size_t idx)
+{
+	if (!scaler_float[idx]) {
+		int exp = MAX(scaler_exp[idx] - FLOAT_DECIMALS, SCALER_MIN);
+
+		float_shift[idx] = scaler_exp[idx] - exp;
+		scaler_exp[idx] = exp;
+		scaler_float[idx] = true;
+	}
+	return clamp_raw(llround(v * pow10_f64[float_shift[idx] - SCALER_MIN]));
+}
+
+static int32_t value_to_raw(const struct cosem_get_result *result,
+			    int table_idx)
+{
+	bool known = table_idx >= 0 && (size_t)table_idx < OBIS_TABLE_SIZE;
 
 	switch (result->data_type) {
 	case COSEM_TYPE_UINT8:
@@ -563,34 +721,87 @@ static double value_to_double(const struct cosem_get_result *result,
 	case COSEM_TYPE_UINT32:
 	case COSEM_TYPE_UINT64:
 	case COSEM_TYPE_ENUM:
-		raw_val = (double)result->value.u64;
-		break;
+		return result->value.u64 > INT32_MAX ? INT32_MAX
+						       : (int32_t)result->value.u64;
 
 	case COSEM_TYPE_INT8:
 	case COSEM_TYPE_INT16:
 	case COSEM_TYPE_INT32:
 	case COSEM_TYPE_INT64:
-		raw_val = (double)result->value.i64;
-		break;
+		return clamp_raw(result->value.i64);
 
 	case COSEM_TYPE_FLOAT32:
 	case COSEM_TYPE_FLOAT64:
-		raw_val = result->value.f64;
-		break;
+		if (!known) {
+			return clamp_raw(llround(result->value.f64));
+		}
+		return float_to_raw(result->value.f64, table_idx);
 
 	default:
 		LOG_WRN("Unexpected data type 0x%02X for %s",
-			result->data_type, obis_table[table_idx].name);
-		return 0.0;
+			result->data_type,
+			known ? obis_table[table_idx].name : "?");
+		return 0;
 	}
+}
+
+/* Raw field @p idx of a reading */
+static inline int32_t field_raw(const struct meter_readings *r, size_t idx)
+{
+	return *(const int32_t *)((const uint8_t *)r + obis_table[idx].offset);
+}
+
+/* ---- Raw field → engineering units (LwM2M boundary only) ---- */
+static double field_value(const struct meter_readings *r, size_t idx)
+{
+	return (double)field_raw(r, idx) * pow10_f64[scaler_exp[idx] - SCALER_MIN];
+}
+
+/*
+ * ---- Integer-only fixed-point helpers ----
+ *
+ * A field is kept as mantissa (raw) and exponent (scaler) until it has
+ * to be formatted as a double for LwM2M; range checks and record
+ * packing work on the pair directly.
+ */
+
+/* round(m × 10^shift), saturated to int32 */
+static int32_t rescale_fixed(int32_t m, int shift)
+{
+	int64_t v = m;
+
+	if (shift >= 0) {
+		if (shift > 9) {
+			/* |m| >= 1 times 10^10 never fits int32 */
+			return m == 0 ? 0 : (m > 0 ? INT32_MAX : INT32_MIN);
+		}
+		return clamp_raw(v * pow10_i64[shift]);
+	}
+
+	if (-shift > 18) {
+		return 0;
+	}
+
+	int64_t p = pow10_i64[-shift];
 
-	/* Apply scaler if cached */
-	if (table_idx >= 0 && (size_t)table_idx < OBIS_TABLE_SIZE &&
-	    scaler_cached[table_idx]) {
-		raw_val *= scaler_cache[table_idx];
+	/* Round half away from zero */
+	v = (v >= 0) ? (v + p / 2) / p : (v - p / 2) / p;
+	return clamp_raw(v);
+}
+
+/* lo <= m × 10^e <= hi, exact, for e in [SCALER_MIN, SCALER_MAX] */
+static bool fixed_in_range(int32_t m, int8_t e, int32_t lo, int32_t hi)
+{
+	if (e < 0) {
+		int64_t p = pow10_i64[-e];
+
+		return (int64_t)m >= (int64_t)lo * p &&
+		       (int64_t)m <= (int64_t)hi * p;
 	}
 
-	return raw_val;
+	int64_t v = (int64_t)m * pow10_i64[e];
+
+	return v >= lo && v <= hi;
 }
 
 /* ---- Read scaler_unit (attribute 3) for a Register object ---- */
@@ -614,7 +825,7 @@ static int read_scaler_unit(int table_idx)
 	ret = build_cosem_iframe(get_pdu, ret);
 	if (ret < 0) return ret;
 
-	ret = transact(tx_buf, ret, &resp);
+	ret = transact(DLMS_PHASE_GET, tx_buf, ret, &resp);
 	if (ret < 0) return ret;
 
 	/* Strip LLC header and update sequence */
@@ -637,21 +848,31 @@ static int read_scaler_unit(int table_idx)
 			/* Parse scaler (int8) */
 			if (d[2] == COSEM_TYPE_INT8 && dlen >= 6) {
 				int8_t scaler = (int8_t)d[3];
-				scaler_cache[table_idx] = pow(10.0, (double)scaler);
+
+				if (scaler < SCALER_MIN || scaler > SCALER_MAX) {
+					LOG_WRN("  %s: scaler %d out of range — "
+						"field unavailable", entry->name,
+						scaler);
+					obis_diag[table_idx].bad_scaler++;
+					scaler_bad[table_idx] = true;
+					scaler_exp[table_idx] = 0;
+					scaler_cached[table_idx] = true;
+					return 0;
+				}
+				scaler_exp[table_idx] = scaler;
 				scaler_cached[table_idx] = true;
 
 				/* Parse unit (enum) */
 				uint8_t unit = (d[4] == COSEM_TYPE_ENUM) ? d[5] : 0;
-				LOG_DBG("  %s: scaler=%d (x%.6f) unit=%u",
-					entry->name, scaler,
-					scaler_cache[table_idx], unit);
+				LOG_DBG("  %s: scaler=%d unit=%u",
+					entry->name, scaler, unit);
 				return 0;
 			}
 		}
 	}
 
 	/* Fallback: no scaler (multiply by 1) */
-	scaler_cache[table_idx] = 1.0;
+	scaler_exp[table_idx] = 0;
 	scaler_cached[table_idx] = true;
 	return 0;
 }
@@ -694,12 +915,15 @@ int meter_read_all(struct meter_readings *readings)
 		if (obis_skip[i] || scaler_cached[i]) {
 			continue;
 		}
+		scaler_float[i] = false;
+		TRACE(SCALER_BEGIN, i);
 		int ret = read_scaler_unit(i);
+		TRACE(SCALER_END, ret);
 		if (ret < 0) {
 			LOG_WRN("Failed to read scaler for %s: %d",
 				obis_table[i].name, ret);
 			/* Use no scaling */
-			scaler_cache[i] = 1.0;
+			scaler_exp[i] = 0;
 			scaler_cached[i] = true;
 		}
 		k_sleep(K_MSEC(20));
@@ -710,7 +934,7 @@ int meter_read_all(struct meter_readings *readings)
 	 */
 	int skip_count = 0;
 	for (size_t i = 0; i < OBIS_TABLE_SIZE; i++) {
-		if (obis_skip[i]) {
+		if (obis_skip[i] || scaler_bad[i]) {
 			skip_count++;
 		}
 	}
@@ -721,7 +945,7 @@ int meter_read_all(struct meter_readings *readings)
 	int64_t t_start = k_uptime_get();
 
 	for (size_t i = 0; i < OBIS_TABLE_SIZE; i++) {
-		if (obis_skip[i]) {
+		if (obis_skip[i] || scaler_bad[i]) {
 			obis_diag[i].skip++;
 			continue;
 		}
@@ -747,7 +971,9 @@ int meter_read_all(struct meter_readings *readings)
 			}
 
 			memset(&result, 0, sizeof(result));
+			TRACE(OBIS_BEGIN, i);
 			ret = read_obis_value(&obis_table[i], &result);
+			TRACE(OBIS_END, ret);
 
 			if (ret == 0 && result.success) {
 				ok = true;
@@ -762,20 +988,21 @@ int meter_read_all(struct meter_readings *readings)
 
 		int64_t read_ms = k_uptime_get() - t_read;
 		obis_diag[i].total_ms += read_ms;
+		lat_hist_record(&obis_lat[i], (uint32_t)read_ms);
 
 		if (ok) {
-			double val = value_to_double(&result, i);
+			int32_t raw = value_to_raw(&result, i);
 
-			/* Write value to the correct field in readings */
-			double *target = (double *)((uint8_t *)readings +
-						    obis_table[i].offset);
-			*target = val;
+			/* Write raw value to the correct field in readings */
+			int32_t *target = (int32_t *)((uint8_t *)readings +
+						      obis_table[i].offset);
+			*target = raw;
 			readings->read_count++;
 			readings->field_mask |= (1u << i);
 			obis_diag[i].success++;
 
-			LOG_DBG("  %s = %.3f (%lldms)", obis_table[i].name,
-				val, read_ms);
+			LOG_DBG("  %s = %d raw (%lldms)", obis_table[i].name,
+				raw, read_ms);
 		} else {
 			LOG_WRN("  %s: read failed (%d) after %d attempts (%lldms)",
 				obis_table[i].name, ret,
@@ -812,10 +1039,10 @@ int meter_read_all(struct meter_readings *readings)
 	if (readings->valid && last_good_valid) {
 		for (size_t j = 0; j < OBIS_TABLE_SIZE; j++) {
 			if (readings->field_mask & (1u << j)) {
-				double *src = (double *)((uint8_t *)readings +
-							 obis_table[j].offset);
-				double *dst = (double *)((uint8_t *)&last_good +
-							 obis_table[j].offset);
+				int32_t *src = (int32_t *)((uint8_t *)readings +
+							   obis_table[j].offset);
+				int32_t *dst = (int32_t *)((uint8_t *)&last_good +
+							   obis_table[j].offset);
 				*dst = *src;
 			}
 		}
@@ -836,11 +1063,12 @@ int meter_read_all(struct meter_readings *readings)
 			int pct = total > 0 ? (int)(obis_diag[i].success * 100 / total) : 0;
 			int64_t avg_ms = total > 0 ? obis_diag[i].total_ms / (int64_t)total : 0;
 			LOG_INF("  [%2zu] %-20s ok=%u fail=%u retry=%u skip=%u "
-				"rate=%d%% avg=%lldms",
+				"badscaler=%u rate=%d%% avg=%lldms p95=%ums",
 				i, obis_table[i].name,
 				obis_diag[i].success, obis_diag[i].fail,
 				obis_diag[i].retries, obis_diag[i].skip,
-				pct, avg_ms);
+				obis_diag[i].bad_scaler, pct, avg_ms,
+				lat_hist_percentile_ms(&obis_lat[i], 95));
 		}
 	}
 
@@ -862,33 +1090,53 @@ int meter_poll(struct meter_readings *readings)
 
 	int64_t poll_start = k_uptime_get();
 	poll_count++;
+	memset(&last_poll, 0, sizeof(last_poll));
+	TRACE(POLL_BEGIN, poll_count);
 	LOG_INF("=== Meter poll cycle #%u ===", poll_count);
 
 	/* Connect */
+	TRACE(CONNECT_BEGIN, 0);
 	ret = meter_connect();
+	TRACE(CONNECT_END, ret);
 	if (ret < 0) {
 		LOG_ERR("Meter connect failed: %d", ret);
+		TRACE(DISCONNECT_BEGIN, 0);
 		meter_disconnect();
+		TRACE(DISCONNECT_END, 0);
+		last_poll.result = ret;
+		last_poll.duration_ms = (uint32_t)(k_uptime_get() - poll_start);
+		TRACE(POLL_END, ret);
 		return ret;
 	}
 
 	/* Read all values */
+	TRACE(READ_ALL_BEGIN, 0);
 	ret = meter_read_all(readings);
+	TRACE(READ_ALL_END, ret);
 	if (ret < 0) {
 		LOG_ERR("Meter read failed: %d", ret);
 	}
 
 	/* Disconnect (always, even on error) */
+	TRACE(DISCONNECT_BEGIN, 0);
 	meter_disconnect();
+	TRACE(DISCONNECT_END, 0);
 
 	int64_t poll_ms = k_uptime_get() - poll_start;
 	last_poll_duration_ms = poll_ms;
 	poll_duration_sum_ms += poll_ms;
 
+	last_poll.result = ret;
+	last_poll.duration_ms = (uint32_t)poll_ms;
+	last_poll.read_count = (uint16_t)readings->read_count;
+	last_poll.read_target = (uint16_t)readings->read_target;
+	last_poll.associated = true;
+
 	int64_t avg_poll_ms = poll_count > 0 ? poll_duration_sum_ms / (int64_t)poll_count : 0;
 	LOG_INF("=== Meter poll complete: %lld ms (avg=%lld ms, T_read=%lld ms) ===",
 		poll_ms, avg_poll_ms, last_read_cycle_ms);
 
+	TRACE(POLL_END, ret);
 	return ret;
 }
 
@@ -913,19 +1161,54 @@ int meter_poll(struct meter_readings *readings)
  */
 
 /*
- * Helper macro: push a field to LwM2M if it was read this cycle.
+ * Each field read this cycle is converted to engineering units (the only
+ * FP step) and set on its Object 10242 resource (obis_table[i].rid).
  * The LwM2M observe engine (pmin/pmax) controls the actual CoAP rate.
+ *
+ * With CONFIG_AMI_LWM2M_COMPOSITE_SEND the values are stored without
+ * going through lwm2m_set_f64(), which would notify every observer of
+ * a changed resource: the RID is recorded and the whole /10242/0
+ * instance goes out in one SenML-CBOR Send after all fields are
+ * stored. The recorded RIDs are only notified individually if the
+ * Send cannot be queued.
  */
-#define PUSH_FIELD(field, rid, bit_idx) do {                                  \
-	if (!(readings->field_mask & (1u << (bit_idx)))) {                    \
-		skipped++;                                                    \
-		break;                                                        \
-	}                                                                     \
-	lwm2m_set_f64(&LWM2M_OBJ(POWER_METER_OBJECT_ID, 0, rid),            \
-		      readings->field);                                       \
-	lwm2m_notify_observer(POWER_METER_OBJECT_ID, 0, rid);                \
-	pushed++;                                                             \
-} while (0)
+static void push_notify(uint16_t rid)
+{
+	TRACE(LWM2M_NOTIFY, rid);
+	lwm2m_notify_observer(POWER_METER_OBJECT_ID, 0, rid);
+}
+
+#if IS_ENABLED(CONFIG_AMI_LWM2M_COMPOSITE_SEND)
+/* Write the resource buffer directly: no observer notify, no cache entry */
+static void push_store(uint16_t rid, double value)
+{
+	const struct lwm2m_obj_path path =
+		LWM2M_OBJ(POWER_METER_OBJECT_ID, 0, rid);
+	void *buf;
+	uint16_t buf_len;
+	int ret;
+
+	lwm2m_registry_lock();
+	ret = lwm2m_get_res_buf(&path, &buf, &buf_len, NULL, NULL);
+	if (ret == 0 && buf && buf_len >= sizeof(value)) {
+		memcpy(buf, &value, sizeof(value));
+	} else {
+		ret = -ENOMEM;
+	}
+	lwm2m_registry_unlock();
+
+	if (ret < 0) {
+		lwm2m_set_f64(&path, value);   /* Notifies, but never loses data */
+	}
+}
+
+#define PUSH_STORE(rid, v)  push_store((rid), (v))
+#define PUSH_NOTIFY(rid)    (pushed_rids[pushed] = (rid))
+#else
+#define PUSH_STORE(rid, v)  \
+	lwm2m_set_f64(&LWM2M_OBJ(POWER_METER_OBJECT_ID, 0, (rid)), (v))
+#define PUSH_NOTIFY(rid)    push_notify(rid)
+#endif
 
 /*
  * Sanity check: reject readings that are obviously invalid.
@@ -936,27 +1219,31 @@ int meter_poll(struct meter_readings *readings)
  *   - Frequency in [40, 70] Hz (covers 50Hz and 60Hz grids)
  *   - Minimum field coverage (enough fields actually read)
  */
-#define VOLTAGE_MIN   50.0
-#define VOLTAGE_MAX  500.0
-#define FREQ_MIN      40.0
-#define FREQ_MAX      70.0
+#define VOLTAGE_MIN   50
+#define VOLTAGE_MAX  500
+#define FREQ_MIN      40
+#define FREQ_MAX      70
 
 static bool readings_sanity_check(const struct meter_readings *r)
 {
 	/* Check 1: voltage must have been read and be in plausible range */
 	if (r->field_mask & (1u << 0)) {  /* bit 0 = voltage_r */
-		if (r->voltage_r < VOLTAGE_MIN || r->voltage_r > VOLTAGE_MAX) {
-			LOG_WRN("Sanity FAIL: voltage_r=%.1f out of range [%.0f,%.0f]",
-				r->voltage_r, VOLTAGE_MIN, VOLTAGE_MAX);
+		if (!fixed_in_range(r->voltage_r, scaler_exp[0],
+				    VOLTAGE_MIN, VOLTAGE_MAX)) {
+			LOG_WRN("Sanity FAIL: voltage_r=%de%d out of range [%d,%d]",
+				r->voltage_r, scaler_exp[0],
+				VOLTAGE_MIN, VOLTAGE_MAX);
 			return false;
 		}
 	}
 
 	/* Check 2: frequency must be in plausible range (if read) */
 	if (r->field_mask & (1u << 25)) {  /* bit 25 = frequency */
-		if (r->frequency < FREQ_MIN || r->frequency > FREQ_MAX) {
-			LOG_WRN("Sanity FAIL: frequency=%.1f out of range [%.0f,%.0f]",
-				r->frequency, FREQ_MIN, FREQ_MAX);
+		if (!fixed_in_range(r->frequency, scaler_exp[25],
+				    FREQ_MIN, FREQ_MAX)) {
+			LOG_WRN("Sanity FAIL: frequency=%de%d out of range [%d,%d]",
+				r->frequency, scaler_exp[25],
+				FREQ_MIN, FREQ_MAX);
 			return false;
 		}
 	}
@@ -985,55 +1272,54 @@ void meter_push_to_lwm2m(const struct meter_readings *readings)
 		return;
 	}
 
+	TRACE(PUSH_BEGIN, 0);
+
 	/* Safety net: don't push obviously-bad readings */
 	if (!readings_sanity_check(readings)) {
 		LOG_WRN("Readings failed sanity check — skipping LwM2M push");
+		TRACE(PUSH_END, 0);
 		return;
 	}
 
 	int pushed = 0;
 	int skipped = 0;   /* Fields not read from meter this cycle */
+#if IS_ENABLED(CONFIG_AMI_LWM2M_COMPOSITE_SEND)
+	uint16_t pushed_rids[OBIS_TABLE_SIZE];
+#endif
 
-	/* ---- Phase R (obis indices 0-5) ---- */
-	PUSH_FIELD(voltage_r,        PM_TENSION_R_RID,         0);
-	PUSH_FIELD(current_r,        PM_CURRENT_R_RID,         1);
-	PUSH_FIELD(active_power_r,   PM_ACTIVE_POWER_R_RID,    2);
-	PUSH_FIELD(reactive_power_r, PM_REACTIVE_POWER_R_RID,  3);
-	PUSH_FIELD(apparent_power_r, PM_APPARENT_POWER_R_RID,  4);
-	PUSH_FIELD(power_factor_r,   PM_POWER_FACTOR_R_RID,    5);
-
-#ifndef CONFIG_AMI_SINGLE_PHASE
-	/* ---- Phase S (obis indices 6-11) ---- */
-	PUSH_FIELD(voltage_s,        PM_TENSION_S_RID,         6);
-	PUSH_FIELD(current_s,        PM_CURRENT_S_RID,         7);
-	PUSH_FIELD(active_power_s,   PM_ACTIVE_POWER_S_RID,    8);
-	PUSH_FIELD(reactive_power_s, PM_REACTIVE_POWER_S_RID,  9);
-	PUSH_FIELD(apparent_power_s, PM_APPARENT_POWER_S_RID, 10);
-	PUSH_FIELD(power_factor_s,   PM_POWER_FACTOR_S_RID,   11);
-
-	/* ---- Phase T (obis indices 12-17) ---- */
-	PUSH_FIELD(voltage_t,        PM_TENSION_T_RID,        12);
-	PUSH_FIELD(current_t,        PM_CURRENT_T_RID,        13);
-	PUSH_FIELD(active_power_t,   PM_ACTIVE_POWER_T_RID,   14);
-	PUSH_FIELD(reactive_power_t, PM_REACTIVE_POWER_T_RID, 15);
-	PUSH_FIELD(apparent_power_t, PM_APPARENT_POWER_T_RID, 16);
-	PUSH_FIELD(power_factor_t,   PM_POWER_FACTOR_T_RID,   17);
-#endif /* !CONFIG_AMI_SINGLE_PHASE */
-
-	/* ---- Totals (obis indices 18-21) ---- */
-	PUSH_FIELD(total_active_power,   PM_3P_ACTIVE_POWER_RID,   18);
-	PUSH_FIELD(total_reactive_power, PM_3P_REACTIVE_POWER_RID, 19);
-	PUSH_FIELD(total_apparent_power, PM_3P_APPARENT_POWER_RID, 20);
-	PUSH_FIELD(total_power_factor,   PM_3P_POWER_FACTOR_RID,   21);
-
-	/* ---- Energy (obis indices 22-24) ---- */
-	PUSH_FIELD(active_energy,   PM_ACTIVE_ENERGY_RID,   22);
-	PUSH_FIELD(reactive_energy, PM_REACTIVE_ENERGY_RID, 23);
-	PUSH_FIELD(apparent_energy, PM_APPARENT_ENERGY_RID, 24);
-
-	/* ---- Other (obis indices 25-26) ---- */
-	PUSH_FIELD(frequency,       PM_FREQUENCY_RID,       25);
-	PUSH_FIELD(neutral_current, PM_NEUTRAL_CURRENT_RID, 26);
+	for (size_t i = 0; i < OBIS_TABLE_SIZE; i++) {
+#ifdef CONFIG_AMI_SINGLE_PHASE
+		/* Phase S/T (obis indices 6-17) are not part of the instance */
+		if (i >= 6 && i <= 17) {
+			continue;
+		}
+#endif
+		if (!(readings->field_mask & (1u << i))) {
+			skipped++;
+			continue;
+		}
+		PUSH_STORE(obis_table[i].rid, field_value(readings, i));
+		PUSH_NOTIFY(obis_table[i].rid);
+		pushed++;
+	}
+
+#if IS_ENABLED(CONFIG_AMI_LWM2M_COMPOSITE_SEND)
+	/* One CoAP message for the whole instance instead of one per RID */
+	if (pushed > 0) {
+		int ret = uplink_send_inst(POWER_METER_OBJECT_ID, 0);
+		TRACE(LWM2M_SEND, ret);
+		if (ret == 0) {
+			LOG_DBG("Composite Send queued (%d resources)", pushed);
+		} else {
+			LOG_DBG("Composite Send unavailable (%d) — per-resource notify",
+				ret);
+			for (int k = 0; k < pushed; k++) {
+				push_notify(pushed_rids[k]);
+			}
+		}
+	}
+#endif
+	TRACE(PUSH_END, pushed);
 
 #ifdef CONFIG_AMI_SINGLE_PHASE
 	#define TOTAL_RESOURCES 15   /* Phase R(6) + Totals(4) + Energy(3) + Freq + Neutral */
@@ -1044,13 +1330,78 @@ void meter_push_to_lwm2m(const struct meter_readings *readings)
 	LOG_INF("LwM2M push: %d/%d pushed, %d skipped (not read) "
 		"(V=%.1f I=%.2f P=%.2fkW E=%.1fkWh f=%.1fHz)",
 		pushed, TOTAL_RESOURCES, skipped,
-		readings->voltage_r, readings->current_r,
-		readings->total_active_power, readings->active_energy,
-		readings->frequency);
+		field_value(readings, 0), field_value(readings, 1),
+		field_value(readings, 18), field_value(readings, 22),
+		field_value(readings, 25));
 
 	#undef TOTAL_RESOURCES
 }
 
+/* ---- Store-and-forward record packing ---- */
+
+bool meter_readings_usable(const struct meter_readings *readings)
+{
+	return readings && readings->valid && readings_sanity_check(readings);
+}
+
+void meter_record_pack(const struct meter_readings *readings,
+		       uint32_t timestamp, struct meter_record *rec)
+{
+	memset(rec, 0, sizeof(*rec));
+	rec->timestamp = timestamp;
+	rec->field_mask = readings->field_mask;
+
+	for (size_t i = 0; i < OBIS_TABLE_SIZE; i++) {
+		if (!(readings->field_mask & (1u << i))) {
+			continue;
+		}
+
+		/* raw × 10^scaler → units of 10^-rec_dec, integer only */
+		rec->value[i] = rescale_fixed(field_raw(readings, i),
+					      scaler_exp[i] + obis_table[i].rec_dec);
+	}
+}
+
+double meter_reading_value(const struct meter_readings *readings, int index)
+{
+	if (index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return 0.0;
+	}
+	return field_value(readings, index);
+}
+
+int meter_reading_fixed(const struct meter_readings *readings, int index,
+			int32_t *mantissa, int8_t *exponent)
+{
+	if (!readings || index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return -EINVAL;
+	}
+	if (mantissa) {
+		*mantissa = field_raw(readings, index);
+	}
+	if (exponent) {
+		*exponent = scaler_exp[index];
+	}
+	return 0;
+}
+
+double meter_record_value(const struct meter_record *rec, int index)
+{
+	if (index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return 0.0;
+	}
+	return (double)rec->value[index] *
+	       pow10_f64[-obis_table[index].rec_dec - SCALER_MIN];
+}
+
+uint16_t meter_field_rid(int index)
+{
+	if (index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return 0xFFFF;
+	}
+	return obis_table[index].rid;
+}
+
 enum meter_state meter_get_state(void)
 {
 	return state;
@@ -1071,6 +1422,11 @@ uint32_t meter_get_poll_count(void)
 	return poll_count;
 }
 
+void meter_get_last_poll(struct meter_poll_stats *out)
+{
+	*out = last_poll;
+}
+
 void meter_get_obis_diag(int index, uint32_t *success, uint32_t *fail,
 			 uint32_t *retries, uint32_t *skip)
 {
@@ -1086,3 +1442,45 @@ void meter_get_obis_diag(int index, uint32_t *success, uint32_t *fail,
 	if (retries) *retries = obis_diag[index].retries;
 	if (skip)    *skip    = obis_diag[index].skip;
 }
+
+const char *meter_field_name(int index)
+{
+	if (index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return NULL;
+	}
+	return obis_table[index].name;
+}
+
+const char *meter_phase_name(enum dlms_phase phase)
+{
+	return (unsigned)phase < DLMS_PHASE_COUNT ? phase_names[phase] : NULL;
+}
+
+int meter_get_obis_latency(int index, struct lat_hist *out)
+{
+	if (index < 0 || (size_t)index >= OBIS_TABLE_SIZE) {
+		return -EINVAL;
+	}
+	*out = obis_lat[index];
+	return 0;
+}
+
+int meter_get_phase_latency(enum dlms_phase phase, struct lat_hist *out,
+			    uint32_t *errors)
+{
+	if ((unsigned)phase >= DLMS_PHASE_COUNT) {
+		return -EINVAL;
+	}
+	*out = phase_lat[phase];
+	if (errors) {
+		*errors = phase_errors[phase];
+	}
+	return 0;
+}
+
+void meter_reset_latency(void)
+{
+	memset(obis_lat, 0, sizeof(obis_lat));
+	memset(phase_lat, 0, sizeof(phase_lat));
+	memset(phase_errors, 0, sizeof(phase_errors));
+}
@@ -18,6 +18,18 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "lat_hist.h"
+
+/* Protocol phases timed per transaction (meter_get_phase_latency) */
+enum dlms_phase {
+	DLMS_PHASE_SNRM = 0,      /* SNRM → UA */
+	DLMS_PHASE_AARQ,          /* AARQ → AARE */
+	DLMS_PHASE_GET,           /* GET.request → GET.response (value, scaler) */
+	DLMS_PHASE_RLRQ,          /* RLRQ → RLRE */
+	DLMS_PHASE_DISC,          /* DISC → UA */
+	DLMS_PHASE_COUNT,
+};
+
 /* Meter connection state */
 enum meter_state {
 	METER_DISCONNECTED = 0,
@@ -26,52 +38,60 @@ enum meter_state {
 	METER_ERROR,
 };
 
-/* Meter readings — all values in engineering units */
+/*
+ * Meter readings — raw register values.
+ *
+ * Each field holds the integer the meter returned for its OBIS code;
+ * the engineering value is raw × 10^scaler, where the scaler comes from
+ * the register's scaler_unit attribute and is kept once per OBIS code in
+ * the dlms_meter scaler cache (not per reading). Use
+ * meter_reading_value() to convert — only at the LwM2M boundary.
+ */
 struct meter_readings {
 	/* Per-phase voltages (V) */
-	double voltage_r;
-	double voltage_s;
-	double voltage_t;
+	int32_t voltage_r;
+	int32_t voltage_s;
+	int32_t voltage_t;
 
 	/* Per-phase currents (A) */
-	double current_r;
-	double current_s;
-	double current_t;
+	int32_t current_r;
+	int32_t current_s;
+	int32_t current_t;
 
 	/* Per-phase active power (kW) */
-	double active_power_r;
-	double active_power_s;
-	double active_power_t;
+	int32_t active_power_r;
+	int32_t active_power_s;
+	int32_t active_power_t;
 
 	/* Per-phase reactive power (kvar) */
-	double reactive_power_r;
-	double reactive_power_s;
-	double reactive_power_t;
+	int32_t reactive_power_r;
+	int32_t reactive_power_s;
+	int32_t reactive_power_t;
 
 	/* Per-phase apparent power (kVA) */
-	double apparent_power_r;
-	double apparent_power_s;
-	double apparent_power_t;
+	int32_t apparent_power_r;
+	int32_t apparent_power_s;
+	int32_t apparent_power_t;
 
 	/* Per-phase power factor */
-	double power_factor_r;
-	double power_factor_s;
-	double power_factor_t;
+	int32_t power_factor_r;
+	int32_t power_factor_s;
+	int32_t power_factor_t;
 
 	/* Totals */
-	double total_active_power;     /* kW */
-	double total_reactive_power;   /* kvar */
-	double total_apparent_power;   /* kVA */
-	double total_power_factor;
+	int32_t total_active_power;     /* kW */
+	int32_t total_reactive_power;   /* kvar */
+	int32_t total_apparent_power;   /* kVA */
+	int32_t total_power_factor;
 
 	/* Energy */
-	double active_energy;          /* kWh */
-	double reactive_energy;        /* kvarh */
-	double apparent_energy;        /* kVAh */
+	int32_t active_energy;          /* kWh */
+	int32_t reactive_energy;        /* kvarh */
+	int32_t apparent_energy;        /* kVAh */
 
 	/* Other */
-	double frequency;              /* Hz */
-	double neutral_current;        /* A */
+	int32_t frequency;              /* Hz */
+	int32_t neutral_current;        /* A */
 
 	/* Metadata */
 	bool     valid;                /* True if enough readings succeeded */
@@ -82,6 +102,34 @@ struct meter_readings {
 	int64_t  timestamp_ms;         /* Uptime when readings were taken */
 };
 
+/* Number of OBIS-backed fields in struct meter_readings (= obis_table) */
+#define METER_FIELD_COUNT  27
+
+/*
+ * Compact reading for store-and-forward.
+ *
+ * Field i (same bit order as meter_readings.field_mask) is kept as a
+ * scaled integer with a per-field fixed precision (see obis_table)
+ * rather than the meter's own raw/scaler pair, so records spilled to
+ * flash stay decodable after a reboot, before scalers are re-read.
+ */
+struct meter_record {
+	uint32_t timestamp;                  /* Seconds when read (see store) */
+	uint32_t field_mask;                 /* Fields present in value[] */
+	int32_t  value[METER_FIELD_COUNT];   /* Scaled by 10^rec_dec */
+};
+
+/* Outcome of the last meter_poll() (meter_get_last_poll()) */
+struct meter_poll_stats {
+	int      result;               /* meter_poll() return value */
+	uint32_t duration_ms;          /* T_cycle, failed polls included */
+	uint16_t read_count;           /* OBIS values read */
+	uint16_t read_target;          /* OBIS values attempted */
+	uint32_t tx_bytes;             /* RS485 bytes sent */
+	uint32_t rx_bytes;             /* RS485 bytes received */
+	bool     associated;           /* meter_connect() succeeded */
+};
+
 /* Meter configuration */
 struct meter_config {
 	uint8_t  client_sap;           /* Client logical address (default: 16) */
@@ -152,6 +200,75 @@ int meter_poll(struct meter_readings *readings);
  */
 void meter_push_to_lwm2m(const struct meter_readings *readings);
 
+/**
+ * @brief Check whether readings are fit to be pushed or stored
+ *
+ * Same gate meter_push_to_lwm2m() applies: valid flag plus voltage,
+ * frequency and field-coverage sanity checks.
+ *
+ * @param readings  Meter readings to check
+ * @return true if the readings may be reported
+ */
+bool meter_readings_usable(const struct meter_readings *readings);
+
+/**
+ * @brief Get field @p index of a reading in engineering units
+ *
+ * Applies the cached scaler (10^scaler, table lookup) for that OBIS
+ * code to the raw register value. This is the only place readings
+ * become floating point.
+ *
+ * @param readings  Meter readings
+ * @param index     Field index (0 to METER_FIELD_COUNT-1)
+ * @return Value in engineering units (0.0 if index is out of range)
+ */
+double meter_reading_value(const struct meter_readings *readings, int index);
+
+/**
+ * @brief Get field @p index as an integer mantissa/exponent pair
+ *
+ * value = mantissa × 10^exponent, with no floating point involved.
+ * Callers can format or compare the pair without converting to double.
+ *
+ * @param readings  Meter readings
+ * @param index     Field index (0 to METER_FIELD_COUNT-1)
+ * @param mantissa  Output: raw register value (NULL to skip)
+ * @param exponent  Output: cached DLMS scaler (NULL to skip)
+ * @return 0 on success, -EINVAL if index is out of range
+ */
+int meter_reading_fixed(const struct meter_readings *readings, int index,
+			int32_t *mantissa, int8_t *exponent);
+
+/**
+ * @brief Pack readings into a compact store-and-forward record
+ *
+ * Only fields set in readings->field_mask are encoded; the others
+ * are left at zero.
+ *
+ * @param readings   Source readings
+ * @param timestamp  Time (s) to stamp the record with
+ * @param rec        Output record
+ */
+void meter_record_pack(const struct meter_readings *readings,
+		       uint32_t timestamp, struct meter_record *rec);
+
+/**
+ * @brief Get field @p index of a record in engineering units
+ *
+ * @param rec    Packed record
+ * @param index  Field index (0 to METER_FIELD_COUNT-1)
+ * @return Value in engineering units (0.0 if index is out of range)
+ */
+double meter_record_value(const struct meter_record *rec, int index);
+
+/**
+ * @brief Get the Object 10242 resource ID backing field @p index
+ *
+ * @param index  Field index (0 to METER_FIELD_COUNT-1)
+ * @return Resource ID, or 0xFFFF if index is out of range
+ */
+uint16_t meter_field_rid(int index);
+
 /**
  * @brief Get current meter state
  *
@@ -183,6 +300,16 @@ int64_t meter_get_avg_poll_duration_ms(void);
  */
 uint32_t meter_get_poll_count(void);
 
+/**
+ * @brief Get the outcome of the last meter_poll()
+ *
+ * Unlike meter_get_poll_duration_ms(), also covers polls whose
+ * connect failed.
+ *
+ * @param out  Output; zeroed if no poll has run
+ */
+void meter_get_last_poll(struct meter_poll_stats *out);
+
 /**
  * @brief Get per-OBIS diagnostic counters
  *
@@ -195,4 +322,45 @@ uint32_t meter_get_poll_count(void);
 void meter_get_obis_diag(int index, uint32_t *success, uint32_t *fail,
 			 uint32_t *retries, uint32_t *skip);
 
+/**
+ * @brief Get the name of OBIS table entry @p index (e.g. "Voltage_R")
+ *
+ * @return Name, or NULL if index is out of range
+ */
+const char *meter_field_name(int index);
+
+/**
+ * @brief Get the name of a protocol phase (e.g. "SNRM")
+ *
+ * @return Name, or NULL if phase is out of range
+ */
+const char *meter_phase_name(enum dlms_phase phase);
+
+/**
+ * @brief Copy the read latency histogram of OBIS entry @p index
+ *
+ * One sample per poll that read the entry: the whole read including
+ * retries, successful or not. Skipped entries get no samples.
+ *
+ * @return 0 on success, -EINVAL if index is out of range
+ */
+int meter_get_obis_latency(int index, struct lat_hist *out);
+
+/**
+ * @brief Copy the transaction latency histogram of a protocol phase
+ *
+ * One sample per transaction (send, wait, receive, parse), failed
+ * ones included.
+ *
+ * @param errors  Output: failed transactions (NULL to skip)
+ * @return 0 on success, -EINVAL if phase is out of range
+ */
+int meter_get_phase_latency(enum dlms_phase phase, struct lat_hist *out,
+			    uint32_t *errors);
+
+/**
+ * @brief Drop all OBIS and phase latency samples
+ */
+void meter_reset_latency(void);
+
 #endif /* DLMS_METER_H_ */
@@ -0,0 +1,110 @@
+/*
+ * Latency Histogram — see lat_hist.h
+ */
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lat_hist.h"
+
+/* log2(LAT_HIST_MIN_MS) */
+#define MIN_SHIFT  4
+
+BUILD_ASSERT((1U << MIN_SHIFT) == LAT_HIST_MIN_MS,
+	     "LAT_HIST_MIN_MS must be 2^MIN_SHIFT");
+
+int lat_hist_bucket(uint32_t ms)
+{
+	int msb, b;
+
+	if (ms < LAT_HIST_MIN_MS) {
+		return 0;
+	}
+
+	msb = 31 - __builtin_clz(ms);
+	/* The bit below the MSB picks the lower or upper half-octave */
+	b = 1 + 2 * (msb - MIN_SHIFT) + ((ms >> (msb - 1)) & 1);
+	return b < LAT_HIST_BUCKETS ? b : LAT_HIST_BUCKETS - 1;
+}
+
+uint32_t lat_hist_bucket_upper_ms(int b)
+{
+	uint32_t octave;
+
+	if (b < 0 || b >= LAT_HIST_BUCKETS - 1) {
+		return UINT32_MAX;
+	}
+	if (b == 0) {
+		return LAT_HIST_MIN_MS;
+	}
+
+	octave = 1U << (MIN_SHIFT + (b - 1) / 2);
+	return (b & 1) ? octave + octave / 2 : 2 * octave;
+}
+
+void lat_hist_record(struct lat_hist *h, uint32_t ms)
+{
+	h->bucket[lat_hist_bucket(ms)]++;
+	h->count++;
+	h->sum_ms += ms;
+	if (ms > h->max_ms) {
+		h->max_ms = ms;
+	}
+}
+
+uint32_t lat_hist_mean_ms(const struct lat_hist *h)
+{
+	return h->count ? (uint32_t)(h->sum_ms / h->count) : 0;
+}
+
+uint32_t lat_hist_percentile_ms(const struct lat_hist *h, int pct)
+{
+	uint64_t rank, seen = 0;
+
+	if (!h->count) {
+		return 0;
+	}
+
+	rank = ((uint64_t)h->count * (uint32_t)pct + 99) / 100;
+	if (rank == 0) {
+		rank = 1;
+	}
+
+	for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+		seen += h->bucket[b];
+		if (seen >= rank) {
+			uint32_t upper = lat_hist_bucket_upper_ms(b);
+
+			return upper < h->max_ms ? upper : h->max_ms;
+		}
+	}
+	return h->max_ms;
+}
+
+int lat_hist_format(const struct lat_hist *h, char *buf, size_t len)
+{
+	size_t pos = 0;
+
+	if (!len) {
+		return -ENOMEM;
+	}
+	buf[0] = '\0';
+
+	for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+		int n = snprintf(&buf[pos], len - pos, b ? ",%u" : "%u",
+				 (unsigned)h->bucket[b]);
+
+		if (n < 0 || (size_t)n >= len - pos) {
+			return -ENOMEM;
+		}
+		pos += n;
+	}
+	return (int)pos;
+}
+
+void lat_hist_reset(struct lat_hist *h)
+{
+	memset(h, 0, sizeof(*h));
+}
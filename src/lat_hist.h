@@ -0,0 +1,77 @@
+/*
+ * Latency Histogram — fixed log-scale buckets for millisecond timings
+ *
+ * Two buckets per octave from 16 ms, so the 100 ms-1 s range where
+ * DLMS transactions live is resolved to within 50%:
+ *
+ *   bucket   0: [0, 16)         bucket 1: [16, 24)    bucket 2: [24, 32)
+ *   bucket 2k+1: [2^(k+4), 1.5 * 2^(k+4))
+ *   bucket 2k+2: [1.5 * 2^(k+4), 2^(k+5))
+ *   bucket  15: [2048, inf)     (response timeouts end up here)
+ *
+ * Bucketing is a bit scan, no table or division. Percentiles are
+ * estimated as the upper bound of the bucket holding that rank, capped
+ * at the largest sample seen.
+ *
+ * Pure C with no locking, so it is unit-tested natively.
+ */
+
+#ifndef LAT_HIST_H_
+#define LAT_HIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LAT_HIST_BUCKETS   16
+#define LAT_HIST_MIN_MS    16     /* Upper bound of bucket 0 */
+
+struct lat_hist {
+	uint32_t bucket[LAT_HIST_BUCKETS];
+	uint32_t count;
+	uint32_t max_ms;
+	uint64_t sum_ms;
+};
+
+/**
+ * @brief Bucket index for a sample of @p ms
+ */
+int lat_hist_bucket(uint32_t ms);
+
+/**
+ * @brief Exclusive upper bound of bucket @p b in ms
+ *
+ * @return Bound, or UINT32_MAX for the last bucket (and out of range)
+ */
+uint32_t lat_hist_bucket_upper_ms(int b);
+
+/**
+ * @brief Add one sample
+ */
+void lat_hist_record(struct lat_hist *h, uint32_t ms);
+
+/**
+ * @brief Mean of all samples in ms (0 when empty)
+ */
+uint32_t lat_hist_mean_ms(const struct lat_hist *h);
+
+/**
+ * @brief Estimated @p pct-th percentile in ms (0 when empty)
+ *
+ * @param pct  1 to 100
+ */
+uint32_t lat_hist_percentile_ms(const struct lat_hist *h, int pct);
+
+/**
+ * @brief Write the bucket counts as "n0,n1,...,n15"
+ *
+ * @return Length written (excluding the NUL), or -ENOMEM if @p len is
+ *         too small
+ */
+int lat_hist_format(const struct lat_hist *h, char *buf, size_t len);
+
+/**
+ * @brief Drop all samples
+ */
+void lat_hist_reset(struct lat_hist *h);
+
+#endif /* LAT_HIST_H_ */
@@ -0,0 +1,88 @@
+/*
+ * Link Statistics — see link_stats.h
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "link_stats.h"
+
+BUILD_ASSERT(LINK_STATS_WINDOW >= 2 && LINK_STATS_WINDOW <= 255,
+	     "LINK_STATS_WINDOW must fit the uint8_t ring indices");
+
+/* OT error rates are 0..0xFFFF for 0..100% */
+#define OT_RATE_TO_PCT(x)  ((double)(x) * 100.0 / 0xFFFF)
+
+void link_ring_reset(struct link_ring *ring)
+{
+	ring->head = 0;
+	ring->count = 0;
+}
+
+void link_ring_push(struct link_ring *ring, int8_t rssi,
+		    uint16_t frame_err, uint16_t msg_err)
+{
+	ring->rssi[ring->head] = rssi;
+	ring->frame_err[ring->head] = frame_err;
+	ring->msg_err[ring->head] = msg_err;
+
+	ring->head = (ring->head + 1) % LINK_STATS_WINDOW;
+	if (ring->count < LINK_STATS_WINDOW) {
+		ring->count++;
+	}
+}
+
+int link_ring_summarize(const struct link_ring *ring, struct link_summary *out)
+{
+	/* Counting sort over the int8_t RSSI range for the percentile */
+	uint8_t hist[256];
+	int32_t rssi_sum = 0;
+	uint32_t frame_sum = 0, msg_sum = 0;
+	uint16_t frame_max = 0;
+	int8_t rssi_min = INT8_MAX, rssi_max = INT8_MIN;
+
+	if (!ring || !out) {
+		return -EINVAL;
+	}
+	if (ring->count == 0) {
+		return -ENODATA;
+	}
+
+	memset(hist, 0, sizeof(hist));
+
+	/* Order does not matter: the first count entries are the window */
+	for (int i = 0; i < ring->count; i++) {
+		int8_t rssi = ring->rssi[i];
+
+		hist[(uint8_t)(rssi - INT8_MIN)]++;
+		rssi_sum += rssi;
+		rssi_min = MIN(rssi_min, rssi);
+		rssi_max = MAX(rssi_max, rssi);
+		frame_sum += ring->frame_err[i];
+		msg_sum += ring->msg_err[i];
+		frame_max = MAX(frame_max, ring->frame_err[i]);
+	}
+
+	/* Nearest rank: ceil(0.95 * n) */
+	int rank = (ring->count * 95 + 99) / 100;
+	int seen = 0;
+
+	out->rssi_p95 = rssi_max;
+	for (int b = 0; b < 256; b++) {
+		seen += hist[b];
+		if (seen >= rank) {
+			out->rssi_p95 = (int8_t)(b + INT8_MIN);
+			break;
+		}
+	}
+
+	out->rssi_min = rssi_min;
+	out->rssi_max = rssi_max;
+	out->rssi_mean = (double)rssi_sum / ring->count;
+	out->frame_err_mean = OT_RATE_TO_PCT(frame_sum) / ring->count;
+	out->frame_err_max = OT_RATE_TO_PCT(frame_max);
+	out->msg_err_mean = OT_RATE_TO_PCT(msg_sum) / ring->count;
+	out->samples = ring->count;
+
+	return 0;
+}
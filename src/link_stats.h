@@ -0,0 +1,65 @@
+/*
+ * Link Statistics — fixed-memory per-neighbor link-quality window
+ *
+ * The neighbor sampler pushes one sample per neighbor per tick (RSSI
+ * and OpenThread frame/message error rates) into a ring of
+ * LINK_STATS_WINDOW entries. link_ring_summarize() reduces the window
+ * to the aggregates published in Object 33005, one instance per
+ * Object 10485 neighbor.
+ *
+ * Pure C, no OpenThread dependency, so it is unit-tested natively.
+ */
+
+#ifndef LINK_STATS_H_
+#define LINK_STATS_H_
+
+#include <stdint.h>
+
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLE_WINDOW)
+#define LINK_STATS_WINDOW  CONFIG_AMI_NEIGHBOR_SAMPLE_WINDOW
+#else
+#define LINK_STATS_WINDOW  60
+#endif
+
+/* One neighbor's sample window (oldest entries overwritten) */
+struct link_ring {
+	int8_t   rssi[LINK_STATS_WINDOW];       /* dBm */
+	uint16_t frame_err[LINK_STATS_WINDOW];  /* OT scale, 0xFFFF = 100% */
+	uint16_t msg_err[LINK_STATS_WINDOW];    /* OT scale, 0xFFFF = 100% */
+	uint8_t  head;                          /* next write position */
+	uint8_t  count;                         /* valid samples */
+};
+
+/* Aggregates over the current window */
+struct link_summary {
+	int8_t  rssi_min;        /* dBm */
+	int8_t  rssi_max;        /* dBm */
+	int8_t  rssi_p95;        /* dBm, nearest-rank 95th percentile */
+	double  rssi_mean;       /* dBm */
+	double  frame_err_mean;  /* percent */
+	double  frame_err_max;   /* percent */
+	double  msg_err_mean;    /* percent */
+	uint8_t samples;
+};
+
+/**
+ * @brief Empty a ring (neighbor arrived or left)
+ */
+void link_ring_reset(struct link_ring *ring);
+
+/**
+ * @brief Append one sample, overwriting the oldest when full
+ */
+void link_ring_push(struct link_ring *ring, int8_t rssi,
+		    uint16_t frame_err, uint16_t msg_err);
+
+/**
+ * @brief Reduce a ring to its aggregates
+ *
+ * @param ring  Sample window
+ * @param out   Output aggregates
+ * @return 0 on success, -ENODATA if the ring is empty, -EINVAL on NULL
+ */
+int link_ring_summarize(const struct link_ring *ring, struct link_summary *out);
+
+#endif /* LINK_STATS_H_ */
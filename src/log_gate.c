@@ -0,0 +1,85 @@
+/*
+ * Log Gate — see log_gate.h
+ *
+ * The gate is a mutex the drain thread takes around each
+ * log_process() call, which formats and outputs one message. The DLMS
+ * thread only touches the gate at the edges of a poll: log_gate_hold()
+ * waits at most for the message in progress, then the drain thread
+ * stays blocked on the mutex until log_gate_release(). During the
+ * poll itself nothing waits on the drain thread: LOG_*() in deferred
+ * mode only copies into the log buffer, which drops its oldest
+ * messages rather than block when it fills (CONFIG_LOG_MODE_OVERFLOW).
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+
+#include "log_gate.h"
+
+LOG_MODULE_REGISTER(log_gate, LOG_LEVEL_INF);
+
+static K_MUTEX_DEFINE(gate);
+
+void log_gate_hold(void)
+{
+	k_mutex_lock(&gate, K_FOREVER);
+}
+
+void log_gate_release(void)
+{
+	k_mutex_unlock(&gate);
+}
+
+#ifdef CONFIG_AMI_LOG_GATE_BOOT_LEVEL
+/* Modules registered at CONFIG_AMI_DLMS_LOG_LEVEL/_RS485_LOG_LEVEL */
+static const char *const gated_modules[] = {
+	"dlms_meter", "dlms_hdlc", "dlms_cosem", "rs485",
+};
+
+static void apply_boot_levels(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(gated_modules); i++) {
+		int src = log_source_id_get(gated_modules[i]);
+
+		if (src < 0) {
+			continue;
+		}
+		/* NULL backend: all backends */
+		log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, (int16_t)src,
+			       CONFIG_AMI_LOG_GATE_BOOT_LEVEL);
+	}
+	LOG_INF("DLMS/RS485 logs at level %d, raise with "
+		"\"log enable dbg <module>\"", CONFIG_AMI_LOG_GATE_BOOT_LEVEL);
+}
+#endif
+
+static void log_drain_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* The logging core k_wakeup()s this thread as messages arrive */
+	log_thread_set(k_current_get());
+
+#ifdef CONFIG_AMI_LOG_GATE_BOOT_LEVEL
+	apply_boot_levels();
+#endif
+
+	while (1) {
+		bool more;
+
+		k_mutex_lock(&gate, K_FOREVER);
+		more = log_process();
+		k_mutex_unlock(&gate);
+
+		if (!more) {
+			k_sleep(K_MSEC(CONFIG_AMI_LOG_GATE_PERIOD_MS));
+		}
+	}
+}
+
+K_THREAD_DEFINE(log_drain_tid, CONFIG_AMI_LOG_GATE_STACK_SIZE,
+		log_drain_entry, NULL, NULL, NULL,
+		CONFIG_AMI_LOG_GATE_PRIORITY, 0, 0);
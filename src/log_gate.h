@@ -0,0 +1,47 @@
+/*
+ * Log Gate — keeps log formatting and console output out of DLMS polls
+ *
+ * In deferred mode a LOG_*() call only copies its arguments into the
+ * log buffer; formatting and the UART backend run wherever
+ * log_process() is called. With CONFIG_AMI_LOG_GATE the Zephyr log
+ * thread is disabled (CONFIG_LOG_PROCESS_THREAD=n) and a low-priority
+ * drain thread calls log_process() instead, except while the gate is
+ * held. The DLMS thread holds it for the whole meter_poll(), so no
+ * message is formatted or written to the console between an RS485
+ * request and its response, whatever the thread priorities; messages
+ * from the poll come out right after it.
+ *
+ * At boot the DLMS/RS485 modules get a runtime level of
+ * CONFIG_AMI_LOG_GATE_BOOT_LEVEL, so debug output compiled into a
+ * production image stays silent until "log enable dbg <module>".
+ *
+ * Without CONFIG_AMI_LOG_GATE hold/release compile to nothing.
+ */
+
+#ifndef LOG_GATE_H_
+#define LOG_GATE_H_
+
+#ifdef CONFIG_AMI_LOG_GATE
+
+/**
+ * @brief Stop log output until log_gate_release()
+ *
+ * Messages logged meanwhile are buffered (CONFIG_LOG_BUFFER_SIZE; the
+ * oldest are dropped with CONFIG_LOG_MODE_OVERFLOW). Only the DLMS
+ * thread holds the gate.
+ */
+void log_gate_hold(void);
+
+/**
+ * @brief Resume log output
+ */
+void log_gate_release(void);
+
+#else
+
+static inline void log_gate_hold(void) { }
+static inline void log_gate_release(void) { }
+
+#endif /* CONFIG_AMI_LOG_GATE */
+
+#endif /* LOG_GATE_H_ */
@@ -8,16 +8,27 @@
  * hooking into the OT CLI infrastructure (avoids conflicts with
  * CONFIG_OPENTHREAD_SHELL).
  *
+ * Commands live in a const table and are looked up through a small
+ * hash index built at init. Handlers stream their output into one
+ * static buffer of CONFIG_AMI_CLI_RESULT_SIZE bytes; results larger
+ * than the CoAP block size are read by the server with Block2
+ * (block-wise) transfer instead of being truncated. No shell, no heap.
+ *
  * Supported commands:
  *   state, rloc16, channel, panid, leaderdata, counters mac,
- *   ipaddr, networkname, eui64, extaddr, version
+ *   counters mle, ipaddr, networkname, eui64, extaddr, version,
+ *   dataset active, neighbor table, router table, childtable, help
  */
 
+#include <stdarg.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/net/lwm2m.h>
 #include <openthread.h>
 #include <openthread/thread.h>
+#if defined(CONFIG_OPENTHREAD_FTD)
+#include <openthread/thread_ftd.h>
+#endif
 #include <openthread/link.h>
 #include <openthread/instance.h>
 #include <openthread/ip6.h>
@@ -37,7 +48,7 @@ LOG_MODULE_REGISTER(thread_cli, LOG_LEVEL_INF);
  * ================================================================ */
 static char cli_version[64];
 static char cli_command[128];
-static char cli_result[256];
+static char cli_result[CONFIG_AMI_CLI_RESULT_SIZE];
 
 /* ================================================================
  * LwM2M Object structures
@@ -63,146 +74,602 @@ static struct lwm2m_engine_res          thread_cli_res[TCLI_NUM_FIELDS];
 static struct lwm2m_engine_res_inst     thread_cli_ri[TCLI_RI_COUNT];
 
 /* ================================================================
- * CLI command handler — maps commands to OT API calls
+ * Output stream — append-only writer over cli_result
  * ================================================================ */
-static void handle_command(const char *cmd, char *result, size_t result_len)
+struct cli_out {
+	char *buf;
+	size_t cap;
+	size_t len;
+	bool overflow;
+};
+
+static void cli_printf(struct cli_out *out, const char *fmt, ...)
 {
-	struct otInstance *ot = openthread_get_default_instance();
-	if (!ot) {
-		snprintf(result, result_len, "Error: No OT instance");
+	va_list ap;
+	int n;
+
+	if (out->overflow) {
+		return;
+	}
+
+	va_start(ap, fmt);
+	n = vsnprintf(out->buf + out->len, out->cap - out->len, fmt, ap);
+	va_end(ap);
+
+	if (n < 0 || (size_t)n >= out->cap - out->len) {
+		/* Keep what fitted; the dispatcher marks the result truncated */
+		out->len = out->cap - 1;
+		out->overflow = true;
 		return;
 	}
+	out->len += n;
+}
+
+static void cli_print_ext_addr(struct cli_out *out, const uint8_t *m8)
+{
+	cli_printf(out, "%02x%02x%02x%02x%02x%02x%02x%02x",
+		   m8[0], m8[1], m8[2], m8[3], m8[4], m8[5], m8[6], m8[7]);
+}
+
+/* ================================================================
+ * Command handlers — each copies what it needs from OpenThread
+ * under openthread_mutex_lock(), unlocks, then formats, so the OT
+ * thread is never held off by vsnprintf.
+ * Return 0 on success (dispatcher appends "Done") or a negative
+ * errno after printing an "Error: ..." line.
+ * ================================================================ */
+
+/* Rows one table command can snapshot; more are reported truncated */
+#define CLI_MAX_ROWS   32
+#define CLI_MAX_ADDRS  16
+
+/*
+ * Table snapshots are too large for the engine thread's stack. Only
+ * the Execute callback runs handlers, one at a time, like cli_result.
+ */
+static union {
+	otNeighborInfo nbr[CLI_MAX_ROWS];
+	otRouterInfo rtr[CLI_MAX_ROWS];
+#if defined(CONFIG_OPENTHREAD_FTD)
+	otChildInfo child[CLI_MAX_ROWS];
+#endif
+	otIp6Address addr[CLI_MAX_ADDRS];
+} cli_rows;
+
+static int cmd_state(struct otInstance *ot, struct cli_out *out)
+{
+	const char *role_str;
+	otDeviceRole role;
+
+	openthread_mutex_lock();
+	role = otThreadGetDeviceRole(ot);
+	openthread_mutex_unlock();
+
+	switch (role) {
+	case OT_DEVICE_ROLE_DISABLED: role_str = "disabled"; break;
+	case OT_DEVICE_ROLE_DETACHED: role_str = "detached"; break;
+	case OT_DEVICE_ROLE_CHILD:    role_str = "child"; break;
+	case OT_DEVICE_ROLE_ROUTER:   role_str = "router"; break;
+	case OT_DEVICE_ROLE_LEADER:   role_str = "leader"; break;
+	default: role_str = "unknown"; break;
+	}
+	cli_printf(out, "%s\n", role_str);
+	return 0;
+}
+
+static int cmd_rloc16(struct otInstance *ot, struct cli_out *out)
+{
+	uint16_t rloc16;
+
+	openthread_mutex_lock();
+	rloc16 = otThreadGetRloc16(ot);
+	openthread_mutex_unlock();
+
+	cli_printf(out, "0x%04x\n", rloc16);
+	return 0;
+}
+
+static int cmd_channel(struct otInstance *ot, struct cli_out *out)
+{
+	uint8_t channel;
+
+	openthread_mutex_lock();
+	channel = otLinkGetChannel(ot);
+	openthread_mutex_unlock();
+
+	cli_printf(out, "%d\n", (int)channel);
+	return 0;
+}
+
+static int cmd_panid(struct otInstance *ot, struct cli_out *out)
+{
+	otPanId panid;
+
+	openthread_mutex_lock();
+	panid = otLinkGetPanId(ot);
+	openthread_mutex_unlock();
+
+	cli_printf(out, "0x%04x\n", panid);
+	return 0;
+}
+
+static int cmd_leaderdata(struct otInstance *ot, struct cli_out *out)
+{
+	otLeaderData ld;
+	otError err;
+
+	openthread_mutex_lock();
+	err = otThreadGetLeaderData(ot, &ld);
+	openthread_mutex_unlock();
+
+	if (err != OT_ERROR_NONE) {
+		cli_printf(out, "Error: no leader data\n");
+		return -ENODATA;
+	}
+	cli_printf(out,
+		   "Partition ID: %u\n"
+		   "Weighting: %u\n"
+		   "Data Version: %u\n"
+		   "Stable Data Version: %u\n"
+		   "Leader Router ID: %u\n",
+		   ld.mPartitionId, ld.mWeighting,
+		   ld.mDataVersion, ld.mStableDataVersion,
+		   ld.mLeaderRouterId);
+	return 0;
+}
+
+static int cmd_counters_mac(struct otInstance *ot, struct cli_out *out)
+{
+	const otMacCounters *counters;
+	otMacCounters mac;
+
+	openthread_mutex_lock();
+	counters = otLinkGetCounters(ot);
+	if (counters) {
+		mac = *counters;
+	}
+	openthread_mutex_unlock();
+
+	if (!counters) {
+		cli_printf(out, "Error: no MAC counters\n");
+		return -ENODATA;
+	}
+	cli_printf(out,
+		   "TxTotal: %u\n"
+		   "TxUnicast: %u\n"
+		   "TxBroadcast: %u\n"
+		   "TxErrAbort: %u\n"
+		   "RxTotal: %u\n"
+		   "RxUnicast: %u\n"
+		   "RxBroadcast: %u\n"
+		   "RxErrNoFrame: %u\n",
+		   mac.mTxTotal, mac.mTxUnicast,
+		   mac.mTxBroadcast, mac.mTxErrAbort,
+		   mac.mRxTotal, mac.mRxUnicast,
+		   mac.mRxBroadcast, mac.mRxErrNoFrame);
+	return 0;
+}
+
+static int cmd_counters_mle(struct otInstance *ot, struct cli_out *out)
+{
+	const otMleCounters *counters;
+	otMleCounters mle;
+
+	openthread_mutex_lock();
+	counters = otThreadGetMleCounters(ot);
+	if (counters) {
+		mle = *counters;
+	}
+	openthread_mutex_unlock();
+
+	if (!counters) {
+		cli_printf(out, "Error: no MLE counters\n");
+		return -ENODATA;
+	}
+	cli_printf(out,
+		   "Role Disabled: %u\n"
+		   "Role Detached: %u\n"
+		   "Role Child: %u\n"
+		   "Role Router: %u\n"
+		   "Role Leader: %u\n"
+		   "Attach Attempts: %u\n"
+		   "Partition Id Changes: %u\n"
+		   "Better Partition Attach Attempts: %u\n"
+		   "Parent Changes: %u\n",
+		   mle.mDisabledRole, mle.mDetachedRole,
+		   mle.mChildRole, mle.mRouterRole, mle.mLeaderRole,
+		   mle.mAttachAttempts, mle.mPartitionIdChanges,
+		   mle.mBetterPartitionAttachAttempts,
+		   mle.mParentChanges);
+	return 0;
+}
+
+static int cmd_ipaddr(struct otInstance *ot, struct cli_out *out)
+{
+	const otNetifAddress *addr;
+	char ip_str[OT_IP6_ADDRESS_STRING_SIZE];
+	int count = 0;
+
+	openthread_mutex_lock();
+	for (addr = otIp6GetUnicastAddresses(ot);
+	     addr != NULL && count < CLI_MAX_ADDRS; addr = addr->mNext) {
+		cli_rows.addr[count++] = addr->mAddress;
+	}
+	openthread_mutex_unlock();
+
+	for (int i = 0; i < count; i++) {
+		otIp6AddressToString(&cli_rows.addr[i], ip_str, sizeof(ip_str));
+		cli_printf(out, "%s\n", ip_str);
+	}
+	return 0;
+}
+
+static int cmd_networkname(struct otInstance *ot, struct cli_out *out)
+{
+	char name[OT_NETWORK_NAME_MAX_SIZE + 1] = "";
+	const char *n;
+
+	openthread_mutex_lock();
+	n = otThreadGetNetworkName(ot);
+	if (n) {
+		strncpy(name, n, sizeof(name) - 1);
+	}
+	openthread_mutex_unlock();
+
+	cli_printf(out, "%s\n", name);
+	return 0;
+}
+
+static int cmd_eui64(struct otInstance *ot, struct cli_out *out)
+{
+	otExtAddress eui;
+
+	openthread_mutex_lock();
+	otLinkGetFactoryAssignedIeeeEui64(ot, &eui);
+	openthread_mutex_unlock();
+
+	cli_print_ext_addr(out, eui.m8);
+	cli_printf(out, "\n");
+	return 0;
+}
+
+static int cmd_extaddr(struct otInstance *ot, struct cli_out *out)
+{
+	const otExtAddress *addr;
+	otExtAddress ext;
+
+	openthread_mutex_lock();
+	addr = otLinkGetExtendedAddress(ot);
+	if (addr) {
+		ext = *addr;
+	}
+	openthread_mutex_unlock();
+
+	if (!addr) {
+		cli_printf(out, "Error: no extended address\n");
+		return -ENODATA;
+	}
+	cli_print_ext_addr(out, ext.m8);
+	cli_printf(out, "\n");
+	return 0;
+}
+
+static int cmd_version(struct otInstance *ot, struct cli_out *out)
+{
+	ARG_UNUSED(ot);
+	/* Static string, no instance state: no lock needed */
+	cli_printf(out, "%s\n", otGetVersionString());
+	return 0;
+}
+
+static int cmd_dataset_active(struct otInstance *ot, struct cli_out *out)
+{
+	otOperationalDataset ds;
+	otError err;
 
 	openthread_mutex_lock();
+	err = otDatasetGetActive(ot, &ds);
+	openthread_mutex_unlock();
+
+	if (err != OT_ERROR_NONE) {
+		cli_printf(out, "Error: no active dataset\n");
+		return -ENODATA;
+	}
+	cli_printf(out,
+		   "Network Name: %s\n"
+		   "PAN ID: 0x%04x\n"
+		   "Channel: %d\n",
+		   ds.mNetworkName.m8, ds.mPanId, (int)ds.mChannel);
+	return 0;
+}
+
+/* Rows past CLI_MAX_ROWS are not shown; mark the result truncated */
+static void cli_rows_done(struct cli_out *out, bool more)
+{
+	if (more) {
+		out->overflow = true;
+	}
+}
 
-	if (strcmp(cmd, "state") == 0) {
-		otDeviceRole role = otThreadGetDeviceRole(ot);
-		const char *role_str;
-		switch (role) {
-		case OT_DEVICE_ROLE_DISABLED: role_str = "disabled"; break;
-		case OT_DEVICE_ROLE_DETACHED: role_str = "detached"; break;
-		case OT_DEVICE_ROLE_CHILD:    role_str = "child"; break;
-		case OT_DEVICE_ROLE_ROUTER:   role_str = "router"; break;
-		case OT_DEVICE_ROLE_LEADER:   role_str = "leader"; break;
-		default: role_str = "unknown"; break;
+/* Same layout as the OpenThread CLI "neighbor table" */
+static int cmd_neighbor_table(struct otInstance *ot, struct cli_out *out)
+{
+	otNeighborInfoIterator iter = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+	otNeighborInfo extra;
+	int count = 0;
+	bool more;
+
+	openthread_mutex_lock();
+	while (count < CLI_MAX_ROWS &&
+	       otThreadGetNextNeighborInfo(ot, &iter,
+					   &cli_rows.nbr[count]) == OT_ERROR_NONE) {
+		count++;
+	}
+	more = count == CLI_MAX_ROWS &&
+	       otThreadGetNextNeighborInfo(ot, &iter, &extra) == OT_ERROR_NONE;
+	openthread_mutex_unlock();
+
+	cli_printf(out,
+		   "| Role | RLOC16 | Age | Avg RSSI | Last RSSI |R|D|N| Extended MAC     |\n"
+		   "+------+--------+-----+----------+-----------+-+-+-+------------------+\n");
+	for (int i = 0; i < count; i++) {
+		const otNeighborInfo *n = &cli_rows.nbr[i];
+
+		cli_printf(out, "| %3c  | 0x%04x | %3lu | %8d | %9d |%1d|%1d|%1d| ",
+			   n->mIsChild ? 'C' : 'R', n->mRloc16,
+			   (unsigned long)n->mAge, n->mAverageRssi, n->mLastRssi,
+			   n->mRxOnWhenIdle, n->mFullThreadDevice,
+			   n->mFullNetworkData);
+		cli_print_ext_addr(out, n->mExtAddress.m8);
+		cli_printf(out, " |\n");
+	}
+	cli_rows_done(out, more);
+	return 0;
+}
+
+/* Same layout as the OpenThread CLI "router table" */
+static int cmd_router_table(struct otInstance *ot, struct cli_out *out)
+{
+	otRouterInfo r;
+	int count = 0;
+	bool more = false;
+
+	openthread_mutex_lock();
+	uint8_t max_id = otThreadGetMaxRouterId(ot);
+
+	for (uint8_t id = 0; id <= max_id; id++) {
+		if (otThreadGetRouterInfo(ot, id, &r) != OT_ERROR_NONE ||
+		    !r.mAllocated) {
+			continue;
 		}
-		snprintf(result, result_len, "%s\nDone", role_str);
-
-	} else if (strcmp(cmd, "rloc16") == 0) {
-		snprintf(result, result_len, "0x%04x\nDone",
-			 otThreadGetRloc16(ot));
-
-	} else if (strcmp(cmd, "channel") == 0) {
-		snprintf(result, result_len, "%d\nDone",
-			 (int)otLinkGetChannel(ot));
-
-	} else if (strcmp(cmd, "panid") == 0) {
-		snprintf(result, result_len, "0x%04x\nDone",
-			 otLinkGetPanId(ot));
-
-	} else if (strcmp(cmd, "leaderdata") == 0) {
-		otLeaderData ld;
-		if (otThreadGetLeaderData(ot, &ld) == OT_ERROR_NONE) {
-			snprintf(result, result_len,
-				 "Partition ID: %u\n"
-				 "Weighting: %u\n"
-				 "Data Version: %u\n"
-				 "Stable Data Version: %u\n"
-				 "Leader Router ID: %u\nDone",
-				 ld.mPartitionId, ld.mWeighting,
-				 ld.mDataVersion, ld.mStableDataVersion,
-				 ld.mLeaderRouterId);
-		} else {
-			snprintf(result, result_len, "Error: no leader data");
+		if (count == CLI_MAX_ROWS) {
+			more = true;
+			break;
 		}
+		cli_rows.rtr[count++] = r;
+	}
+	openthread_mutex_unlock();
 
-	} else if (strcmp(cmd, "counters mac") == 0) {
-		const otMacCounters *mac = otLinkGetCounters(ot);
-		if (mac) {
-			snprintf(result, result_len,
-				 "TxTotal: %u\n"
-				 "TxUnicast: %u\n"
-				 "TxBroadcast: %u\n"
-				 "TxErrAbort: %u\n"
-				 "RxTotal: %u\n"
-				 "RxUnicast: %u\n"
-				 "RxBroadcast: %u\n"
-				 "RxErrNoFrame: %u\nDone",
-				 mac->mTxTotal, mac->mTxUnicast,
-				 mac->mTxBroadcast, mac->mTxErrAbort,
-				 mac->mRxTotal, mac->mRxUnicast,
-				 mac->mRxBroadcast, mac->mRxErrNoFrame);
-		} else {
-			snprintf(result, result_len, "Error: no MAC counters");
+	cli_printf(out,
+		   "| ID | RLOC16 | Next Hop | Path Cost | LQ In | LQ Out | Age | Extended MAC     | Link |\n"
+		   "+----+--------+----------+-----------+-------+--------+-----+------------------+------+\n");
+	for (int i = 0; i < count; i++) {
+		const otRouterInfo *ri = &cli_rows.rtr[i];
+
+		cli_printf(out, "| %2u | 0x%04x | %8u | %9u | %5u | %6u | %3u | ",
+			   ri->mRouterId, ri->mRloc16, ri->mNextHop, ri->mPathCost,
+			   ri->mLinkQualityIn, ri->mLinkQualityOut, ri->mAge);
+		cli_print_ext_addr(out, ri->mExtAddress.m8);
+		cli_printf(out, " | %4d |\n", ri->mLinkEstablished);
+	}
+	cli_rows_done(out, more);
+	return 0;
+}
+
+/* Same layout as the OpenThread CLI "child table" */
+static int cmd_childtable(struct otInstance *ot, struct cli_out *out)
+{
+#if defined(CONFIG_OPENTHREAD_FTD)
+	otChildInfo c;
+	int count = 0;
+	bool more = false;
+
+	openthread_mutex_lock();
+	uint16_t max = otThreadGetMaxAllowedChildren(ot);
+
+	for (uint16_t i = 0; i < max; i++) {
+		if (otThreadGetChildInfoByIndex(ot, i, &c) != OT_ERROR_NONE ||
+		    c.mIsStateRestoring) {
+			continue;
+		}
+		if (count == CLI_MAX_ROWS) {
+			more = true;
+			break;
 		}
+		cli_rows.child[count++] = c;
+	}
+	openthread_mutex_unlock();
+
+	cli_printf(out,
+		   "| ID  | RLOC16 | Timeout    | Age        | LQ In | C_VN |R|D|N| Extended MAC     |\n"
+		   "+-----+--------+------------+------------+-------+------+-+-+-+------------------+\n");
+	for (int i = 0; i < count; i++) {
+		const otChildInfo *ci = &cli_rows.child[i];
+
+		cli_printf(out, "| %3u | 0x%04x | %10lu | %10lu | %5u | %4u |%1d|%1d|%1d| ",
+			   ci->mChildId, ci->mRloc16,
+			   (unsigned long)ci->mTimeout, (unsigned long)ci->mAge,
+			   ci->mLinkQualityIn, ci->mNetworkDataVersion,
+			   ci->mRxOnWhenIdle, ci->mFullThreadDevice,
+			   ci->mFullNetworkData);
+		cli_print_ext_addr(out, ci->mExtAddress.m8);
+		cli_printf(out, " |\n");
+	}
+	cli_rows_done(out, more);
+	return 0;
+#else
+	ARG_UNUSED(ot);
+	cli_printf(out, "Error: childtable requires an FTD build\n");
+	return -ENOTSUP;
+#endif
+}
 
-	} else if (strcmp(cmd, "ipaddr") == 0) {
-		char *p = result;
-		size_t rem = result_len;
-		const otNetifAddress *addr = otIp6GetUnicastAddresses(ot);
-		for (; addr != NULL; addr = addr->mNext) {
-			char ip_str[48];
-			otIp6AddressToString(&addr->mAddress, ip_str, sizeof(ip_str));
-			int n = snprintf(p, rem, "%s\n", ip_str);
-			if (n > 0 && (size_t)n < rem) {
-				p += n;
-				rem -= n;
-			}
+static int cmd_help(struct otInstance *ot, struct cli_out *out);
+
+/* ================================================================
+ * Command registry
+ * ================================================================ */
+struct cli_cmd {
+	const char *name;
+	int (*handler)(struct otInstance *ot, struct cli_out *out);
+};
+
+static const struct cli_cmd cli_cmds[] = {
+	{ "state",          cmd_state },
+	{ "rloc16",         cmd_rloc16 },
+	{ "channel",        cmd_channel },
+	{ "panid",          cmd_panid },
+	{ "leaderdata",     cmd_leaderdata },
+	{ "counters mac",   cmd_counters_mac },
+	{ "counters mle",   cmd_counters_mle },
+	{ "ipaddr",         cmd_ipaddr },
+	{ "networkname",    cmd_networkname },
+	{ "eui64",          cmd_eui64 },
+	{ "extaddr",        cmd_extaddr },
+	{ "version",        cmd_version },
+	{ "dataset active", cmd_dataset_active },
+	{ "neighbor table", cmd_neighbor_table },
+	{ "router table",   cmd_router_table },
+	{ "childtable",     cmd_childtable },
+	{ "help",           cmd_help },
+};
+
+/* Hash index over cli_cmds: power of two, at most half full */
+#define CLI_INDEX_SIZE   64
+#define CLI_INDEX_MASK   (CLI_INDEX_SIZE - 1)
+#define CLI_INDEX_EMPTY  0xFF
+
+BUILD_ASSERT(ARRAY_SIZE(cli_cmds) <= CLI_INDEX_SIZE / 2,
+	     "CLI hash index too small for the command table");
+
+static uint8_t cli_index[CLI_INDEX_SIZE];
+
+static uint32_t cli_hash(const char *s)
+{
+	uint32_t h = 2166136261u;  /* FNV-1a */
+
+	while (*s) {
+		h = (h ^ (uint8_t)*s++) * 16777619u;
+	}
+	return h & CLI_INDEX_MASK;
+}
+
+static void cli_index_build(void)
+{
+	memset(cli_index, CLI_INDEX_EMPTY, sizeof(cli_index));
+
+	for (int i = 0; i < ARRAY_SIZE(cli_cmds); i++) {
+		uint32_t pos = cli_hash(cli_cmds[i].name);
+
+		while (cli_index[pos] != CLI_INDEX_EMPTY) {
+			pos = (pos + 1) & CLI_INDEX_MASK;
 		}
-		snprintf(p, rem, "Done");
-
-	} else if (strcmp(cmd, "networkname") == 0) {
-		const char *name = otThreadGetNetworkName(ot);
-		snprintf(result, result_len, "%s\nDone", name ? name : "");
-
-	} else if (strcmp(cmd, "eui64") == 0) {
-		otExtAddress eui;
-		otLinkGetFactoryAssignedIeeeEui64(ot, &eui);
-		snprintf(result, result_len,
-			 "%02x%02x%02x%02x%02x%02x%02x%02x\nDone",
-			 eui.m8[0], eui.m8[1], eui.m8[2], eui.m8[3],
-			 eui.m8[4], eui.m8[5], eui.m8[6], eui.m8[7]);
-
-	} else if (strcmp(cmd, "extaddr") == 0) {
-		const otExtAddress *ext = otLinkGetExtendedAddress(ot);
-		if (ext) {
-			snprintf(result, result_len,
-				 "%02x%02x%02x%02x%02x%02x%02x%02x\nDone",
-				 ext->m8[0], ext->m8[1], ext->m8[2], ext->m8[3],
-				 ext->m8[4], ext->m8[5], ext->m8[6], ext->m8[7]);
+		cli_index[pos] = i;
+	}
+}
+
+static const struct cli_cmd *cli_lookup(const char *name)
+{
+	uint32_t pos = cli_hash(name);
+
+	while (cli_index[pos] != CLI_INDEX_EMPTY) {
+		const struct cli_cmd *cmd = &cli_cmds[cli_index[pos]];
+
+		if (strcmp(cmd->name, name) == 0) {
+			return cmd;
 		}
+		pos = (pos + 1) & CLI_INDEX_MASK;
+	}
+	return NULL;
+}
+
+static int cmd_help(struct otInstance *ot, struct cli_out *out)
+{
+	ARG_UNUSED(ot);
 
-	} else if (strcmp(cmd, "version") == 0) {
-		snprintf(result, result_len, "%s\nDone",
-			 otGetVersionString());
-
-	} else if (strcmp(cmd, "dataset active") == 0) {
-		otOperationalDataset ds;
-		if (otDatasetGetActive(ot, &ds) == OT_ERROR_NONE) {
-			snprintf(result, result_len,
-				 "Network Name: %s\n"
-				 "PAN ID: 0x%04x\n"
-				 "Channel: %d\nDone",
-				 ds.mNetworkName.m8,
-				 ds.mPanId,
-				 (int)ds.mChannel);
-		} else {
-			snprintf(result, result_len, "Error: no active dataset");
+	cli_printf(out, "Supported:");
+	for (int i = 0; i < ARRAY_SIZE(cli_cmds); i++) {
+		cli_printf(out, "%s %s", i ? "," : "", cli_cmds[i].name);
+	}
+	cli_printf(out, "\n");
+	return 0;
+}
+
+/*
+ * Normalize a command in place: trim, collapse runs of whitespace to
+ * one space, so "counters   mac\n" matches "counters mac".
+ */
+static void cli_normalize(char *cmd)
+{
+	char *src = cmd, *dst = cmd;
+	bool space = false;
+
+	while (*src == ' ' || *src == '\t' || *src == '\r' || *src == '\n') {
+		src++;
+	}
+	for (; *src; src++) {
+		if (*src == ' ' || *src == '\t' || *src == '\r' || *src == '\n') {
+			space = true;
+			continue;
 		}
+		if (space && dst != cmd) {
+			*dst++ = ' ';
+		}
+		space = false;
+		*dst++ = *src;
+	}
+	*dst = '\0';
+}
 
-	} else if (strcmp(cmd, "help") == 0) {
-		snprintf(result, result_len,
-			 "Supported: state, rloc16, channel, panid, "
-			 "leaderdata, counters mac, ipaddr, networkname, "
-			 "eui64, extaddr, version, dataset active, help\nDone");
+/* ================================================================
+ * CLI command dispatcher
+ * ================================================================ */
+static size_t handle_command(char *cmd, char *result, size_t result_len)
+{
+	struct cli_out out = { .buf = result, .cap = result_len };
+	struct otInstance *ot = openthread_get_default_instance();
+	const struct cli_cmd *entry;
 
-	} else {
-		snprintf(result, result_len,
-			 "Error: Unknown command '%s'\n"
-			 "Type 'help' for available commands", cmd);
+	result[0] = '\0';
+
+	if (!ot) {
+		cli_printf(&out, "Error: No OT instance");
+		return out.len;
 	}
 
-	openthread_mutex_unlock();
+	cli_normalize(cmd);
+	entry = cli_lookup(cmd);
+	if (!entry) {
+		cli_printf(&out,
+			   "Error: Unknown command '%s'\n"
+			   "Type 'help' for available commands", cmd);
+		return out.len;
+	}
+
+	int ret = entry->handler(ot, &out);
+
+	if (out.overflow) {
+		/* Overwrite the tail so the marker always fits */
+		static const char marker[] = "\n...truncated\n";
+
+		out.len = result_len - sizeof(marker);
+		memcpy(result + out.len, marker, sizeof(marker));
+		out.len += sizeof(marker) - 1;
+	} else if (ret == 0) {
+		cli_printf(&out, "Done");
+	}
+
+	return out.len;
 }
 
 /* ================================================================
@@ -223,14 +690,16 @@ static int cli_execute_cb(uint16_t obj_inst_id,
 	}
 
 	LOG_INF("CLI Execute: '%s'", cli_command);
-	handle_command(cli_command, cli_result, sizeof(cli_result));
+	size_t len = handle_command(cli_command, cli_result, sizeof(cli_result));
 
-	/* Update via LwM2M API to set correct data_len */
-	lwm2m_set_string(&LWM2M_OBJ(THREAD_CLI_OBJECT_ID, 0, TCLI_RESULT_RID),
-			 cli_result);
+	/* Output was streamed in place: only publish the new length
+	 * (includes the NUL, as lwm2m_set_string() does).
+	 */
+	lwm2m_set_res_data_len(&LWM2M_OBJ(THREAD_CLI_OBJECT_ID, 0,
+					   TCLI_RESULT_RID), len + 1);
 
-	LOG_INF("CLI Result: %.80s%s", cli_result,
-		strlen(cli_result) > 80 ? "..." : "");
+	LOG_INF("CLI Result (%u bytes): %.80s%s", (unsigned int)len, cli_result,
+		len > 80 ? "..." : "");
 
 	/* Notify observer of result change */
 	lwm2m_notify_observer(THREAD_CLI_OBJECT_ID, 0, TCLI_RESULT_RID);
@@ -273,6 +742,8 @@ void init_thread_cli_object(void)
 {
 	struct lwm2m_engine_obj_inst *obj_inst = NULL;
 
+	cli_index_build();
+
 	thread_cli_obj.obj_id = THREAD_CLI_OBJECT_ID;
 	thread_cli_obj.version_major = 1;
 	thread_cli_obj.version_minor = 0;
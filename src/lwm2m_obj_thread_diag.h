@@ -6,6 +6,9 @@
  *
  * v2.0 — Reduced: RLOC16, Channel, Parent info moved to 10483/10485.
  * Remaining: Thread Role, Partition ID, and 8 MAC counters.
+ *
+ * v2.1 — Rates computed on-device over a sliding window (mac_rate.c):
+ * frames/s, TX/RX error ratios, counter resets and the window span.
  */
 
 #ifndef LWM2M_OBJ_THREAD_DIAG_H
@@ -24,8 +27,14 @@
 #define TD_RX_BROADCAST_RID       7   /* U32: MAC RX broadcast */
 #define TD_TX_ERR_ABORT_RID       8   /* U32: MAC TX errors (abort) */
 #define TD_RX_ERR_NOFRAME_RID     9   /* U32: MAC RX errors (no frame) */
+#define TD_TX_FPS_RID             10  /* Float: MAC TX frames/s over the window */
+#define TD_RX_FPS_RID             11  /* Float: MAC RX frames/s over the window */
+#define TD_TX_ERR_PCT_RID         12  /* Float: failed TX / TX attempts (%) */
+#define TD_RX_ERR_PCT_RID         13  /* Float: RX errors / RX frames seen (%) */
+#define TD_COUNTER_RESETS_RID     14  /* U32: MAC counter resets detected */
+#define TD_RATE_WINDOW_RID        15  /* U32: time covered by the rates (s) */
 
-#define TD_NUM_FIELDS             10
-#define TD_RES_INST_COUNT         10
+#define TD_NUM_FIELDS             16
+#define TD_RES_INST_COUNT         16
 
 #endif /* LWM2M_OBJ_THREAD_DIAG_H */
@@ -2,8 +2,14 @@
  * LwM2M Object 10485 — Thread Neighbor Information
  *
  * Standard OMA object for Thread neighbor diagnostics.
- * Multiple instances — one per discovered neighbor.
- * Reports RSSI, LQI, role, age, MAC address, error rates.
+ * Multiple instances — one per discovered neighbor, keyed by extended
+ * address so a neighbor keeps its instance ID across updates.
+ * Reports RSSI, LQI, role, age, MAC address and error rates.
+ *
+ * With CONFIG_AMI_NEIGHBOR_SAMPLER the min/max/mean/p95 aggregates
+ * sampled on-device between updates go to the custom Object 33005,
+ * one instance per /10485 instance, so 10485 keeps the registered
+ * resource set.
  */
 
 #include <zephyr/kernel.h>
@@ -15,6 +21,7 @@
 #include <openthread/instance.h>
 
 #include "lwm2m_obj_thread_neighbor.h"
+#include "link_stats.h"
 
 /* Internal headers for custom object creation */
 #include "lwm2m_object.h"
@@ -44,6 +51,22 @@ struct neighbor_data {
 
 static struct neighbor_data nd[NI_MAX_INSTANCES];
 
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+/* Sampled window aggregates (link_stats.h), Object 33005 */
+struct neighbor_link_data {
+	int32_t  rssi_min;        /* dBm */
+	int32_t  rssi_max;        /* dBm */
+	double   rssi_mean;       /* dBm */
+	int32_t  rssi_p95;        /* dBm */
+	double   frame_err_mean;  /* percentage */
+	double   frame_err_max;   /* percentage */
+	double   msg_err_mean;    /* percentage */
+	int32_t  samples;         /* count */
+};
+
+static struct neighbor_link_data nl[NI_MAX_INSTANCES];
+#endif
+
 /* ================================================================
  * LwM2M Object structures — per instance
  * ================================================================ */
@@ -70,6 +93,30 @@ static struct lwm2m_engine_res          neighbor_res[NI_MAX_INSTANCES][NI_NUM_FI
 static struct lwm2m_engine_res_inst     neighbor_ri[NI_MAX_INSTANCES][NI_NUM_FIELDS];
 static bool                             neighbor_inst_created[NI_MAX_INSTANCES];
 
+BUILD_ASSERT(ARRAY_SIZE(thread_neighbor_fields) == NI_NUM_FIELDS,
+	     "Object 10485 field table out of sync with NI_NUM_FIELDS");
+
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+static struct lwm2m_engine_obj          neighbor_link_obj;
+static struct lwm2m_engine_obj_field    neighbor_link_fields[] = {
+	OBJ_FIELD_DATA(NL_RSSI_MIN_RID, R, S32),
+	OBJ_FIELD_DATA(NL_RSSI_MAX_RID, R, S32),
+	OBJ_FIELD_DATA(NL_RSSI_MEAN_RID, R, FLOAT),
+	OBJ_FIELD_DATA(NL_RSSI_P95_RID, R, S32),
+	OBJ_FIELD_DATA(NL_FRAME_ERR_MEAN_RID, R, FLOAT),
+	OBJ_FIELD_DATA(NL_FRAME_ERR_MAX_RID, R, FLOAT),
+	OBJ_FIELD_DATA(NL_MSG_ERR_MEAN_RID, R, FLOAT),
+	OBJ_FIELD_DATA(NL_SAMPLES_RID, R, S32),
+};
+
+static struct lwm2m_engine_obj_inst     link_inst[NI_MAX_INSTANCES];
+static struct lwm2m_engine_res          link_res[NI_MAX_INSTANCES][NL_NUM_FIELDS];
+static struct lwm2m_engine_res_inst     link_ri[NI_MAX_INSTANCES][NL_NUM_FIELDS];
+
+BUILD_ASSERT(ARRAY_SIZE(neighbor_link_fields) == NL_NUM_FIELDS,
+	     "Object 33005 field table out of sync with NL_NUM_FIELDS");
+#endif
+
 /* ================================================================
  * Create callback
  * ================================================================ */
@@ -160,6 +207,183 @@ static int neighbor_delete_cb(uint16_t obj_inst_id)
 	return 0;
 }
 
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+/* ================================================================
+ * Object 33005 create/delete — instance ID = neighbor slot
+ * ================================================================ */
+static struct lwm2m_engine_obj_inst *link_create_cb(uint16_t obj_inst_id)
+{
+	if (obj_inst_id >= NI_MAX_INSTANCES) {
+		LOG_ERR("No slot for neighbor link instance %u", obj_inst_id);
+		return NULL;
+	}
+
+	int slot = obj_inst_id;
+	int i = 0, j = 0;
+
+	init_res_instance(link_ri[slot], ARRAY_SIZE(link_ri[slot]));
+
+	INIT_OBJ_RES_DATA(NL_RSSI_MIN_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].rssi_min, sizeof(nl[slot].rssi_min));
+	INIT_OBJ_RES_DATA(NL_RSSI_MAX_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].rssi_max, sizeof(nl[slot].rssi_max));
+	INIT_OBJ_RES_DATA(NL_RSSI_MEAN_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].rssi_mean, sizeof(nl[slot].rssi_mean));
+	INIT_OBJ_RES_DATA(NL_RSSI_P95_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].rssi_p95, sizeof(nl[slot].rssi_p95));
+	INIT_OBJ_RES_DATA(NL_FRAME_ERR_MEAN_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].frame_err_mean, sizeof(nl[slot].frame_err_mean));
+	INIT_OBJ_RES_DATA(NL_FRAME_ERR_MAX_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].frame_err_max, sizeof(nl[slot].frame_err_max));
+	INIT_OBJ_RES_DATA(NL_MSG_ERR_MEAN_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].msg_err_mean, sizeof(nl[slot].msg_err_mean));
+	INIT_OBJ_RES_DATA(NL_SAMPLES_RID, link_res[slot], i,
+			  link_ri[slot], j,
+			  &nl[slot].samples, sizeof(nl[slot].samples));
+
+	link_inst[slot].resources = link_res[slot];
+	link_inst[slot].resource_count = i;
+	return &link_inst[slot];
+}
+
+static int link_delete_cb(uint16_t obj_inst_id)
+{
+	if (obj_inst_id < NI_MAX_INSTANCES) {
+		memset(&nl[obj_inst_id], 0, sizeof(nl[obj_inst_id]));
+	}
+	return 0;
+}
+
+static void init_neighbor_link_object(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+
+	neighbor_link_obj.obj_id = NEIGHBOR_LINK_OBJECT_ID;
+	neighbor_link_obj.version_major = 1;
+	neighbor_link_obj.version_minor = 0;
+	neighbor_link_obj.is_core = false;
+	neighbor_link_obj.fields = neighbor_link_fields;
+	neighbor_link_obj.field_count = ARRAY_SIZE(neighbor_link_fields);
+	neighbor_link_obj.max_instance_count = NI_MAX_INSTANCES;
+	neighbor_link_obj.create_cb = link_create_cb;
+	neighbor_link_obj.delete_cb = link_delete_cb;
+	lwm2m_register_obj(&neighbor_link_obj);
+
+	/* Instance 0 is permanent, like /10485/0 */
+	int ret = lwm2m_create_obj_inst(NEIGHBOR_LINK_OBJECT_ID, 0, &obj_inst);
+	if (ret < 0) {
+		LOG_ERR("Failed to create initial neighbor link instance: %d",
+			ret);
+	}
+}
+#endif /* CONFIG_AMI_NEIGHBOR_SAMPLER */
+
+/* ================================================================
+ * Neighbor → instance mapping
+ *
+ * Each neighbor is keyed by its extended address and keeps the same
+ * instance ID (= slot) for as long as it stays in the OT neighbor
+ * table, so observers on /10485/i/x keep tracking the same node.
+ * Lookups go through a small open-addressed hash index; only arrivals
+ * and departures create or delete instances.
+ * ================================================================ */
+
+/* Neighbors copied per update: room for newcomers beyond mapped slots */
+#define NI_SNAPSHOT_MAX   (NI_MAX_INSTANCES + 8)
+
+/* Hash index: power of two, at most half full */
+#define NI_INDEX_SIZE     128
+#define NI_INDEX_MASK     (NI_INDEX_SIZE - 1)
+#define NI_INDEX_EMPTY    0xFF
+
+BUILD_ASSERT(NI_MAX_INSTANCES <= NI_INDEX_SIZE / 2,
+	     "neighbor hash index too small for NI_MAX_INSTANCES");
+
+struct neighbor_slot {
+	otExtAddress ext_addr;
+	bool used;
+	bool seen;      /* present in the current snapshot */
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+	struct link_ring ring;
+#endif
+};
+
+static struct neighbor_slot slots[NI_MAX_INSTANCES];
+static uint8_t slot_index[NI_INDEX_SIZE];
+
+static uint32_t ext_addr_hash(const otExtAddress *addr)
+{
+	uint32_t h = 2166136261u;  /* FNV-1a */
+
+	for (int i = 0; i < OT_EXT_ADDRESS_SIZE; i++) {
+		h = (h ^ addr->m8[i]) * 16777619u;
+	}
+	return h & NI_INDEX_MASK;
+}
+
+static int index_find_pos(const otExtAddress *addr)
+{
+	uint32_t pos = ext_addr_hash(addr);
+
+	while (slot_index[pos] != NI_INDEX_EMPTY) {
+		if (memcmp(&slots[slot_index[pos]].ext_addr, addr,
+			   sizeof(*addr)) == 0) {
+			return pos;
+		}
+		pos = (pos + 1) & NI_INDEX_MASK;
+	}
+	return -1;
+}
+
+static int index_find(const otExtAddress *addr)
+{
+	int pos = index_find_pos(addr);
+
+	return pos < 0 ? -1 : slot_index[pos];
+}
+
+static void index_insert(int slot)
+{
+	uint32_t pos = ext_addr_hash(&slots[slot].ext_addr);
+
+	while (slot_index[pos] != NI_INDEX_EMPTY) {
+		pos = (pos + 1) & NI_INDEX_MASK;
+	}
+	slot_index[pos] = slot;
+}
+
+/* Linear-probing delete with backward shift (no tombstones) */
+static void index_remove(int slot)
+{
+	int pos = index_find_pos(&slots[slot].ext_addr);
+	uint32_t hole, next, home;
+
+	if (pos < 0) {
+		return;
+	}
+
+	hole = pos;
+	next = (hole + 1) & NI_INDEX_MASK;
+	while (slot_index[next] != NI_INDEX_EMPTY) {
+		home = ext_addr_hash(&slots[slot_index[next]].ext_addr);
+		/* Move the entry back if its home is not in (hole, next] */
+		if (((next - home) & NI_INDEX_MASK) >=
+		    ((next - hole) & NI_INDEX_MASK)) {
+			slot_index[hole] = slot_index[next];
+			hole = next;
+		}
+		next = (next + 1) & NI_INDEX_MASK;
+	}
+	slot_index[hole] = NI_INDEX_EMPTY;
+}
+
 /* ================================================================
  * Initialization
  * ================================================================ */
@@ -167,6 +391,8 @@ void init_thread_neighbor_object(void)
 {
 	struct lwm2m_engine_obj_inst *obj_inst = NULL;
 
+	memset(slot_index, NI_INDEX_EMPTY, sizeof(slot_index));
+
 	thread_neighbor_obj.obj_id = THREAD_NEIGHBOR_OBJECT_ID;
 	thread_neighbor_obj.version_major = 1;
 	thread_neighbor_obj.version_minor = 0;
@@ -191,6 +417,10 @@ void init_thread_neighbor_object(void)
 	lwm2m_set_string(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, 0,
 				     NI_EXT_MAC_RID), "N/A");
 
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+	init_neighbor_link_object();
+#endif
+
 	LOG_INF("Object 10485 (Thread Neighbor) initialized (max %d)",
 		NI_MAX_INSTANCES);
 }
@@ -205,8 +435,199 @@ static void format_ext_addr(const uint8_t *addr, char *buf, size_t len)
 		 addr[4], addr[5], addr[6], addr[7]);
 }
 
+/* Placeholder shown on instance 0 while it has no neighbor */
+static void neighbor_data_placeholder(struct neighbor_data *d)
+{
+	memset(d, 0, sizeof(*d));
+	strcpy(d->rloc16_str, "N/A");
+	strcpy(d->ext_mac_str, "N/A");
+}
+
+static void neighbor_data_from_info(struct neighbor_data *d,
+				    const otNeighborInfo *ninfo)
+{
+	d->role = ninfo->mIsChild ? 0 : 1;
+	snprintf(d->rloc16_str, sizeof(d->rloc16_str), "0x%04X",
+		 ninfo->mRloc16);
+	d->age = (int32_t)ninfo->mAge;
+	d->avg_rssi = (int32_t)ninfo->mAverageRssi;
+	d->last_rssi = (int32_t)ninfo->mLastRssi;
+	d->rx_on_idle = ninfo->mRxOnWhenIdle;
+	d->ftd = ninfo->mFullThreadDevice;
+	d->fnd = ninfo->mFullNetworkData;
+	format_ext_addr(ninfo->mExtAddress.m8, d->ext_mac_str,
+			sizeof(d->ext_mac_str));
+	d->lqi_in = (int32_t)ninfo->mLinkQualityIn;
+	d->lqi_out = 0; /* Not directly available in OT */
+	/* Frame/Message error rates: OT uses 0xFFFF scale -> convert to % */
+	d->frame_error = (double)ninfo->mFrameErrorRate * 100.0 / 0xFFFF;
+	d->msg_error = (double)ninfo->mMessageErrorRate * 100.0 / 0xFFFF;
+	d->queued_msgs = 0; /* Not directly available */
+}
+
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+/* Fill the window aggregates; left at zero until the first sample */
+static void link_data_from_ring(struct neighbor_link_data *d, int slot)
+{
+	struct link_summary sum;
+
+	memset(d, 0, sizeof(*d));
+	if (link_ring_summarize(&slots[slot].ring, &sum) == 0) {
+		d->rssi_min = sum.rssi_min;
+		d->rssi_max = sum.rssi_max;
+		d->rssi_mean = sum.rssi_mean;
+		d->rssi_p95 = sum.rssi_p95;
+		d->frame_err_mean = sum.frame_err_mean;
+		d->frame_err_max = sum.frame_err_max;
+		d->msg_err_mean = sum.msg_err_mean;
+		d->samples = sum.samples;
+	}
+}
+#endif
+
+#define NI_PATH(slot, rid)  (&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, (slot), (rid)))
+#define NL_PATH(slot, rid)  (&LWM2M_OBJ(NEIGHBOR_LINK_OBJECT_ID, (slot), (rid)))
+
+#define OBJ_SET_IF_CHANGED(path, field, rid, setter)                   \
+	do {                                                           \
+		if (cur->field != next->field) {                       \
+			setter(path(slot, rid), next->field);          \
+			changed++;                                     \
+		}                                                      \
+	} while (0)
+
+#define NI_SET_IF_CHANGED(field, rid, setter)                          \
+	OBJ_SET_IF_CHANGED(NI_PATH, field, rid, setter)
+#define NL_SET_IF_CHANGED(field, rid, setter)                          \
+	OBJ_SET_IF_CHANGED(NL_PATH, field, rid, setter)
+
+#define NI_SET_STR_IF_CHANGED(field, rid)                              \
+	do {                                                           \
+		if (strcmp(cur->field, next->field) != 0) {            \
+			lwm2m_set_string(NI_PATH(slot, rid), next->field); \
+			changed++;                                     \
+		}                                                      \
+	} while (0)
+
+/*
+ * Write only the resources that differ from what the instance already
+ * holds. lwm2m_set_*() notifies observers itself when a value changes,
+ * so unchanged resources cost no CoAP traffic at all.
+ *
+ * @return number of resources written
+ */
+static int neighbor_apply(int slot, const struct neighbor_data *next)
+{
+	const struct neighbor_data *cur = &nd[slot];
+	int changed = 0;
+
+	NI_SET_IF_CHANGED(role, NI_ROLE_RID, lwm2m_set_s32);
+	NI_SET_STR_IF_CHANGED(rloc16_str, NI_RLOC16_RID);
+	NI_SET_IF_CHANGED(age, NI_AGE_RID, lwm2m_set_s32);
+	NI_SET_IF_CHANGED(avg_rssi, NI_AVG_RSSI_RID, lwm2m_set_s32);
+	NI_SET_IF_CHANGED(last_rssi, NI_LAST_RSSI_RID, lwm2m_set_s32);
+	NI_SET_IF_CHANGED(rx_on_idle, NI_RX_ON_IDLE_RID, lwm2m_set_bool);
+	NI_SET_IF_CHANGED(ftd, NI_FTD_RID, lwm2m_set_bool);
+	NI_SET_IF_CHANGED(fnd, NI_FND_RID, lwm2m_set_bool);
+	NI_SET_STR_IF_CHANGED(ext_mac_str, NI_EXT_MAC_RID);
+	NI_SET_IF_CHANGED(lqi_in, NI_LQI_IN_RID, lwm2m_set_s32);
+	NI_SET_IF_CHANGED(lqi_out, NI_LQI_OUT_RID, lwm2m_set_s32);
+	NI_SET_IF_CHANGED(frame_error, NI_FRAME_ERR_RID, lwm2m_set_f64);
+	NI_SET_IF_CHANGED(msg_error, NI_MSG_ERR_RID, lwm2m_set_f64);
+	NI_SET_IF_CHANGED(queued_msgs, NI_QUEUED_MSGS_RID, lwm2m_set_s32);
+
+	return changed;
+}
+
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+/* Same for the Object 33005 instance of the slot */
+static int link_apply(int slot, const struct neighbor_link_data *next)
+{
+	const struct neighbor_link_data *cur = &nl[slot];
+	int changed = 0;
+
+	NL_SET_IF_CHANGED(rssi_min, NL_RSSI_MIN_RID, lwm2m_set_s32);
+	NL_SET_IF_CHANGED(rssi_max, NL_RSSI_MAX_RID, lwm2m_set_s32);
+	NL_SET_IF_CHANGED(rssi_mean, NL_RSSI_MEAN_RID, lwm2m_set_f64);
+	NL_SET_IF_CHANGED(rssi_p95, NL_RSSI_P95_RID, lwm2m_set_s32);
+	NL_SET_IF_CHANGED(frame_err_mean, NL_FRAME_ERR_MEAN_RID, lwm2m_set_f64);
+	NL_SET_IF_CHANGED(frame_err_max, NL_FRAME_ERR_MAX_RID, lwm2m_set_f64);
+	NL_SET_IF_CHANGED(msg_err_mean, NL_MSG_ERR_MEAN_RID, lwm2m_set_f64);
+	NL_SET_IF_CHANGED(samples, NL_SAMPLES_RID, lwm2m_set_s32);
+
+	return changed;
+}
+#endif
+
+/* Give a newly seen neighbor the lowest free slot; -1 if full */
+static int neighbor_insert(const otExtAddress *addr)
+{
+	int slot = -1;
+
+	for (int s = 0; s < NI_MAX_INSTANCES; s++) {
+		if (!slots[s].used) {
+			slot = s;
+			break;
+		}
+	}
+	if (slot < 0) {
+		return -1;
+	}
+
+	/* Instance 0 is permanent (placeholder), the rest are created here */
+	if (slot != 0) {
+		struct lwm2m_engine_obj_inst *inst = NULL;
+		int ret = lwm2m_create_obj_inst(THREAD_NEIGHBOR_OBJECT_ID, slot,
+						&inst);
+		if (ret < 0) {
+			LOG_ERR("Failed to create neighbor inst %d: %d", slot, ret);
+			return -1;
+		}
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+		ret = lwm2m_create_obj_inst(NEIGHBOR_LINK_OBJECT_ID, slot, &inst);
+		if (ret < 0) {
+			LOG_WRN("Failed to create neighbor link inst %d: %d",
+				slot, ret);
+		}
+#endif
+	}
+
+	slots[slot].ext_addr = *addr;
+	slots[slot].used = true;
+	slots[slot].seen = true;
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+	link_ring_reset(&slots[slot].ring);
+#endif
+	index_insert(slot);
+	return slot;
+}
+
+static void neighbor_evict(int slot)
+{
+	index_remove(slot);
+	slots[slot].used = false;
+
+	if (slot == 0) {
+		struct neighbor_data placeholder;
+
+		neighbor_data_placeholder(&placeholder);
+		neighbor_apply(0, &placeholder);
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+		struct neighbor_link_data none = { 0 };
+
+		link_apply(0, &none);
+#endif
+	} else {
+		lwm2m_delete_object_inst(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, slot));
+		neighbor_inst_created[slot] = false;
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+		lwm2m_delete_object_inst(&LWM2M_OBJ(NEIGHBOR_LINK_OBJECT_ID, slot));
+#endif
+	}
+}
+
 /* ================================================================
- * Periodic update — called from main loop
+ * Periodic update — called from the Thread metrics work queue
  * ================================================================ */
 void update_thread_neighbors(void)
 {
@@ -215,89 +636,123 @@ void update_thread_neighbors(void)
 		return;
 	}
 
-	/* Instance 0 always exists (created in init), so prev starts at 1 */
-	static int prev_count = 1;
-
-	openthread_mutex_lock();
-
-	/* Iterate OT neighbor table */
+	/* Copy the raw neighbor table under the OT mutex, format after */
+	static otNeighborInfo snap[NI_SNAPSHOT_MAX];
+	static int8_t snap_slot[NI_SNAPSHOT_MAX];
 	otNeighborInfoIterator iter = OT_NEIGHBOR_INFO_ITERATOR_INIT;
-	otNeighborInfo ninfo;
 	int count = 0;
 
-	while (otThreadGetNextNeighborInfo(ot, &iter, &ninfo) == OT_ERROR_NONE &&
-	       count < NI_MAX_INSTANCES) {
-
-		/* Update data buffer for this neighbor */
-		nd[count].role = ninfo.mIsChild ? 0 : 1;
-		snprintf(nd[count].rloc16_str, sizeof(nd[count].rloc16_str),
-			 "0x%04X", ninfo.mRloc16);
-		nd[count].age = (int32_t)ninfo.mAge;
-		nd[count].avg_rssi = (int32_t)ninfo.mAverageRssi;
-		nd[count].last_rssi = (int32_t)ninfo.mLastRssi;
-		nd[count].rx_on_idle = ninfo.mRxOnWhenIdle;
-		nd[count].ftd = ninfo.mFullThreadDevice;
-		nd[count].fnd = ninfo.mFullNetworkData;
-		format_ext_addr(ninfo.mExtAddress.m8, nd[count].ext_mac_str,
-				sizeof(nd[count].ext_mac_str));
-		nd[count].lqi_in = (int32_t)ninfo.mLinkQualityIn;
-		nd[count].lqi_out = 0; /* Not directly available in OT */
-		/* Frame/Message error rates: OT uses 0xFFFF scale -> convert to % */
-		nd[count].frame_error =
-			(double)ninfo.mFrameErrorRate * 100.0 / 0xFFFF;
-		nd[count].msg_error =
-			(double)ninfo.mMessageErrorRate * 100.0 / 0xFFFF;
-		nd[count].queued_msgs = 0; /* Not directly available */
-
+	openthread_mutex_lock();
+	while (count < NI_SNAPSHOT_MAX &&
+	       otThreadGetNextNeighborInfo(ot, &iter, &snap[count]) == OT_ERROR_NONE) {
 		count++;
 	}
-
 	openthread_mutex_unlock();
 
-	/* Keep at least instance 0 alive (created in init) */
-	int effective = count > 0 ? count : 1;
+	int added = 0, evicted = 0, untracked = 0, changed = 0;
 
-	/* Create new instances if effective > prev_count (instance 0 already exists) */
-	for (int i = prev_count; i < effective; i++) {
-		struct lwm2m_engine_obj_inst *inst = NULL;
-		int ret = lwm2m_create_obj_inst(THREAD_NEIGHBOR_OBJECT_ID, i, &inst);
-		if (ret < 0) {
-			LOG_ERR("Failed to create neighbor inst %d: %d", i, ret);
+	/* Known neighbors keep their slot */
+	for (int s = 0; s < NI_MAX_INSTANCES; s++) {
+		slots[s].seen = false;
+	}
+	for (int n = 0; n < count; n++) {
+		snap_slot[n] = index_find(&snap[n].mExtAddress);
+		if (snap_slot[n] >= 0) {
+			slots[snap_slot[n]].seen = true;
 		}
 	}
 
-	/* Delete excess instances if effective < prev_count (never delete inst 0) */
-	for (int i = effective; i < prev_count; i++) {
-		lwm2m_delete_object_inst(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, i));
-		neighbor_inst_created[i] = false;
+	/* Departed neighbors free their slot before newcomers are placed */
+	for (int s = 0; s < NI_MAX_INSTANCES; s++) {
+		if (slots[s].used && !slots[s].seen) {
+			neighbor_evict(s);
+			evicted++;
+		}
+	}
+
+	/* Newcomers take the lowest free slot */
+	for (int n = 0; n < count; n++) {
+		if (snap_slot[n] >= 0) {
+			continue;
+		}
+		snap_slot[n] = neighbor_insert(&snap[n].mExtAddress);
+		if (snap_slot[n] < 0) {
+			untracked++;
+		} else {
+			added++;
+		}
 	}
 
-	prev_count = effective;
+	for (int n = 0; n < count; n++) {
+		struct neighbor_data next;
 
-	/* Update string resources via lwm2m_set_string for proper data_len */
-	for (int i = 0; i < count; i++) {
-		lwm2m_set_string(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, i,
-					     NI_RLOC16_RID),
-				 nd[i].rloc16_str);
-		lwm2m_set_string(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, i,
-					     NI_EXT_MAC_RID),
-				 nd[i].ext_mac_str);
+		if (snap_slot[n] < 0) {
+			continue;
+		}
+		neighbor_data_from_info(&next, &snap[n]);
+		changed += neighbor_apply(snap_slot[n], &next);
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+		struct neighbor_link_data link;
+
+		link_data_from_ring(&link, snap_slot[n]);
+		changed += link_apply(snap_slot[n], &link);
+#endif
+	}
+
+	if (untracked > 0) {
+		LOG_WRN("Obj10485: %d neighbor(s) beyond %d instances not tracked",
+			untracked, NI_MAX_INSTANCES);
 	}
+	LOG_INF("Obj10485: %d neighbor(s), +%d -%d, %d resource(s) changed",
+		count - untracked, added, evicted, changed);
+}
 
-	/* If no neighbors, clear instance 0 with defaults */
-	if (count == 0) {
-		memset(&nd[0], 0, sizeof(nd[0]));
-		lwm2m_set_string(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, 0,
-					     NI_RLOC16_RID), "N/A");
-		lwm2m_set_string(&LWM2M_OBJ(THREAD_NEIGHBOR_OBJECT_ID, 0,
-					     NI_EXT_MAC_RID), "N/A");
+/* ================================================================
+ * Link-quality sampler — called from the Thread metrics work queue
+ *
+ * Same work queue as update_thread_neighbors(), so the slot mapping
+ * needs no extra locking. Neighbors not yet mapped to a slot are
+ * picked up after the next update.
+ * ================================================================ */
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+struct link_sample {
+	otExtAddress ext_addr;
+	int8_t rssi;
+	uint16_t frame_err;
+	uint16_t msg_err;
+};
+
+void sample_thread_neighbors(void)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	if (!ot) {
+		return;
 	}
 
-	/* Notify observers for all active instances */
-	for (int i = 0; i < effective; i++) {
-		lwm2m_notify_observer(THREAD_NEIGHBOR_OBJECT_ID, i, NI_AVG_RSSI_RID);
-		lwm2m_notify_observer(THREAD_NEIGHBOR_OBJECT_ID, i, NI_AGE_RID);
+	static struct link_sample samples[NI_SNAPSHOT_MAX];
+	otNeighborInfoIterator iter = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+	otNeighborInfo ninfo;
+	int count = 0;
+
+	/* Only the fields the ring needs, to keep the lock section short */
+	openthread_mutex_lock();
+	while (count < NI_SNAPSHOT_MAX &&
+	       otThreadGetNextNeighborInfo(ot, &iter, &ninfo) == OT_ERROR_NONE) {
+		samples[count].ext_addr = ninfo.mExtAddress;
+		samples[count].rssi = ninfo.mLastRssi;
+		samples[count].frame_err = ninfo.mFrameErrorRate;
+		samples[count].msg_err = ninfo.mMessageErrorRate;
+		count++;
 	}
+	openthread_mutex_unlock();
+
+	for (int n = 0; n < count; n++) {
+		int slot = index_find(&samples[n].ext_addr);
 
-	LOG_INF("Obj10485: %d neighbor(s) updated", count);
+		if (slot >= 0) {
+			link_ring_push(&slots[slot].ring, samples[n].rssi,
+				       samples[n].frame_err, samples[n].msg_err);
+		}
+	}
 }
+#endif /* CONFIG_AMI_NEIGHBOR_SAMPLER */
@@ -2,7 +2,14 @@
  * LwM2M Object 10485 — Thread Neighbor Information
  *
  * Standard OMA object (Hydro-Québec, 2023) for Thread neighbor
- * diagnostics. Multiple instances, one per neighbor.
+ * diagnostics. Multiple instances, one per neighbor. Only the
+ * registered resources 0-13 are served, so servers can use the
+ * registered DDF as is.
+ *
+ * Object 33005 — Thread Neighbor Link Statistics (custom,
+ * CONFIG_AMI_NEIGHBOR_SAMPLER): on-device window aggregates of each
+ * neighbor's link quality. Instance i describes the same neighbor as
+ * /10485/i and is created and deleted with it.
  */
 
 #ifndef LWM2M_OBJ_THREAD_NEIGHBOR_H
@@ -27,9 +34,32 @@
 #define NI_QUEUED_MSGS_RID        13  /* Integer: Queued message count */
 
 #define NI_NUM_FIELDS             14
-#define NI_MAX_INSTANCES          4   /* Max neighbors tracked */
+#define NI_MAX_INSTANCES          CONFIG_AMI_NEIGHBOR_MAX_INSTANCES
+
+#define NEIGHBOR_LINK_OBJECT_ID   33005
+
+/* Resource IDs (Object 33005) */
+#define NL_RSSI_MIN_RID           0   /* Integer: Min last RSSI in window (dBm) */
+#define NL_RSSI_MAX_RID           1   /* Integer: Max last RSSI in window (dBm) */
+#define NL_RSSI_MEAN_RID          2   /* Float: Mean last RSSI in window (dBm) */
+#define NL_RSSI_P95_RID           3   /* Integer: 95th percentile RSSI (dBm) */
+#define NL_FRAME_ERR_MEAN_RID     4   /* Float: Mean frame error % in window */
+#define NL_FRAME_ERR_MAX_RID      5   /* Float: Max frame error % in window */
+#define NL_MSG_ERR_MEAN_RID       6   /* Float: Mean message error % in window */
+#define NL_SAMPLES_RID            7   /* Integer: Samples in window */
+
+#define NL_NUM_FIELDS             8
 
 void init_thread_neighbor_object(void);
 void update_thread_neighbors(void);
 
+/**
+ * @brief Sample link quality of tracked neighbors into their rings
+ *
+ * Runs on the Thread metrics work queue every
+ * CONFIG_AMI_NEIGHBOR_SAMPLE_INTERVAL_MS. Aggregates are published
+ * to Object 33005 by update_thread_neighbors().
+ */
+void sample_thread_neighbors(void);
+
 #endif /* LWM2M_OBJ_THREAD_NEIGHBOR_H */
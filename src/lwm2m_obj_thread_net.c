@@ -4,7 +4,10 @@
  * Standard OMA object for Thread network configuration and identity.
  * Provides network name, PAN ID, channel, RLOC16, EUI64, IPv6 addresses, etc.
  *
- * All readable data comes from OpenThread APIs.
+ * All readable data comes from OpenThread APIs, fetched lazily by a
+ * read callback when the server reads. Observers are notified only on
+ * OpenThread state changes (role, RLOC, addresses, dataset), so an idle
+ * network costs no CPU, lock time or CoAP traffic.
  * Writable resources (Name, PAN, Channel, etc.) are exposed for
  * server-side configuration but Write operations are not yet implemented.
  */
@@ -21,6 +24,7 @@
 #include <openthread/platform/radio.h>
 
 #include "lwm2m_obj_thread_net.h"
+#include "thread_metrics.h"
 
 /* Internal headers for custom object creation */
 #include "lwm2m_object.h"
@@ -127,6 +131,293 @@ static void format_ext_addr(const uint8_t *addr, char *buf, size_t len)
 		 addr[4], addr[5], addr[6], addr[7]);
 }
 
+/* ================================================================
+ * Lazy reads — values are fetched from OpenThread when the server
+ * reads (or an observation fires), never on a timer. Each fetch takes
+ * the OT mutex only long enough to copy the raw value.
+ * ================================================================ */
+
+/* Index-th valid unicast address; false if there are fewer */
+static bool fetch_ipv6(struct otInstance *ot, int index, otIp6Address *out)
+{
+	const otNetifAddress *addr;
+	bool found = false;
+
+	openthread_mutex_lock();
+	for (addr = otIp6GetUnicastAddresses(ot); addr != NULL;
+	     addr = addr->mNext) {
+		if (addr->mValid && index-- == 0) {
+			*out = addr->mAddress;
+			found = true;
+			break;
+		}
+	}
+	openthread_mutex_unlock();
+
+	return found;
+}
+
+static int count_ipv6(struct otInstance *ot)
+{
+	const otNetifAddress *addr;
+	int count = 0;
+
+	openthread_mutex_lock();
+	for (addr = otIp6GetUnicastAddresses(ot);
+	     addr != NULL && count < TN_MAX_IPV6; addr = addr->mNext) {
+		if (addr->mValid) {
+			count++;
+		}
+	}
+	openthread_mutex_unlock();
+
+	return count;
+}
+
+static void *thread_net_read_cb(uint16_t obj_inst_id, uint16_t res_id,
+				uint16_t res_inst_id, size_t *data_len)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	/* static: otOperationalDataset is large for the engine stack */
+	static otOperationalDataset ds;
+	bool ds_valid;
+	otMeshLocalPrefix mlp;
+	otExtAddress ext;
+	otIp6Address ip;
+	uint16_t rloc16;
+	char *str = NULL;
+
+	ARG_UNUSED(obj_inst_id);
+
+	if (!ot) {
+		goto fallback;
+	}
+
+	switch (res_id) {
+	case TN_NET_NAME_RID:
+	case TN_PAN_ID_RID:
+	case TN_XPAN_ID_RID:
+		openthread_mutex_lock();
+		ds_valid = (otDatasetGetActive(ot, &ds) == OT_ERROR_NONE);
+		openthread_mutex_unlock();
+		if (!ds_valid) {
+			break;
+		}
+		if (res_id == TN_NET_NAME_RID &&
+		    ds.mComponents.mIsNetworkNamePresent) {
+			strncpy(net_name, ds.mNetworkName.m8, sizeof(net_name) - 1);
+			net_name[sizeof(net_name) - 1] = '\0';
+		} else if (res_id == TN_PAN_ID_RID &&
+			   ds.mComponents.mIsPanIdPresent) {
+			snprintf(pan_id_str, sizeof(pan_id_str), "0x%04X",
+				 ds.mPanId);
+		} else if (res_id == TN_XPAN_ID_RID &&
+			   ds.mComponents.mIsExtendedPanIdPresent) {
+			format_ext_addr(ds.mExtendedPanId.m8, xpan_id_str,
+					sizeof(xpan_id_str));
+		}
+		break;
+
+	case TN_CHANNEL_RID:
+		openthread_mutex_lock();
+		channel_val = (int32_t)otLinkGetChannel(ot);
+		openthread_mutex_unlock();
+		*data_len = sizeof(channel_val);
+		return &channel_val;
+
+	case TN_MESH_PREFIX_RID: {
+		const otMeshLocalPrefix *p;
+		bool valid = false;
+
+		openthread_mutex_lock();
+		p = otThreadGetMeshLocalPrefix(ot);
+		if (p) {
+			mlp = *p;
+			valid = true;
+		}
+		openthread_mutex_unlock();
+		if (valid) {
+			snprintf(mesh_prefix_str, sizeof(mesh_prefix_str),
+				 "%02x%02x:%02x%02x:%02x%02x:%02x%02x::/64",
+				 mlp.m8[0], mlp.m8[1], mlp.m8[2], mlp.m8[3],
+				 mlp.m8[4], mlp.m8[5], mlp.m8[6], mlp.m8[7]);
+		}
+		break;
+	}
+
+	case TN_RLOC16_RID:
+		openthread_mutex_lock();
+		rloc16 = otThreadGetRloc16(ot);
+		openthread_mutex_unlock();
+		snprintf(rloc16_str, sizeof(rloc16_str), "0x%04X", rloc16);
+		break;
+
+	case TN_EUI64_RID:
+		openthread_mutex_lock();
+		otLinkGetFactoryAssignedIeeeEui64(ot, &ext);
+		openthread_mutex_unlock();
+		format_ext_addr(ext.m8, eui64_str, sizeof(eui64_str));
+		break;
+
+	case TN_EXT_MAC_RID: {
+		const otExtAddress *p;
+		bool valid = false;
+
+		openthread_mutex_lock();
+		p = otLinkGetExtendedAddress(ot);
+		if (p) {
+			ext = *p;
+			valid = true;
+		}
+		openthread_mutex_unlock();
+		if (valid) {
+			format_ext_addr(ext.m8, ext_mac_str, sizeof(ext_mac_str));
+		}
+		break;
+	}
+
+	case TN_IPV6_ADDRS_RID:
+		if (res_inst_id >= TN_MAX_IPV6) {
+			break;
+		}
+		if (fetch_ipv6(ot, res_inst_id, &ip)) {
+			otIp6AddressToString(&ip, ip_strs[res_inst_id],
+					     sizeof(ip_strs[res_inst_id]));
+		} else {
+			ip_strs[res_inst_id][0] = '\0';
+		}
+		str = ip_strs[res_inst_id];
+		break;
+
+	default:
+		break;
+	}
+
+fallback:
+	/* Strings (and constants) are served from their static buffers */
+	switch (res_id) {
+	case TN_NET_NAME_RID:     str = net_name; break;
+	case TN_PAN_ID_RID:       str = pan_id_str; break;
+	case TN_XPAN_ID_RID:      str = xpan_id_str; break;
+	case TN_PASSPHRASE_RID:   str = passphrase; break;
+	case TN_MASTER_KEY_RID:   str = master_key; break;
+	case TN_MESH_PREFIX_RID:  str = mesh_prefix_str; break;
+	case TN_RLOC16_RID:       str = rloc16_str; break;
+	case TN_EUI64_RID:        str = eui64_str; break;
+	case TN_EXT_MAC_RID:      str = ext_mac_str; break;
+	case TN_CHANNEL_RID:
+		*data_len = sizeof(channel_val);
+		return &channel_val;
+	case TN_MAX_CHILDREN_RID:
+		*data_len = sizeof(max_children_val);
+		return &max_children_val;
+	default:
+		break;
+	}
+
+	if (!str) {
+		*data_len = 0;
+		return NULL;
+	}
+	*data_len = strlen(str) + 1;
+	return str;
+}
+
+/* ================================================================
+ * Push on OpenThread state changes
+ *
+ * The OT callback runs in the OpenThread thread with its mutex held,
+ * so it only latches the flags; notifications are sent from the
+ * Thread metrics work queue.
+ * ================================================================ */
+static const struct {
+	otChangedFlags flags;
+	uint16_t rid;
+} tn_notify_map[] = {
+	{ OT_CHANGED_THREAD_NETWORK_NAME | OT_CHANGED_ACTIVE_DATASET,
+	  TN_NET_NAME_RID },
+	{ OT_CHANGED_THREAD_PANID | OT_CHANGED_ACTIVE_DATASET,
+	  TN_PAN_ID_RID },
+	{ OT_CHANGED_THREAD_EXT_PANID | OT_CHANGED_ACTIVE_DATASET,
+	  TN_XPAN_ID_RID },
+	{ OT_CHANGED_THREAD_CHANNEL, TN_CHANNEL_RID },
+	{ OT_CHANGED_THREAD_ML_ADDR | OT_CHANGED_ACTIVE_DATASET,
+	  TN_MESH_PREFIX_RID },
+	{ OT_CHANGED_THREAD_ROLE | OT_CHANGED_THREAD_RLOC_ADDED |
+	  OT_CHANGED_THREAD_RLOC_REMOVED, TN_RLOC16_RID },
+	{ OT_CHANGED_IP6_ADDRESS_ADDED | OT_CHANGED_IP6_ADDRESS_REMOVED,
+	  TN_IPV6_ADDRS_RID },
+};
+
+#define TN_WATCHED_FLAGS  (OT_CHANGED_THREAD_NETWORK_NAME |            \
+			   OT_CHANGED_ACTIVE_DATASET |                 \
+			   OT_CHANGED_THREAD_PANID |                   \
+			   OT_CHANGED_THREAD_EXT_PANID |               \
+			   OT_CHANGED_THREAD_CHANNEL |                 \
+			   OT_CHANGED_THREAD_ML_ADDR |                 \
+			   OT_CHANGED_THREAD_ROLE |                    \
+			   OT_CHANGED_THREAD_RLOC_ADDED |              \
+			   OT_CHANGED_THREAD_RLOC_REMOVED |            \
+			   OT_CHANGED_IP6_ADDRESS_ADDED |              \
+			   OT_CHANGED_IP6_ADDRESS_REMOVED)
+
+static atomic_t tn_pending_flags;
+static struct k_work tn_event_work;
+static struct openthread_state_changed_callback tn_ot_cb;
+static int ip_inst_count;
+
+/* Keep one resource instance per valid IPv6 address */
+static void sync_ipv6_instances(struct otInstance *ot)
+{
+	int count = count_ipv6(ot);
+
+	for (int i = ip_inst_count; i < count; i++) {
+		lwm2m_create_res_inst(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
+						  TN_IPV6_ADDRS_RID, i));
+	}
+	for (int i = count; i < ip_inst_count; i++) {
+		lwm2m_delete_res_inst(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
+						  TN_IPV6_ADDRS_RID, i));
+	}
+	ip_inst_count = count;
+}
+
+static void tn_event_work_handler(struct k_work *work)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	otChangedFlags flags = (otChangedFlags)atomic_clear(&tn_pending_flags);
+
+	ARG_UNUSED(work);
+
+	if (!ot || flags == 0) {
+		return;
+	}
+
+	if (flags & (OT_CHANGED_IP6_ADDRESS_ADDED |
+		     OT_CHANGED_IP6_ADDRESS_REMOVED)) {
+		sync_ipv6_instances(ot);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(tn_notify_map); i++) {
+		if (flags & tn_notify_map[i].flags) {
+			lwm2m_notify_observer(THREAD_NET_OBJECT_ID, 0,
+					      tn_notify_map[i].rid);
+		}
+	}
+
+	LOG_DBG("Obj10483: state change 0x%08x, %d IPv6", flags, ip_inst_count);
+}
+
+static void tn_ot_state_changed(otChangedFlags flags, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (flags & TN_WATCHED_FLAGS) {
+		atomic_or(&tn_pending_flags, (atomic_val_t)flags);
+		thread_metrics_submit(&tn_event_work);
+	}
+}
+
 /* ================================================================
  * Initialization
  * ================================================================ */
@@ -153,59 +444,6 @@ void init_thread_net_object(void)
 	/* Set initial defaults */
 	strncpy(net_name, "unknown", sizeof(net_name));
 	strncpy(pan_id_str, "0x0000", sizeof(pan_id_str));
-	max_children_val = 0;
-
-	LOG_INF("Object 10483 (Thread Network) initialized");
-}
-
-/* ================================================================
- * Periodic update — called from main loop
- * ================================================================ */
-void update_thread_network(void)
-{
-	struct otInstance *ot = openthread_get_default_instance();
-	if (!ot) {
-		return;
-	}
-
-	openthread_mutex_lock();
-
-	/* ---- Active Dataset info ---- */
-	otOperationalDataset dataset;
-	if (otDatasetGetActive(ot, &dataset) == OT_ERROR_NONE) {
-		if (dataset.mComponents.mIsNetworkNamePresent) {
-			strncpy(net_name, dataset.mNetworkName.m8, sizeof(net_name) - 1);
-			net_name[sizeof(net_name) - 1] = '\0';
-		}
-		if (dataset.mComponents.mIsPanIdPresent) {
-			snprintf(pan_id_str, sizeof(pan_id_str), "0x%04X",
-				 dataset.mPanId);
-		}
-		if (dataset.mComponents.mIsExtendedPanIdPresent) {
-			snprintf(xpan_id_str, sizeof(xpan_id_str),
-				 "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
-				 dataset.mExtendedPanId.m8[0],
-				 dataset.mExtendedPanId.m8[1],
-				 dataset.mExtendedPanId.m8[2],
-				 dataset.mExtendedPanId.m8[3],
-				 dataset.mExtendedPanId.m8[4],
-				 dataset.mExtendedPanId.m8[5],
-				 dataset.mExtendedPanId.m8[6],
-				 dataset.mExtendedPanId.m8[7]);
-		}
-	}
-
-	/* ---- Channel ---- */
-	channel_val = (int32_t)otLinkGetChannel(ot);
-
-	/* ---- Mesh Local Prefix ---- */
-	const otMeshLocalPrefix *mlp = otThreadGetMeshLocalPrefix(ot);
-	if (mlp) {
-		snprintf(mesh_prefix_str, sizeof(mesh_prefix_str),
-			 "%02x%02x:%02x%02x:%02x%02x:%02x%02x::/64",
-			 mlp->m8[0], mlp->m8[1], mlp->m8[2], mlp->m8[3],
-			 mlp->m8[4], mlp->m8[5], mlp->m8[6], mlp->m8[7]);
-	}
 
 	/* ---- Max Children (from config, if FTD) ---- */
 #if defined(CONFIG_OPENTHREAD_FTD)
@@ -218,68 +456,34 @@ void update_thread_network(void)
 	max_children_val = 0;
 #endif
 
-	/* ---- RLOC16 ---- */
-	snprintf(rloc16_str, sizeof(rloc16_str), "0x%04X",
-		 otThreadGetRloc16(ot));
-
-	/* ---- EUI64 ---- */
-	otExtAddress eui64;
-	otLinkGetFactoryAssignedIeeeEui64(ot, &eui64);
-	format_ext_addr(eui64.m8, eui64_str, sizeof(eui64_str));
-
-	/* ---- Extended MAC Address ---- */
-	const otExtAddress *ext_mac = otLinkGetExtendedAddress(ot);
-	if (ext_mac) {
-		format_ext_addr(ext_mac->m8, ext_mac_str, sizeof(ext_mac_str));
-	}
-
-	/* ---- IPv6 Addresses ---- */
-	int ip_count = 0;
-	const otNetifAddress *addr = otIp6GetUnicastAddresses(ot);
-	for (; addr != NULL && ip_count < TN_MAX_IPV6; addr = addr->mNext) {
-		if (!addr->mValid) {
-			continue;
-		}
-		otIp6AddressToString(&addr->mAddress, ip_strs[ip_count],
-				     sizeof(ip_strs[ip_count]));
-		ip_count++;
-	}
-
-	/* ---- Extended PAN ID resource instance ---- */
-	static bool xpan_created = false;
-	if (!xpan_created && xpan_id_str[0] != '\0') {
-		lwm2m_create_res_inst(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
-						  TN_XPAN_ID_RID, 0));
-		xpan_created = true;
-	}
-	if (xpan_created) {
-		lwm2m_set_res_buf(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
-					      TN_XPAN_ID_RID, 0),
-				  xpan_id_str, sizeof(xpan_id_str),
-				  strlen(xpan_id_str) + 1, 0);
+	/* Every readable resource is served by the read callback */
+	static const uint16_t lazy_rids[] = {
+		TN_NET_NAME_RID, TN_PAN_ID_RID, TN_XPAN_ID_RID,
+		TN_PASSPHRASE_RID, TN_MASTER_KEY_RID, TN_CHANNEL_RID,
+		TN_MESH_PREFIX_RID, TN_MAX_CHILDREN_RID, TN_RLOC16_RID,
+		TN_EUI64_RID, TN_EXT_MAC_RID, TN_IPV6_ADDRS_RID,
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(lazy_rids); i++) {
+		lwm2m_register_read_callback(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
+							lazy_rids[i]),
+					     thread_net_read_cb);
 	}
 
-	openthread_mutex_unlock();
+	/* Extended PAN ID: single resource instance, always present */
+	lwm2m_create_res_inst(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
+					  TN_XPAN_ID_RID, 0));
 
-	/* ---- Update IPv6 address resource instances ---- */
-	static int prev_ip_count = 0;
-	for (int i = 0; i < ip_count; i++) {
-		if (i >= prev_ip_count) {
-			lwm2m_create_res_inst(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
-							  TN_IPV6_ADDRS_RID, i));
-		}
-		lwm2m_set_res_buf(&LWM2M_OBJ(THREAD_NET_OBJECT_ID, 0,
-					      TN_IPV6_ADDRS_RID, i),
-				  ip_strs[i], sizeof(ip_strs[i]),
-				  strlen(ip_strs[i]) + 1, 0);
+	struct otInstance *ot = openthread_get_default_instance();
+	if (ot) {
+		sync_ipv6_instances(ot);
 	}
-	prev_ip_count = ip_count;
 
-	/* ---- Notify observers ---- */
-	lwm2m_notify_observer(THREAD_NET_OBJECT_ID, 0, TN_RLOC16_RID);
-	lwm2m_notify_observer(THREAD_NET_OBJECT_ID, 0, TN_CHANNEL_RID);
-	lwm2m_notify_observer(THREAD_NET_OBJECT_ID, 0, TN_IPV6_ADDRS_RID);
+	k_work_init(&tn_event_work, tn_event_work_handler);
+	tn_ot_cb.otCallback = tn_ot_state_changed;
+	tn_ot_cb.user_data = NULL;
+	openthread_state_changed_callback_register(&tn_ot_cb);
 
-	LOG_INF("Obj10483: net=%s PAN=%s ch=%d RLOC=%s IPs=%d",
-		net_name, pan_id_str, channel_val, rloc16_str, ip_count);
+	LOG_INF("Object 10483 (Thread Network) initialized (lazy reads, "
+		"%d IPv6)", ip_inst_count);
 }
@@ -28,6 +28,5 @@
 #define TN_MAX_IPV6              4   /* Max IPv6 addresses */
 
 void init_thread_net_object(void);
-void update_thread_network(void);
 
 #endif /* LWM2M_OBJ_THREAD_NET_H */
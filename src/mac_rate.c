@@ -0,0 +1,129 @@
+/*
+ * MAC Rate — see mac_rate.h
+ */
+
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <string.h>
+
+#include "mac_rate.h"
+
+#define MAC_RATE_SLOTS  (MAC_RATE_WINDOW + 1)
+
+BUILD_ASSERT(MAC_RATE_WINDOW >= 1 && MAC_RATE_SLOTS <= 255,
+	     "MAC_RATE_WINDOW must fit the uint8_t ring indices");
+
+static const struct mac_sample *newest(const struct mac_rate_window *w)
+{
+	return &w->s[(w->head + MAC_RATE_SLOTS - 1) % MAC_RATE_SLOTS];
+}
+
+static const struct mac_sample *oldest(const struct mac_rate_window *w)
+{
+	return &w->s[(w->head + MAC_RATE_SLOTS - w->count) % MAC_RATE_SLOTS];
+}
+
+static bool is_reset(uint32_t prev, uint32_t next)
+{
+	return (uint32_t)(next - prev) >= MAC_RATE_MAX_DELTA;
+}
+
+void mac_rate_init(struct mac_rate_window *w)
+{
+	memset(w, 0, sizeof(*w));
+}
+
+bool mac_rate_push(struct mac_rate_window *w, const struct mac_sample *s)
+{
+	bool reset = false;
+
+	if (w->count > 0) {
+		const struct mac_sample *prev = newest(w);
+
+		if (is_reset(prev->tx_total, s->tx_total) ||
+		    is_reset(prev->rx_total, s->rx_total) ||
+		    is_reset(prev->tx_err, s->tx_err) ||
+		    is_reset(prev->rx_err, s->rx_err)) {
+			w->head = 0;
+			w->count = 0;
+			w->resets++;
+			reset = true;
+		}
+	}
+
+	w->s[w->head] = *s;
+	w->head = (w->head + 1) % MAC_RATE_SLOTS;
+	if (w->count < MAC_RATE_SLOTS) {
+		w->count++;
+	}
+
+	return reset;
+}
+
+int mac_rate_get(const struct mac_rate_window *w, struct mac_rates *out)
+{
+	if (!w || !out) {
+		return -EINVAL;
+	}
+	if (w->count < 2) {
+		return -ENODATA;
+	}
+
+	const struct mac_sample *a = oldest(w);
+	const struct mac_sample *b = newest(w);
+	int64_t span = b->t_ms - a->t_ms;
+
+	if (span <= 0) {
+		return -ENODATA;
+	}
+
+	/* Unsigned deltas stay correct across a 32-bit wrap */
+	uint32_t d_tx = b->tx_total - a->tx_total;
+	uint32_t d_rx = b->rx_total - a->rx_total;
+	uint32_t d_tx_err = b->tx_err - a->tx_err;
+	uint32_t d_rx_err = b->rx_err - a->rx_err;
+
+	out->span_ms = (uint32_t)span;
+	out->tx_fps = (double)d_tx * 1000.0 / (double)span;
+	out->rx_fps = (double)d_rx * 1000.0 / (double)span;
+	/* mTxTotal counts attempts, failed ones included */
+	out->tx_err_pct = d_tx ? (double)d_tx_err * 100.0 / d_tx : 0.0;
+	/* RX errors relative to good + errored frames */
+	out->rx_err_pct = (d_rx + d_rx_err) ?
+		(double)d_rx_err * 100.0 / ((double)d_rx + d_rx_err) : 0.0;
+
+	return 0;
+}
+
+static bool fps_moved(double last, double now)
+{
+	double d = fabs(now - last);
+
+	return d >= MAC_RATE_FPS_FLOOR &&
+	       d > fabs(last) * MAC_RATE_FPS_STEP_PCT / 100.0;
+}
+
+static bool pct_moved(double last, double now)
+{
+	return fabs(now - last) >= MAC_RATE_ERR_STEP_PCT;
+}
+
+uint32_t mac_rate_changes(const struct mac_rates *last,
+			  const struct mac_rates *now)
+{
+	uint32_t changed = 0;
+
+	if (fps_moved(last->tx_fps, now->tx_fps)) {
+		changed |= MAC_RATE_TX_FPS;
+	}
+	if (fps_moved(last->rx_fps, now->rx_fps)) {
+		changed |= MAC_RATE_RX_FPS;
+	}
+	if (pct_moved(last->tx_err_pct, now->tx_err_pct)) {
+		changed |= MAC_RATE_TX_ERR_PCT;
+	}
+	if (pct_moved(last->rx_err_pct, now->rx_err_pct)) {
+		changed |= MAC_RATE_RX_ERR_PCT;
+	}
+	return changed;
+}
@@ -0,0 +1,118 @@
+/*
+ * MAC Rate — sliding-window rates over cumulative MAC counters
+ *
+ * OpenThread MAC counters are cumulative 32-bit values that restart
+ * at zero on reboot or otLinkResetCounters(). Object 33000 samples
+ * them periodically into a window of MAC_RATE_WINDOW intervals and
+ * publishes frames per second and error ratios computed on-device,
+ * so the server no longer differences raw totals itself.
+ *
+ * Wrap-around is handled with unsigned deltas; a decrease too large
+ * to be a wrap is reported as a counter reset and restarts the window.
+ *
+ * The window is sampled more often than the rates are worth
+ * notifying: mac_rate_changes() tells which rates moved far enough
+ * from their last published value to be published again.
+ *
+ * Pure C, no OpenThread dependency, so it is unit-tested natively.
+ */
+
+#ifndef MAC_RATE_H_
+#define MAC_RATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(CONFIG_AMI_MAC_RATE_WINDOW)
+#define MAC_RATE_WINDOW  CONFIG_AMI_MAC_RATE_WINDOW
+#else
+#define MAC_RATE_WINDOW  6
+#endif
+
+/* A forward step larger than this between two samples is a reset */
+#define MAC_RATE_MAX_DELTA  0x80000000u
+
+/* Change thresholds for republishing a rate (mac_rate_changes()) */
+#if defined(CONFIG_AMI_MAC_RATE_FPS_STEP_PCT)
+#define MAC_RATE_FPS_STEP_PCT  CONFIG_AMI_MAC_RATE_FPS_STEP_PCT
+#else
+#define MAC_RATE_FPS_STEP_PCT  20
+#endif
+#if defined(CONFIG_AMI_MAC_RATE_ERR_STEP_PCT)
+#define MAC_RATE_ERR_STEP_PCT  CONFIG_AMI_MAC_RATE_ERR_STEP_PCT
+#else
+#define MAC_RATE_ERR_STEP_PCT  2
+#endif
+
+/* Smallest frame-rate change worth a notification (frames/s) */
+#define MAC_RATE_FPS_FLOOR  0.1
+
+/* mac_rate_changes() bits */
+#define MAC_RATE_TX_FPS      (1u << 0)
+#define MAC_RATE_RX_FPS      (1u << 1)
+#define MAC_RATE_TX_ERR_PCT  (1u << 2)
+#define MAC_RATE_RX_ERR_PCT  (1u << 3)
+
+/* One reading of the counters the rates are built from */
+struct mac_sample {
+	int64_t  t_ms;       /* k_uptime_get() at sampling */
+	uint32_t tx_total;   /* mTxTotal */
+	uint32_t rx_total;   /* mRxTotal */
+	uint32_t tx_err;     /* CCA + abort + busy-channel failures */
+	uint32_t rx_err;     /* no-frame, unknown neighbor, src, sec, FCS, other */
+};
+
+/* Window of MAC_RATE_WINDOW intervals (one more sample than intervals) */
+struct mac_rate_window {
+	struct mac_sample s[MAC_RATE_WINDOW + 1];
+	uint8_t  head;       /* next write position */
+	uint8_t  count;      /* valid samples */
+	uint32_t resets;     /* counter resets detected */
+};
+
+/* Rates between the oldest and newest sample in the window */
+struct mac_rates {
+	double   tx_fps;       /* frames per second */
+	double   rx_fps;
+	double   tx_err_pct;   /* failed TX / TX attempts, percent */
+	double   rx_err_pct;   /* RX errors / (RX + RX errors), percent */
+	uint32_t span_ms;      /* time covered by the window */
+};
+
+/**
+ * @brief Empty the window and clear the reset count
+ */
+void mac_rate_init(struct mac_rate_window *w);
+
+/**
+ * @brief Add a sample, detecting counter resets
+ *
+ * @return true if the counters went backwards (reset); the window then
+ *         restarts from this sample and w->resets is incremented
+ */
+bool mac_rate_push(struct mac_rate_window *w, const struct mac_sample *s);
+
+/**
+ * @brief Compute rates over the current window
+ *
+ * @return 0 on success, -ENODATA with fewer than two samples or a
+ *         zero time span, -EINVAL on NULL
+ */
+int mac_rate_get(const struct mac_rate_window *w, struct mac_rates *out);
+
+/**
+ * @brief Which rates moved enough since they were last published
+ *
+ * A frame rate counts as changed when it differs from @p last by more
+ * than MAC_RATE_FPS_STEP_PCT percent of @p last and by at least
+ * MAC_RATE_FPS_FLOOR frames/s; an error ratio when it differs by at
+ * least MAC_RATE_ERR_STEP_PCT percentage points.
+ *
+ * @param last  Values last published
+ * @param now   Values just computed
+ * @return MAC_RATE_* bits of the rates to publish (0 if none)
+ */
+uint32_t mac_rate_changes(const struct mac_rates *last,
+			  const struct mac_rates *now);
+
+#endif /* MAC_RATE_H_ */
@@ -34,6 +34,28 @@
 #include "lwm2m_obj_thread_cli.h"
 #include "lwm2m_observation.h"
 #include "dlms_meter.h"
+#include "telemetry_uplink.h"
+#include "thread_metrics.h"
+#include "log_gate.h"
+#ifdef CONFIG_AMI_STORE_FORWARD
+#include "reading_store.h"
+#endif
+#ifdef CONFIG_AMI_AIRTIME
+#include "airtime.h"
+#endif
+#ifdef CONFIG_AMI_SSED
+#include "sed_profile.h"
+#endif
+#ifdef CONFIG_AMI_SEND_WINDOW
+#include "send_window.h"
+#endif
+#ifdef CONFIG_AMI_DLMS_LATENCY
+#include "dlms_latency.h"
+#endif
+#ifdef CONFIG_AMI_DLMS_HEALTH
+#include "dlms_health.h"
+#endif
+#include "trace.h"
 
 /* Firmware update (Object 5) */
 extern void init_firmware_update(void);
@@ -41,7 +63,6 @@ extern void init_firmware_update(void);
 /* Thread connectivity monitoring (Objects 4 + 33000) */
 extern void init_connmon_thread(void);
 extern void init_thread_diag_object(void);
-extern void update_connectivity_metrics(void);
 
 LOG_MODULE_REGISTER(ami_lwm2m, LOG_LEVEL_INF);
 
@@ -60,7 +81,6 @@ static char endpoint_name[32];
 
 /* Sensor update intervals */
 #define DLMS_POLL_INTERVAL_DEFAULT  15   /* seconds — default DLMS meter poll */
-#define CONN_UPDATE_INTERVAL_S     60   /* seconds — RSSI/LQI/Thread update (v0.18.0) */
 #define LOOP_TICK              K_MSEC(500)     /* Main loop tick */
 
 /* Runtime-configurable DLMS poll interval (seconds).
@@ -107,6 +127,13 @@ static void rd_client_event(struct lwm2m_ctx *client,
 	case LWM2M_RD_CLIENT_EVENT_REGISTRATION_COMPLETE:
 		LOG_INF("LwM2M Registration complete!");
 		lwm2m_connected = true;
+		uplink_set_registered(true);
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_set_registered(true);
+#endif
+#ifdef CONFIG_AMI_STORE_FORWARD
+		store_drain_kick();
+#endif
 		if (gpio_is_ready_dt(&led0)) {
 			gpio_pin_set_dt(&led0, 1);
 		}
@@ -114,24 +141,55 @@ static void rd_client_event(struct lwm2m_ctx *client,
 	case LWM2M_RD_CLIENT_EVENT_REGISTRATION_FAILURE:
 		LOG_ERR("LwM2M Registration FAILED");
 		lwm2m_connected = false;
+		uplink_set_registered(false);
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_set_registered(false);
+#endif
 		break;
 	case LWM2M_RD_CLIENT_EVENT_REG_TIMEOUT:
 		LOG_WRN("LwM2M Registration timeout");
 		lwm2m_connected = false;
+		uplink_set_registered(false);
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_set_registered(false);
+#endif
 		break;
 	case LWM2M_RD_CLIENT_EVENT_REG_UPDATE_COMPLETE:
 		LOG_DBG("LwM2M Registration update complete");
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_update_done();
+#endif
+#ifdef CONFIG_AMI_STORE_FORWARD
+		/* Resume a drain that stopped on a failed Send */
+		store_drain_kick();
+#endif
 		break;
 	case LWM2M_RD_CLIENT_EVENT_DISCONNECT:
 		LOG_WRN("LwM2M Disconnected");
 		lwm2m_connected = false;
+		uplink_set_registered(false);
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_set_registered(false);
+#endif
 		if (gpio_is_ready_dt(&led0)) {
 			gpio_pin_set_dt(&led0, 0);
 		}
 		break;
+#if defined(CONFIG_LWM2M_QUEUE_MODE_ENABLED)
+	case LWM2M_RD_CLIENT_EVENT_QUEUE_MODE_RX_OFF:
+		LOG_DBG("LwM2M queue mode: RX window closed");
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_rx_off();
+#endif
+		break;
+#endif
 	case LWM2M_RD_CLIENT_EVENT_NETWORK_ERROR:
 		LOG_ERR("LwM2M network error — will retry");
 		lwm2m_connected = false;
+		uplink_set_registered(false);
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_set_registered(false);
+#endif
 		break;
 	default:
 		LOG_DBG("LwM2M event: %d", client_event);
@@ -172,7 +230,7 @@ static int lwm2m_setup(void)
 
 	/* Server Object (1) */
 	lwm2m_set_u16(&LWM2M_OBJ(1, 0, 0), 101); /* Short Server ID */
-	lwm2m_set_u32(&LWM2M_OBJ(1, 0, 1), 300); /* Lifetime = 300s */
+	lwm2m_set_u32(&LWM2M_OBJ(1, 0, 1), CONFIG_AMI_LWM2M_LIFETIME);
 
 	/* Device Object (3) */
 	lwm2m_set_res_buf(&LWM2M_OBJ(3, 0, 0),
@@ -214,6 +272,26 @@ static int lwm2m_setup(void)
 	init_thread_commission_object();
 	init_thread_cli_object();
 
+#ifdef CONFIG_AMI_AIRTIME
+	/* Airtime accounting per object ID (Object 33001) */
+	init_airtime_object();
+#endif
+
+#ifdef CONFIG_AMI_DLMS_LATENCY
+	/* DLMS latency histograms (Object 33003) */
+	init_dlms_latency_object();
+#endif
+
+#ifdef CONFIG_AMI_DLMS_HEALTH
+	/* DLMS poll service level (Object 33004) */
+	init_dlms_health_object(&client_ctx);
+#endif
+
+#ifdef CONFIG_AMI_TRACE
+	/* Poll pipeline trace dump (Object 33002) */
+	init_trace_object();
+#endif
+
 	LOG_INF("LwM2M objects configured");
 	LOG_INF("  Server: %s", LWM2M_SERVER_URI);
 	LOG_INF("  Endpoint: %s", endpoint_name);
@@ -274,8 +352,15 @@ static void update_sensors(void)
 		meter_initialized = true;
 	}
 
-	/* Full poll cycle: connect → read → disconnect */
+	/* Full poll cycle: connect → read → disconnect. No console output
+	 * meanwhile with CONFIG_AMI_LOG_GATE; it resumes after the poll.
+	 */
+	log_gate_hold();
 	ret = meter_poll(&last_readings);
+	log_gate_release();
+#ifdef CONFIG_AMI_DLMS_HEALTH
+	dlms_health_update();
+#endif
 	if (ret < 0) {
 		consecutive_meter_failures++;
 		if (consecutive_meter_failures >= MAX_CONSEC_FAILURES) {
@@ -298,6 +383,39 @@ static void update_sensors(void)
 	}
 	consecutive_meter_failures = 0;
 
+#ifdef CONFIG_AMI_SSED
+	/*
+	 * SSED: every reading is buffered; the radio wakes once per batch
+	 * to drain them in one time-series Send. The send window fast-polls
+	 * for the ACK, a due registration update and queued server requests.
+	 * Nothing is notified, so this needs a server that accepts Send.
+	 */
+	if (meter_readings_usable(&last_readings)) {
+		store_put(&last_readings);
+	}
+	if (lwm2m_connected && sed_batch_due()) {
+		store_drain_kick();
+		send_window_open();
+	}
+	return;
+#elif defined(CONFIG_AMI_STORE_FORWARD)
+	/*
+	 * Not registered: buffer the reading for the backlog Send. Once
+	 * registered, live values are pushed even while an older backlog
+	 * drains — its records carry their own timestamps, so the series
+	 * stays gap-free, and a server that refuses Send still gets them.
+	 */
+	if (!lwm2m_connected) {
+		if (meter_readings_usable(&last_readings)) {
+			store_put(&last_readings);
+		}
+		return;
+	}
+	if (!store_is_empty()) {
+		store_drain_kick();
+	}
+#endif
+
 	/* Push ONLY real meter readings to LwM2M (field_mask gates each field) */
 	meter_push_to_lwm2m(&last_readings);
 }
@@ -319,6 +437,15 @@ static void dlms_thread_entry(void *p1, void *p2, void *p3)
 
 		update_sensors();
 
+#if defined(CONFIG_AMI_SEND_WINDOW) && !defined(CONFIG_AMI_SSED)
+		/* Poll data is queued: exchange it, a due registration
+		 * update and any server-queued requests in one RX window.
+		 */
+		if (lwm2m_connected) {
+			send_window_open();
+		}
+#endif
+
 		dlms_thread_running = false;
 	}
 }
@@ -371,6 +498,14 @@ int main(void)
 		gpio_pin_configure_dt(&led0, GPIO_OUTPUT_INACTIVE);
 	}
 
+#ifdef CONFIG_AMI_SSED
+	/* Attach directly as a sleepy child with CSL */
+	ret = sed_profile_init();
+	if (ret < 0) {
+		LOG_ERR("SSED profile init failed: %d", ret);
+	}
+#endif
+
 	/* Poll OpenThread role until attached (Child/Router/Leader) */
 	LOG_INF("Waiting for Thread network...");
 	for (int i = 0; i < 120; i++) {
@@ -408,22 +543,33 @@ int main(void)
 		return ret;
 	}
 
+#ifdef CONFIG_AMI_STORE_FORWARD
+	/* Time-series caches need the Object 10242 instance from lwm2m_setup() */
+	store_init();
+#endif
+
 	/* Start LwM2M RD client */
 	memset(&client_ctx, 0, sizeof(client_ctx));
+	uplink_init(&client_ctx);
+#ifdef CONFIG_AMI_AIRTIME
+	airtime_init(&client_ctx);
+#endif
 	lwm2m_rd_client_start(&client_ctx, endpoint_name, 0,
 			      rd_client_event, observe_cb);
 
 	/* Main loop — DLMS poll at configurable interval with smart threshold notify */
 	LOG_INF("Entering sensor loop (DLMS=%ds, conn=%ds, threshold-notify)",
-		dlms_poll_interval_s, CONN_UPDATE_INTERVAL_S);
-
-	/* Initial update so resources have real values before first sleep */
-	update_connectivity_metrics();
-	update_thread_network();
-	update_thread_neighbors();
+		dlms_poll_interval_s, CONFIG_AMI_THREAD_METRICS_INTERVAL);
+
+	/* Periodic Thread jobs (33000 MAC counters, 10485) run on their
+	 * own low-priority work queue. Their first runs are staggered:
+	 * the MAC sampler starts right away, the neighbor update about
+	 * half a metrics period later, so the two never fire together.
+	 * Objects 4, 33000 and 10483 are otherwise pushed on OT state changes.
+	 */
+	thread_metrics_start();
 	k_sem_give(&dlms_poll_sem);  /* Trigger initial DLMS poll in background */
 	last_dlms_poll_ms = k_uptime_get();
-	int64_t last_conn_update_ms = last_dlms_poll_ms;
 
 	while (1) {
 		k_sleep(LOOP_TICK);
@@ -437,14 +583,6 @@ int main(void)
 			}
 			last_dlms_poll_ms = now;
 		}
-
-		/* Connectivity metrics at slower rate (v0.18.0: decoupled from DLMS) */
-		if ((now - last_conn_update_ms) >= (CONN_UPDATE_INTERVAL_S * 1000)) {
-			update_connectivity_metrics();
-			update_thread_network();
-			update_thread_neighbors();
-			last_conn_update_ms = now;
-		}
 	}
 
 	return 0;
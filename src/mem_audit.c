@@ -0,0 +1,156 @@
+/*
+ * Memory Audit — see mem_audit.h
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/sys_heap.h>
+#include <string.h>
+
+#include "mem_audit.h"
+
+LOG_MODULE_REGISTER(mem_audit, LOG_LEVEL_INF);
+
+struct stacks_ctx {
+	void (*cb)(const struct mem_audit_stack *s, void *user_data);
+	void *user_data;
+};
+
+static void visit_thread(const struct k_thread *t, void *user_data)
+{
+	struct stacks_ctx *ctx = user_data;
+	struct mem_audit_stack s;
+	const char *name = k_thread_name_get((k_tid_t)t);
+	size_t unused;
+
+	if (k_thread_stack_space_get(t, &unused) < 0) {
+		return;
+	}
+
+	s.name = name ? name : "";
+	s.size = t->stack_info.size;
+	s.used = s.size - unused;
+	ctx->cb(&s, ctx->user_data);
+}
+
+void mem_audit_stacks(void (*cb)(const struct mem_audit_stack *s,
+				 void *user_data),
+		      void *user_data)
+{
+	struct stacks_ctx ctx = { .cb = cb, .user_data = user_data };
+
+	/* Unlocked: the stack scan and the shell output take a while */
+	k_thread_foreach_unlocked(visit_thread, &ctx);
+}
+
+static unsigned int pct(size_t part, size_t whole)
+{
+	return whole ? (unsigned int)(part * 100 / whole) : 0;
+}
+
+/* ==== Periodic sample ==== */
+
+#if CONFIG_AMI_MEM_AUDIT_INTERVAL > 0
+
+struct worst {
+	char name[CONFIG_THREAD_MAX_NAME_LEN];
+	size_t size;
+	size_t used;
+};
+
+static void keep_worst(const struct mem_audit_stack *s, void *user_data)
+{
+	struct worst *w = user_data;
+
+	if (pct(s->used, s->size) > pct(w->used, w->size)) {
+		strncpy(w->name, s->name, sizeof(w->name) - 1);
+		w->size = s->size;
+		w->used = s->used;
+	}
+}
+
+static void sample_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sample_work, sample_handler);
+
+static void sample_handler(struct k_work *work)
+{
+	struct worst w = { 0 };
+	unsigned int p;
+
+	ARG_UNUSED(work);
+
+	mem_audit_stacks(keep_worst, &w);
+	p = pct(w.used, w.size);
+	if (p >= CONFIG_AMI_MEM_AUDIT_STACK_WARN_PCT) {
+		LOG_WRN("Stack %s at %u%% (%u/%u bytes)", w.name, p,
+			(unsigned int)w.used, (unsigned int)w.size);
+	} else {
+		LOG_INF("Fullest stack: %s at %u%% (%u/%u bytes)", w.name, p,
+			(unsigned int)w.used, (unsigned int)w.size);
+	}
+
+	k_work_reschedule(&sample_work,
+			  K_SECONDS(CONFIG_AMI_MEM_AUDIT_INTERVAL));
+}
+
+static int mem_audit_init(void)
+{
+	k_work_reschedule(&sample_work,
+			  K_SECONDS(CONFIG_AMI_MEM_AUDIT_INTERVAL));
+	return 0;
+}
+
+SYS_INIT(mem_audit_init, APPLICATION, 99);
+
+#endif /* CONFIG_AMI_MEM_AUDIT_INTERVAL > 0 */
+
+/* ==== Shell ==== */
+
+static void print_stack(const struct mem_audit_stack *s, void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	shell_print(sh, "stk %u/%u %u%% %s", (unsigned int)s->used,
+		    (unsigned int)s->size, pct(s->used, s->size),
+		    s->name[0] ? s->name : "(unnamed)");
+}
+
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS) && K_HEAP_MEM_POOL_SIZE > 0
+/* Defined by the kernel for k_malloc() (CONFIG_HEAP_MEM_POOL_SIZE) */
+extern struct k_heap _system_heap;
+
+static void print_system_heap(const struct shell *sh)
+{
+	struct sys_memory_stats st;
+	size_t size;
+
+	if (sys_heap_runtime_stats_get(&_system_heap.heap, &st) < 0) {
+		return;
+	}
+	size = st.free_bytes + st.allocated_bytes;
+	shell_print(sh, "heap %u/%u %u%% system",
+		    (unsigned int)st.max_allocated_bytes, (unsigned int)size,
+		    pct(st.max_allocated_bytes, size));
+}
+#else
+static void print_system_heap(const struct shell *sh)
+{
+	ARG_UNUSED(sh);
+}
+#endif
+
+static int cmd_mem_audit(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	mem_audit_stacks(print_stack, (void *)sh);
+	print_system_heap(sh);
+	shell_print(sh, "mem end");
+	return 0;
+}
+
+SHELL_CMD_REGISTER(mem_audit, NULL,
+		   "Stack and heap high-water marks (see tools/footprint_report.py)",
+		   cmd_mem_audit);
@@ -0,0 +1,49 @@
+/*
+ * Memory Audit — runtime stack and heap high-water marks
+ *
+ * The static side of the footprint (per-module RAM and flash) comes
+ * from the linker map: "west build -t footprint" runs
+ * tools/footprint_report.py against footprint_budget.json. What the
+ * map cannot show is how much of each thread stack and of the system
+ * heap is ever used; this module samples that on the device.
+ *
+ * "mem_audit" on the shell prints one line per thread and heap:
+ *
+ *   stk <used>/<size> <pct>% <thread name>
+ *   heap <max allocated>/<size> <pct>% <heap name>
+ *   mem end
+ *
+ * Stack figures come from k_thread_stack_space_get() (stacks are
+ * filled with a pattern at creation, CONFIG_INIT_STACKS), so "used" is
+ * the deepest the thread has ever been since boot, not its current
+ * depth. Save the console output and pass it to footprint_report.py
+ * with --stacks to check it against the budget too.
+ *
+ * With CONFIG_AMI_MEM_AUDIT_INTERVAL > 0 the same sample runs
+ * periodically and logs the fullest stack, as a warning once it
+ * reaches CONFIG_AMI_MEM_AUDIT_STACK_WARN_PCT.
+ */
+
+#ifndef MEM_AUDIT_H_
+#define MEM_AUDIT_H_
+
+#include <stddef.h>
+
+struct mem_audit_stack {
+	const char *name;      /* Thread name, "" if unnamed */
+	size_t size;           /* Stack size (bytes) */
+	size_t used;           /* High-water mark (bytes) */
+};
+
+/**
+ * @brief Call @p cb for every thread's stack high-water mark
+ *
+ * The thread list is walked unlocked (k_thread_foreach_unlocked()),
+ * so @p cb may print; threads created or aborted meanwhile may be
+ * missed.
+ */
+void mem_audit_stacks(void (*cb)(const struct mem_audit_stack *s,
+				 void *user_data),
+		      void *user_data);
+
+#endif /* MEM_AUDIT_H_ */
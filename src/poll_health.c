@@ -0,0 +1,97 @@
+/*
+ * Poll Health — see poll_health.h
+ */
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+
+#include "poll_health.h"
+
+BUILD_ASSERT(POLL_HEALTH_WINDOW >= 1 && POLL_HEALTH_WINDOW <= 255,
+	     "POLL_HEALTH_WINDOW must fit the uint8_t ring indices");
+
+void poll_health_reset(struct poll_health *h)
+{
+	memset(h, 0, sizeof(*h));
+}
+
+void poll_health_record(struct poll_health *h,
+			const struct poll_health_sample *s)
+{
+	struct poll_health_sample *slot = &h->win[h->head];
+
+	*slot = *s;
+	if (s->associated) {
+		h->last_target = s->target;
+		if (h->link_lost) {
+			h->reconnects++;
+		}
+	} else {
+		slot->read = 0;
+		slot->target = h->last_target;
+	}
+	h->link_lost = !s->associated;
+
+	h->polls++;
+	if (s->ok) {
+		h->consec_failures = 0;
+	} else {
+		h->failures++;
+		h->consec_failures++;
+	}
+
+	h->head = (uint8_t)((h->head + 1) % POLL_HEALTH_WINDOW);
+	if (h->count < POLL_HEALTH_WINDOW) {
+		h->count++;
+	}
+}
+
+int poll_health_summarize(const struct poll_health *h,
+			  struct poll_health_summary *out)
+{
+	uint32_t sorted[POLL_HEALTH_WINDOW];
+	uint64_t cycle_sum = 0, bytes_sum = 0;
+	uint32_t read_sum = 0, target_sum = 0;
+	int n, rank, last;
+
+	if (!h || !out) {
+		return -EINVAL;
+	}
+	if (h->count == 0) {
+		return -ENODATA;
+	}
+
+	n = h->count;
+	for (int i = 0; i < n; i++) {
+		const struct poll_health_sample *s = &h->win[i];
+		int j = i;
+
+		cycle_sum += s->cycle_ms;
+		bytes_sum += s->bytes;
+		read_sum += s->read;
+		target_sum += s->target;
+
+		/* Insertion sort: at most POLL_HEALTH_WINDOW entries */
+		while (j > 0 && sorted[j - 1] > s->cycle_ms) {
+			sorted[j] = sorted[j - 1];
+			j--;
+		}
+		sorted[j] = s->cycle_ms;
+	}
+
+	rank = (95 * n + 99) / 100;
+	last = (h->head + POLL_HEALTH_WINDOW - 1) % POLL_HEALTH_WINDOW;
+
+	out->polls = h->polls;
+	out->failures = h->failures;
+	out->consec_failures = h->consec_failures;
+	out->reconnects = h->reconnects;
+	out->last_cycle_ms = h->win[last].cycle_ms;
+	out->mean_cycle_ms = (uint32_t)(cycle_sum / n);
+	out->p95_cycle_ms = sorted[rank - 1];
+	out->bytes_per_poll = (uint32_t)(bytes_sum / n);
+	out->coverage_pct = target_sum ? 100.0 * read_sum / target_sum : 0.0;
+	out->samples = (uint8_t)n;
+	return 0;
+}
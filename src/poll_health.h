@@ -0,0 +1,84 @@
+/*
+ * Poll Health — fixed-memory window of DLMS poll outcomes
+ *
+ * The DLMS thread pushes one sample per meter_poll() (duration, values
+ * read and attempted, bytes on the RS485 bus, association result) into
+ * a ring of POLL_HEALTH_WINDOW entries, plus a few lifetime counters.
+ * poll_health_summarize() reduces them to the service-level figures
+ * published in Object 33004: T_cycle last/mean/p95, read coverage,
+ * consecutive failures, reconnects and bytes per poll.
+ *
+ * Pure C, no LwM2M dependency, so it is unit-tested natively.
+ */
+
+#ifndef POLL_HEALTH_H_
+#define POLL_HEALTH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(CONFIG_AMI_DLMS_HEALTH_WINDOW)
+#define POLL_HEALTH_WINDOW  CONFIG_AMI_DLMS_HEALTH_WINDOW
+#else
+#define POLL_HEALTH_WINDOW  32
+#endif
+
+/* One meter_poll() */
+struct poll_health_sample {
+	uint32_t cycle_ms;       /* T_cycle: connect + read + disconnect */
+	uint32_t bytes;          /* RS485 bytes, both directions */
+	uint16_t read;           /* OBIS values read */
+	uint16_t target;         /* OBIS values attempted, 0 if not associated */
+	bool     associated;     /* SNRM/UA and AARQ/AARE succeeded */
+	bool     ok;             /* meter_poll() returned 0 */
+};
+
+struct poll_health {
+	struct poll_health_sample win[POLL_HEALTH_WINDOW];
+	uint8_t  head;                /* next write position */
+	uint8_t  count;               /* valid samples */
+	uint16_t last_target;         /* target of the last associated poll */
+	uint32_t polls;               /* lifetime */
+	uint32_t failures;            /* lifetime polls not ok */
+	uint32_t consec_failures;     /* polls not ok since the last ok one */
+	uint32_t reconnects;          /* associations after a failed one */
+	bool     link_lost;           /* the last poll failed to associate */
+};
+
+/* Aggregates; window figures cover the last POLL_HEALTH_WINDOW polls */
+struct poll_health_summary {
+	uint32_t polls;
+	uint32_t failures;
+	uint32_t consec_failures;
+	uint32_t reconnects;
+	uint32_t last_cycle_ms;
+	uint32_t mean_cycle_ms;       /* window */
+	uint32_t p95_cycle_ms;        /* window, nearest rank */
+	uint32_t bytes_per_poll;      /* window mean */
+	double   coverage_pct;        /* window: values read / attempted */
+	uint8_t  samples;
+};
+
+/**
+ * @brief Empty the window and zero all counters
+ */
+void poll_health_reset(struct poll_health *h);
+
+/**
+ * @brief Record one poll
+ *
+ * A poll that did not associate attempts the target of the last one
+ * that did, so lost connections lower the coverage.
+ */
+void poll_health_record(struct poll_health *h,
+			const struct poll_health_sample *s);
+
+/**
+ * @brief Reduce the window and counters to their aggregates
+ *
+ * @return 0 on success, -ENODATA if no poll was recorded, -EINVAL on NULL
+ */
+int poll_health_summarize(const struct poll_health *h,
+			  struct poll_health_summary *out);
+
+#endif /* POLL_HEALTH_H_ */
@@ -0,0 +1,712 @@
+/*
+ * Reading Store — store-and-forward for meter readings
+ *
+ * RAM ring of struct meter_record with optional spill of the oldest
+ * record to an FCB (flash circular buffer). Every record carries a
+ * monotonically increasing sequence number, so the drain can release
+ * "everything up to seq N" after an ACK even if records moved from
+ * RAM to flash (or flash sectors were recycled) while the Send was
+ * in flight.
+ *
+ * Drain path: a batch of up to CONFIG_AMI_STORE_DRAIN_BATCH records is
+ * written into the Object 10242 time-series caches (lwm2m_enable_cache)
+ * with each record's own timestamp, then sent as SenML time-series via
+ * uplink_send_series() in chunks of UPLINK_MAX_PATHS resources.
+ * If any chunk fails the whole batch is retried later — the server may
+ * see a duplicate timestamp, never a gap. A batch that fails
+ * CONFIG_AMI_STORE_DRAIN_RETRIES times in a row means the server does
+ * not take the Send, so the whole backlog is discarded and counted as
+ * abandoned instead of being retried forever.
+ *
+ * Timestamps: nothing guarantees the wall clock is set when a reading
+ * is stored, so a record is stamped with Unix time only once the clock
+ * holds a plausible date (STORE_EPOCH_MIN, e.g. after SNTP). Otherwise
+ * it keeps its uptime in seconds plus the boot it was taken in, and is
+ * rebased at drain time: against the wall clock if it has been set
+ * since, else as a SenML relative time (negative seconds before the
+ * Send, RFC 8428 §4.5.3) that the server resolves on receipt. Uptime
+ * stamps from an earlier boot cannot be rebased — the downtime is
+ * unknown — so such records are released unsent and counted as
+ * undated rather than replayed at the wrong time.
+ *
+ * The boot number only has to tell this boot's records from those
+ * left in flash, so it is one more than the highest found at mount.
+ *
+ * Flash entry layout (little-endian, variable length):
+ *   seq(4) | timestamp(4) | boot(4) | field_mask(4) | value[i] per set bit
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <zephyr/shell/shell.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#endif
+
+#include "lwm2m_registry.h"
+
+#include "reading_store.h"
+#include "lwm2m_obj_power_meter.h"
+#include "telemetry_uplink.h"
+
+LOG_MODULE_REGISTER(reading_store, LOG_LEVEL_INF);
+
+#define RAM_RECORDS   CONFIG_AMI_STORE_RAM_RECORDS
+#define DRAIN_BATCH   CONFIG_AMI_STORE_DRAIN_BATCH
+
+/* Back-off before retrying a batch the server did not ACK */
+#define DRAIN_RETRY_DELAY  K_SECONDS(30)
+#define DRAIN_RETRIES      CONFIG_AMI_STORE_DRAIN_RETRIES
+
+/* Earliest wall-clock time taken as set (2024-01-01T00:00:00Z) */
+#define STORE_EPOCH_MIN  1704067200
+
+/* store_slot.boot of a record stamped with Unix time */
+#define BOOT_WALL_CLOCK  0
+
+/* Record plus store sequence number */
+struct store_slot {
+	uint32_t seq;
+	uint32_t boot;          /* BOOT_WALL_CLOCK, or boot of an uptime stamp */
+	struct meter_record rec;
+};
+
+/* ---- Module state (guarded by store_lock) ---- */
+static K_MUTEX_DEFINE(store_lock);
+static struct store_slot ram_ring[RAM_RECORDS];
+static uint16_t ram_head;       /* Index of the oldest RAM record */
+static uint16_t ram_count;
+static uint32_t next_seq = 1;
+static uint32_t cur_boot = 1;
+static struct store_stats stats;
+
+/* ---- Drain state (drain work + Send reply callback only) ---- */
+static struct store_slot batch[DRAIN_BATCH];
+static uint8_t batch_len;
+static struct lwm2m_obj_path batch_paths[METER_FIELD_COUNT];
+static uint8_t batch_path_count;
+static uint8_t batch_path_next;
+static uint8_t batch_chunk;
+static uint8_t batch_failures;  /* Consecutive failed attempts */
+static volatile bool drain_active;
+
+static void drain_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(drain_work, drain_work_handler);
+
+/* Time-series cache backing each Object 10242 resource during a drain */
+static struct lwm2m_time_series_elem ts_cache[METER_FIELD_COUNT][DRAIN_BATCH];
+
+/* ==== Flash spill (FCB) ==== */
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+
+/* Never shared with an image slot: FOTA would erase the backlog */
+#if !FIXED_PARTITION_EXISTS(store_partition)
+#error "CONFIG_AMI_STORE_FLASH_SPILL needs a store_partition in the devicetree"
+#endif
+#define STORE_PARTITION  store_partition
+
+#define STORE_FCB_MAGIC    0x414D4952  /* "AMIR" */
+#define STORE_FCB_VERSION  2
+
+#define SLOT_HDR_LEN  16
+
+static struct fcb store_fcb;
+static struct flash_sector store_sectors[CONFIG_AMI_STORE_FLASH_SECTORS];
+static struct fcb_entry flash_cursor;  /* Last consumed entry (zeroed = none) */
+static uint32_t flash_count;           /* Unconsumed entries in flash */
+static bool flash_ready;
+
+static size_t slot_encode(const struct store_slot *s, uint8_t *buf)
+{
+	size_t len = 0;
+
+	memcpy(&buf[len], &s->seq, 4);                len += 4;
+	memcpy(&buf[len], &s->rec.timestamp, 4);      len += 4;
+	memcpy(&buf[len], &s->boot, 4);               len += 4;
+	memcpy(&buf[len], &s->rec.field_mask, 4);     len += 4;
+	for (int i = 0; i < METER_FIELD_COUNT; i++) {
+		if (s->rec.field_mask & (1u << i)) {
+			memcpy(&buf[len], &s->rec.value[i], 4);
+			len += 4;
+		}
+	}
+	return len;
+}
+
+static int slot_decode(const uint8_t *buf, size_t len, struct store_slot *s)
+{
+	size_t off = SLOT_HDR_LEN;
+
+	if (len < off) {
+		return -EINVAL;
+	}
+
+	memset(s, 0, sizeof(*s));
+	memcpy(&s->seq, &buf[0], 4);
+	memcpy(&s->rec.timestamp, &buf[4], 4);
+	memcpy(&s->boot, &buf[8], 4);
+	memcpy(&s->rec.field_mask, &buf[12], 4);
+	for (int i = 0; i < METER_FIELD_COUNT; i++) {
+		if (!(s->rec.field_mask & (1u << i))) {
+			continue;
+		}
+		if (off + 4 > len) {
+			return -EINVAL;
+		}
+		memcpy(&s->rec.value[i], &buf[off], 4);
+		off += 4;
+	}
+	return 0;
+}
+
+static int flash_read_slot(const struct fcb_entry *loc, struct store_slot *s)
+{
+	uint8_t buf[SLOT_HDR_LEN + 4 * METER_FIELD_COUNT];
+
+	if (loc->fe_data_len > sizeof(buf)) {
+		return -EINVAL;
+	}
+
+	int ret = flash_area_read(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(*loc),
+				  buf, loc->fe_data_len);
+	if (ret < 0) {
+		return ret;
+	}
+	return slot_decode(buf, loc->fe_data_len, s);
+}
+
+/* Erase sectors whose entries have all been consumed */
+static void flash_release_sectors(void)
+{
+	if (flash_count == 0) {
+		fcb_clear(&store_fcb);
+		memset(&flash_cursor, 0, sizeof(flash_cursor));
+		return;
+	}
+
+	while (flash_cursor.fe_sector &&
+	       flash_cursor.fe_sector != store_fcb.f_oldest) {
+		if (fcb_rotate(&store_fcb) < 0) {
+			break;
+		}
+	}
+}
+
+/* Make room by recycling the oldest sector; returns records lost */
+static uint32_t flash_recycle_oldest(void)
+{
+	uint32_t lost = 0;
+
+	if (!flash_cursor.fe_sector ||
+	    flash_cursor.fe_sector == store_fcb.f_oldest) {
+		struct fcb_entry loc = flash_cursor;
+
+		while (fcb_getnext(&store_fcb, &loc) == 0 &&
+		       loc.fe_sector == store_fcb.f_oldest) {
+			lost++;
+		}
+		memset(&flash_cursor, 0, sizeof(flash_cursor));
+	}
+
+	fcb_rotate(&store_fcb);
+	flash_count -= MIN(lost, flash_count);
+	return lost;
+}
+
+static int flash_append(const struct store_slot *s)
+{
+	uint8_t buf[SLOT_HDR_LEN + 4 * METER_FIELD_COUNT];
+	size_t len = slot_encode(s, buf);
+	struct fcb_entry loc;
+
+	int ret = fcb_append(&store_fcb, len, &loc);
+	if (ret == -ENOSPC) {
+		uint32_t lost = flash_recycle_oldest();
+
+		if (lost > 0) {
+			stats.dropped += lost;
+			LOG_WRN("Flash spill full — %u oldest records lost", lost);
+		}
+		ret = fcb_append(&store_fcb, len, &loc);
+	}
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = flash_area_write(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc),
+			       buf, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = fcb_append_finish(&store_fcb, &loc);
+	if (ret < 0) {
+		return ret;
+	}
+
+	flash_count++;
+	return 0;
+}
+
+static int flash_init(void)
+{
+	uint32_t cnt = ARRAY_SIZE(store_sectors);
+
+	/* -ENOMEM: partition has more sectors than we use — take the first N */
+	int ret = flash_area_get_sectors(FIXED_PARTITION_ID(STORE_PARTITION),
+					 &cnt, store_sectors);
+	if (ret < 0 && ret != -ENOMEM) {
+		return ret;
+	}
+
+	store_fcb.f_magic = STORE_FCB_MAGIC;
+	store_fcb.f_version = STORE_FCB_VERSION;
+	store_fcb.f_sector_cnt = (uint8_t)cnt;
+	store_fcb.f_scratch_cnt = 0;
+	store_fcb.f_sectors = store_sectors;
+
+	ret = fcb_init(FIXED_PARTITION_ID(STORE_PARTITION), &store_fcb);
+	if (ret < 0) {
+		/* Older entry layout (or corruption): start from an empty spill */
+		const struct flash_area *fa;
+
+		LOG_WRN("Flash spill unreadable (%d) — erasing", ret);
+		ret = flash_area_open(FIXED_PARTITION_ID(STORE_PARTITION), &fa);
+		if (ret < 0) {
+			return ret;
+		}
+		ret = flash_area_erase(fa, 0, fa->fa_size);
+		flash_area_close(fa);
+		if (ret < 0) {
+			return ret;
+		}
+		ret = fcb_init(FIXED_PARTITION_ID(STORE_PARTITION), &store_fcb);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/*
+	 * Pick up records left by a previous boot, continue the sequence
+	 * and number this boot past every uptime stamp already stored
+	 */
+	struct fcb_entry loc = { 0 };
+	struct store_slot s;
+	uint32_t undated = 0;
+
+	while (fcb_getnext(&store_fcb, &loc) == 0) {
+		if (flash_read_slot(&loc, &s) == 0) {
+			if (s.seq >= next_seq) {
+				next_seq = s.seq + 1;
+			}
+			if (s.boot >= cur_boot) {
+				cur_boot = s.boot + 1;
+			}
+			if (s.boot != BOOT_WALL_CLOCK) {
+				undated++;
+			}
+		}
+		flash_count++;
+	}
+
+	stats.undated = undated;
+	flash_ready = true;
+	LOG_INF("Flash spill: %u sectors, %u records pending (%u undated)",
+		cnt, flash_count, undated);
+	return 0;
+}
+
+#endif /* CONFIG_AMI_STORE_FLASH_SPILL */
+
+/* Wall-clock time, or 0 while the clock has not been set */
+static int64_t wall_now(void)
+{
+	time_t now = time(NULL);
+
+	return (now >= STORE_EPOCH_MIN) ? (int64_t)now : 0;
+}
+
+static uint32_t uptime_s(void)
+{
+	return (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+}
+
+/*
+ * Drain-time timestamp of a record: Unix time, or SenML relative time
+ * (<= 0) while the clock is unset. False for an uptime stamp taken in
+ * an earlier boot, which no longer maps to any time.
+ */
+static bool slot_time(const struct store_slot *s, int64_t wall,
+		      uint32_t uptime, time_t *t)
+{
+	if (s->boot == BOOT_WALL_CLOCK) {
+		*t = (time_t)s->rec.timestamp;
+		return true;
+	}
+	if (s->boot != cur_boot) {
+		return false;
+	}
+
+	int64_t age = (int64_t)uptime - s->rec.timestamp;
+
+	*t = (time_t)(wall ? wall - age : -age);
+	return true;
+}
+
+static uint32_t pending_locked(void)
+{
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+	return ram_count + flash_count;
+#else
+	return ram_count;
+#endif
+}
+
+/* ==== Public API ==== */
+
+int store_init(void)
+{
+	int ret = 0;
+
+	for (int i = 0; i < METER_FIELD_COUNT; i++) {
+		int err = lwm2m_enable_cache(&LWM2M_OBJ(POWER_METER_OBJECT_ID, 0,
+							meter_field_rid(i)),
+					     ts_cache[i], DRAIN_BATCH);
+		if (err < 0) {
+			LOG_ERR("Time-series cache for RID %u failed: %d",
+				meter_field_rid(i), err);
+			ret = err;
+		}
+	}
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+	int err = flash_init();
+	if (err < 0) {
+		LOG_ERR("Flash spill unavailable (%d) — RAM only", err);
+		ret = err;
+	}
+#endif
+
+	LOG_INF("Store-and-forward ready (RAM=%d records, batch=%d)",
+		RAM_RECORDS, DRAIN_BATCH);
+	return ret;
+}
+
+int store_put(const struct meter_readings *readings)
+{
+	if (!readings) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+	if (ram_count == RAM_RECORDS) {
+		struct store_slot *oldest = &ram_ring[ram_head];
+		bool kept = false;
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+		if (flash_ready) {
+			int ret = flash_append(oldest);
+			if (ret == 0) {
+				stats.spilled++;
+				kept = true;
+			} else {
+				LOG_ERR("Flash spill failed: %d", ret);
+			}
+		}
+#endif
+		if (!kept) {
+			stats.dropped++;
+			LOG_WRN("Store full — dropping record seq=%u", oldest->seq);
+		}
+		ram_head = (ram_head + 1) % RAM_RECORDS;
+		ram_count--;
+	}
+
+	struct store_slot *slot = &ram_ring[(ram_head + ram_count) % RAM_RECORDS];
+
+	/* Unix time once the clock is set, else uptime rebased at drain */
+	int64_t wall = wall_now();
+
+	slot->seq = next_seq++;
+	slot->boot = wall ? BOOT_WALL_CLOCK : cur_boot;
+	meter_record_pack(readings, wall ? (uint32_t)wall : uptime_s(),
+			  &slot->rec);
+	ram_count++;
+	stats.stored++;
+
+	LOG_INF("Stored reading seq=%u (%u pending)", slot->seq,
+		pending_locked());
+
+	k_mutex_unlock(&store_lock);
+	return 0;
+}
+
+bool store_is_empty(void)
+{
+	k_mutex_lock(&store_lock, K_FOREVER);
+	bool empty = (pending_locked() == 0);
+	k_mutex_unlock(&store_lock);
+
+	return empty;
+}
+
+void store_drain_kick(void)
+{
+	if (drain_active) {
+		return;
+	}
+
+	drain_active = true;
+	k_work_reschedule(&drain_work, K_NO_WAIT);
+}
+
+void store_get_stats(struct store_stats *out)
+{
+	if (!out) {
+		return;
+	}
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+	*out = stats;
+	out->pending = pending_locked();
+	k_mutex_unlock(&store_lock);
+}
+
+/* ==== Drain ==== */
+
+/* Copy the oldest records (flash first, then RAM) into batch[] */
+static uint8_t collect_batch(void)
+{
+	uint8_t n = 0;
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+	if (flash_ready) {
+		struct fcb_entry loc = flash_cursor;
+
+		while (n < DRAIN_BATCH && fcb_getnext(&store_fcb, &loc) == 0) {
+			if (flash_read_slot(&loc, &batch[n]) == 0) {
+				n++;
+			}
+		}
+	}
+#endif
+
+	for (uint16_t i = 0; i < ram_count && n < DRAIN_BATCH; i++) {
+		batch[n++] = ram_ring[(ram_head + i) % RAM_RECORDS];
+	}
+
+	k_mutex_unlock(&store_lock);
+	return n;
+}
+
+/*
+ * Release every buffered record with seq <= last_seq, counted as
+ * drained if the server ACKed them, else as abandoned
+ */
+static uint32_t release_batch(uint32_t last_seq, bool delivered)
+{
+	uint32_t *count = delivered ? &stats.drained : &stats.abandoned;
+	uint32_t released = 0;
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+#ifdef CONFIG_AMI_STORE_FLASH_SPILL
+	if (flash_ready) {
+		struct fcb_entry loc = flash_cursor;
+		struct store_slot s;
+
+		while (flash_count > 0 && fcb_getnext(&store_fcb, &loc) == 0) {
+			if (flash_read_slot(&loc, &s) == 0 && s.seq > last_seq) {
+				break;
+			}
+			flash_cursor = loc;
+			flash_count--;
+			released++;
+		}
+		if (released > 0) {
+			flash_release_sectors();
+		}
+	}
+#endif
+
+	while (ram_count > 0 && ram_ring[ram_head].seq <= last_seq) {
+		ram_head = (ram_head + 1) % RAM_RECORDS;
+		ram_count--;
+		released++;
+	}
+	*count += released;
+
+	k_mutex_unlock(&store_lock);
+	return released;
+}
+
+/* Load batch[] into the time-series caches and build the path list */
+static void fill_caches(void)
+{
+	int64_t wall = wall_now();
+	uint32_t uptime = uptime_s();
+
+	batch_path_count = 0;
+
+	lwm2m_registry_lock();
+
+	for (int i = 0; i < METER_FIELD_COUNT; i++) {
+		struct lwm2m_obj_path path =
+			LWM2M_OBJ(POWER_METER_OBJECT_ID, 0, meter_field_rid(i));
+		struct lwm2m_time_series_resource *entry = NULL;
+		struct lwm2m_time_series_elem elem;
+		bool used = false;
+
+		for (uint8_t b = 0; b < batch_len; b++) {
+			time_t t;
+
+			if (!(batch[b].rec.field_mask & (1u << i)) ||
+			    !slot_time(&batch[b], wall, uptime, &t)) {
+				continue;
+			}
+
+			if (!entry) {
+				entry = lwm2m_cache_entry_get_by_object(&path);
+				if (!entry) {
+					break;
+				}
+				/* Drop live values cached by lwm2m_set_*() */
+				while (lwm2m_cache_read(entry, &elem)) {
+				}
+			}
+
+			elem.t = t;
+			elem.f = meter_record_value(&batch[b].rec, i);
+			lwm2m_cache_write(entry, &elem);
+			used = true;
+		}
+
+		if (used) {
+			batch_paths[batch_path_count++] = path;
+		}
+	}
+
+	lwm2m_registry_unlock();
+}
+
+/* Retry the batch later, or give up on the backlog after DRAIN_RETRIES */
+static void drain_retry(void)
+{
+	batch_path_next = 0;
+
+	if (++batch_failures < DRAIN_RETRIES) {
+		LOG_WRN("Backlog batch not delivered (%u/%u) — retrying in 30 s",
+			batch_failures, DRAIN_RETRIES);
+		k_work_reschedule(&drain_work, DRAIN_RETRY_DELAY);
+		return;
+	}
+
+	uint32_t n = release_batch(UINT32_MAX, false);
+
+	LOG_ERR("Backlog Send failed %u times — %u records abandoned",
+		batch_failures, n);
+	batch_len = 0;
+	batch_failures = 0;
+	drain_active = false;
+}
+
+/* Runs in the LwM2M engine thread */
+static void drain_send_done(bool acked)
+{
+	if (!acked) {
+		drain_retry();
+		return;
+	}
+
+	batch_failures = 0;
+	batch_path_next += batch_chunk;
+	if (batch_path_next >= batch_path_count) {
+		release_batch(batch[batch_len - 1].seq, true);
+		batch_len = 0;
+		batch_path_next = 0;
+	}
+
+	k_work_reschedule(&drain_work, K_NO_WAIT);
+}
+
+static void drain_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (!uplink_is_registered()) {
+		/* Resumed by the next store_drain_kick() on registration */
+		drain_active = false;
+		return;
+	}
+
+	if (batch_len == 0) {
+		batch_len = collect_batch();
+		batch_path_next = 0;
+		if (batch_len == 0) {
+			LOG_INF("Backlog drained (%u records delivered)",
+				stats.drained);
+			drain_active = false;
+			return;
+		}
+	}
+
+	if (batch_path_next == 0) {
+		fill_caches();
+		if (batch_path_count == 0) {
+			/* Nothing encodable (empty masks) — just release */
+			release_batch(batch[batch_len - 1].seq, true);
+			batch_len = 0;
+			k_work_reschedule(&drain_work, K_NO_WAIT);
+			return;
+		}
+	}
+
+	batch_chunk = MIN(batch_path_count - batch_path_next, UPLINK_MAX_PATHS);
+
+	int ret = uplink_send_series(&batch_paths[batch_path_next],
+				     batch_chunk, drain_send_done);
+	if (ret == -EBUSY) {
+		k_work_reschedule(&drain_work, K_SECONDS(1));
+	} else if (ret < 0) {
+		LOG_WRN("Backlog Send failed (%d)", ret);
+		drain_retry();
+	} else {
+		LOG_DBG("Backlog: %u records, paths %u..%u",
+			batch_len, batch_path_next,
+			batch_path_next + batch_chunk - 1);
+	}
+}
+
+/* ==== Shell ==== */
+
+static int cmd_store(const struct shell *sh, size_t argc, char **argv)
+{
+	struct store_stats s;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	store_get_stats(&s);
+	shell_print(sh, "Store-and-forward:");
+	shell_print(sh, "  pending : %u", s.pending);
+	shell_print(sh, "  stored  : %u", s.stored);
+	shell_print(sh, "  spilled : %u", s.spilled);
+	shell_print(sh, "  drained : %u", s.drained);
+	shell_print(sh, "  dropped : %u", s.dropped);
+	shell_print(sh, "  undated : %u", s.undated);
+	shell_print(sh, "  abandon : %u", s.abandoned);
+	shell_print(sh, "  drain   : %s", drain_active ? "active" : "idle");
+	return 0;
+}
+
+SHELL_CMD_REGISTER(store, NULL, "Show store-and-forward backlog status",
+		   cmd_store);
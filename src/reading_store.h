@@ -0,0 +1,85 @@
+/*
+ * Reading Store — store-and-forward for meter readings
+ *
+ * While the LwM2M client is not registered (Thread partition, RD
+ * re-registration, server down) DLMS polls keep running. Instead of
+ * overwriting Object 10242 and losing every reading taken during the
+ * outage, update_sensors() hands them to store_put().
+ *
+ * Readings are packed into struct meter_record (scaled integers) and
+ * kept in a RAM ring. When the ring is full the oldest record spills
+ * to a flash circular buffer (CONFIG_AMI_STORE_FLASH_SPILL). Once
+ * registration completes, store_drain_kick() replays the backlog
+ * oldest-first as LwM2M Send messages carrying SenML time-series
+ * (one timestamped record per reading), and records are only released
+ * after the server ACKs them. Live readings keep going out as
+ * notifications meanwhile; every record carries its own timestamp.
+ *
+ * The server must accept LwM2M 1.1 Send. A batch that is not ACKed
+ * after CONFIG_AMI_STORE_DRAIN_RETRIES attempts abandons the backlog.
+ */
+
+#ifndef READING_STORE_H_
+#define READING_STORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dlms_meter.h"
+
+/* Store-and-forward statistics */
+struct store_stats {
+	uint32_t stored;      /* Records accepted by store_put() */
+	uint32_t spilled;     /* Records moved from RAM to flash */
+	uint32_t dropped;     /* Records lost (buffer full, flash error) */
+	uint32_t drained;     /* Records ACKed by the server */
+	uint32_t undated;     /* Uptime-stamped records of an earlier boot,
+			       * released without being sent */
+	uint32_t abandoned;   /* Records discarded after the drain gave up */
+	uint32_t pending;     /* Records currently buffered (RAM + flash) */
+};
+
+/**
+ * @brief Initialize the store and the Object 10242 time-series caches
+ *
+ * Must be called after the Object 10242 instance exists and before
+ * lwm2m_rd_client_start(). Records left in flash by a previous boot
+ * are picked up and drained after the first registration.
+ *
+ * @return 0 on success, negative errno on failure (RAM-only operation
+ *         continues if only the flash spill failed to mount)
+ */
+int store_init(void);
+
+/**
+ * @brief Buffer one reading for later delivery
+ *
+ * @param readings  Readings that passed meter_readings_usable()
+ * @return 0 on success, negative errno on failure
+ */
+int store_put(const struct meter_readings *readings);
+
+/**
+ * @brief Check whether any record is waiting to be drained
+ *
+ * @return true if RAM and flash are both empty
+ */
+bool store_is_empty(void);
+
+/**
+ * @brief Start (or resume) draining the backlog to the server
+ *
+ * Called from the RD client event handler on registration and after
+ * polls that find a backlog. Safe to call repeatedly; does nothing
+ * while a drain is already in flight.
+ */
+void store_drain_kick(void);
+
+/**
+ * @brief Get store-and-forward statistics
+ *
+ * @param stats  Output structure
+ */
+void store_get_stats(struct store_stats *stats);
+
+#endif /* READING_STORE_H_ */
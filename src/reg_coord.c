@@ -0,0 +1,58 @@
+/*
+ * Registration Coordinator — see reg_coord.h
+ */
+
+#include <string.h>
+
+#include "reg_coord.h"
+
+void reg_coord_init(struct reg_coord *rc, uint32_t refresh_s,
+		    uint32_t liveness_s)
+{
+	memset(rc, 0, sizeof(*rc));
+	rc->refresh_ms = refresh_s * 1000U;
+	rc->liveness_ms = liveness_s * 1000U;
+}
+
+void reg_coord_update_done(struct reg_coord *rc, int64_t now_ms)
+{
+	rc->last_update_ms = now_ms;
+	rc->have_update = true;
+	/* The update itself was an ACKed exchange */
+	reg_coord_exchange_acked(rc, now_ms);
+}
+
+void reg_coord_exchange_acked(struct reg_coord *rc, int64_t now_ms)
+{
+	rc->last_ack_ms = now_ms;
+	rc->have_ack = true;
+}
+
+static bool update_stale(const struct reg_coord *rc, int64_t now_ms)
+{
+	return !rc->have_update ||
+	       now_ms - rc->last_update_ms >= (int64_t)rc->refresh_ms;
+}
+
+enum reg_coord_action reg_coord_on_send(struct reg_coord *rc, int64_t now_ms)
+{
+	if (update_stale(rc, now_ms)) {
+		rc->piggybacked++;
+		return REG_COORD_UPDATE;
+	}
+
+	rc->suppressed++;
+	return REG_COORD_NONE;
+}
+
+enum reg_coord_action reg_coord_on_idle(struct reg_coord *rc, int64_t now_ms)
+{
+	if (!update_stale(rc, now_ms) && rc->have_ack &&
+	    now_ms - rc->last_ack_ms < (int64_t)rc->liveness_ms) {
+		rc->suppressed++;
+		return REG_COORD_NONE;
+	}
+
+	rc->forced++;
+	return REG_COORD_UPDATE;
+}
@@ -0,0 +1,77 @@
+/*
+ * Registration Coordinator — piggyback LwM2M registration updates
+ *
+ * Left to the engine, registration updates follow its lifetime timer:
+ * each is a separate CoAP exchange with its own 6LoWPAN fragment train
+ * and CONFIG_COAP_INIT_ACK_TIMEOUT_MS retransmission timer. The
+ * coordinator decides, per send window, whether an update is worth
+ * sending, and the send window requests it:
+ *
+ *   - Data window (a poll produced uplink data): the update rides along
+ *     with the data once the last one is REFRESH old, otherwise the data
+ *     exchange alone tells the server the node is awake.
+ *   - Idle window (no data for a while): an ACKed exchange within the
+ *     LIVENESS interval already proved the node alive, so the update is
+ *     suppressed; otherwise one is sent so server-queued requests flow.
+ *
+ * Pure C, no LwM2M dependency, so it is unit-tested natively.
+ */
+
+#ifndef REG_COORD_H_
+#define REG_COORD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum reg_coord_action {
+	REG_COORD_NONE,      /* no registration update needed */
+	REG_COORD_UPDATE,    /* send a registration update in this window */
+};
+
+struct reg_coord {
+	uint32_t refresh_ms;      /* update age that triggers a piggyback */
+	uint32_t liveness_ms;     /* ACK age still accepted as liveness */
+	int64_t  last_update_ms;
+	int64_t  last_ack_ms;
+	bool     have_update;
+	bool     have_ack;
+	/* Decisions taken, for logging and the shell */
+	uint32_t piggybacked;     /* updates sent alongside data */
+	uint32_t forced;          /* updates sent in an idle window */
+	uint32_t suppressed;      /* updates skipped */
+};
+
+/**
+ * @brief Reset the coordinator
+ *
+ * @param refresh_s   Refresh the registration once it is this old
+ * @param liveness_s  An ACKed exchange this recent proves liveness
+ */
+void reg_coord_init(struct reg_coord *rc, uint32_t refresh_s,
+		    uint32_t liveness_s);
+
+/**
+ * @brief A registration or registration update completed
+ */
+void reg_coord_update_done(struct reg_coord *rc, int64_t now_ms);
+
+/**
+ * @brief The server ACKed a data exchange (Send or notification)
+ */
+void reg_coord_exchange_acked(struct reg_coord *rc, int64_t now_ms);
+
+/**
+ * @brief A send window opens with data queued
+ *
+ * @return REG_COORD_UPDATE if the update should ride along
+ */
+enum reg_coord_action reg_coord_on_send(struct reg_coord *rc, int64_t now_ms);
+
+/**
+ * @brief A send window opens with no data queued
+ *
+ * @return REG_COORD_UPDATE if an explicit update is needed
+ */
+enum reg_coord_action reg_coord_on_idle(struct reg_coord *rc, int64_t now_ms);
+
+#endif /* REG_COORD_H_ */
@@ -13,8 +13,9 @@
 #include <zephyr/logging/log.h>
 
 #include "rs485_uart.h"
+#include "trace.h"
 
-LOG_MODULE_REGISTER(rs485, LOG_LEVEL_DBG);
+LOG_MODULE_REGISTER(rs485, CONFIG_AMI_RS485_LOG_LEVEL);
 
 /* UART1 device (configured in overlay) */
 static const struct device *uart_dev;
@@ -40,6 +41,13 @@ static void uart_isr_cb(const struct device *dev, void *user_data)
 	while (uart_irq_update(dev) && uart_irq_is_pending(dev)) {
 		if (uart_irq_rx_ready(dev)) {
 			uint8_t byte;
+			/* Only the first ISR of a burst is traced: it marks
+			 * the meter's response latency without one trace
+			 * record per received byte.
+			 */
+			bool first = (rx_head == rx_tail);
+			uint16_t n = 0;
+
 			while (uart_fifo_read(dev, &byte, 1) == 1) {
 				uint16_t next = (rx_head + 1) % RS485_RX_BUF_SIZE;
 				if (next != rx_tail) {
@@ -47,6 +55,10 @@ static void uart_isr_cb(const struct device *dev, void *user_data)
 					rx_head = next;
 				}
 				/* else: buffer full, drop byte */
+				n++;
+			}
+			if (first && n > 0) {
+				TRACE(UART_RX_ISR, n);
 			}
 			k_sem_give(&rx_sem);
 		}
@@ -96,6 +108,8 @@ int rs485_send(const uint8_t *data, size_t len)
 		return -EINVAL;
 	}
 
+	TRACE(RS485_TX_BEGIN, len);
+
 	/* Assert DE pin (transmit mode) */
 	gpio_pin_set_dt(&de_pin, 1);
 
@@ -124,9 +138,11 @@ int rs485_send(const uint8_t *data, size_t len)
 
 	/* De-assert DE pin (receive mode) */
 	gpio_pin_set_dt(&de_pin, 0);
+	TRACE(RS485_TX_END, len);
+
+	TRACE_HEXDUMP(FRAME_TX, data, len);
 
 	LOG_DBG("RS485 TX: %u bytes (drain wait %u us)", (unsigned)len, tx_drain_us);
-	LOG_HEXDUMP_DBG(data, len, "RS485 TX");
 	return (int)len;
 }
 
@@ -146,9 +162,12 @@ int rs485_recv(uint8_t *buf, size_t buf_size, int timeout_ms)
 		timeout = K_MSEC(timeout_ms);
 	}
 
+	TRACE(RS485_RX_BEGIN, timeout_ms);
+
 	/* Wait for at least one byte */
 	if (rx_head == rx_tail) {
 		if (k_sem_take(&rx_sem, timeout) != 0) {
+			TRACE(RS485_RX_END, -EAGAIN);
 			return -EAGAIN;  /* Timeout */
 		}
 	}
@@ -198,9 +217,10 @@ int rs485_recv(uint8_t *buf, size_t buf_size, int timeout_ms)
 	}
 
 	irq_unlock(key);
+	TRACE(RS485_RX_END, count);
 
 	if (count > 0) {
-		LOG_HEXDUMP_DBG(buf, count, "RS485 RX");
+		TRACE_HEXDUMP(FRAME_RX, buf, count);
 	}
 	LOG_DBG("RS485 RX: %u bytes", (unsigned)count);
 	return (int)count;
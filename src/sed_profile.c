@@ -0,0 +1,116 @@
+/*
+ * SSED Profile — see sed_profile.h
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <openthread.h>
+#include <openthread/thread.h>
+#include <openthread/link.h>
+#include <openthread/instance.h>
+
+#include "sed_profile.h"
+#include "reading_store.h"
+
+LOG_MODULE_REGISTER(sed_profile, LOG_LEVEL_INF);
+
+static struct k_work_delayable burst_end_work;
+static bool burst_active;
+
+/* Data poll period; the OpenThread mutex is taken here */
+static void set_poll_period(uint32_t period_ms)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	otError err;
+
+	if (!ot) {
+		return;
+	}
+
+	openthread_mutex_lock();
+	err = otLinkSetPollPeriod(ot, period_ms);
+	openthread_mutex_unlock();
+
+	if (err != OT_ERROR_NONE) {
+		LOG_WRN("Poll period %u ms rejected (%d)", period_ms, err);
+	}
+}
+
+static void burst_end_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (!burst_active) {
+		return;
+	}
+	burst_active = false;
+	set_poll_period(CONFIG_AMI_SSED_POLL_PERIOD_MS);
+	LOG_DBG("SSED burst end");
+}
+
+int sed_profile_init(void)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	otLinkModeConfig mode = {
+		.mRxOnWhenIdle = false,
+		.mDeviceType = false,   /* MTD: never a router */
+		.mNetworkData = false,  /* stable network data only */
+	};
+	otError err, csl_err;
+
+	k_work_init_delayable(&burst_end_work, burst_end_work_handler);
+
+	if (!ot) {
+		return -ENODEV;
+	}
+
+	openthread_mutex_lock();
+	err = otThreadSetLinkMode(ot, mode);
+	if (err == OT_ERROR_NONE) {
+		err = otLinkSetPollPeriod(ot, CONFIG_AMI_SSED_POLL_PERIOD_MS);
+	}
+	/* otLinkSetCslPeriod() takes microseconds */
+	csl_err = otLinkSetCslPeriod(ot, CONFIG_AMI_SSED_CSL_PERIOD_MS * 1000U);
+	openthread_mutex_unlock();
+
+	if (err != OT_ERROR_NONE) {
+		LOG_ERR("SSED link mode rejected (%d)", err);
+		return -EINVAL;
+	}
+
+	if (csl_err != OT_ERROR_NONE) {
+		LOG_WRN("CSL unavailable (%d) — polling SED, poll %d ms",
+			csl_err, CONFIG_AMI_SSED_POLL_PERIOD_MS);
+	} else {
+		LOG_INF("SSED: CSL %d ms, poll %d ms, batch %d readings",
+			CONFIG_AMI_SSED_CSL_PERIOD_MS,
+			CONFIG_AMI_SSED_POLL_PERIOD_MS,
+			CONFIG_AMI_SSED_BATCH_READINGS);
+	}
+	return 0;
+}
+
+bool sed_batch_due(void)
+{
+	struct store_stats s;
+
+	store_get_stats(&s);
+	return s.pending >= CONFIG_AMI_SSED_BATCH_READINGS;
+}
+
+void sed_burst_begin(void)
+{
+	if (!burst_active) {
+		burst_active = true;
+		set_poll_period(CONFIG_AMI_SSED_BURST_POLL_MS);
+		LOG_DBG("SSED burst start");
+	}
+
+	/* Upper bound in case the RX-off event never comes */
+	k_work_reschedule(&burst_end_work, K_MSEC(CONFIG_AMI_SSED_BURST_MAX_MS));
+}
+
+void sed_burst_end(void)
+{
+	k_work_reschedule(&burst_end_work, K_NO_WAIT);
+}
@@ -0,0 +1,53 @@
+/*
+ * SSED Profile — Synchronized Sleepy End Device with CSL
+ *
+ * For battery-backed or low-power installs (overlay-ssed.conf). The
+ * node attaches as an MTD child with rx-on-when-idle off, so it never
+ * routes and its receiver is off between:
+ *   - CSL slots every CONFIG_AMI_SSED_CSL_PERIOD_MS, in which the
+ *     parent may deliver frames without waiting for a data poll;
+ *   - data polls every CONFIG_AMI_SSED_POLL_PERIOD_MS (supervision).
+ *
+ * Uplinks are batched: DLMS readings go through the store-and-forward
+ * buffer and are drained as one SenML time-series Send every
+ * CONFIG_AMI_SSED_BATCH_READINGS readings. Around that drain the radio
+ * enters a burst — fast data polls so the ACKs, the registration
+ * update and any server requests queued for the node (LwM2M queue
+ * mode) all arrive in the same wake — and goes back to sleep when the
+ * LwM2M engine reports the queue-mode RX window closed.
+ */
+
+#ifndef SED_PROFILE_H_
+#define SED_PROFILE_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Switch OpenThread to sleepy MTD operation with CSL
+ *
+ * Call once the Thread stack is up. CSL is optional: if the radio
+ * driver does not support it the node keeps running as a polling SED.
+ *
+ * @return 0 on success, negative errno if the link mode was rejected
+ */
+int sed_profile_init(void);
+
+/**
+ * @brief Whether enough readings are buffered for an uplink batch
+ */
+bool sed_batch_due(void);
+
+/**
+ * @brief Start (or extend) a radio burst
+ *
+ * Drops the data poll period to CONFIG_AMI_SSED_BURST_POLL_MS until
+ * sed_burst_end() or CONFIG_AMI_SSED_BURST_MAX_MS elapses.
+ */
+void sed_burst_begin(void);
+
+/**
+ * @brief End the radio burst and restore the idle poll period
+ */
+void sed_burst_end(void);
+
+#endif /* SED_PROFILE_H_ */
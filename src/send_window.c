@@ -0,0 +1,214 @@
+/*
+ * Send Window — see send_window.h
+ *
+ * The engine is never paused: queue mode turns RX off on its own and
+ * resumes it for the next notification or Send. Registration updates
+ * are requested from the system work queue, never from the RD client
+ * callback or the DLMS thread directly.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+
+#include "send_window.h"
+#ifdef CONFIG_AMI_SSED
+#include "sed_profile.h"
+#endif
+#ifdef CONFIG_AMI_REG_COORD
+#include "reg_coord.h"
+#endif
+
+LOG_MODULE_REGISTER(send_window, LOG_LEVEL_INF);
+
+static atomic_t registered;
+static atomic_t window_open;
+static atomic_t idle_open;        /* opened by the gap timer, no data */
+
+static struct k_work open_work;
+static struct k_work close_work;
+static struct k_work_delayable gap_work;
+static bool initialized;
+
+#ifdef CONFIG_AMI_REG_COORD
+BUILD_ASSERT(CONFIG_AMI_REG_REFRESH_S <
+	     CONFIG_AMI_LWM2M_LIFETIME - CONFIG_LWM2M_SECONDS_TO_UPDATE_EARLY,
+	     "Registration refresh must come before the engine's own update");
+
+/* Decisions are taken on the system work queue; events arrive from the
+ * engine thread, so the coordinator is guarded.
+ */
+static struct reg_coord coord;
+static struct k_spinlock coord_lock;
+static atomic_t coord_update_pending;  /* update it asked for in flight */
+
+static bool update_needed(bool idle)
+{
+	k_spinlock_key_t key = k_spin_lock(&coord_lock);
+	int64_t now = k_uptime_get();
+	enum reg_coord_action act = idle ? reg_coord_on_idle(&coord, now)
+					 : reg_coord_on_send(&coord, now);
+
+	k_spin_unlock(&coord_lock, key);
+	LOG_DBG("%s window: registration update %s", idle ? "Idle" : "Data",
+		act == REG_COORD_UPDATE ? "sent" : "suppressed");
+	if (act == REG_COORD_UPDATE) {
+		atomic_set(&coord_update_pending, 1);
+	}
+	return act == REG_COORD_UPDATE;
+}
+
+/*
+ * Only a registration or an update the coordinator asked for restarts
+ * its refresh clock. An update the engine sent on its own (lifetime
+ * timer) is not taken as one, or the coordinator would be judging its
+ * own decisions by the engine's.
+ */
+static void coord_update_done(bool registration)
+{
+	k_spinlock_key_t key;
+
+	if (!atomic_clear(&coord_update_pending) && !registration) {
+		return;
+	}
+	key = k_spin_lock(&coord_lock);
+	reg_coord_update_done(&coord, k_uptime_get());
+	k_spin_unlock(&coord_lock, key);
+}
+#else
+/* The engine's lifetime timer keeps the registration; an idle window
+ * updates so requests the server queued are not held any longer.
+ */
+static bool update_needed(bool idle)
+{
+	return idle;
+}
+#endif
+
+static void open_work_handler(struct k_work *work)
+{
+	bool idle = atomic_clear(&idle_open);
+
+	ARG_UNUSED(work);
+
+	if (!atomic_set(&window_open, 1)) {
+		LOG_DBG("Send window open");
+	}
+#ifdef CONFIG_AMI_SSED
+	sed_burst_begin();
+#endif
+
+	if (!atomic_get(&registered)) {
+		k_work_cancel_delayable(&gap_work);
+		return;
+	}
+
+	if (update_needed(idle)) {
+		lwm2m_rd_client_update();
+	}
+
+	/* Rearmed here too: a window with nothing to exchange gets no
+	 * RX-off event to rearm it from.
+	 */
+	k_work_reschedule(&gap_work, K_SECONDS(CONFIG_AMI_SEND_WINDOW_MAX_GAP_S));
+}
+
+static void close_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (atomic_cas(&window_open, 1, 0)) {
+		LOG_DBG("Send window closed");
+	}
+#ifdef CONFIG_AMI_SSED
+	sed_burst_end();
+#endif
+
+	/* Registration lost meanwhile: the engine registers on its own */
+	if (!atomic_get(&registered)) {
+		return;
+	}
+
+	k_work_reschedule(&gap_work, K_SECONDS(CONFIG_AMI_SEND_WINDOW_MAX_GAP_S));
+}
+
+static void gap_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	LOG_DBG("No poll for %ds — opening send window",
+		CONFIG_AMI_SEND_WINDOW_MAX_GAP_S);
+	atomic_set(&idle_open, 1);
+	k_work_submit(&open_work);
+}
+
+static void send_window_init_once(void)
+{
+	if (initialized) {
+		return;
+	}
+	k_work_init(&open_work, open_work_handler);
+	k_work_init(&close_work, close_work_handler);
+	k_work_init_delayable(&gap_work, gap_work_handler);
+#ifdef CONFIG_AMI_REG_COORD
+	reg_coord_init(&coord, CONFIG_AMI_REG_REFRESH_S,
+		       CONFIG_AMI_REG_LIVENESS_S);
+#endif
+	initialized = true;
+}
+
+void send_window_set_registered(bool is_registered)
+{
+	send_window_init_once();
+
+	if (is_registered) {
+#ifdef CONFIG_AMI_REG_COORD
+		coord_update_done(true);
+#endif
+		if (!atomic_set(&registered, 1)) {
+			LOG_INF("Send windows active (queue mode, RX %ds)",
+				CONFIG_LWM2M_QUEUE_MODE_UPTIME);
+		}
+		return;
+	}
+
+	atomic_clear(&registered);
+#ifdef CONFIG_AMI_REG_COORD
+	atomic_clear(&coord_update_pending);
+#endif
+	k_work_cancel_delayable(&gap_work);
+}
+
+void send_window_update_done(void)
+{
+#ifdef CONFIG_AMI_REG_COORD
+	coord_update_done(false);
+#endif
+}
+
+void send_window_exchange_acked(void)
+{
+#ifdef CONFIG_AMI_REG_COORD
+	k_spinlock_key_t key = k_spin_lock(&coord_lock);
+
+	reg_coord_exchange_acked(&coord, k_uptime_get());
+	k_spin_unlock(&coord_lock, key);
+#endif
+}
+
+void send_window_open(void)
+{
+	send_window_init_once();
+	k_work_submit(&open_work);
+}
+
+void send_window_rx_off(void)
+{
+	send_window_init_once();
+	k_work_submit(&close_work);
+}
+
+bool send_window_is_open(void)
+{
+	return atomic_get(&window_open) != 0;
+}
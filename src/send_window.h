@@ -0,0 +1,64 @@
+/*
+ * Send Window — LwM2M queue mode with node-chosen radio-active intervals
+ *
+ * With LwM2M 1.1 queue mode the engine turns RX off
+ * CONFIG_LWM2M_QUEUE_MODE_UPTIME after the last exchange, and the
+ * server holds its requests until it hears from the client again. The
+ * engine keeps running throughout: a notification or Send due while RX
+ * is off resumes the link by itself (LWM2M_QUEUE_MODE_NO_MSG_BUFFERING
+ * sends it right away), so observations still meet their pmax.
+ *
+ * A window opens when a DLMS poll cycle has queued its uplink data and
+ * closes on the engine's RX-off event. It never pauses or resumes the
+ * engine — each lwm2m_engine_resume() would cost a registration update
+ * — and only asks for an update when one is due: in idle windows, and
+ * with CONFIG_AMI_REG_COORD as reg_coord.h decides.
+ *
+ * If no poll opens a window for CONFIG_AMI_SEND_WINDOW_MAX_GAP_S, one
+ * is opened anyway, so requests the server queued are never stuck.
+ */
+
+#ifndef SEND_WINDOW_H_
+#define SEND_WINDOW_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Track registration state (RD client event handler)
+ *
+ * @param registered  True after a registration completed
+ */
+void send_window_set_registered(bool registered);
+
+/**
+ * @brief A registration update completed (RD client event handler)
+ *
+ * Counts for the coordinator only if it asked for the update.
+ */
+void send_window_update_done(void);
+
+/**
+ * @brief The server ACKed a Send (liveness for the coordinator)
+ */
+void send_window_exchange_acked(void);
+
+/**
+ * @brief Open a send window (or extend the current one)
+ *
+ * Called when a DLMS poll cycle has produced its uplink data.
+ */
+void send_window_open(void);
+
+/**
+ * @brief The engine's queue-mode RX window timed out: close the window
+ *
+ * Called from the LWM2M_RD_CLIENT_EVENT_QUEUE_MODE_RX_OFF event.
+ */
+void send_window_rx_off(void);
+
+/**
+ * @brief Whether a send window is currently open
+ */
+bool send_window_is_open(void);
+
+#endif /* SEND_WINDOW_H_ */
@@ -0,0 +1,155 @@
+/*
+ * Telemetry Uplink — LwM2M 1.1 Send (SenML-CBOR) batching
+ *
+ * Per-resource Observe notifications cost one CoAP exchange each:
+ * 15 resources (single-phase) or 27 (3-phase) per DLMS poll, every one
+ * with its own 6LoWPAN fragment train, ACK and pending-message slot
+ * (CONFIG_LWM2M_ENGINE_MAX_PENDING). A single Send of /10242/0 carries
+ * the whole instance in one SenML-CBOR payload instead.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <string.h>
+
+#include "telemetry_uplink.h"
+#ifdef CONFIG_AMI_AIRTIME
+#include "airtime.h"
+#endif
+#ifdef CONFIG_AMI_SEND_WINDOW
+#include "send_window.h"
+#endif
+
+LOG_MODULE_REGISTER(uplink, LOG_LEVEL_INF);
+
+static struct lwm2m_ctx *uplink_ctx;
+static volatile bool registered;
+static struct uplink_stats stats;
+static uplink_done_cb_t series_done;
+
+/* Reply callback — runs in the LwM2M engine thread */
+static void send_reply_cb(enum lwm2m_send_status status)
+{
+	switch (status) {
+	case LWM2M_SEND_STATUS_SUCCESS:
+		stats.acked++;
+		LOG_DBG("Send ACKed");
+#ifdef CONFIG_AMI_SEND_WINDOW
+		send_window_exchange_acked();
+#endif
+		break;
+	case LWM2M_SEND_STATUS_TIMEOUT:
+		stats.timeouts++;
+		LOG_WRN("Send timed out");
+		break;
+	default:
+		stats.failed++;
+		LOG_WRN("Send failed (status=%d)", status);
+		break;
+	}
+}
+
+/*
+ * lwm2m_send_cb() carries no user data, so series Sends get their own
+ * reply callback and a single completion slot.
+ */
+static void series_reply_cb(enum lwm2m_send_status status)
+{
+	uplink_done_cb_t done = series_done;
+
+	series_done = NULL;
+	send_reply_cb(status);
+	if (done) {
+		done(status == LWM2M_SEND_STATUS_SUCCESS);
+	}
+}
+
+void uplink_init(struct lwm2m_ctx *ctx)
+{
+	uplink_ctx = ctx;
+	registered = false;
+	series_done = NULL;
+	memset(&stats, 0, sizeof(stats));
+
+	LOG_INF("Telemetry uplink ready (LwM2M Send, SenML-CBOR)");
+}
+
+void uplink_set_registered(bool is_registered)
+{
+	registered = is_registered;
+}
+
+bool uplink_is_registered(void)
+{
+	return registered;
+}
+
+int uplink_send(const struct lwm2m_obj_path *paths, uint8_t count)
+{
+	if (!paths || count == 0 || count > UPLINK_MAX_PATHS) {
+		return -EINVAL;
+	}
+
+	if (!uplink_ctx || !registered) {
+		return -ENOTCONN;
+	}
+
+#ifdef CONFIG_AMI_AIRTIME
+	airtime_hint_send(paths[0].obj_id);
+#endif
+	int ret = lwm2m_send_cb(uplink_ctx, paths, count, send_reply_cb);
+	if (ret < 0) {
+		stats.failed++;
+		LOG_WRN("lwm2m_send_cb failed: %d", ret);
+		return ret;
+	}
+
+	stats.sent++;
+	return 0;
+}
+
+int uplink_send_series(const struct lwm2m_obj_path *paths, uint8_t count,
+		       uplink_done_cb_t done)
+{
+	if (!paths || count == 0 || count > UPLINK_MAX_PATHS || !done) {
+		return -EINVAL;
+	}
+
+	if (!uplink_ctx || !registered) {
+		return -ENOTCONN;
+	}
+
+	if (series_done) {
+		return -EBUSY;
+	}
+
+	series_done = done;
+#ifdef CONFIG_AMI_AIRTIME
+	airtime_hint_send(paths[0].obj_id);
+#endif
+	int ret = lwm2m_send_cb(uplink_ctx, paths, count, series_reply_cb);
+	if (ret < 0) {
+		series_done = NULL;
+		stats.failed++;
+		LOG_WRN("lwm2m_send_cb (series) failed: %d", ret);
+		return ret;
+	}
+
+	stats.sent++;
+	return 0;
+}
+
+int uplink_send_inst(uint16_t obj_id, uint16_t obj_inst_id)
+{
+	const struct lwm2m_obj_path path = LWM2M_OBJ(obj_id, obj_inst_id);
+
+	return uplink_send(&path, 1);
+}
+
+void uplink_get_stats(struct uplink_stats *out)
+{
+	if (out) {
+		*out = stats;
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * Telemetry Uplink — LwM2M 1.1 Send (SenML-CBOR) batching
+ *
+ * Instead of one CoAP notification per resource (up to 27 per DLMS poll),
+ * callers hand a list of object/instance paths to uplink_send() and the
+ * engine encodes them into a single SenML-CBOR Send message.
+ *
+ * Send is only legal while registered; callers fall back to per-resource
+ * lwm2m_notify_observer() when uplink_send() returns an error.
+ */
+
+#ifndef TELEMETRY_UPLINK_H_
+#define TELEMETRY_UPLINK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/net/lwm2m.h>
+
+/* Maximum number of paths accepted by a single uplink_send() call */
+#define UPLINK_MAX_PATHS  8
+
+/* Completion callback for uplink_send_series(): true if ACKed */
+typedef void (*uplink_done_cb_t)(bool acked);
+
+/* Cumulative Send statistics */
+struct uplink_stats {
+	uint32_t sent;        /* Send requests handed to the engine */
+	uint32_t acked;       /* Send requests ACKed by the server */
+	uint32_t timeouts;    /* Send requests that timed out */
+	uint32_t failed;      /* Send requests rejected locally */
+};
+
+/**
+ * @brief Bind the uplink to the RD client context
+ *
+ * Must be called once after lwm2m_rd_client_start().
+ *
+ * @param ctx  LwM2M client context used for Send operations
+ */
+void uplink_init(struct lwm2m_ctx *ctx);
+
+/**
+ * @brief Track LwM2M registration state
+ *
+ * Called from the RD client event handler. While unregistered,
+ * uplink_send() fails fast with -ENOTCONN.
+ *
+ * @param registered  True once registration (or update) completed
+ */
+void uplink_set_registered(bool registered);
+
+/**
+ * @brief Query LwM2M registration state as seen by the uplink
+ *
+ * @return true if registered with the server
+ */
+bool uplink_is_registered(void);
+
+/**
+ * @brief Send a list of paths in one LwM2M Send (SenML-CBOR) message
+ *
+ * @param paths  Object, instance or resource paths to include
+ * @param count  Number of paths (1..UPLINK_MAX_PATHS)
+ * @return 0 if the Send was queued, negative errno otherwise
+ */
+int uplink_send(const struct lwm2m_obj_path *paths, uint8_t count);
+
+/**
+ * @brief Convenience: send a whole object instance (e.g. /10242/0)
+ *
+ * @param obj_id       Object ID
+ * @param obj_inst_id  Object instance ID
+ * @return 0 if the Send was queued, negative errno otherwise
+ */
+int uplink_send_inst(uint16_t obj_id, uint16_t obj_inst_id);
+
+/**
+ * @brief Send paths whose resources carry time-series cache entries
+ *
+ * Like uplink_send(), but @p done is invoked from the LwM2M engine
+ * thread with the outcome so the caller can release buffered data
+ * only once the server has it. One series Send may be in flight at
+ * a time.
+ *
+ * @param paths  Resource paths with lwm2m_enable_cache() buffers
+ * @param count  Number of paths (1..UPLINK_MAX_PATHS)
+ * @param done   Completion callback (required)
+ * @return 0 if queued, -EBUSY if a series Send is in flight,
+ *         negative errno otherwise
+ */
+int uplink_send_series(const struct lwm2m_obj_path *paths, uint8_t count,
+		       uplink_done_cb_t done);
+
+/**
+ * @brief Get cumulative Send statistics
+ *
+ * @param stats  Output structure
+ */
+void uplink_get_stats(struct uplink_stats *stats);
+
+#endif /* TELEMETRY_UPLINK_H_ */
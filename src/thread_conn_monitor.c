@@ -14,8 +14,16 @@
  *   RID 0: Thread Role (string: "Disabled"/"Detached"/"Child"/"Router"/"Leader")
  *   RID 1: Partition ID
  *   RID 2-9: MAC Counters (TX/RX Total, Unicast, Broadcast, Errors)
+ *   RID 10-15: TX/RX frames/s, TX/RX error %, counter resets, window span
  *
  * Note: RLOC16, Channel, Parent RSSI/LQI/RLOC moved to Objects 10483/10485.
+ *
+ * Updates are event-driven: OpenThread state changes (role, partition,
+ * parent/link quality, addresses) trigger an immediate refresh of just
+ * the affected resources. A timer samples only the MAC counters, from
+ * which the rates are computed over a sliding window. The counters
+ * are published once per CONFIG_AMI_THREAD_METRICS_INTERVAL; a rate
+ * in between only when it moves past its threshold (mac_rate.h).
  */
 
 #include <zephyr/kernel.h>
@@ -29,9 +37,9 @@
 #include <openthread/ip6.h>
 #include <openthread/dataset.h>
 
-#include <math.h>
-
 #include "lwm2m_obj_thread_diag.h"
+#include "mac_rate.h"
+#include "thread_metrics.h"
 
 /* Internal headers for custom object creation */
 #include "lwm2m_object.h"
@@ -40,12 +48,16 @@
 LOG_MODULE_REGISTER(thread_conn, LOG_LEVEL_INF);
 
 /* ================================================================
- * Object 33000 — Thread MAC Diagnostics (Reduced v2.0)
+ * Object 33000 — Thread MAC Diagnostics (Reduced v2.1)
  * ================================================================ */
 
-#define THREAD_DIAG_MAX_ID    10  /* resource IDs 0..9 */
+#define THREAD_DIAG_MAX_ID    16  /* resource IDs 0..15 */
 #define THREAD_DIAG_MAX_INST  1
 
+/* Snapshot limits — bounded copy work under the OpenThread mutex */
+#define CONNMON_MAX_NEIGHBORS 16
+#define CONNMON_MAX_IPV6      4
+
 /* Static data buffers — reduced: only Role, Partition ID, MAC counters */
 static char     role_str[12];
 static uint32_t partition_id_val;
@@ -57,6 +69,12 @@ static uint32_t tx_broadcast;
 static uint32_t rx_broadcast;
 static uint32_t tx_err_abort;
 static uint32_t rx_err_no_frame;
+static double   tx_fps;
+static double   rx_fps;
+static double   tx_err_pct;
+static double   rx_err_pct;
+static uint32_t counter_resets;
+static uint32_t rate_window_s;
 
 /* LwM2M object structures */
 static struct lwm2m_engine_obj thread_diag_obj;
@@ -72,6 +90,12 @@ static struct lwm2m_engine_obj_field thread_diag_fields[] = {
 	OBJ_FIELD_DATA(TD_RX_BROADCAST_RID, R, U32),
 	OBJ_FIELD_DATA(TD_TX_ERR_ABORT_RID, R, U32),
 	OBJ_FIELD_DATA(TD_RX_ERR_NOFRAME_RID, R, U32),
+	OBJ_FIELD_DATA(TD_TX_FPS_RID, R, FLOAT),
+	OBJ_FIELD_DATA(TD_RX_FPS_RID, R, FLOAT),
+	OBJ_FIELD_DATA(TD_TX_ERR_PCT_RID, R, FLOAT),
+	OBJ_FIELD_DATA(TD_RX_ERR_PCT_RID, R, FLOAT),
+	OBJ_FIELD_DATA(TD_COUNTER_RESETS_RID, R, U32),
+	OBJ_FIELD_DATA(TD_RATE_WINDOW_RID, R, U32),
 };
 
 static struct lwm2m_engine_obj_inst thread_diag_inst;
@@ -104,6 +128,18 @@ static struct lwm2m_engine_obj_inst *thread_diag_create(uint16_t obj_inst_id)
 			  &tx_err_abort, sizeof(tx_err_abort));
 	INIT_OBJ_RES_DATA(TD_RX_ERR_NOFRAME_RID, thread_diag_res, i, thread_diag_ri, j,
 			  &rx_err_no_frame, sizeof(rx_err_no_frame));
+	INIT_OBJ_RES_DATA(TD_TX_FPS_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &tx_fps, sizeof(tx_fps));
+	INIT_OBJ_RES_DATA(TD_RX_FPS_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &rx_fps, sizeof(rx_fps));
+	INIT_OBJ_RES_DATA(TD_TX_ERR_PCT_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &tx_err_pct, sizeof(tx_err_pct));
+	INIT_OBJ_RES_DATA(TD_RX_ERR_PCT_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &rx_err_pct, sizeof(rx_err_pct));
+	INIT_OBJ_RES_DATA(TD_COUNTER_RESETS_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &counter_resets, sizeof(counter_resets));
+	INIT_OBJ_RES_DATA(TD_RATE_WINDOW_RID, thread_diag_res, i, thread_diag_ri, j,
+			  &rate_window_s, sizeof(rate_window_s));
 
 	thread_diag_inst.resources = thread_diag_res;
 	thread_diag_inst.resource_count = i;
@@ -118,7 +154,7 @@ void init_thread_diag_object(void)
 
 	thread_diag_obj.obj_id = THREAD_DIAG_OBJECT_ID;
 	thread_diag_obj.version_major = 2;
-	thread_diag_obj.version_minor = 0;
+	thread_diag_obj.version_minor = 1;
 	thread_diag_obj.is_core = false;
 	thread_diag_obj.fields = thread_diag_fields;
 	thread_diag_obj.field_count = ARRAY_SIZE(thread_diag_fields);
@@ -137,25 +173,103 @@ void init_thread_diag_object(void)
 }
 
 /* ================================================================
- * Object 4 initialization — set Thread-specific defaults
+ * Snapshot — raw OpenThread state copied under the OT mutex.
+ * Everything that costs time (neighbor selection, IPv6 formatting,
+ * LwM2M writes) works on this copy after the mutex is released.
+ * Only the groups named in "what" are copied.
  * ================================================================ */
 
-void init_connmon_thread(void)
+#define CONNMON_ROLE   BIT(0)  /* Role, partition ID */
+#define CONNMON_LINK   BIT(1)  /* Best neighbor / parent RSSI + LQI */
+#define CONNMON_ADDR   BIT(2)  /* Unicast IPv6 list */
+#define CONNMON_ROUTER BIT(3)  /* Leader ALOC (mesh-local prefix) */
+#define CONNMON_MAC    BIT(4)  /* MAC counters */
+#define CONNMON_ALL    (CONNMON_ROLE | CONNMON_LINK | CONNMON_ADDR | \
+			CONNMON_ROUTER | CONNMON_MAC)
+
+struct connmon_snapshot {
+	otDeviceRole role;
+	uint32_t partition_id;
+	otNeighborInfo neighbors[CONNMON_MAX_NEIGHBORS];
+	int neighbor_count;
+	int8_t parent_rssi;
+	bool parent_rssi_valid;
+	uint8_t parent_lqi;
+	otMacCounters mac;
+	bool mac_valid;
+	otIp6Address addrs[CONNMON_MAX_IPV6];
+	int addr_count;
+	otMeshLocalPrefix mlp;
+	bool mlp_valid;
+};
+
+static void connmon_snapshot_take(struct otInstance *ot,
+				  struct connmon_snapshot *snap, uint32_t what)
 {
-	/* Set network bearer to IEEE 802.15.4 (21) */
-	lwm2m_set_u8(&LWM2M_OBJ(4, 0, 0), 21);
+	otNeighborInfoIterator iter = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+	const otNetifAddress *addr;
+	const otMeshLocalPrefix *mlp;
+	const otMacCounters *mac;
+	otRouterInfo pi;
 
-	/* Available bearers: instance 0 = 802.15.4 */
-	lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 1, 0));
-	uint8_t bearer = 21;
-	lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 1, 0), &bearer,
-			  sizeof(bearer), sizeof(bearer), 0);
+	memset(snap, 0, sizeof(*snap));
 
-	LOG_INF("Object 4 (Connectivity Monitoring) initialized for Thread");
+	openthread_mutex_lock();
+
+	if (what & CONNMON_ROLE) {
+		snap->role = otThreadGetDeviceRole(ot);
+		snap->partition_id = otThreadGetPartitionId(ot);
+	}
+
+	if (what & CONNMON_LINK) {
+		while (snap->neighbor_count < CONNMON_MAX_NEIGHBORS &&
+		       otThreadGetNextNeighborInfo(ot, &iter,
+				&snap->neighbors[snap->neighbor_count]) == OT_ERROR_NONE) {
+			snap->neighbor_count++;
+		}
+
+		if (otThreadGetParentAverageRssi(ot, &snap->parent_rssi) == OT_ERROR_NONE &&
+		    snap->parent_rssi != 0) {
+			snap->parent_rssi_valid = true;
+			if (otThreadGetParentInfo(ot, &pi) == OT_ERROR_NONE) {
+				snap->parent_lqi = pi.mLinkQualityIn;
+			}
+		}
+	}
+
+	if (what & CONNMON_MAC) {
+		mac = otLinkGetCounters(ot);
+		if (mac) {
+			snap->mac = *mac;
+			snap->mac_valid = true;
+		}
+	}
+
+	if (what & CONNMON_ADDR) {
+		for (addr = otIp6GetUnicastAddresses(ot);
+		     addr != NULL && snap->addr_count < CONNMON_MAX_IPV6;
+		     addr = addr->mNext) {
+			if (addr->mValid) {
+				snap->addrs[snap->addr_count++] = addr->mAddress;
+			}
+		}
+	}
+
+	if (what & CONNMON_ROUTER) {
+		mlp = otThreadGetMeshLocalPrefix(ot);
+		if (mlp) {
+			snap->mlp = *mlp;
+			snap->mlp_valid = true;
+		}
+	}
+
+	openthread_mutex_unlock();
 }
 
 /* ================================================================
- * Periodic update — called from main loop
+ * Publishers — one per snapshot group. lwm2m_set_*() notifies
+ * observers only when the value actually changed; OPTDATA buffers
+ * (IPv6 lists) are compared here and notified explicitly.
  * ================================================================ */
 
 static const char *role_to_str(otDeviceRole role)
@@ -171,21 +285,20 @@ static const char *role_to_str(otDeviceRole role)
 }
 
 /*
- * Compute best RSSI across all neighbors in the Thread neighbor table.
- * Returns the highest (least negative) average RSSI.
- * For a Child, this is typically the parent. For a Router, the best peer.
+ * Best RSSI across the snapshotted neighbor table: the highest (least
+ * negative) average RSSI. For a Child this is typically the parent,
+ * for a Router the best peer.
  */
-static int16_t compute_best_neighbor_rssi(struct otInstance *ot, uint8_t *best_lqi)
+static int16_t compute_best_neighbor_rssi(const struct connmon_snapshot *snap,
+					  uint8_t *best_lqi)
 {
-	otNeighborInfoIterator iter = OT_NEIGHBOR_INFO_ITERATOR_INIT;
-	otNeighborInfo ninfo;
 	int16_t best_rssi = -128;  /* worst possible */
 	uint8_t best_lqi_val = 0;
 
-	while (otThreadGetNextNeighborInfo(ot, &iter, &ninfo) == OT_ERROR_NONE) {
-		if (ninfo.mAverageRssi > best_rssi) {
-			best_rssi = ninfo.mAverageRssi;
-			best_lqi_val = ninfo.mLinkQualityIn;
+	for (int i = 0; i < snap->neighbor_count; i++) {
+		if (snap->neighbors[i].mAverageRssi > best_rssi) {
+			best_rssi = snap->neighbors[i].mAverageRssi;
+			best_lqi_val = snap->neighbors[i].mLinkQualityIn;
 		}
 	}
 
@@ -209,148 +322,352 @@ static int16_t lqi_to_percent(uint8_t lqi)
 	}
 }
 
-void update_connectivity_metrics(void)
+static void publish_role(const struct connmon_snapshot *snap)
 {
-	struct otInstance *ot = openthread_get_default_instance();
-	if (!ot) {
-		return;
-	}
-
-	openthread_mutex_lock();
-
-	/* ---- Thread role ---- */
-	otDeviceRole role = otThreadGetDeviceRole(ot);
-	const char *role_name = role_to_str(role);
 	lwm2m_set_string(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_ROLE_RID),
-			 role_name);
+			 role_to_str(snap->role));
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_PARTITION_ID_RID),
+		      snap->partition_id);
+	lwm2m_set_u32(&LWM2M_OBJ(4, 0, 8), snap->partition_id);  /* Cell ID */
 
-	/* ---- Partition ID ---- */
-	partition_id_val = otThreadGetPartitionId(ot);
+	LOG_INF("Obj33000: role=%s part=%u", role_str, partition_id_val);
+}
 
-	/* ---- REAL RSSI for Object 4 ---- */
+static void publish_link(const struct connmon_snapshot *snap)
+{
 	/* Scan ALL neighbors to find the best RSSI (works for Router AND Child) */
 	uint8_t best_lqi = 0;
-	int16_t best_rssi = compute_best_neighbor_rssi(ot, &best_lqi);
+	int16_t best_rssi = compute_best_neighbor_rssi(snap, &best_lqi);
 
 	/* Fallback to parent RSSI if neighbor table is empty (e.g. just attached) */
-	if (best_rssi <= -128) {
-		int8_t p_rssi = 0;
-		if (otThreadGetParentAverageRssi(ot, &p_rssi) == OT_ERROR_NONE &&
-		    p_rssi != 0) {
-			best_rssi = (int16_t)p_rssi;
-			otRouterInfo pi;
-			if (otThreadGetParentInfo(ot, &pi) == OT_ERROR_NONE) {
-				best_lqi = pi.mLinkQualityIn;
-			}
-		}
+	if (best_rssi <= -128 && snap->parent_rssi_valid) {
+		best_rssi = (int16_t)snap->parent_rssi;
+		best_lqi = snap->parent_lqi;
 	}
 
-	/* ---- MAC Counters ---- */
-	const otMacCounters *mac = otLinkGetCounters(ot);
-	if (mac) {
-		tx_total     = mac->mTxTotal;
-		rx_total     = mac->mRxTotal;
-		tx_unicast   = mac->mTxUnicast;
-		rx_unicast   = mac->mRxUnicast;
-		tx_broadcast = mac->mTxBroadcast;
-		rx_broadcast = mac->mRxBroadcast;
-		tx_err_abort = mac->mTxErrAbort;
-		rx_err_no_frame = mac->mRxErrNoFrame;
-	}
+	lwm2m_set_s16(&LWM2M_OBJ(4, 0, 2), best_rssi);
+	lwm2m_set_s16(&LWM2M_OBJ(4, 0, 3), lqi_to_percent(best_lqi));
 
-	/* ---- Collect IPv6 addresses from OpenThread directly ---- */
-	/* This is more reliable than Zephyr net_if for Thread addresses */
-	static char ip_strs[4][48];  /* up to 4 addresses, 48 chars each */
-	int ip_count = 0;
-	const otNetifAddress *addr = otIp6GetUnicastAddresses(ot);
+	LOG_INF("Obj4: RSSI=%ddBm LQI=%u%%", best_rssi, lqi_to_percent(best_lqi));
+}
 
-	for (; addr != NULL && ip_count < 4; addr = addr->mNext) {
-		if (!addr->mValid) {
+static void publish_addrs(const struct connmon_snapshot *snap)
+{
+	/* OPTDATA resources have no pre-allocated buffer, must use set_res_buf */
+	static char ip_strs[CONNMON_MAX_IPV6][48];
+	static int prev_ip_count;
+	bool changed = (snap->addr_count != prev_ip_count);
+	char ip[48];
+
+	for (int i = 0; i < snap->addr_count; i++) {
+		otIp6AddressToString(&snap->addrs[i], ip, sizeof(ip));
+		if (i >= prev_ip_count) {
+			lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 4, i));
+		} else if (strcmp(ip, ip_strs[i]) == 0) {
 			continue;
 		}
-		otIp6AddressToString(&addr->mAddress, ip_strs[ip_count],
-				     sizeof(ip_strs[ip_count]));
-		ip_count++;
+		strcpy(ip_strs[i], ip);
+		lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 4, i),
+				  ip_strs[i], sizeof(ip_strs[i]),
+				  strlen(ip_strs[i]) + 1, 0);
+		changed = true;
 	}
+	for (int i = snap->addr_count; i < prev_ip_count; i++) {
+		lwm2m_delete_res_inst(&LWM2M_OBJ(4, 0, 4, i));
+	}
+	prev_ip_count = snap->addr_count;
 
-	/* ---- Build Router/Gateway IP (Leader ALOC) ---- */
+	if (changed) {
+		lwm2m_notify_observer(4, 0, 4);
+		LOG_INF("Obj4: %d IPv6 address(es)", prev_ip_count);
+	}
+}
+
+static void publish_router(const struct connmon_snapshot *snap)
+{
 	static char router_ip_str[48];
-	const otIp6Address *leader_rloc = otThreadGetRloc(ot);
-	if (leader_rloc) {
-		/* Construct Leader ALOC: mesh-local prefix + 0000:00ff:fe00:fc00 */
-		const otMeshLocalPrefix *mlp = otThreadGetMeshLocalPrefix(ot);
-		if (mlp) {
-			otIp6Address leader_aloc;
-			memcpy(&leader_aloc, mlp->m8, 8);
-			leader_aloc.mFields.m8[8]  = 0x00;
-			leader_aloc.mFields.m8[9]  = 0x00;
-			leader_aloc.mFields.m8[10] = 0x00;
-			leader_aloc.mFields.m8[11] = 0xff;
-			leader_aloc.mFields.m8[12] = 0xfe;
-			leader_aloc.mFields.m8[13] = 0x00;
-			leader_aloc.mFields.m8[14] = 0xfc;
-			leader_aloc.mFields.m8[15] = 0x00;
-			otIp6AddressToString(&leader_aloc, router_ip_str,
-					     sizeof(router_ip_str));
-		}
+	static bool router_ip_created;
+	char ip[48];
+
+	if (!snap->mlp_valid) {
+		return;
 	}
 
-	openthread_mutex_unlock();
+	/* Construct Leader ALOC: mesh-local prefix + 0000:00ff:fe00:fc00 */
+	otIp6Address leader_aloc;
+	memcpy(&leader_aloc, snap->mlp.m8, 8);
+	leader_aloc.mFields.m8[8]  = 0x00;
+	leader_aloc.mFields.m8[9]  = 0x00;
+	leader_aloc.mFields.m8[10] = 0x00;
+	leader_aloc.mFields.m8[11] = 0xff;
+	leader_aloc.mFields.m8[12] = 0xfe;
+	leader_aloc.mFields.m8[13] = 0x00;
+	leader_aloc.mFields.m8[14] = 0xfc;
+	leader_aloc.mFields.m8[15] = 0x00;
+	otIp6AddressToString(&leader_aloc, ip, sizeof(ip));
+
+	if (router_ip_created && strcmp(ip, router_ip_str) == 0) {
+		return;
+	}
 
-	/* ---- Update Object 4 with REAL Thread data ---- */
-	lwm2m_set_u32(&LWM2M_OBJ(4, 0, 8), partition_id_val);           /* Cell ID */
+	strcpy(router_ip_str, ip);
+	if (!router_ip_created) {
+		lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 5, 0));
+		router_ip_created = true;
+	}
+	lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 5, 0),
+			  router_ip_str, sizeof(router_ip_str),
+			  strlen(router_ip_str) + 1, 0);
+	lwm2m_notify_observer(4, 0, 5);
 
-	/* ---- Update Object 4 IP addresses (RID 4) from OpenThread ---- */
-	/* OPTDATA resources have no pre-allocated buffer, must use set_res_buf */
-	static int prev_ip_count = 0;
-	for (int i = 0; i < ip_count; i++) {
-		if (i >= prev_ip_count) {
-			lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 4, i));
+	LOG_INF("Obj4: router=%s", router_ip_str);
+}
+
+/* Counters and the full rate set go out on the slow metrics period */
+#define MAC_PUBLISH_MS  (CONFIG_AMI_THREAD_METRICS_INTERVAL * 1000)
+
+static int64_t mac_next_publish_ms;  /* 0: publish on the first sample */
+
+static bool mac_publish_due(void)
+{
+	int64_t now = k_uptime_get();
+
+	if (mac_next_publish_ms != 0 && now < mac_next_publish_ms) {
+		return false;
+	}
+	mac_next_publish_ms = now + MAC_PUBLISH_MS;
+	return true;
+}
+
+static void publish_mac(const struct connmon_snapshot *snap)
+{
+	if (!snap->mac_valid) {
+		return;
+	}
+
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_TOTAL_RID),
+		      snap->mac.mTxTotal);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_TOTAL_RID),
+		      snap->mac.mRxTotal);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_UNICAST_RID),
+		      snap->mac.mTxUnicast);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_UNICAST_RID),
+		      snap->mac.mRxUnicast);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_BROADCAST_RID),
+		      snap->mac.mTxBroadcast);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_BROADCAST_RID),
+		      snap->mac.mRxBroadcast);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_ERR_ABORT_RID),
+		      snap->mac.mTxErrAbort);
+	lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_ERR_NOFRAME_RID),
+		      snap->mac.mRxErrNoFrame);
+
+	LOG_INF("Obj33000: TX=%u RX=%u", tx_total, rx_total);
+}
+
+/*
+ * Feed the MAC rate window on every sample. All rates are published
+ * with the counters (@p full); in between only a rate that moved past
+ * its threshold, so an error spike still reaches observers early
+ * without a notification per sample.
+ */
+static void publish_mac_rates(const struct connmon_snapshot *snap, bool full)
+{
+	static struct mac_rate_window win;
+	static struct mac_rates published;
+	const otMacCounters *m = &snap->mac;
+	struct mac_rates rates;
+	uint32_t changed;
+
+	if (!snap->mac_valid) {
+		return;
+	}
+
+	struct mac_sample s = {
+		.t_ms = k_uptime_get(),
+		.tx_total = m->mTxTotal,
+		.rx_total = m->mRxTotal,
+		.tx_err = m->mTxErrCca + m->mTxErrAbort + m->mTxErrBusyChannel,
+		.rx_err = m->mRxErrNoFrame + m->mRxErrUnknownNeighbor +
+			  m->mRxErrInvalidSrcAddr + m->mRxErrSec +
+			  m->mRxErrFcs + m->mRxErrOther,
+	};
+
+	if (mac_rate_push(&win, &s)) {
+		LOG_WRN("Obj33000: MAC counters reset (%u so far)", win.resets);
+		lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_COUNTER_RESETS_RID),
+			      win.resets);
+	}
+
+	if (mac_rate_get(&win, &rates) < 0) {
+		return;
+	}
+
+	changed = full ? (MAC_RATE_TX_FPS | MAC_RATE_RX_FPS |
+			  MAC_RATE_TX_ERR_PCT | MAC_RATE_RX_ERR_PCT)
+		       : mac_rate_changes(&published, &rates);
+	if (!changed) {
+		return;
+	}
+
+	if (changed & MAC_RATE_TX_FPS) {
+		lwm2m_set_f64(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_FPS_RID),
+			      rates.tx_fps);
+		published.tx_fps = rates.tx_fps;
+	}
+	if (changed & MAC_RATE_RX_FPS) {
+		lwm2m_set_f64(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_FPS_RID),
+			      rates.rx_fps);
+		published.rx_fps = rates.rx_fps;
+	}
+	if (changed & MAC_RATE_TX_ERR_PCT) {
+		lwm2m_set_f64(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_TX_ERR_PCT_RID),
+			      rates.tx_err_pct);
+		published.tx_err_pct = rates.tx_err_pct;
+	}
+	if (changed & MAC_RATE_RX_ERR_PCT) {
+		lwm2m_set_f64(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RX_ERR_PCT_RID),
+			      rates.rx_err_pct);
+		published.rx_err_pct = rates.rx_err_pct;
+	}
+	if (full) {
+		lwm2m_set_u32(&LWM2M_OBJ(THREAD_DIAG_OBJECT_ID, 0, TD_RATE_WINDOW_RID),
+			      rates.span_ms / 1000);
+	}
+
+	LOG_INF("Obj33000: %.1f/%.1f fps, err %.1f%%/%.1f%% over %us",
+		rates.tx_fps, rates.rx_fps, rates.tx_err_pct, rates.rx_err_pct,
+		rates.span_ms / 1000);
+}
+
+static void connmon_refresh(uint32_t what)
+{
+	struct otInstance *ot = openthread_get_default_instance();
+	if (!ot) {
+		return;
+	}
+
+	/* static: keeps the neighbor array off the work queue stack */
+	static struct connmon_snapshot snap;
+
+	connmon_snapshot_take(ot, &snap, what);
+
+	if (what & CONNMON_ROLE) {
+		publish_role(&snap);
+	}
+	if (what & CONNMON_LINK) {
+		publish_link(&snap);
+	}
+	if (what & CONNMON_ADDR) {
+		publish_addrs(&snap);
+	}
+	if (what & CONNMON_ROUTER) {
+		publish_router(&snap);
+	}
+	if (what & CONNMON_MAC) {
+		bool full = mac_publish_due();
+
+		if (full) {
+			publish_mac(&snap);
 		}
-		lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 4, i),
-				  ip_strs[i], sizeof(ip_strs[i]),
-				  strlen(ip_strs[i]) + 1, 0);
+		publish_mac_rates(&snap, full);
 	}
-	prev_ip_count = ip_count;
+}
 
-	/* ---- Update Object 4 Router IP Addresses (RID 5) ---- */
-	static bool router_ip_created = false;
-	if (router_ip_str[0] != '\0') {
-		if (!router_ip_created) {
-			lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 5, 0));
-			router_ip_created = true;
+/* ================================================================
+ * Event path — OpenThread state changes
+ *
+ * The OT callback runs in the OpenThread thread with its mutex held,
+ * so it only translates flags into snapshot groups; the refresh runs
+ * on the Thread metrics work queue.
+ * ================================================================ */
+
+static const struct {
+	otChangedFlags flags;
+	uint32_t what;
+} connmon_event_map[] = {
+	{ OT_CHANGED_THREAD_ROLE,
+	  CONNMON_ROLE | CONNMON_LINK | CONNMON_ROUTER },
+	{ OT_CHANGED_THREAD_PARTITION_ID, CONNMON_ROLE },
+	/* A child's RLOC16 changes when it moves to a new parent */
+	{ OT_CHANGED_THREAD_RLOC_ADDED | OT_CHANGED_PARENT_LINK_QUALITY |
+	  OT_CHANGED_THREAD_CHILD_ADDED | OT_CHANGED_THREAD_CHILD_REMOVED,
+	  CONNMON_LINK },
+	{ OT_CHANGED_IP6_ADDRESS_ADDED | OT_CHANGED_IP6_ADDRESS_REMOVED,
+	  CONNMON_ADDR },
+	{ OT_CHANGED_THREAD_ML_ADDR | OT_CHANGED_ACTIVE_DATASET,
+	  CONNMON_ROUTER },
+};
+
+static atomic_t connmon_pending;
+static struct k_work connmon_event_work;
+static struct openthread_state_changed_callback connmon_ot_cb;
+
+static void connmon_event_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	uint32_t what = (uint32_t)atomic_clear(&connmon_pending);
+
+	if (what) {
+		connmon_refresh(what);
+	}
+}
+
+static void connmon_ot_state_changed(otChangedFlags flags, void *user_data)
+{
+	uint32_t what = 0;
+
+	ARG_UNUSED(user_data);
+
+	for (int i = 0; i < ARRAY_SIZE(connmon_event_map); i++) {
+		if (flags & connmon_event_map[i].flags) {
+			what |= connmon_event_map[i].what;
 		}
-		lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 5, 0),
-				  router_ip_str, sizeof(router_ip_str),
-				  strlen(router_ip_str) + 1, 0);
-	}
-
-	/* ---- Update & notify all observers (v0.18.0) ---- */
-	/* Always set values and call notify_observer(). The Zephyr LwM2M
-	 * observe engine enforces pmin/pmax: if the server has set pmin=15s,
-	 * no CoAP notification will be emitted faster than that, even if
-	 * we call notify_observer() every 60s. If pmax is set, the engine
-	 * will force a notification even if the value hasn't changed.
-	 *
-	 * Previous versions used firmware-side filtering (nudge in v0.17.0,
-	 * prev_rssi/prev_lqi_pct initially in v0.18.0), but that violated
-	 * pmax: a stable RSSI would never trigger a notification, even if
-	 * the server expected periodic updates via pmax.
+	}
+
+	if (what) {
+		atomic_or(&connmon_pending, (atomic_val_t)what);
+		thread_metrics_submit(&connmon_event_work);
+	}
+}
+
+/* ================================================================
+ * Object 4 initialization — set Thread-specific defaults
+ * ================================================================ */
+
+void init_connmon_thread(void)
+{
+	/* Set network bearer to IEEE 802.15.4 (21) */
+	lwm2m_set_u8(&LWM2M_OBJ(4, 0, 0), 21);
+
+	/* Available bearers: instance 0 = 802.15.4 */
+	lwm2m_create_res_inst(&LWM2M_OBJ(4, 0, 1, 0));
+	uint8_t bearer = 21;
+	lwm2m_set_res_buf(&LWM2M_OBJ(4, 0, 1, 0), &bearer,
+			  sizeof(bearer), sizeof(bearer), 0);
+
+	/* Event path for role/partition/link/address changes, plus one
+	 * full refresh so every resource starts with real values.
 	 */
-	int16_t lqi_pct = lqi_to_percent(best_lqi);
-
-	lwm2m_set_s16(&LWM2M_OBJ(4, 0, 2), (int16_t)best_rssi);
-	lwm2m_set_s16(&LWM2M_OBJ(4, 0, 3), lqi_pct);
-
-	lwm2m_notify_observer(4, 0, 2);   /* RSSI */
-	lwm2m_notify_observer(4, 0, 3);   /* Link Quality */
-	lwm2m_notify_observer(4, 0, 4);   /* IP Addresses */
-	lwm2m_notify_observer(4, 0, 5);   /* Router IP */
-	lwm2m_notify_observer(THREAD_DIAG_OBJECT_ID, 0, TD_TX_TOTAL_RID);
-	lwm2m_notify_observer(THREAD_DIAG_OBJECT_ID, 0, TD_RX_TOTAL_RID);
-
-	LOG_INF("Obj4: RSSI=%ddBm LQI=%u%% IPs=%d router=%s",
-		best_rssi, lqi_to_percent(best_lqi), ip_count, router_ip_str);
-	LOG_INF("Obj33000: role=%s part=%u TX=%u RX=%u",
-		role_str, partition_id_val, tx_total, rx_total);
+	k_work_init(&connmon_event_work, connmon_event_work_handler);
+	connmon_ot_cb.otCallback = connmon_ot_state_changed;
+	connmon_ot_cb.user_data = NULL;
+	openthread_state_changed_callback_register(&connmon_ot_cb);
+
+	atomic_or(&connmon_pending, CONNMON_ALL);
+	thread_metrics_submit(&connmon_event_work);
+
+	LOG_INF("Object 4 (Connectivity Monitoring) initialized for Thread");
+}
+
+/* ================================================================
+ * Timer — MAC counters and rates only (Thread metrics work queue),
+ * sampled every CONFIG_AMI_MAC_RATE_SAMPLE_INTERVAL seconds and
+ * published as described at publish_mac_rates(). Everything else is
+ * pushed by the event path above.
+ * ================================================================ */
+void update_connectivity_metrics(void)
+{
+	connmon_refresh(CONNMON_MAC);
 }
@@ -0,0 +1,104 @@
+/*
+ * Thread Metrics Scheduler — see thread_metrics.h
+ *
+ * Each job is a k_work_delayable that reschedules itself one period
+ * after it started, so a slow lwm2m_set_*() does not drift the cadence
+ * of the other two jobs.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+#include "thread_metrics.h"
+#include "lwm2m_obj_thread_neighbor.h"
+
+LOG_MODULE_REGISTER(thread_metrics, LOG_LEVEL_INF);
+
+/* Object 33000 MAC counters (thread_conn_monitor.c) */
+extern void update_connectivity_metrics(void);
+
+#define METRICS_PERIOD_MS   (CONFIG_AMI_THREAD_METRICS_INTERVAL * 1000)
+#define METRICS_STAGGER_MS  (METRICS_PERIOD_MS / 2)
+#define MAC_SAMPLE_MS       (CONFIG_AMI_MAC_RATE_SAMPLE_INTERVAL * 1000)
+
+K_THREAD_STACK_DEFINE(metrics_wq_stack, CONFIG_AMI_THREAD_METRICS_STACK_SIZE);
+static struct k_work_q metrics_wq;
+
+struct metrics_job {
+	struct k_work_delayable work;
+	void (*update)(void);
+	const char *name;
+	int32_t period_ms;
+	int32_t offset_ms;
+};
+
+/* Jobs never overlap: they share metrics_wq. The offsets only keep the
+ * two publishing jobs' notifications apart.
+ */
+static struct metrics_job jobs[] = {
+	{ .update = update_connectivity_metrics, .name = "connmon",
+	  .period_ms = MAC_SAMPLE_MS, .offset_ms = 0 },
+	{ .update = update_thread_neighbors,     .name = "neighbors",
+	  .period_ms = METRICS_PERIOD_MS,
+	  .offset_ms = METRICS_STAGGER_MS + MAC_SAMPLE_MS / 2 },
+#if defined(CONFIG_AMI_NEIGHBOR_SAMPLER)
+	/* Feeds the Object 33005 window aggregates */
+	{ .update = sample_thread_neighbors,     .name = "sampler",
+	  .period_ms = CONFIG_AMI_NEIGHBOR_SAMPLE_INTERVAL_MS, .offset_ms = 0 },
+#endif
+};
+
+static void metrics_job_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct metrics_job *job = CONTAINER_OF(dwork, struct metrics_job, work);
+
+	int64_t start = k_uptime_get();
+
+	job->update();
+
+	int64_t elapsed = k_uptime_get() - start;
+	int64_t next = job->period_ms - elapsed;
+
+	if (elapsed > MIN(job->period_ms, METRICS_STAGGER_MS)) {
+		LOG_WRN("%s update took %lld ms", job->name, elapsed);
+	}
+
+	k_work_schedule_for_queue(&metrics_wq, &job->work,
+				  K_MSEC(next > 0 ? next : 0));
+}
+
+/* Started at boot so event work can be submitted from object init on */
+static int thread_metrics_wq_init(void)
+{
+	struct k_work_queue_config cfg = {
+		.name = "thread_metrics",
+		.no_yield = false,
+	};
+
+	k_work_queue_start(&metrics_wq, metrics_wq_stack,
+			   K_THREAD_STACK_SIZEOF(metrics_wq_stack),
+			   CONFIG_AMI_THREAD_METRICS_PRIORITY, &cfg);
+	return 0;
+}
+
+SYS_INIT(thread_metrics_wq_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+void thread_metrics_start(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(jobs); i++) {
+		k_work_init_delayable(&jobs[i].work, metrics_job_handler);
+		k_work_schedule_for_queue(&metrics_wq, &jobs[i].work,
+					  K_MSEC(jobs[i].offset_ms));
+	}
+
+	LOG_INF("Thread metrics every %ds (stagger %dms, prio %d)",
+		CONFIG_AMI_THREAD_METRICS_INTERVAL, METRICS_STAGGER_MS,
+		CONFIG_AMI_THREAD_METRICS_PRIORITY);
+}
+
+void thread_metrics_submit(struct k_work *work)
+{
+	k_work_submit_to_queue(&metrics_wq, work);
+}
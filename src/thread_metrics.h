@@ -0,0 +1,44 @@
+/*
+ * Thread Metrics Scheduler — low-priority work queue for Thread telemetry
+ *
+ * Object 33000 MAC counters (update_connectivity_metrics) and Object
+ * 10485 (update_thread_neighbors) are refreshed from a dedicated preemptible
+ * work queue instead of the main loop. The queue runs one job at a
+ * time, so only one of them holds the OpenThread mutex at a time. The
+ * two publishing jobs also start at staggered offsets, so their
+ * notifications do not land in the same CoAP burst.
+ *
+ * Event-driven updates (OpenThread state-change callbacks) are also
+ * deferred to this queue through thread_metrics_submit().
+ *
+ * With CONFIG_AMI_NEIGHBOR_SAMPLER a third, faster job feeds the
+ * per-neighbor link-quality rings published by Object 33005. It
+ * publishes nothing itself and starts right away.
+ */
+
+#ifndef THREAD_METRICS_H_
+#define THREAD_METRICS_H_
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Start the periodic Thread metrics jobs
+ *
+ * Must be called after the Thread LwM2M objects are initialized. The
+ * first update of each job runs at its start offset, then once per
+ * period of that job.
+ */
+void thread_metrics_start(void);
+
+/**
+ * @brief Run a work item on the Thread metrics work queue
+ *
+ * For OpenThread state-change callbacks, which run in the OpenThread
+ * thread and must not do LwM2M work themselves. The queue runs from
+ * boot, before thread_metrics_start() schedules the periodic jobs.
+ *
+ * @param work  Initialized work item
+ */
+void thread_metrics_submit(struct k_work *work);
+
+#endif /* THREAD_METRICS_H_ */
@@ -0,0 +1,278 @@
+/*
+ * Poll Pipeline Tracing — see trace.h
+ *
+ * Probes run in the DLMS thread, the LwM2M engine thread and the
+ * UART ISR; each one takes the spinlock for the few stores of one
+ * record. Timestamps are raw k_cycle_get_32() counts (the 16 MHz
+ * systimer on the ESP32-C6, wrapping every ~268 s); the decoder
+ * unwraps them, so any dump spanning less than one wrap between
+ * consecutive records is exact.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/lwm2m.h>
+#include <zephyr/shell/shell.h>
+
+#include "trace.h"
+#include "trace_ring.h"
+
+/* Internal headers for custom object creation */
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+LOG_MODULE_REGISTER(trace, LOG_LEVEL_INF);
+
+static uint32_t trace_buf[TRACE_RING_BUF_LEN(CONFIG_AMI_TRACE_EVENTS) / 4];
+static struct trace_ring ring;
+static struct k_spinlock ring_lock;
+
+void trace_event(uint8_t id, uint16_t arg)
+{
+	uint8_t flags = k_is_in_isr() ? TRACE_FLAG_ISR : 0;
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+
+	trace_ring_put(&ring, k_cycle_get_32(), id, flags, arg);
+	k_spin_unlock(&ring_lock, key);
+}
+
+#ifdef CONFIG_AMI_TRACE_HEXDUMP
+void trace_hexdump(uint8_t id, const uint8_t *data, size_t len)
+{
+	uint8_t flags = k_is_in_isr() ? TRACE_FLAG_ISR : 0;
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+
+	trace_ring_put_data(&ring, k_cycle_get_32(), id, flags, data, len,
+			    CONFIG_AMI_TRACE_HEXDUMP_MAX);
+	k_spin_unlock(&ring_lock, key);
+}
+#endif
+
+static size_t trace_freeze(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+	size_t len = trace_ring_freeze(&ring, sys_clock_hw_cycles_per_sec());
+
+	k_spin_unlock(&ring_lock, key);
+	return len;
+}
+
+static void trace_clear(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+
+	trace_ring_clear(&ring);
+	k_spin_unlock(&ring_lock, key);
+}
+
+static int trace_init(void)
+{
+	trace_ring_init(&ring, (uint8_t *)trace_buf, sizeof(trace_buf));
+	ring.enabled = IS_ENABLED(CONFIG_AMI_TRACE_AUTOSTART);
+	return 0;
+}
+
+/* Before the application, so boot-time polls are traced too */
+SYS_INIT(trace_init, APPLICATION, 0);
+
+/* ================================================================
+ * Object 33002 — single instance, values served on read
+ * ================================================================ */
+
+static uint32_t trc_vals[TRC_RES_INST_COUNT];
+
+static struct lwm2m_engine_obj trace_obj;
+
+static struct lwm2m_engine_obj_field trace_fields[] = {
+	OBJ_FIELD_DATA(TRC_DATA_RID, R, OPAQUE),
+	OBJ_FIELD_DATA(TRC_EVENTS_RID, R, U32),
+	OBJ_FIELD_DATA(TRC_OVERWRITTEN_RID, R, U32),
+	OBJ_FIELD_DATA(TRC_CYCLE_HZ_RID, R, U32),
+	OBJ_FIELD(TRC_CLEAR_RID, X_OPT, NONE),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(trace_fields) == TRC_NUM_FIELDS,
+	     "trace_fields[] size mismatch with TRC_NUM_FIELDS");
+
+static struct lwm2m_engine_obj_inst trace_inst;
+static struct lwm2m_engine_res trace_res[TRC_NUM_FIELDS];
+static struct lwm2m_engine_res_inst trace_ri[TRC_RES_INST_COUNT];
+
+static void *trace_read_cb(uint16_t obj_inst_id, uint16_t res_id,
+			   uint16_t res_inst_id, size_t *data_len)
+{
+	k_spinlock_key_t key;
+	uint32_t *v;
+
+	ARG_UNUSED(obj_inst_id);
+	ARG_UNUSED(res_inst_id);
+
+	if (res_id == TRC_DATA_RID) {
+		/* Frozen until cleared: every Block2 block sees one dump */
+		*data_len = trace_freeze();
+		return trace_buf;
+	}
+	if (res_id >= TRC_RES_INST_COUNT) {
+		*data_len = 0;
+		return NULL;
+	}
+
+	v = &trc_vals[res_id];
+	key = k_spin_lock(&ring_lock);
+	switch (res_id) {
+	case TRC_EVENTS_RID:      *v = trace_ring_count(&ring); break;
+	case TRC_OVERWRITTEN_RID: *v = trace_ring_overwritten(&ring); break;
+	case TRC_CYCLE_HZ_RID:    *v = sys_clock_hw_cycles_per_sec(); break;
+	default: break;
+	}
+	k_spin_unlock(&ring_lock, key);
+
+	*data_len = sizeof(*v);
+	return v;
+}
+
+static int trace_clear_cb(uint16_t obj_inst_id, uint8_t *args,
+			  uint16_t args_len)
+{
+	ARG_UNUSED(obj_inst_id);
+	ARG_UNUSED(args);
+	ARG_UNUSED(args_len);
+
+	trace_clear();
+	LOG_INF("Trace cleared by server");
+	return 0;
+}
+
+static struct lwm2m_engine_obj_inst *trace_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+
+	init_res_instance(trace_ri, ARRAY_SIZE(trace_ri));
+
+	INIT_OBJ_RES_DATA(TRC_DATA_RID, trace_res, i, trace_ri, j,
+			  trace_buf, sizeof(trace_buf));
+	for (int rid = TRC_EVENTS_RID; rid < TRC_RES_INST_COUNT; rid++) {
+		INIT_OBJ_RES_DATA(rid, trace_res, i, trace_ri, j,
+				  &trc_vals[rid], sizeof(uint32_t));
+	}
+	INIT_OBJ_RES_EXECUTE(TRC_CLEAR_RID, trace_res, i, trace_clear_cb);
+
+	trace_inst.resources = trace_res;
+	trace_inst.resource_count = i;
+
+	LOG_DBG("Created Trace instance %u", obj_inst_id);
+	return &trace_inst;
+}
+
+void init_trace_object(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	int ret;
+
+	trace_obj.obj_id = TRACE_OBJECT_ID;
+	trace_obj.version_major = 1;
+	trace_obj.version_minor = 0;
+	trace_obj.is_core = false;
+	trace_obj.fields = trace_fields;
+	trace_obj.field_count = ARRAY_SIZE(trace_fields);
+	trace_obj.max_instance_count = 1;
+	trace_obj.create_cb = trace_create;
+	lwm2m_register_obj(&trace_obj);
+
+	ret = lwm2m_create_obj_inst(TRACE_OBJECT_ID, 0, &obj_inst);
+	if (ret < 0) {
+		LOG_ERR("Failed to create Trace instance: %d", ret);
+		return;
+	}
+	for (int rid = 0; rid < TRC_RES_INST_COUNT; rid++) {
+		lwm2m_register_read_callback(
+			&LWM2M_OBJ(TRACE_OBJECT_ID, 0, rid), trace_read_cb);
+	}
+
+	LOG_INF("Object 33002 (Poll Trace) registered, %u events",
+		ring.capacity);
+}
+
+/* ==== Shell ==== */
+
+#define DUMP_BYTES_PER_LINE  32
+
+static int cmd_trace(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(sh, "%s%s, %u/%u events, %u overwritten, %u Hz",
+		    ring.enabled ? "recording" : "stopped",
+		    ring.frozen ? " (frozen: trace clear to resume)" : "",
+		    trace_ring_count(&ring), ring.capacity,
+		    trace_ring_overwritten(&ring),
+		    sys_clock_hw_cycles_per_sec());
+	return 0;
+}
+
+/*
+ * One "trc <offset>: <hex>" line per 32 bytes, then "trc end <len>".
+ * The decoder picks these out of a console log, so log lines printed
+ * in between do no harm.
+ */
+static int cmd_trace_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	const uint8_t *d = (const uint8_t *)trace_buf;
+	char line[2 * DUMP_BYTES_PER_LINE + 1];
+	size_t len = trace_freeze();
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	for (size_t off = 0; off < len; off += DUMP_BYTES_PER_LINE) {
+		size_t n = MIN(len - off, DUMP_BYTES_PER_LINE);
+
+		bin2hex(&d[off], n, line, sizeof(line));
+		shell_print(sh, "trc %04x: %s", (unsigned)off, line);
+	}
+	shell_print(sh, "trc end %u", (unsigned)len);
+	return 0;
+}
+
+static int cmd_trace_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	trace_clear();
+	shell_print(sh, "Trace cleared");
+	return 0;
+}
+
+static int cmd_trace_on(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	ring.enabled = true;
+	shell_print(sh, "Trace recording");
+	return 0;
+}
+
+static int cmd_trace_off(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	ring.enabled = false;
+	shell_print(sh, "Trace stopped");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_trace,
+	SHELL_CMD(dump, NULL, "Freeze and print the ring as hex", cmd_trace_dump),
+	SHELL_CMD(clear, NULL, "Drop all events and resume", cmd_trace_clear),
+	SHELL_CMD(on, NULL, "Start recording", cmd_trace_on),
+	SHELL_CMD(off, NULL, "Stop recording", cmd_trace_off),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(trace, &sub_trace,
+		   "Poll pipeline trace ring (see tools/trace_to_perfetto.py)",
+		   cmd_trace);
@@ -0,0 +1,116 @@
+/*
+ * Poll Pipeline Tracing — binary trace ring, "trace" shell command and
+ * LwM2M Object 33002
+ *
+ * TRACE(EVENT, arg) probes in the DLMS poll path, the RS485 driver
+ * and the LwM2M push record hardware cycle-counter timestamps into a
+ * RAM ring (trace_ring.h). Recording takes a few dozen cycles and no
+ * formatting, so it does not distort the timing it measures the way
+ * LOG_INF under CONFIG_LOG_MODE_IMMEDIATE does. Without
+ * CONFIG_AMI_TRACE the probes compile to nothing.
+ *
+ * The ring is read out as one binary dump, over the shell ("trace
+ * dump", hex lines) or as the opaque resource /33002/0/0. Reading it
+ * freezes the ring so every Block2 block comes from the same dump;
+ * "trace clear" or an Execute on /33002/0/4 resumes recording.
+ * tools/trace_to_perfetto.py turns a dump into a Chrome/Perfetto
+ * trace and prints a per-phase timing summary.
+ *
+ * With CONFIG_AMI_TRACE_HEXDUMP, TRACE_HEXDUMP(EVENT, data, len) keeps
+ * the first bytes of each RS485 frame in the ring as well, in place of
+ * LOG_HEXDUMP_DBG: a memcpy instead of a formatted console dump in the
+ * middle of the inter-frame window.
+ *
+ * Event IDs are part of the dump format: the decoder reads this enum,
+ * so append new IDs and never renumber. _BEGIN and _END pairs become
+ * slices, anything else an instant event.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_OBJECT_ID          33002
+
+/* Resource IDs */
+#define TRC_DATA_RID             0   /* Opaque R: dump (freezes the ring) */
+#define TRC_EVENTS_RID           1   /* U32 R: records in the ring */
+#define TRC_OVERWRITTEN_RID      2   /* U32 R: records lost to wrap-around */
+#define TRC_CYCLE_HZ_RID         3   /* U32 R: timestamp frequency */
+#define TRC_CLEAR_RID            4   /* Execute: drop records, resume */
+
+#define TRC_NUM_FIELDS           5
+#define TRC_RES_INST_COUNT       4   /* data resources (execute has none) */
+
+enum trace_event_id {
+	TRACE_EV_POLL_BEGIN        = 0x01,  /* arg: poll number (low 16 bits) */
+	TRACE_EV_POLL_END          = 0x02,  /* arg: result */
+	TRACE_EV_CONNECT_BEGIN     = 0x03,
+	TRACE_EV_CONNECT_END       = 0x04,  /* arg: result */
+	TRACE_EV_READ_ALL_BEGIN    = 0x05,
+	TRACE_EV_READ_ALL_END      = 0x06,  /* arg: result */
+	TRACE_EV_DISCONNECT_BEGIN  = 0x07,
+	TRACE_EV_DISCONNECT_END    = 0x08,
+	TRACE_EV_OBIS_BEGIN        = 0x09,  /* arg: OBIS table index */
+	TRACE_EV_OBIS_END          = 0x0A,  /* arg: result */
+	TRACE_EV_SCALER_BEGIN      = 0x0B,  /* arg: OBIS table index */
+	TRACE_EV_SCALER_END        = 0x0C,  /* arg: result */
+	TRACE_EV_TRANSACT_BEGIN    = 0x0D,  /* arg: TX bytes */
+	TRACE_EV_TRANSACT_END      = 0x0E,  /* arg: result */
+	TRACE_EV_RS485_TX_BEGIN    = 0x0F,  /* arg: bytes */
+	TRACE_EV_RS485_TX_END      = 0x10,
+	TRACE_EV_RS485_RX_BEGIN    = 0x11,  /* arg: timeout (ms) */
+	TRACE_EV_RS485_RX_END      = 0x12,  /* arg: bytes or result */
+	TRACE_EV_UART_RX_ISR       = 0x13,  /* arg: bytes; first of a burst only */
+	TRACE_EV_PUSH_BEGIN        = 0x14,
+	TRACE_EV_PUSH_END          = 0x15,  /* arg: resources pushed */
+	TRACE_EV_LWM2M_NOTIFY      = 0x16,  /* arg: resource ID */
+	TRACE_EV_LWM2M_SEND        = 0x17,  /* arg: result */
+	TRACE_EV_FRAME_TX          = 0x18,  /* arg: bytes; data follows */
+	TRACE_EV_FRAME_RX          = 0x19,  /* arg: bytes; data follows */
+};
+
+#ifdef CONFIG_AMI_TRACE
+
+/**
+ * @brief Record one event with the current cycle count
+ *
+ * Callable from threads and ISRs.
+ */
+void trace_event(uint8_t id, uint16_t arg);
+
+/**
+ * @brief Register Object 33002
+ *
+ * Call from lwm2m_setup().
+ */
+void init_trace_object(void);
+
+#define TRACE(ev, arg)  trace_event(TRACE_EV_##ev, (uint16_t)(arg))
+
+#else
+
+#define TRACE(ev, arg)  do { } while (0)
+
+#endif /* CONFIG_AMI_TRACE */
+
+#ifdef CONFIG_AMI_TRACE_HEXDUMP
+
+/**
+ * @brief Record an event followed by up to
+ *        CONFIG_AMI_TRACE_HEXDUMP_MAX bytes of @p data
+ */
+void trace_hexdump(uint8_t id, const uint8_t *data, size_t len);
+
+#define TRACE_HEXDUMP(ev, data, len) \
+	trace_hexdump(TRACE_EV_##ev, (data), (len))
+
+#else
+
+#define TRACE_HEXDUMP(ev, data, len)  do { } while (0)
+
+#endif /* CONFIG_AMI_TRACE_HEXDUMP */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,149 @@
+/*
+ * Binary Trace Ring — see trace_ring.h
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "trace_ring.h"
+
+BUILD_ASSERT(sizeof(struct trace_rec) == TRACE_RING_REC_LEN,
+	     "trace_rec must match the dump record layout");
+
+int trace_ring_init(struct trace_ring *r, uint8_t *buf, size_t buf_len)
+{
+	size_t n;
+
+	if (!r || !buf || ((uintptr_t)buf & 3) ||
+	    buf_len < TRACE_RING_BUF_LEN(1)) {
+		return -EINVAL;
+	}
+
+	n = (buf_len - TRACE_RING_HDR_LEN) / TRACE_RING_REC_LEN;
+	if (n > UINT16_MAX) {
+		n = UINT16_MAX;
+	}
+
+	memset(r, 0, sizeof(*r));
+	r->buf = buf;
+	r->recs = (struct trace_rec *)&buf[TRACE_RING_HDR_LEN];
+	r->capacity = (uint16_t)n;
+	r->enabled = true;
+	return 0;
+}
+
+static struct trace_rec *next_rec(struct trace_ring *r)
+{
+	return &r->recs[r->written++ % r->capacity];
+}
+
+void trace_ring_put(struct trace_ring *r, uint32_t cycles, uint8_t id,
+		    uint8_t flags, uint16_t arg)
+{
+	struct trace_rec *rec;
+
+	if (!r->enabled || r->frozen) {
+		return;
+	}
+
+	rec = next_rec(r);
+	rec->cycles = cycles;
+	rec->id = id;
+	rec->flags = flags;
+	rec->arg = arg;
+}
+
+void trace_ring_put_data(struct trace_ring *r, uint32_t cycles, uint8_t id,
+			 uint8_t flags, const uint8_t *data, size_t len,
+			 size_t max)
+{
+	/* Fill the last payload record when the data goes on: only the
+	 * end of the data is ever zero-padded, so the decoder trims to arg.
+	 */
+	size_t keep = max + TRACE_RING_DATA_PER_REC - 1;
+
+	keep -= keep % TRACE_RING_DATA_PER_REC;
+	keep = len < keep ? len : keep;
+
+	trace_ring_put(r, cycles, id, flags,
+		       len > UINT16_MAX ? UINT16_MAX : (uint16_t)len);
+	if (!r->enabled || r->frozen) {
+		return;
+	}
+
+	for (size_t off = 0; off < keep; off += TRACE_RING_DATA_PER_REC) {
+		uint8_t *b = (uint8_t *)next_rec(r);
+		uint8_t chunk[TRACE_RING_DATA_PER_REC] = { 0 };
+		size_t n = keep - off;
+
+		memcpy(chunk, &data[off],
+		       n < sizeof(chunk) ? n : sizeof(chunk));
+		memcpy(b, chunk, 4);
+		b[4] = TRACE_RING_ID_DATA;
+		memcpy(&b[5], &chunk[4], 3);
+	}
+}
+
+uint16_t trace_ring_count(const struct trace_ring *r)
+{
+	return r->written < r->capacity ? (uint16_t)r->written : r->capacity;
+}
+
+uint32_t trace_ring_overwritten(const struct trace_ring *r)
+{
+	return r->written - trace_ring_count(r);
+}
+
+static void reverse(struct trace_rec *a, size_t lo, size_t hi)
+{
+	while (lo + 1 < hi) {
+		struct trace_rec t = a[lo];
+
+		a[lo++] = a[--hi];
+		a[hi] = t;
+	}
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+size_t trace_ring_freeze(struct trace_ring *r, uint32_t hz)
+{
+	uint16_t count = trace_ring_count(r);
+
+	if (!r->frozen) {
+		/* Once wrapped, the oldest record sits at the write position:
+		 * rotate it to the front (three reversals, in place).
+		 */
+		size_t oldest = r->written % r->capacity;
+
+		if (r->written > r->capacity && oldest) {
+			reverse(r->recs, 0, oldest);
+			reverse(r->recs, oldest, r->capacity);
+			reverse(r->recs, 0, r->capacity);
+		}
+		r->frozen = true;
+	}
+
+	memcpy(r->buf, TRACE_RING_MAGIC, 4);
+	r->buf[4] = TRACE_RING_VERSION;
+	r->buf[5] = TRACE_RING_REC_LEN;
+	r->buf[6] = 0;
+	r->buf[7] = 0;
+	put_le32(&r->buf[8], hz);
+	put_le32(&r->buf[12], count);
+	put_le32(&r->buf[16], trace_ring_overwritten(r));
+
+	return TRACE_RING_BUF_LEN((size_t)count);
+}
+
+void trace_ring_clear(struct trace_ring *r)
+{
+	r->written = 0;
+	r->frozen = false;
+}
@@ -0,0 +1,130 @@
+/*
+ * Binary Trace Ring — fixed-size flight recorder of timestamped events
+ *
+ * Each record is 8 bytes: a 32-bit hardware cycle count, an event ID,
+ * a flags byte and a 16-bit argument. When the ring is full the oldest
+ * record is overwritten and counted.
+ *
+ * The ring lives in one buffer laid out as its own dump:
+ *
+ *   offset  size  field
+ *        0     4  magic "AMTR"
+ *        4     1  format version (1)
+ *        5     1  record size (8)
+ *        6     2  reserved (0)
+ *        8     4  cycle counter frequency, Hz
+ *       12     4  records that follow
+ *       16     4  records overwritten before the first one
+ *       20   8*n  records, oldest first:
+ *                 u32 cycles, u8 event, u8 flags, u16 arg
+ *
+ * All fields are little-endian; records are stored in that form as
+ * written, so the target must be little-endian (RISC-V, x86).
+ *
+ * A data event (trace_ring_put_data()) is one ordinary record, whose
+ * arg is the data length, followed by payload records with event ID
+ * TRACE_RING_ID_DATA. Those carry 7 data bytes each, in every byte
+ * but the ID (offsets 0-3 and 5-7), and no timestamp.
+ *
+ * trace_ring_freeze() rotates the records into order and fills the
+ * header in place, so the dump is served straight from the ring with
+ * no second buffer. A frozen ring ignores new records until
+ * trace_ring_clear().
+ *
+ * Pure C with no locking, so it is unit-tested natively; trace.c owns
+ * the lock and the cycle counter.
+ */
+
+#ifndef TRACE_RING_H_
+#define TRACE_RING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_RING_MAGIC     "AMTR"
+#define TRACE_RING_VERSION   1
+#define TRACE_RING_HDR_LEN   20
+#define TRACE_RING_REC_LEN   8
+
+/* Storage needed for a ring of @p n records */
+#define TRACE_RING_BUF_LEN(n)  (TRACE_RING_HDR_LEN + (n) * TRACE_RING_REC_LEN)
+
+/* Event ID of payload records following a data event */
+#define TRACE_RING_ID_DATA   0xFF
+#define TRACE_RING_DATA_PER_REC  7
+
+/* Record flags */
+#define TRACE_FLAG_ISR       0x01   /* Recorded in interrupt context */
+
+struct trace_rec {
+	uint32_t cycles;
+	uint8_t  id;
+	uint8_t  flags;
+	uint16_t arg;
+};
+
+struct trace_ring {
+	struct trace_rec *recs;    /* Inside buf, after the header */
+	uint8_t  *buf;
+	uint16_t  capacity;        /* Records */
+	uint32_t  written;         /* Records put since the last clear */
+	bool      enabled;
+	bool      frozen;
+};
+
+/**
+ * @brief Set up a ring over @p buf
+ *
+ * @param buf_len  At least TRACE_RING_BUF_LEN(1); whole records only
+ *
+ * @return 0 on success, -EINVAL if @p buf is too small or misaligned
+ */
+int trace_ring_init(struct trace_ring *r, uint8_t *buf, size_t buf_len);
+
+/**
+ * @brief Append a record, overwriting the oldest when full
+ *
+ * Ignored while the ring is disabled or frozen.
+ */
+void trace_ring_put(struct trace_ring *r, uint32_t cycles, uint8_t id,
+		    uint8_t flags, uint16_t arg);
+
+/**
+ * @brief Append a data event: one record, then the payload
+ *
+ * At most @p max bytes of @p data, rounded up to whole payload
+ * records, are kept; the event's arg still holds the full @p len.
+ * Ignored while the ring is disabled or frozen.
+ */
+void trace_ring_put_data(struct trace_ring *r, uint32_t cycles, uint8_t id,
+			 uint8_t flags, const uint8_t *data, size_t len,
+			 size_t max);
+
+/**
+ * @brief Records held (at most the capacity)
+ */
+uint16_t trace_ring_count(const struct trace_ring *r);
+
+/**
+ * @brief Records overwritten since the last clear
+ */
+uint32_t trace_ring_overwritten(const struct trace_ring *r);
+
+/**
+ * @brief Stop recording and turn the buffer into a dump
+ *
+ * Idempotent: freezing a frozen ring returns the same dump.
+ *
+ * @param hz  Cycle counter frequency, written to the header
+ *
+ * @return Dump length in bytes (header + records)
+ */
+size_t trace_ring_freeze(struct trace_ring *r, uint32_t hz);
+
+/**
+ * @brief Drop all records and resume recording
+ */
+void trace_ring_clear(struct trace_ring *r);
+
+#endif /* TRACE_RING_H_ */
@@ -0,0 +1,164 @@
+/*
+ * CRC-16 Microbenchmark — hdlc_crc16_*() implementations (dlms_hdlc.c)
+ *
+ * Times every CRC-16/X.25 implementation behind hdlc_crc16() on the
+ * frame sizes the firmware checks:
+ *
+ *     9 B  HCS-sized header slice / short S- and U-frames
+ *    64 B  typical GET.response I-frame
+ *   300 B  largest frame accepted (HDLC_MAX_FRAME_LEN)
+ *
+ * and prints ns/byte, MB/s and, on x86, TSC cycles/byte as JSON. All
+ * implementations are checked against each other before timing. Host
+ * figures only rank the variants; the device numbers that matter come
+ * from the "crc_bench" shell command (CONFIG_AMI_HDLC_CRC_BENCH). The
+ * ROM variant only exists on the ESP32-C6 and is not timed here.
+ *
+ * Compile (Windows, GCC/MinGW):
+ *   cd tests
+ *   gcc -O2 -o bench_crc.exe bench_crc.c ../src/dlms_hdlc.c \
+ *       -I../src -Istubs -DUNIT_TEST -lm
+ *
+ * Run:
+ *   .\bench_crc.exe [--iterations N]
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "dlms_hdlc.h"
+
+#define BENCH_DEFAULT_ITER  200000L
+
+struct crc_impl {
+	const char *name;
+	uint16_t (*fn)(const uint8_t *data, size_t len);
+	int table_bytes;
+};
+
+static const struct crc_impl impls[] = {
+	{ "table",   hdlc_crc16_table,   512 },
+	{ "slice4",  hdlc_crc16_slice4,  2048 },
+	{ "nibble",  hdlc_crc16_nibble,  32 },
+	{ "bitwise", hdlc_crc16_bitwise, 0 },
+};
+
+static const size_t lengths[] = { 9, 64, HDLC_MAX_FRAME_LEN };
+
+#define N_IMPLS    (sizeof(impls) / sizeof(impls[0]))
+#define N_LENGTHS  (sizeof(lengths) / sizeof(lengths[0]))
+
+/* Keeps the CRC loop from being optimized away */
+static volatile uint32_t sink;
+
+static uint8_t buf[HDLC_MAX_FRAME_LEN];
+
+static int check_agree(void)
+{
+	for (size_t len = 0; len <= sizeof(buf); len++) {
+		uint16_t ref = impls[0].fn(buf, len);
+
+		for (size_t k = 1; k < N_IMPLS; k++) {
+			uint16_t crc = impls[k].fn(buf, len);
+
+			if (crc != ref) {
+				fprintf(stderr, "%s: len %zu CRC 0x%04X != "
+					"table 0x%04X\n", impls[k].name, len,
+					crc, ref);
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	long iterations = BENCH_DEFAULT_ITER;
+	uint32_t x = 0x2545F491;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+			iterations = atol(argv[++i]);
+		} else {
+			fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (iterations < 1) {
+		fprintf(stderr, "--iterations must be positive\n");
+		return 2;
+	}
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		buf[i] = (uint8_t)x;
+	}
+	if (check_agree() < 0) {
+		return 1;
+	}
+
+	printf("{\n");
+	printf("  \"benchmark\": \"hdlc_crc16\",\n");
+	printf("  \"iterations\": %ld,\n", iterations);
+	printf("  \"implementations\": [\n");
+
+	for (size_t k = 0; k < N_IMPLS; k++) {
+		const struct crc_impl *impl = &impls[k];
+
+		printf("    {\n");
+		printf("      \"name\": \"%s\",\n", impl->name);
+		printf("      \"table_bytes\": %d,\n", impl->table_bytes);
+		printf("      \"lengths\": [\n");
+
+		for (size_t l = 0; l < N_LENGTHS; l++) {
+			size_t len = lengths[l];
+			double bytes = (double)len * iterations;
+			double secs;
+			clock_t t0;
+#ifdef HAVE_TSC
+			uint64_t c0;
+#endif
+
+			/* Warm the table into the cache first */
+			sink += impl->fn(buf, len);
+
+#ifdef HAVE_TSC
+			c0 = __rdtsc();
+#endif
+			t0 = clock();
+			for (long i = 0; i < iterations; i++) {
+				sink += impl->fn(buf, len);
+			}
+			secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+			if (secs <= 0.0) {
+				secs = 1.0 / CLOCKS_PER_SEC;
+			}
+
+			printf("        { \"bytes\": %zu, \"ns_per_byte\": %.3f, "
+			       "\"mb_per_s\": %.1f", len, secs * 1e9 / bytes,
+			       bytes / secs / 1e6);
+#ifdef HAVE_TSC
+			printf(", \"tsc_cycles_per_byte\": %.2f",
+			       (double)(__rdtsc() - c0) / bytes);
+#endif
+			printf(" }%s\n", l + 1 < N_LENGTHS ? "," : "");
+		}
+
+		printf("      ]\n");
+		printf("    }%s\n", k + 1 < N_IMPLS ? "," : "");
+	}
+
+	printf("  ]\n");
+	printf("}\n");
+	return 0;
+}
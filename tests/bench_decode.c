@@ -0,0 +1,193 @@
+/*
+ * Decoder Throughput Microbenchmark — dlms_hdlc.c / dlms_cosem.c
+ *
+ * Decodes the same frames the firmware receives in a poll cycle, in a
+ * tight loop, and prints frames/s and ns/frame per case as JSON:
+ *
+ *   get_u16    I-frame, GET.response uint16 (voltage, current, freq)
+ *   get_u32    I-frame, GET.response uint32 (energy registers)
+ *   scaler     I-frame, GET.response structure { int8, enum }
+ *   aare       I-frame, AARE accepted (57 B, the largest response)
+ *   noisy_u16  get_u16 behind 32 bytes of line noise (flag scan)
+ *
+ * Each iteration runs the receive path: hdlc_find_frame(),
+ * hdlc_parse_frame(), then the COSEM parser on the info field after
+ * LLC. Host wall-clock figures are not reproducible across machines,
+ * so there is no baseline gate; compare runs on one machine, and run
+ * tests/fuzz/fuzz_dlms.c over any decoder change to show it is still
+ * memory-safe.
+ *
+ * Compile (Windows, GCC/MinGW):
+ *   cd tests
+ *   gcc -O2 -o bench_decode.exe bench_decode.c \
+ *       ../src/dlms_hdlc.c ../src/dlms_cosem.c \
+ *       -I../src -Istubs -DUNIT_TEST -lm
+ *
+ * Run:
+ *   .\bench_decode.exe [--iterations N]
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dlms_hdlc.h"
+#include "dlms_cosem.h"
+
+#define BENCH_DEFAULT_ITER  2000000L
+#define LLC_HDR_LEN         3
+
+enum bench_parser {
+	PARSE_GET,
+	PARSE_AARE,
+};
+
+struct bench_case {
+	const char *name;
+	enum bench_parser parser;
+	size_t noise;               /* Garbage bytes before the frame */
+	const uint8_t *apdu;
+	size_t apdu_len;
+};
+
+static const uint8_t apdu_get_u16[] = {
+	0xE6, 0xE7, 0x00, COSEM_TAG_GET_RESPONSE, GET_RESPONSE_NORMAL, 0xC1,
+	0x00, COSEM_TYPE_UINT16, 0x5A, 0x05,
+};
+
+static const uint8_t apdu_get_u32[] = {
+	0xE6, 0xE7, 0x00, COSEM_TAG_GET_RESPONSE, GET_RESPONSE_NORMAL, 0xC1,
+	0x00, COSEM_TYPE_UINT32, 0x00, 0x12, 0xD6, 0x87,
+};
+
+static const uint8_t apdu_scaler[] = {
+	0xE6, 0xE7, 0x00, COSEM_TAG_GET_RESPONSE, GET_RESPONSE_NORMAL, 0xC1,
+	0x00, COSEM_TYPE_STRUCTURE, 0x02, COSEM_TYPE_INT8, 0xFE,
+	COSEM_TYPE_ENUM, 0x23,
+};
+
+static const uint8_t apdu_aare[] = {
+	0xE6, 0xE7, 0x00,
+	0x61, 0x29, 0xA1, 0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08,
+	0x01, 0x01, 0xA2, 0x03, 0x02, 0x01, 0x00, 0xA3, 0x05, 0xA1, 0x03,
+	0x02, 0x01, 0x00, 0xBE, 0x10, 0x04, 0x0E, 0x08, 0x00, 0x06, 0x5F,
+	0x1F, 0x04, 0x00, 0x00, 0x18, 0x1D, 0x00, 0x80, 0x00, 0x07,
+};
+
+static const struct bench_case cases[] = {
+	{ "get_u16", PARSE_GET, 0, apdu_get_u16, sizeof(apdu_get_u16) },
+	{ "get_u32", PARSE_GET, 0, apdu_get_u32, sizeof(apdu_get_u32) },
+	{ "scaler", PARSE_GET, 0, apdu_scaler, sizeof(apdu_scaler) },
+	{ "aare", PARSE_AARE, 0, apdu_aare, sizeof(apdu_aare) },
+	{ "noisy_u16", PARSE_GET, 32, apdu_get_u16, sizeof(apdu_get_u16) },
+};
+
+/* Keeps the decode loop from being optimized away */
+static volatile uint64_t sink;
+
+static int decode_once(const uint8_t *buf, size_t len,
+		       enum bench_parser parser)
+{
+	static struct hdlc_frame frame;
+	struct cosem_get_result res;
+	size_t start, flen;
+	int ret;
+
+	ret = hdlc_find_frame(buf, len, &start, &flen);
+	if (ret < 0) {
+		return ret;
+	}
+	ret = hdlc_parse_frame(&buf[start], flen, &frame);
+	if (ret < 0) {
+		return ret;
+	}
+	if (parser == PARSE_AARE) {
+		return cosem_parse_aare(&frame.info[LLC_HDR_LEN],
+					frame.info_len - LLC_HDR_LEN);
+	}
+	ret = cosem_parse_get_response(&frame.info[LLC_HDR_LEN],
+				       frame.info_len - LLC_HDR_LEN, &res);
+	sink += res.value.u64;
+	return ret;
+}
+
+static int build_input(const struct bench_case *bc, uint8_t *buf,
+		       size_t buf_size)
+{
+	uint32_t x = 0x2545F491;
+	int flen;
+
+	/* Line noise without flags, so the frame is the first one found */
+	for (size_t i = 0; i < bc->noise; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		buf[i] = (uint8_t)x == HDLC_FLAG ? 0x00 : (uint8_t)x;
+	}
+
+	/* Meter → client: addresses swapped relative to a request */
+	flen = hdlc_build_iframe(&buf[bc->noise], buf_size - bc->noise,
+				 0x03, 0x21, 0, 1, bc->apdu, bc->apdu_len);
+	return flen < 0 ? flen : (int)bc->noise + flen;
+}
+
+int main(int argc, char **argv)
+{
+	long iterations = BENCH_DEFAULT_ITER;
+	uint8_t buf[HDLC_MAX_FRAME_LEN + 64];
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+			iterations = atol(argv[++i]);
+		} else {
+			fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (iterations < 1) {
+		fprintf(stderr, "--iterations must be positive\n");
+		return 2;
+	}
+
+	printf("{\n");
+	printf("  \"benchmark\": \"dlms_decode\",\n");
+	printf("  \"iterations\": %ld,\n", iterations);
+	printf("  \"cases\": [\n");
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const struct bench_case *bc = &cases[c];
+		int len = build_input(bc, buf, sizeof(buf));
+		clock_t t0;
+		double secs;
+
+		/* The case must decode cleanly, or it measures an error path */
+		if (len < 0 || decode_once(buf, (size_t)len, bc->parser) != 0) {
+			fprintf(stderr, "case %s does not decode\n", bc->name);
+			return 1;
+		}
+
+		t0 = clock();
+		for (long i = 0; i < iterations; i++) {
+			(void)decode_once(buf, (size_t)len, bc->parser);
+		}
+		secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+		if (secs <= 0.0) {
+			secs = 1.0 / CLOCKS_PER_SEC;
+		}
+
+		printf("    {\n");
+		printf("      \"name\": \"%s\",\n", bc->name);
+		printf("      \"bytes\": %d,\n", len);
+		printf("      \"frames_per_s\": %.0f,\n", iterations / secs);
+		printf("      \"ns_per_frame\": %.1f,\n", secs * 1e9 / iterations);
+		printf("      \"mb_per_s\": %.2f\n",
+		       (double)len * iterations / secs / 1e6);
+		printf("    }%s\n",
+		       c + 1 < sizeof(cases) / sizeof(cases[0]) ? "," : "");
+	}
+
+	printf("  ]\n");
+	printf("}\n");
+	return 0;
+}
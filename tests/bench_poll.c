@@ -0,0 +1,353 @@
+/*
+ * DLMS Poll-Cycle Benchmark — meter_poll() against the virtual meter
+ *
+ * Runs N polls per scenario on the virtual clock (see meter_sim.h) and
+ * prints, as JSON, T_cycle p50/p95/p99 (as measured by the firmware,
+ * meter_get_poll_duration_ms()), bytes on the wire and round trips per
+ * poll. Virtual time makes every figure exact and reproducible, so a
+ * baseline can gate regressions with a tight tolerance.
+ *
+ * Compile (Windows, GCC/MinGW):
+ *   cd tests
+ *   gcc -O2 -o bench_poll.exe bench_poll.c meter_sim.c stubs/zephyr_stubs.c \
+ *       ../src/dlms_hdlc.c ../src/dlms_cosem.c ../src/lat_hist.c \
+ *       -I../src -Istubs -DUNIT_TEST -lm -Wall -Wextra
+ *
+ * Run:
+ *   .\bench_poll.exe                                  JSON to stdout
+ *   .\bench_poll.exe --baseline bench_baseline.json   exit 1 on regression
+ *   .\bench_poll.exe --polls 200 --tolerance 5
+ *
+ * Refresh the baseline after an intended change:
+ *   .\bench_poll.exe > bench_baseline.json
+ *
+ * Like test_dlms_logic.c, this file #includes dlms_meter.c: the
+ * three-phase scenario clears the single-phase pre-skip that the test
+ * stubs' CONFIG_AMI_SINGLE_PHASE sets up in meter_init().
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* LwM2M push is not benchmarked: no uplink */
+int uplink_send_inst(uint16_t obj_id, uint16_t obj_inst_id)
+{
+	(void)obj_id; (void)obj_inst_id;
+	return -ENOTCONN;
+}
+
+#include "../src/dlms_meter.c"
+#include "meter_sim.h"
+
+#define BENCH_DEFAULT_POLLS      1000
+#define BENCH_DEFAULT_TOLERANCE  2.0    /* % over baseline */
+#define BENCH_MAX_POLLS          100000
+
+struct bench_scenario {
+	const char *name;
+	const char *desc;
+	bool three_phase;           /* Build reads phase S/T as well */
+	void (*setup)(struct meter_sim_config *cfg);
+};
+
+struct bench_result {
+	int polls;
+	int failed;
+	int64_t p50, p95, p99, max;
+	double mean_ms;
+	double tx_bytes;            /* Client → meter, per poll */
+	double rx_bytes;            /* Meter → client, per poll */
+	double round_trips;         /* Per poll */
+	double host_cpu_ms;         /* Informational, not gated */
+};
+
+/* ---- Scenarios ---- */
+
+static void setup_single_phase(struct meter_sim_config *cfg)
+{
+	cfg->three_phase = false;
+}
+
+static void setup_three_phase(struct meter_sim_config *cfg)
+{
+	cfg->three_phase = true;
+}
+
+static void setup_lossy(struct meter_sim_config *cfg)
+{
+	cfg->three_phase = false;
+	cfg->loss_permille = 20;
+	cfg->corrupt_permille = 10;
+	cfg->jitter_us = 50000;
+	cfg->seed = 1234;
+}
+
+static void setup_slow_meter(struct meter_sim_config *cfg)
+{
+	cfg->three_phase = false;
+	cfg->latency_us = 800000;
+	cfg->jitter_us = 200000;
+	cfg->seed = 99;
+}
+
+static const struct bench_scenario scenarios[] = {
+	{ "single_phase", "Single-phase meter, clean bus",
+	  false, setup_single_phase },
+	{ "three_phase", "Three-phase meter, all 27 registers",
+	  true, setup_three_phase },
+	{ "lossy", "2% responses lost, 1% corrupted, 50 ms jitter",
+	  false, setup_lossy },
+	{ "slow_meter", "Meter answers in 800-1000 ms",
+	  false, setup_slow_meter },
+};
+
+/* ---- Statistics ---- */
+
+static int cmp_i64(const void *a, const void *b)
+{
+	int64_t x = *(const int64_t *)a;
+	int64_t y = *(const int64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static int64_t percentile(const int64_t *sorted, int n, int pct)
+{
+	int rank = (pct * n + 99) / 100;
+
+	if (rank < 1) {
+		rank = 1;
+	}
+	return sorted[rank - 1];
+}
+
+static void run_scenario(const struct bench_scenario *sc, int polls,
+			 int64_t *t_ms, struct bench_result *res)
+{
+	struct meter_sim_config cfg;
+	struct meter_sim_stats st;
+	struct meter_readings r;
+	clock_t c0;
+	int64_t sum = 0;
+
+	meter_sim_default_config(&cfg);
+	sc->setup(&cfg);
+	meter_sim_reset(&cfg);
+	meter_init();
+	if (sc->three_phase) {
+		memset(obis_skip, 0, sizeof(obis_skip));
+	}
+
+	memset(res, 0, sizeof(*res));
+	res->polls = polls;
+
+	c0 = clock();
+	for (int i = 0; i < polls; i++) {
+		if (meter_poll(&r) != 0) {
+			res->failed++;
+		}
+		t_ms[i] = meter_get_poll_duration_ms();
+		sum += t_ms[i];
+	}
+	res->host_cpu_ms = (double)(clock() - c0) * 1000.0 / CLOCKS_PER_SEC;
+
+	qsort(t_ms, (size_t)polls, sizeof(t_ms[0]), cmp_i64);
+	res->p50 = percentile(t_ms, polls, 50);
+	res->p95 = percentile(t_ms, polls, 95);
+	res->p99 = percentile(t_ms, polls, 99);
+	res->max = t_ms[polls - 1];
+	res->mean_ms = (double)sum / polls;
+
+	meter_sim_get_stats(&st);
+	res->tx_bytes = (double)st.bytes_rx / polls;
+	res->rx_bytes = (double)st.bytes_tx / polls;
+	res->round_trips = (double)st.round_trips / polls;
+
+	meter_sim_disable();
+}
+
+/* ---- Baseline ---- */
+
+static char *read_file(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	char *buf;
+	long len;
+
+	if (!f) {
+		return NULL;
+	}
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	buf = malloc((size_t)len + 1);
+	if (buf && fread(buf, 1, (size_t)len, f) != (size_t)len) {
+		free(buf);
+		buf = NULL;
+	}
+	if (buf) {
+		buf[len] = '\0';
+	}
+	fclose(f);
+	return buf;
+}
+
+/*
+ * Look up "key" inside the scenario object named @p name. Only the
+ * layout this program prints is understood: one "name" per scenario,
+ * followed by its metrics before the next "name".
+ */
+static bool baseline_get(const char *json, const char *name, const char *key,
+			 double *out)
+{
+	char pat[64];
+	const char *obj, *end, *k;
+
+	snprintf(pat, sizeof(pat), "\"name\": \"%s\"", name);
+	obj = strstr(json, pat);
+	if (!obj) {
+		return false;
+	}
+	end = strstr(obj + strlen(pat), "\"name\":");
+
+	snprintf(pat, sizeof(pat), "\"%s\":", key);
+	k = strstr(obj, pat);
+	if (!k || (end && k > end)) {
+		return false;
+	}
+	*out = strtod(k + strlen(pat), NULL);
+	return true;
+}
+
+/* Returns the number of metrics that regressed */
+static int check_baseline(const char *json, const char *name,
+			  const struct bench_result *res, double tol_pct)
+{
+	const struct {
+		const char *key;
+		double value;
+		double slack;           /* Absolute, on top of tol_pct */
+	} m[] = {
+		{ "p50_ms", (double)res->p50, 1.0 },
+		{ "p95_ms", (double)res->p95, 1.0 },
+		{ "p99_ms", (double)res->p99, 1.0 },
+		{ "tx_bytes_per_poll", res->tx_bytes, 0.0 },
+		{ "rx_bytes_per_poll", res->rx_bytes, 0.0 },
+		{ "round_trips_per_poll", res->round_trips, 0.0 },
+		{ "failed_polls", (double)res->failed, 0.0 },
+	};
+	int regressions = 0;
+	double base;
+
+	for (size_t i = 0; i < ARRAY_SIZE(m); i++) {
+		if (!baseline_get(json, name, m[i].key, &base)) {
+			fprintf(stderr, "baseline: %s.%s missing, not gated\n",
+				name, m[i].key);
+			continue;
+		}
+		if (m[i].value > base * (1.0 + tol_pct / 100.0) + m[i].slack) {
+			fprintf(stderr, "REGRESSION %s.%s: %.2f > baseline %.2f "
+				"(+%.1f%%)\n", name, m[i].key, m[i].value, base,
+				base > 0 ? (m[i].value / base - 1.0) * 100.0 : 0.0);
+			regressions++;
+		}
+	}
+	return regressions;
+}
+
+/* ---- Main ---- */
+
+static void usage(const char *argv0)
+{
+	fprintf(stderr, "usage: %s [--polls N] [--baseline FILE] "
+		"[--tolerance PCT]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+	int polls = BENCH_DEFAULT_POLLS;
+	double tol_pct = BENCH_DEFAULT_TOLERANCE;
+	const char *baseline_path = NULL;
+	char *baseline = NULL;
+	int regressions = 0;
+	int64_t *t_ms;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--polls") && i + 1 < argc) {
+			polls = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+			baseline_path = argv[++i];
+		} else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) {
+			tol_pct = atof(argv[++i]);
+		} else {
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (polls < 1 || polls > BENCH_MAX_POLLS) {
+		fprintf(stderr, "--polls must be 1..%d\n", BENCH_MAX_POLLS);
+		return 2;
+	}
+	if (baseline_path) {
+		baseline = read_file(baseline_path);
+		if (!baseline) {
+			fprintf(stderr, "cannot read baseline %s\n", baseline_path);
+			return 2;
+		}
+	}
+
+	t_ms = malloc(sizeof(*t_ms) * (size_t)polls);
+	if (!t_ms) {
+		free(baseline);
+		return 2;
+	}
+
+	printf("{\n");
+	printf("  \"benchmark\": \"dlms_poll_cycle\",\n");
+	printf("  \"polls_per_scenario\": %d,\n", polls);
+	printf("  \"scenarios\": [\n");
+
+	for (size_t s = 0; s < ARRAY_SIZE(scenarios); s++) {
+		const struct bench_scenario *sc = &scenarios[s];
+		struct bench_result res;
+
+		run_scenario(sc, polls, t_ms, &res);
+
+		printf("    {\n");
+		printf("      \"name\": \"%s\",\n", sc->name);
+		printf("      \"description\": \"%s\",\n", sc->desc);
+		printf("      \"p50_ms\": %lld,\n", (long long)res.p50);
+		printf("      \"p95_ms\": %lld,\n", (long long)res.p95);
+		printf("      \"p99_ms\": %lld,\n", (long long)res.p99);
+		printf("      \"max_ms\": %lld,\n", (long long)res.max);
+		printf("      \"mean_ms\": %.1f,\n", res.mean_ms);
+		printf("      \"tx_bytes_per_poll\": %.2f,\n", res.tx_bytes);
+		printf("      \"rx_bytes_per_poll\": %.2f,\n", res.rx_bytes);
+		printf("      \"round_trips_per_poll\": %.3f,\n", res.round_trips);
+		printf("      \"failed_polls\": %d,\n", res.failed);
+		printf("      \"host_cpu_ms\": %.1f\n", res.host_cpu_ms);
+		printf("    }%s\n", s + 1 < ARRAY_SIZE(scenarios) ? "," : "");
+
+		if (baseline) {
+			regressions += check_baseline(baseline, sc->name, &res,
+						      tol_pct);
+		}
+	}
+
+	printf("  ]\n");
+	printf("}\n");
+
+	free(t_ms);
+	free(baseline);
+
+	if (regressions) {
+		fprintf(stderr, "%d metric(s) regressed beyond %.1f%%\n",
+			regressions, tol_pct);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+seed_corpus.py — Seed corpus for fuzz_dlms.c from the unit-test vectors
+=======================================================================
+
+Extracts every `uint8_t name[] = { ... };` byte array from
+tests/test_hdlc.c and tests/test_cosem.c (resolving the #define
+constants of dlms_hdlc.h / dlms_cosem.h) and writes one file per vector.
+Each COSEM vector is also wrapped in a valid HDLC I-frame (LLC header,
+HCS and FCS), so the fuzzer starts past the CRC checks and reaches the
+COSEM parsers through hdlc_parse_frame() as well.
+
+Usage:
+  python3 seed_corpus.py [OUT_DIR]      (default: corpus)
+"""
+
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TESTS = os.path.dirname(HERE)
+SRC = os.path.join(os.path.dirname(TESTS), "src")
+
+VECTOR_FILES = ["test_hdlc.c", "test_cosem.c"]
+HEADERS = ["dlms_hdlc.h", "dlms_cosem.h"]
+
+ARRAY_RE = re.compile(r"uint8_t\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};", re.S)
+DEFINE_RE = re.compile(r"^#define\s+(\w+)\s+(0x[0-9A-Fa-f]+|\d+)\b", re.M)
+COMMENT_RE = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+
+
+def load_defines():
+    defines = {}
+    for h in HEADERS:
+        with open(os.path.join(SRC, h), encoding="utf-8") as f:
+            for name, val in DEFINE_RE.findall(f.read()):
+                defines[name] = int(val, 0)
+    return defines
+
+
+def parse_token(tok, defines):
+    tok = tok.strip()
+    if not tok:
+        return None
+    if tok in defines:
+        return defines[tok]
+    if len(tok) == 3 and tok[0] == tok[2] == "'":
+        return ord(tok[1])
+    return int(tok, 0)
+
+
+def extract_vectors(path, defines):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    vectors = []
+    for idx, (name, body) in enumerate(ARRAY_RE.findall(text)):
+        body = COMMENT_RE.sub("", body)
+        try:
+            vals = [parse_token(t, defines) for t in body.split(",")]
+        except ValueError:
+            continue  # expression we do not evaluate: skip the vector
+        vals = [v for v in vals if v is not None]
+        if vals and all(0 <= v <= 0xFF for v in vals):
+            vectors.append((f"{idx:03d}_{name}", bytes(vals)))
+    return vectors
+
+
+def crc16_x25(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc ^ 0xFFFF
+
+
+def wrap_iframe(apdu, client=0x21, server=0x03, ctrl=0x30):
+    """Meter → client I-frame carrying LLC E6 E7 00 + apdu."""
+    info = bytes([0xE6, 0xE7, 0x00]) + apdu
+    flen = 7 + len(info) + 2
+    hdr = bytes([0xA0 | ((flen >> 8) & 0x07), flen & 0xFF, client, server,
+                 ctrl])
+    hcs = crc16_x25(hdr)
+    body = hdr + bytes([hcs & 0xFF, hcs >> 8]) + info
+    fcs = crc16_x25(body)
+    return bytes([0x7E]) + body + bytes([fcs & 0xFF, fcs >> 8, 0x7E])
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.join(HERE, "corpus")
+    os.makedirs(out, exist_ok=True)
+    defines = load_defines()
+    count = 0
+
+    for vf in VECTOR_FILES:
+        stem = os.path.splitext(vf)[0].replace("test_", "")
+        for name, data in extract_vectors(os.path.join(TESTS, vf), defines):
+            seeds = [(f"{stem}_{name}", data)]
+            if stem == "cosem" and len(data) <= 200:
+                seeds.append((f"{stem}_{name}_iframe", wrap_iframe(data)))
+            for fname, blob in seeds:
+                with open(os.path.join(out, fname + ".bin"), "wb") as f:
+                    f.write(blob)
+                count += 1
+
+    print(f"{count} seed(s) written to {out}")
+
+
+if __name__ == "__main__":
+    main()
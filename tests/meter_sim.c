@@ -0,0 +1,773 @@
+/*
+ * Virtual Microstar Meter — see meter_sim.h
+ *
+ * The frame codec here is written independently of dlms_hdlc.c (own
+ * bitwise CRC, own header layout) so an encoder/decoder bug in the
+ * firmware cannot cancel out against the same bug in the simulator.
+ */
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "rs485_uart.h"
+#include "meter_sim.h"
+
+#define SIM_FLAG        0x7E
+#define SIM_CTRL_SNRM   0x93
+#define SIM_CTRL_UA     0x73
+#define SIM_CTRL_DISC   0x53
+#define SIM_CTRL_DM     0x1F
+
+#define SIM_MAX_FRAME   600
+#define SIM_MAX_INFO    512
+
+/* rs485_send() DE timing and rs485_recv() polling, as in src/rs485_uart.c */
+#define SEND_DE_SETUP_US  100
+#define RECV_POLL_MS      10
+#define RECV_POLL_MAX_MS  150
+
+struct sim_reg {
+	struct obis_code obis;
+	uint8_t  type;
+	int64_t  value;
+	int8_t   scaler;
+	uint8_t  unit;
+	uint8_t  dar;
+	uint8_t  flags;
+};
+
+static struct {
+	bool enabled;
+	struct meter_sim_config cfg;
+	struct sim_reg regs[METER_SIM_MAX_REGS];
+	int nregs;
+
+	/* HDLC link / association */
+	bool nrm;
+	bool associated;
+	uint8_t client_addr;
+	uint8_t v_s, v_r;
+
+	/* Segments of the current response still to send (on RR) */
+	uint8_t seg[SIM_MAX_INFO];
+	size_t seg_len, seg_off, seg_size;
+
+	/* Response on the wire: byte i arrives at start_us + t(i + 1) */
+	uint8_t pend[SIM_MAX_FRAME];
+	size_t pend_len, pend_off;
+	uint64_t pend_start_us;
+
+	enum meter_sim_fault script[METER_SIM_MAX_FAULTS];
+	int script_head, script_count;
+
+	uint32_t rng;
+	struct meter_sim_stats st;
+} sim;
+
+/* ---- Helpers ---- */
+
+static uint32_t rng_next(void)
+{
+	/* xorshift32 */
+	uint32_t x = sim.rng;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sim.rng = x;
+	return x;
+}
+
+static bool rng_permille(uint16_t permille)
+{
+	return permille && (rng_next() % 1000) < permille;
+}
+
+/* Wire time of @p n bytes, 8N1 */
+static uint64_t byte_time_us(size_t n)
+{
+	return (uint64_t)n * 10U * 1000000U / sim.cfg.baud;
+}
+
+/* Bytes of the pending response that have arrived by now */
+static size_t arrived(void)
+{
+	uint64_t now = vclock_now_us();
+
+	if (now <= sim.pend_start_us) {
+		return 0;
+	}
+
+	uint64_t n = (now - sim.pend_start_us) * sim.cfg.baud /
+		     (10U * 1000000U);
+
+	return n < sim.pend_len ? (size_t)n : sim.pend_len;
+}
+
+static uint16_t crc16_x25(const uint8_t *d, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= d[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+		}
+	}
+	return crc ^ 0xFFFF;
+}
+
+static bool obis_eq(const struct obis_code *a, const uint8_t *b)
+{
+	return a->a == b[0] && a->b == b[1] && a->c == b[2] &&
+	       a->d == b[3] && a->e == b[4] && a->f == b[5];
+}
+
+static struct sim_reg *find_reg(const struct obis_code *obis)
+{
+	uint8_t o[6] = { obis->a, obis->b, obis->c, obis->d, obis->e, obis->f };
+
+	for (int i = 0; i < sim.nregs; i++) {
+		if (obis_eq(&sim.regs[i].obis, o)) {
+			return &sim.regs[i];
+		}
+	}
+	return NULL;
+}
+
+/* ---- Response framing ---- */
+
+static void queue_frame(uint8_t ctrl, const uint8_t *info, size_t info_len,
+			bool segmented, bool scripted)
+{
+	uint8_t *f = sim.pend;
+	size_t flen = 7 + (info_len ? info_len + 2 : 0);  /* without flags */
+	size_t pos = 0;
+	uint16_t crc;
+	enum meter_sim_fault fault = METER_SIM_FAULT_NONE;
+	uint64_t latency = sim.cfg.latency_us;
+
+	f[pos++] = SIM_FLAG;
+	f[pos++] = 0xA0 | (segmented ? 0x08 : 0x00) | ((flen >> 8) & 0x07);
+	f[pos++] = flen & 0xFF;
+	f[pos++] = sim.client_addr;
+	f[pos++] = sim.cfg.server_addr;
+	f[pos++] = ctrl;
+	crc = crc16_x25(&f[1], 5);
+	f[pos++] = crc & 0xFF;
+	f[pos++] = crc >> 8;
+	if (info_len) {
+		memcpy(&f[pos], info, info_len);
+		pos += info_len;
+		crc = crc16_x25(&f[1], pos - 1);
+		f[pos++] = crc & 0xFF;
+		f[pos++] = crc >> 8;
+	}
+	f[pos++] = SIM_FLAG;
+
+	sim.pend_len = pos;
+	sim.pend_off = 0;
+	sim.st.frames_tx++;
+	sim.st.round_trips++;
+
+	/* Scripted fault (GET responses) first, then the random ones */
+	if (scripted && sim.script_count > 0) {
+		fault = sim.script[sim.script_head];
+		sim.script_head = (sim.script_head + 1) % METER_SIM_MAX_FAULTS;
+		sim.script_count--;
+	} else if (rng_permille(sim.cfg.loss_permille)) {
+		fault = METER_SIM_FAULT_DROP;
+	} else if (rng_permille(sim.cfg.corrupt_permille)) {
+		fault = METER_SIM_FAULT_CORRUPT;
+	}
+
+	switch (fault) {
+	case METER_SIM_FAULT_DROP:
+		sim.pend_len = 0;
+		sim.st.dropped++;
+		break;
+	case METER_SIM_FAULT_CORRUPT: {
+		/* Any byte between the flags */
+		size_t at = 1 + rng_next() % (pos - 2);
+
+		f[at] ^= (uint8_t)(1u << (rng_next() % 8));
+		sim.st.corrupted++;
+		break;
+	}
+	case METER_SIM_FAULT_TRUNCATE:
+		sim.pend_len = pos / 2;
+		sim.st.corrupted++;
+		break;
+	case METER_SIM_FAULT_SLOW:
+		latency *= 2;
+		break;
+	default:
+		break;
+	}
+
+	if (sim.cfg.jitter_us) {
+		latency += rng_next() % (sim.cfg.jitter_us + 1);
+	}
+	sim.pend_start_us = vclock_now_us() + latency;
+	sim.st.bytes_tx += sim.pend_len;
+
+	for (size_t i = 1; i + 1 < sim.pend_len; i++) {
+		if (f[i] == SIM_FLAG) {
+			sim.st.inner_flags++;
+			break;
+		}
+	}
+}
+
+static void send_next_segment(bool scripted)
+{
+	size_t n = sim.seg_len - sim.seg_off;
+	bool more = n > sim.seg_size;
+	uint8_t ctrl = (uint8_t)((sim.v_r << 5) | 0x10 | (sim.v_s << 1));
+
+	if (more) {
+		n = sim.seg_size;
+	}
+	queue_frame(ctrl, &sim.seg[sim.seg_off], n, more, scripted);
+	sim.v_s = (sim.v_s + 1) & 0x07;
+	sim.seg_off += n;
+	if (!more) {
+		sim.seg_len = 0;
+		sim.seg_off = 0;
+	}
+}
+
+/* I-frame carrying LLC (E6 E7 00) + APDU */
+static void send_apdu(const uint8_t *apdu, size_t len, bool force_segments,
+		      bool scripted)
+{
+	size_t size = sim.cfg.max_info_tx ? sim.cfg.max_info_tx : SIM_MAX_INFO;
+
+	sim.seg[0] = 0xE6;
+	sim.seg[1] = 0xE7;
+	sim.seg[2] = 0x00;
+	memcpy(&sim.seg[3], apdu, len);
+	sim.seg_len = len + 3;
+	sim.seg_off = 0;
+
+	if (force_segments && (sim.seg_len + 1) / 2 < size) {
+		size = (sim.seg_len + 1) / 2;
+	}
+	sim.seg_size = size;
+	send_next_segment(scripted);
+}
+
+/* ---- COSEM ---- */
+
+static void handle_aarq(const uint8_t *apdu, size_t len)
+{
+	uint8_t result = sim.cfg.aare_result;
+	uint8_t diag = 0;
+	uint8_t aare[64];
+	size_t p = 0;
+
+	if (!result) {
+		const uint8_t *pw = NULL;
+		size_t pw_len = 0;
+
+		for (size_t i = 2; i + 4 <= len; i++) {
+			if (apdu[i] == 0xAC && apdu[i + 2] == 0x80) {
+				pw_len = apdu[i + 3];
+				pw = &apdu[i + 4];
+				break;
+			}
+		}
+		if (!pw || pw + pw_len > apdu + len ||
+		    pw_len != strlen(sim.cfg.password) ||
+		    memcmp(pw, sim.cfg.password, pw_len) != 0) {
+			result = 1;     /* rejected-permanent */
+			diag = 13;      /* authentication-failure */
+		}
+	}
+
+	static const uint8_t app_ctx[] = {
+		0xA1, 0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01,
+	};
+	static const uint8_t initiate_resp[] = {
+		0xBE, 0x10, 0x04, 0x0E, 0x08, 0x00, 0x06, 0x5F, 0x1F, 0x04,
+		0x00, 0x00, 0x18, 0x1D, 0x00, 0x80, 0x00, 0x07,
+	};
+
+	aare[p++] = 0x61;
+	aare[p++] = 0;  /* length, below */
+	memcpy(&aare[p], app_ctx, sizeof(app_ctx));
+	p += sizeof(app_ctx);
+	aare[p++] = 0xA2; aare[p++] = 0x03; aare[p++] = 0x02; aare[p++] = 0x01;
+	aare[p++] = result;
+	aare[p++] = 0xA3; aare[p++] = 0x05; aare[p++] = 0xA1; aare[p++] = 0x03;
+	aare[p++] = 0x02; aare[p++] = 0x01; aare[p++] = diag;
+	if (result == 0) {
+		memcpy(&aare[p], initiate_resp, sizeof(initiate_resp));
+		p += sizeof(initiate_resp);
+	}
+	aare[1] = (uint8_t)(p - 2);
+
+	sim.associated = (result == 0);
+	if (sim.associated) {
+		sim.st.associations++;
+	}
+	send_apdu(aare, p, false, false);
+}
+
+static size_t encode_value(uint8_t *d, uint8_t type, int64_t v)
+{
+	int n;
+
+	switch (type) {
+	case COSEM_TYPE_UINT8:
+	case COSEM_TYPE_INT8:
+	case COSEM_TYPE_ENUM:
+		n = 1;
+		break;
+	case COSEM_TYPE_UINT16:
+	case COSEM_TYPE_INT16:
+		n = 2;
+		break;
+	case COSEM_TYPE_UINT64:
+	case COSEM_TYPE_INT64:
+		n = 8;
+		break;
+	case COSEM_TYPE_UINT32:
+	case COSEM_TYPE_INT32:
+		n = 4;
+		break;
+	default:
+		type = COSEM_TYPE_INT32;
+		n = 4;
+		break;
+	}
+
+	d[0] = type;
+	for (int i = 0; i < n; i++) {
+		d[1 + i] = (uint8_t)((uint64_t)v >> (8 * (n - 1 - i)));
+	}
+	return 1 + n;
+}
+
+static void send_get_error(uint8_t invoke, uint8_t dar)
+{
+	uint8_t r[] = { COSEM_TAG_GET_RESPONSE, GET_RESPONSE_NORMAL, invoke,
+			0x01, dar };
+
+	send_apdu(r, sizeof(r), false, true);
+}
+
+static void handle_get(const uint8_t *apdu, size_t len)
+{
+	uint8_t r[40];
+	size_t p = 0, dlen;
+	uint8_t data[16];
+	struct obis_code obis;
+	struct sim_reg *reg;
+
+	if (len < 12 || apdu[1] != GET_REQUEST_NORMAL) {
+		return;   /* not understood: no answer */
+	}
+
+	uint8_t invoke = apdu[2];
+	uint8_t attr = apdu[11];
+
+	sim.st.gets++;
+	obis = (struct obis_code){ apdu[5], apdu[6], apdu[7],
+				   apdu[8], apdu[9], apdu[10] };
+	reg = find_reg(&obis);
+
+	if (!sim.associated) {
+		send_get_error(invoke, METER_SIM_DAR_READ_DENIED);
+		return;
+	}
+	if (!reg) {
+		send_get_error(invoke, METER_SIM_DAR_OBJECT_UNDEFINED);
+		return;
+	}
+	if (reg->dar) {
+		send_get_error(invoke, reg->dar);
+		return;
+	}
+
+	if (attr == 2) {
+		dlen = encode_value(data, reg->type, reg->value);
+	} else if (attr == 3) {
+		data[0] = COSEM_TYPE_STRUCTURE;
+		data[1] = 0x02;
+		data[2] = COSEM_TYPE_INT8;
+		data[3] = (uint8_t)reg->scaler;
+		data[4] = COSEM_TYPE_ENUM;
+		data[5] = reg->unit;
+		dlen = 6;
+	} else {
+		send_get_error(invoke, METER_SIM_DAR_READ_DENIED);
+		return;
+	}
+
+	r[p++] = COSEM_TAG_GET_RESPONSE;
+	if (reg->flags & METER_SIM_REG_DATABLOCK) {
+		r[p++] = GET_RESPONSE_WITH_DATABLOCK;
+		r[p++] = invoke;
+		r[p++] = 0x01;                   /* last-block */
+		r[p++] = 0; r[p++] = 0; r[p++] = 0; r[p++] = 1;  /* block 1 */
+		r[p++] = 0x00;                   /* raw-data */
+		r[p++] = (uint8_t)dlen;
+	} else {
+		r[p++] = GET_RESPONSE_NORMAL;
+		r[p++] = invoke;
+		r[p++] = 0x00;                   /* data */
+	}
+	memcpy(&r[p], data, dlen);
+	p += dlen;
+
+	send_apdu(r, p, reg->flags & METER_SIM_REG_SEGMENTED, true);
+}
+
+static void handle_apdu(const uint8_t *info, size_t len)
+{
+	/* LLC: client → server E6 E6 00 */
+	if (len < 4 || info[0] != 0xE6 || info[1] != 0xE6) {
+		return;
+	}
+	info += 3;
+	len -= 3;
+
+	switch (info[0]) {
+	case COSEM_TAG_AARQ:
+		handle_aarq(info, len);
+		break;
+	case COSEM_TAG_RLRQ: {
+		static const uint8_t rlre[] = { COSEM_TAG_RLRE, 0x03, 0x80,
+						0x01, 0x00 };
+
+		sim.associated = false;
+		send_apdu(rlre, sizeof(rlre), false, false);
+		break;
+	}
+	case COSEM_TAG_GET_REQUEST:
+		handle_get(info, len);
+		break;
+	default:
+		break;
+	}
+}
+
+/* ---- HDLC ---- */
+
+static void handle_frame(const uint8_t *f, size_t len)
+{
+	static const uint8_t ua_params[] = {
+		0x81, 0x80, 0x14,
+		0x05, 0x02, 0x00, 0x80,             /* max info TX 128 */
+		0x06, 0x02, 0x00, 0x80,             /* max info RX 128 */
+		0x07, 0x04, 0x00, 0x00, 0x00, 0x01, /* window TX 1 */
+		0x08, 0x04, 0x00, 0x00, 0x00, 0x01, /* window RX 1 */
+	};
+	uint8_t ctrl;
+	const uint8_t *info = NULL;
+	size_t info_len = 0;
+
+	if (len < 9 || f[0] != SIM_FLAG || f[len - 1] != SIM_FLAG ||
+	    (f[1] & 0xF0) != 0xA0 ||
+	    crc16_x25(&f[1], 5) != (uint16_t)(f[6] | (f[7] << 8))) {
+		sim.st.bad_frames++;
+		return;
+	}
+	if (len > 9) {
+		if (len < 12 ||
+		    crc16_x25(&f[1], len - 4) !=
+		    (uint16_t)(f[len - 3] | (f[len - 2] << 8))) {
+			sim.st.bad_frames++;
+			return;
+		}
+		info = &f[8];
+		info_len = len - 11;
+	}
+
+	/* Multi-drop bus: only our address answers */
+	if (f[3] != sim.cfg.server_addr) {
+		return;
+	}
+	sim.client_addr = f[4];
+	ctrl = f[5];
+
+	if (ctrl == SIM_CTRL_SNRM) {
+		if (sim.cfg.dm_on_snrm) {
+			queue_frame(SIM_CTRL_DM, NULL, 0, false, false);
+			return;
+		}
+		sim.nrm = true;
+		sim.associated = false;
+		sim.v_s = 0;
+		sim.v_r = 0;
+		sim.seg_len = 0;
+		queue_frame(SIM_CTRL_UA, ua_params, sizeof(ua_params), false, false);
+	} else if (ctrl == SIM_CTRL_DISC) {
+		queue_frame(sim.nrm ? SIM_CTRL_UA : SIM_CTRL_DM, NULL, 0, false, false);
+		sim.nrm = false;
+		sim.associated = false;
+	} else if (!sim.nrm) {
+		queue_frame(SIM_CTRL_DM, NULL, 0, false, false);
+	} else if ((ctrl & 0x01) == 0) {
+		/* I-frame: acknowledge N(S), drop any unsent segments */
+		sim.v_r = (((ctrl >> 1) & 0x07) + 1) & 0x07;
+		sim.seg_len = 0;
+		if (info) {
+			handle_apdu(info, info_len);
+		}
+	} else if ((ctrl & 0x0F) == 0x01) {
+		/* RR: next segment, or RR back when there is none */
+		if (sim.seg_len) {
+			send_next_segment(false);
+		} else {
+			queue_frame((uint8_t)((sim.v_r << 5) | 0x11), NULL, 0,
+				    false, false);
+		}
+	}
+}
+
+/* ---- rs485_uart.h ---- */
+
+int rs485_init(void)
+{
+	return 0;
+}
+
+int rs485_send(const uint8_t *data, size_t len)
+{
+	uint64_t on_bus, drain;
+
+	if (!sim.enabled) {
+		return (int)len;
+	}
+
+	/* Half duplex: the client talking ends any response in flight */
+	sim.pend_len = 0;
+	sim.pend_off = 0;
+
+	/* The meter has the request once its last byte is on the bus ... */
+	on_bus = SEND_DE_SETUP_US + byte_time_us(len);
+	k_busy_wait((uint32_t)on_bus);
+	sim.st.bytes_rx += len;
+	sim.st.frames_rx++;
+	handle_frame(data, len);
+
+	/* ... the driver returns after its fixed 9600 baud drain wait */
+	drain = SEND_DE_SETUP_US + (uint64_t)len * 10417U / 10U + 2000U;
+	if (drain > on_bus) {
+		k_busy_wait((uint32_t)(drain - on_bus));
+	}
+	return (int)len;
+}
+
+int rs485_recv(uint8_t *buf, size_t buf_size, int timeout_ms)
+{
+	uint64_t now, deadline, first;
+	size_t avail, count;
+
+	if (!buf || buf_size == 0) {
+		return -EINVAL;
+	}
+	if (!sim.enabled) {
+		return 0;
+	}
+
+	now = vclock_now_us();
+	deadline = timeout_ms < 0 ? UINT64_MAX
+				  : now + (uint64_t)timeout_ms * 1000U;
+
+	if (sim.pend_off >= sim.pend_len) {
+		first = UINT64_MAX;
+	} else {
+		first = sim.pend_start_us + byte_time_us(sim.pend_off + 1);
+	}
+
+	if (first == UINT64_MAX && timeout_ms < 0) {
+		sim.st.recv_timeouts++;
+		return -EAGAIN;     /* would block forever */
+	}
+	if (first > deadline) {
+		vclock_advance_us(deadline - now);
+		sim.st.recv_timeouts++;
+		return -EAGAIN;
+	}
+	if (first > now) {
+		vclock_advance_us(first - now);
+	}
+
+	/* Poll until the last byte received is a closing flag */
+	for (int waited = 0; waited < RECV_POLL_MAX_MS;
+	     waited += RECV_POLL_MS) {
+		k_sleep(K_MSEC(RECV_POLL_MS));
+		avail = arrived();
+		if (avail - sim.pend_off >= 2 &&
+		    sim.pend[avail - 1] == SIM_FLAG) {
+			break;
+		}
+	}
+
+	avail = arrived() - sim.pend_off;
+	count = avail < buf_size ? avail : buf_size;
+	memcpy(buf, &sim.pend[sim.pend_off], count);
+	sim.pend_off += count;
+	return (int)count;
+}
+
+void rs485_flush_rx(void)
+{
+	if (sim.enabled && arrived() > sim.pend_off) {
+		sim.pend_off = arrived();
+	}
+}
+
+/* ---- Scripting API ---- */
+
+struct default_reg {
+	uint8_t c, d;
+	uint8_t type;
+	int64_t value;
+	int8_t  scaler;
+	uint8_t unit;
+	bool    poly;   /* phase S/T register: three-phase meters only */
+};
+
+/* Microstar-like register set; units per IEC 62056-62 */
+static const struct default_reg default_regs[] = {
+	{ 32, 7, COSEM_TYPE_UINT16, 23045, -2, 35, false },  /* V */
+	{ 31, 7, COSEM_TYPE_UINT16,  5123, -3, 33, false },  /* A */
+	{ 21, 7, COSEM_TYPE_INT32,   1178,  0, 27, false },  /* W */
+	{ 23, 7, COSEM_TYPE_INT32,    120,  0, 29, false },  /* var */
+	{ 29, 7, COSEM_TYPE_UINT32,  1184,  0, 28, false },  /* VA */
+	{ 33, 7, COSEM_TYPE_INT16,    995, -3, 255, false },
+	{ 52, 7, COSEM_TYPE_UINT16, 23110, -2, 35, true },
+	{ 51, 7, COSEM_TYPE_UINT16,  4987, -3, 33, true },
+	{ 41, 7, COSEM_TYPE_INT32,   1146,  0, 27, true },
+	{ 43, 7, COSEM_TYPE_INT32,    118,  0, 29, true },
+	{ 49, 7, COSEM_TYPE_UINT32,  1152,  0, 28, true },
+	{ 53, 7, COSEM_TYPE_INT16,    994, -3, 255, true },
+	{ 72, 7, COSEM_TYPE_UINT16, 22980, -2, 35, true },
+	{ 71, 7, COSEM_TYPE_UINT16,  5210, -3, 33, true },
+	{ 61, 7, COSEM_TYPE_INT32,   1195,  0, 27, true },
+	{ 63, 7, COSEM_TYPE_INT32,    122,  0, 29, true },
+	{ 69, 7, COSEM_TYPE_UINT32,  1201,  0, 28, true },
+	{ 73, 7, COSEM_TYPE_INT16,    995, -3, 255, true },
+	{  1, 7, COSEM_TYPE_INT32,   3519,  0, 27, false },
+	{  3, 7, COSEM_TYPE_INT32,    360,  0, 29, false },
+	{  9, 7, COSEM_TYPE_UINT32,  3537,  0, 28, false },
+	{ 13, 7, COSEM_TYPE_INT16,    995, -3, 255, false },
+	{  1, 8, COSEM_TYPE_UINT32, 1234567, 1, 30, false },  /* Wh */
+	{  3, 8, COSEM_TYPE_UINT32,  234567, 1, 32, false },  /* varh */
+	{  9, 8, COSEM_TYPE_UINT32, 1345678, 1, 31, false },  /* VAh */
+	{ 14, 7, COSEM_TYPE_UINT16,  5001, -2, 44, false },  /* Hz */
+	{ 91, 7, COSEM_TYPE_UINT16,  5120, -3, 33, false },
+};
+
+void meter_sim_default_config(struct meter_sim_config *cfg)
+{
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->baud = 9600;
+	cfg->latency_us = 250000;   /* Microstar answers in ~250 ms */
+	cfg->seed = 1;
+	cfg->server_addr = 0x03;    /* logical 0, physical 1 */
+	strncpy(cfg->password, "22222222", sizeof(cfg->password) - 1);
+	cfg->three_phase = true;
+	cfg->max_info_tx = 128;
+}
+
+void meter_sim_reset(const struct meter_sim_config *cfg)
+{
+	memset(&sim, 0, sizeof(sim));
+	vclock_reset();
+	if (cfg) {
+		sim.cfg = *cfg;
+	} else {
+		meter_sim_default_config(&sim.cfg);
+	}
+	if (!sim.cfg.baud) {
+		sim.cfg.baud = 9600;
+	}
+	sim.rng = sim.cfg.seed ? sim.cfg.seed : 1;
+
+	for (size_t i = 0; i < sizeof(default_regs) / sizeof(default_regs[0]);
+	     i++) {
+		const struct default_reg *d = &default_regs[i];
+		struct obis_code o = { 1, 1, d->c, d->d, 0, 255 };
+
+		meter_sim_set_register(&o, d->type, d->value, d->scaler, d->unit);
+		if (d->poly && !sim.cfg.three_phase) {
+			meter_sim_set_error(&o, METER_SIM_DAR_OBJECT_UNDEFINED);
+		}
+	}
+	sim.enabled = true;
+}
+
+void meter_sim_disable(void)
+{
+	sim.enabled = false;
+	sim.pend_len = 0;
+}
+
+int meter_sim_set_register(const struct obis_code *obis, uint8_t type,
+			   int64_t value, int8_t scaler, uint8_t unit)
+{
+	struct sim_reg *r = find_reg(obis);
+
+	if (!r) {
+		if (sim.nregs >= METER_SIM_MAX_REGS) {
+			return -ENOMEM;
+		}
+		r = &sim.regs[sim.nregs++];
+		memset(r, 0, sizeof(*r));
+		r->obis = *obis;
+	}
+	r->type = type;
+	r->value = value;
+	r->scaler = scaler;
+	r->unit = unit;
+	return 0;
+}
+
+int meter_sim_set_error(const struct obis_code *obis, uint8_t dar)
+{
+	struct sim_reg *r = find_reg(obis);
+
+	if (!r) {
+		return -ENOENT;
+	}
+	r->dar = dar;
+	return 0;
+}
+
+int meter_sim_set_flags(const struct obis_code *obis, uint8_t flags)
+{
+	struct sim_reg *r = find_reg(obis);
+
+	if (!r) {
+		return -ENOENT;
+	}
+	r->flags = flags;
+	return 0;
+}
+
+int meter_sim_inject(enum meter_sim_fault fault)
+{
+	if (sim.script_count >= METER_SIM_MAX_FAULTS) {
+		return -ENOMEM;
+	}
+	sim.script[(sim.script_head + sim.script_count) %
+		   METER_SIM_MAX_FAULTS] = fault;
+	sim.script_count++;
+	return 0;
+}
+
+uint64_t meter_sim_now_us(void)
+{
+	return vclock_now_us();
+}
+
+void meter_sim_get_stats(struct meter_sim_stats *out)
+{
+	*out = sim.st;
+	out->now_us = vclock_now_us();
+}
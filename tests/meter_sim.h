@@ -0,0 +1,148 @@
+/*
+ * Virtual Microstar Meter — host-side DLMS/COSEM server behind rs485_*
+ *
+ * Replaces the RS485 driver in the host test build with a scripted
+ * meter, so meter_connect(), meter_read_all() and meter_poll() run end
+ * to end: HDLC SNRM/UA, DISC/UA and DM; COSEM AARQ/AARE (LLS password
+ * check), GET.request for attribute 2 (value) and 3 (scaler_unit),
+ * Data-Access-Result errors, RLRQ/RLRE; HDLC segmentation and
+ * GET.response-with-datablock on request.
+ *
+ * Time is simulated on the stubs' virtual clock (vclock_*), shared with
+ * k_uptime_get() and k_sleep(): each byte costs 10 bit times at the
+ * configured baud rate (8N1), the meter waits latency_us (+ jitter)
+ * before answering, and rs485_send()/rs485_recv() follow the real
+ * driver — DE setup and the fixed TX drain wait; wait for the first
+ * byte up to the timeout, then poll every 10 ms for up to 150 ms until
+ * a closing 0x7E arrives. Poll-cycle timing (meter_get_poll_duration_ms()
+ * and the per-OBIS diagnostics) is therefore exact and reproducible.
+ *
+ * Faults are either random (loss/corruption per mille, seeded, so runs
+ * are reproducible) or scripted per GET response with meter_sim_inject().
+ *
+ * Like a real meter, the simulator does not escape 0x7E inside a frame
+ * (the length field delimits it). The client's flag scan misframes such
+ * responses; stats.inner_flags counts them.
+ *
+ * When the simulator is disabled (the default) rs485_recv() returns no
+ * data, like the former no-op stubs.
+ */
+#ifndef METER_SIM_H_
+#define METER_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dlms_cosem.h"
+
+#define METER_SIM_MAX_REGS    32
+#define METER_SIM_MAX_FAULTS  16
+
+/* Data-Access-Result codes (IEC 62056-53) */
+#define METER_SIM_DAR_HW_FAULT          1
+#define METER_SIM_DAR_TEMP_FAILURE      2
+#define METER_SIM_DAR_READ_DENIED       3
+#define METER_SIM_DAR_OBJECT_UNDEFINED  4
+#define METER_SIM_DAR_OBJECT_UNAVAIL   11
+
+/* Per-register behaviour flags */
+#define METER_SIM_REG_SEGMENTED  0x01  /* HDLC-segment the response */
+#define METER_SIM_REG_DATABLOCK  0x02  /* Answer with-datablock */
+
+struct meter_sim_config {
+	uint32_t baud;               /* Bus speed (default 9600) */
+	uint32_t latency_us;         /* Request → first response byte */
+	uint32_t jitter_us;          /* Uniform extra latency 0..jitter */
+	uint16_t loss_permille;      /* Responses dropped */
+	uint16_t corrupt_permille;   /* Responses with one bit flipped */
+	uint32_t seed;               /* PRNG seed for jitter and faults */
+	uint8_t  server_addr;        /* HDLC address answered (default 0x03) */
+	char     password[16];       /* LLS password (default "22222222") */
+	uint8_t  aare_result;        /* Forced AARE result, 0 = check password */
+	bool     dm_on_snrm;         /* Refuse the link with DM */
+	bool     three_phase;        /* Phase S/T registers exist */
+	uint16_t max_info_tx;        /* Segment responses longer than this */
+};
+
+enum meter_sim_fault {
+	METER_SIM_FAULT_NONE,
+	METER_SIM_FAULT_DROP,        /* Swallow the response */
+	METER_SIM_FAULT_CORRUPT,     /* Flip one bit inside the frame */
+	METER_SIM_FAULT_TRUNCATE,    /* Lose the second half of the frame */
+	METER_SIM_FAULT_SLOW,        /* Answer after 2 × the latency */
+};
+
+struct meter_sim_stats {
+	uint64_t now_us;             /* Virtual clock (vclock_now_us()) */
+	uint32_t frames_rx;          /* Frames received from the client */
+	uint32_t frames_tx;          /* Frames sent to the client */
+	uint32_t bytes_rx;           /* Bytes on the wire, client → meter */
+	uint32_t bytes_tx;           /* Bytes on the wire, meter → client */
+	uint32_t round_trips;        /* Requests answered */
+	uint32_t bad_frames;         /* Client frames failing HCS/FCS */
+	uint32_t dropped;            /* Responses lost to faults */
+	uint32_t corrupted;          /* Responses corrupted or truncated */
+	uint32_t recv_timeouts;      /* rs485_recv() returning -EAGAIN */
+	uint32_t gets;               /* GET.requests served */
+	uint32_t associations;       /* AAREs accepted */
+	uint32_t inner_flags;        /* Responses with 0x7E between the flags */
+};
+
+/**
+ * @brief Enable the simulator with @p cfg (NULL = defaults)
+ *
+ * Loads the default Microstar register set (27 OBIS codes), resets the
+ * virtual clock to 0, clears statistics and fault script, and drops the
+ * HDLC link.
+ */
+void meter_sim_reset(const struct meter_sim_config *cfg);
+
+/**
+ * @brief Fill @p cfg with the defaults meter_sim_reset(NULL) uses
+ */
+void meter_sim_default_config(struct meter_sim_config *cfg);
+
+/**
+ * @brief Disable the simulator: the bus goes silent again
+ */
+void meter_sim_disable(void);
+
+/**
+ * @brief Set (or add) a register's value and scaler_unit
+ *
+ * @param type  COSEM integer type tag used on the wire
+ * @return 0, or -ENOMEM when the register table is full
+ */
+int meter_sim_set_register(const struct obis_code *obis, uint8_t type,
+			   int64_t value, int8_t scaler, uint8_t unit);
+
+/**
+ * @brief Make every GET of a register fail with a Data-Access-Result
+ *
+ * @param dar  Result code, 0 to clear
+ * @return 0, or -ENOENT for an unknown register
+ */
+int meter_sim_set_error(const struct obis_code *obis, uint8_t dar);
+
+/**
+ * @brief Set METER_SIM_REG_* behaviour flags on a register
+ *
+ * @return 0, or -ENOENT for an unknown register
+ */
+int meter_sim_set_flags(const struct obis_code *obis, uint8_t flags);
+
+/**
+ * @brief Apply @p fault to the next GET response not yet scripted
+ *
+ * @return 0, or -ENOMEM when the script is full
+ */
+int meter_sim_inject(enum meter_sim_fault fault);
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+uint64_t meter_sim_now_us(void);
+
+void meter_sim_get_stats(struct meter_sim_stats *out);
+
+#endif /* METER_SIM_H_ */
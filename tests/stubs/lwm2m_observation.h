@@ -7,9 +7,13 @@
 
 #include <stdint.h>
 
+/* Number of lwm2m_notify_observer() calls — lets tests check batching */
+static int stub_notify_count;
+
 static inline int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id)
 {
 	(void)obj_id; (void)obj_inst_id; (void)res_id;
+	stub_notify_count++;
 	return 0;
 }
 
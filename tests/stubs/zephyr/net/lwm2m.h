@@ -8,6 +8,9 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* Opaque RD client context (only passed by pointer) */
+struct lwm2m_ctx;
+
 /* Path struct used by observation API */
 struct lwm2m_obj_path {
 	uint16_t obj_id;
@@ -21,10 +24,38 @@ struct lwm2m_obj_path {
 #define LWM2M_OBJ(obj_id, obj_inst_id, res_id) \
 	((struct lwm2m_obj_path){ (obj_id), (obj_inst_id), (res_id), 0, 3 })
 
+/* Number of lwm2m_set_f64() calls — each one notifies on the device */
+static int stub_set_f64_count;
+
+/* Resource buffers handed out by lwm2m_get_res_buf(), indexed by RID */
+static double stub_res_f64[64];
+
 /* Stub implementations — accept path pointer, do nothing */
 static inline int lwm2m_set_f64(const struct lwm2m_obj_path *path, double value)
 {
 	(void)path; (void)value;
+	stub_set_f64_count++;
+	return 0;
+}
+
+static inline void lwm2m_registry_lock(void) {}
+static inline void lwm2m_registry_unlock(void) {}
+
+static inline int lwm2m_get_res_buf(const struct lwm2m_obj_path *path,
+				    void **buffer_ptr, uint16_t *buffer_len,
+				    uint16_t *data_len, uint8_t *data_flags)
+{
+	if (path->res_id >= sizeof(stub_res_f64) / sizeof(stub_res_f64[0])) {
+		return -22;   /* -EINVAL: no such resource */
+	}
+	*buffer_ptr = &stub_res_f64[path->res_id];
+	*buffer_len = sizeof(double);
+	if (data_len) {
+		*data_len = sizeof(double);
+	}
+	if (data_flags) {
+		*data_flags = 0;
+	}
 	return 0;
 }
 
@@ -46,4 +77,12 @@ static inline int lwm2m_set_s32(const struct lwm2m_obj_path *path, int32_t value
 	return 0;
 }
 
+/* Number of registration updates requested from the RD client */
+static int stub_rd_update_count;
+
+static inline void lwm2m_rd_client_update(void)
+{
+	stub_rd_update_count++;
+}
+
 #endif /* ZEPHYR_NET_LWM2M_H_ */
@@ -0,0 +1,21 @@
+/*
+ * Zephyr API Stubs — virtual clock (see zephyr_stubs.h)
+ */
+#include "zephyr_stubs.h"
+
+static uint64_t vclock_us;
+
+uint64_t vclock_now_us(void)
+{
+	return vclock_us;
+}
+
+void vclock_advance_us(uint64_t us)
+{
+	vclock_us += us;
+}
+
+void vclock_reset(void)
+{
+	vclock_us = 0;
+}
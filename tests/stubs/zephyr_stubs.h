@@ -47,14 +47,163 @@
 /* ---- Zephyr kernel stubs ---- */
 #define K_MSEC(x) (x)
 #define K_SECONDS(x) ((x) * 1000)
-static inline int64_t k_uptime_get(void) { return 0; }
-static inline void k_sleep(int ms) { (void)ms; }
+
+/*
+ * Virtual time (zephyr_stubs.c): a single simulated clock in
+ * microseconds. Nothing runs concurrently, so sleeping just moves the
+ * clock forward; the virtual meter (meter_sim.c) advances it too while
+ * bytes are on the bus. A thousand poll cycles take milliseconds of
+ * host CPU, and their timing is exact and reproducible.
+ */
+uint64_t vclock_now_us(void);
+void vclock_advance_us(uint64_t us);
+void vclock_reset(void);
+
+static inline int64_t k_uptime_get(void)
+{
+	return (int64_t)(vclock_now_us() / 1000U);
+}
+
+static inline void k_sleep(int ms)
+{
+	if (ms > 0) {
+		vclock_advance_us((uint64_t)ms * 1000U);
+	}
+}
+
+static inline void k_busy_wait(uint32_t usec)
+{
+	vclock_advance_us(usec);
+}
+
+/*
+ * Work queue, atomics and spinlocks. Nothing runs concurrently:
+ * submitted work runs at once, and delayable work when the test calls
+ * k_work_run_due() after moving the virtual clock past its deadline.
+ */
+#ifndef ARG_UNUSED
+#define ARG_UNUSED(x) (void)(x)
+#endif
+
+struct k_work;
+typedef void (*k_work_handler_t)(struct k_work *work);
+
+struct k_work {
+	k_work_handler_t handler;
+};
+
+struct k_work_delayable {
+	struct k_work work;
+	int64_t due_ms;
+	bool pending;
+};
+
+static inline void k_work_init(struct k_work *work, k_work_handler_t handler)
+{
+	work->handler = handler;
+}
+
+static inline int k_work_submit(struct k_work *work)
+{
+	work->handler(work);
+	return 1;
+}
+
+static inline void k_work_init_delayable(struct k_work_delayable *dwork,
+					 k_work_handler_t handler)
+{
+	dwork->work.handler = handler;
+	dwork->pending = false;
+}
+
+static inline int k_work_reschedule(struct k_work_delayable *dwork, int delay_ms)
+{
+	dwork->due_ms = k_uptime_get() + delay_ms;
+	dwork->pending = true;
+	return 1;
+}
+
+static inline int k_work_cancel_delayable(struct k_work_delayable *dwork)
+{
+	dwork->pending = false;
+	return 0;
+}
+
+/* Run @p dwork if its deadline has passed; true if it ran */
+static inline bool k_work_run_due(struct k_work_delayable *dwork)
+{
+	if (!dwork->pending || k_uptime_get() < dwork->due_ms) {
+		return false;
+	}
+	dwork->pending = false;
+	dwork->work.handler(&dwork->work);
+	return true;
+}
+
+typedef long atomic_t;
+#define ATOMIC_INIT(v) (v)
+
+static inline long atomic_get(const atomic_t *target)
+{
+	return *target;
+}
+
+static inline long atomic_set(atomic_t *target, long value)
+{
+	long old = *target;
+
+	*target = value;
+	return old;
+}
+
+static inline long atomic_clear(atomic_t *target)
+{
+	return atomic_set(target, 0);
+}
+
+static inline bool atomic_cas(atomic_t *target, long old_value, long new_value)
+{
+	if (*target != old_value) {
+		return false;
+	}
+	*target = new_value;
+	return true;
+}
+
+struct k_spinlock {
+	int unused;
+};
+typedef int k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *lock)
+{
+	(void)lock;
+	return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *lock, k_spinlock_key_t key)
+{
+	(void)lock; (void)key;
+}
 
 /* ---- Zephyr ARRAY_SIZE ---- */
 #ifndef ARRAY_SIZE
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
 #endif
 
+/* ---- Zephyr MIN/MAX ---- */
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/* ---- Zephyr BUILD_ASSERT ---- */
+#ifndef BUILD_ASSERT
+#define BUILD_ASSERT(cond, msg) _Static_assert(cond, msg)
+#endif
+
 /* ---- Zephyr logging stubs (no-op) ---- */
 #define LOG_MODULE_REGISTER(name, level)
 #define LOG_MODULE_DECLARE(name, level)
@@ -70,18 +219,21 @@ static inline void k_sleep(int ms) { (void)ms; }
 
 /* ---- Zephyr IS_ENABLED / Kconfig stubs ---- */
 #ifndef IS_ENABLED
-#define _IS_ENABLED1(cfg_val) _IS_ENABLED2(_IS_EMPTY_##cfg_val)
+#define _IS_ENABLED1(cfg_val) _IS_ENABLED2(_XXXX##cfg_val)
 #define _IS_ENABLED2(one_or_two_args) _IS_ENABLED3(one_or_two_args 1, 0)
 #define _IS_ENABLED3(ignore_this, val, ...) val
-#define _IS_EMPTY_ ~,1
+#define _XXXX1 _YYYY,
 
-/* Simplified IS_ENABLED: returns 1 if macro is defined to 1 */
+/* Same expansion as Zephyr's IS_ENABLED: 1 if macro is defined to 1 */
 #define IS_ENABLED(cfg) _IS_ENABLED1(cfg)
 #endif
 
 /* Enable single-phase mode for tests (matches prj.conf) */
 #define CONFIG_AMI_SINGLE_PHASE 1
 
+/* Batch Object 10242 pushes into one LwM2M Send (matches Kconfig default) */
+#define CONFIG_AMI_LWM2M_COMPOSITE_SEND 1
+
 /* ---- Zephyr kernel header replacement ---- */
 /* When source files #include <zephyr/kernel.h>, redirect to this file */
 
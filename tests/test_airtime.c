@@ -0,0 +1,308 @@
+/*
+ * Unit Tests — Airtime Accounting (airtime_acct.c)
+ *
+ * Tests the CoAP option parser, the 802.15.4 frame/airtime estimate,
+ * and per-object attribution of requests, notifications, ACKs,
+ * registration traffic and LwM2M Sends.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "airtime_acct.h"
+
+#define CON  0
+#define NON  1
+#define ACK  2
+
+#define GET      0x01
+#define POST     0x02
+#define CONTENT  0x45
+#define CREATED  0x41
+#define CHANGED  0x44
+
+static struct airtime_acct acct;
+
+/*
+ * Build a CoAP message with an optional Observe value (< 0: none) and
+ * up to three Uri-Path segments.
+ */
+static size_t coap_build(uint8_t *buf, uint8_t type, uint8_t code,
+			 uint16_t mid, uint8_t token, int observe,
+			 const char *p0, const char *p1, const char *p2,
+			 size_t payload)
+{
+	const char *segs[3] = { p0, p1, p2 };
+	size_t pos = 0;
+	uint16_t last = 0;
+
+	buf[pos++] = (uint8_t)(0x40 | (type << 4) | (token ? 1 : 0));
+	buf[pos++] = code;
+	buf[pos++] = (uint8_t)(mid >> 8);
+	buf[pos++] = (uint8_t)mid;
+	if (token) {
+		buf[pos++] = token;
+	}
+
+	if (observe >= 0) {
+		uint8_t olen = observe == 0 ? 0 : 1;
+
+		buf[pos++] = (uint8_t)((6 << 4) | olen);
+		if (olen) {
+			buf[pos++] = (uint8_t)observe;
+		}
+		last = 6;
+	}
+	for (int i = 0; i < 3 && segs[i]; i++) {
+		size_t n = strlen(segs[i]);
+
+		buf[pos++] = (uint8_t)(((11 - last) << 4) | n);
+		memcpy(&buf[pos], segs[i], n);
+		pos += n;
+		last = 11;
+	}
+
+	if (payload) {
+		buf[pos++] = 0xFF;
+		memset(&buf[pos], 0xA5, payload);
+		pos += payload;
+	}
+	return pos;
+}
+
+static const struct airtime_class *find_class(uint16_t id)
+{
+	for (int i = 0; i < acct.class_count; i++) {
+		if (acct.classes[i].id == id) {
+			return &acct.classes[i];
+		}
+	}
+	return NULL;
+}
+
+/* ==== Parser Tests ==== */
+
+void test_airtime_parse_rejects_malformed(void)
+{
+	struct coap_meta m;
+	uint8_t bad_ver[4] = { 0x80, 0x01, 0x00, 0x01 };
+	uint8_t bad_tkl[4] = { 0x49, 0x01, 0x00, 0x01 };
+	uint8_t short_opt[6] = { 0x40, 0x01, 0x00, 0x01, 0xB5, 'a' };
+
+	ASSERT_EQ(-EINVAL, airtime_coap_parse(bad_ver, 2, &m));
+	ASSERT_EQ(-EINVAL, airtime_coap_parse(bad_ver, sizeof(bad_ver), &m));
+	ASSERT_EQ(-EINVAL, airtime_coap_parse(bad_tkl, sizeof(bad_tkl), &m));
+	ASSERT_EQ(-EINVAL, airtime_coap_parse(short_opt, sizeof(short_opt), &m));
+	ASSERT_EQ(-EINVAL, airtime_coap_parse(NULL, 4, &m));
+}
+
+void test_airtime_parse_path_and_observe(void)
+{
+	struct coap_meta m;
+	uint8_t buf[64];
+	size_t len = coap_build(buf, CON, GET, 0x1234, 0xAB, 0,
+				"10242", "0", "5", 0);
+
+	ASSERT_EQ(0, airtime_coap_parse(buf, len, &m));
+	ASSERT_EQ(CON, m.type);
+	ASSERT_EQ(GET, m.code);
+	ASSERT_EQ(0x1234, m.mid);
+	ASSERT_EQ(1, m.tkl);
+	ASSERT_EQ(0xAB, m.token[0]);
+	ASSERT_TRUE(m.has_observe);
+	ASSERT_EQ(0, m.observe);
+	ASSERT_TRUE(m.has_path);
+	ASSERT_STR_EQ("10242", m.path0);
+}
+
+/* ==== Airtime Model Tests ==== */
+
+void test_airtime_frames_fragmentation(void)
+{
+	/* 106-byte frame payload, 25 bytes of 6LoWPAN/UDP header */
+	ASSERT_EQ(1, airtime_frames(0));
+	ASSERT_EQ(1, airtime_frames(81));
+	ASSERT_EQ(2, airtime_frames(82));
+	/* 525 bytes: 96 in FRAG1 + 5 x 96 in FRAGN */
+	ASSERT_EQ(6, airtime_frames(500));
+}
+
+void test_airtime_estimate_single_frame(void)
+{
+	/* (50 + 25 + 21 + 6) bytes x 32 us + one MAC ACK (544 us) */
+	ASSERT_EQ(3808, airtime_estimate_us(50));
+	ASSERT_TRUE(airtime_estimate_us(500) > 6 * 544);
+}
+
+/* ==== Attribution Tests ==== */
+
+void test_airtime_notification_follows_observe_token(void)
+{
+	uint8_t buf[128];
+	size_t len;
+
+	airtime_acct_init(&acct);
+
+	len = coap_build(buf, CON, GET, 100, 0x11, 0, "10242", "0", "5", 0);
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_RX, buf, len));
+
+	/* Piggy-backed 2.05 answering the Observe request */
+	len = coap_build(buf, ACK, CONTENT, 100, 0x11, 2, NULL, NULL, NULL, 8);
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+
+	/* Later confirmable notification, then the server's empty ACK */
+	len = coap_build(buf, CON, CONTENT, 7, 0x11, 3, NULL, NULL, NULL, 8);
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+	len = coap_build(buf, ACK, 0, 7, 0, -1, NULL, NULL, NULL, 0);
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_RX, buf, len));
+
+	const struct airtime_class *c = find_class(10242);
+
+	ASSERT_TRUE(c != NULL);
+	ASSERT_EQ(2, c->tx_msgs);
+	ASSERT_EQ(2, c->rx_msgs);
+	ASSERT_EQ(2, c->tx_frames);
+	ASSERT_TRUE(c->airtime_us > 0);
+}
+
+void test_airtime_observe_cancel_forgets_token(void)
+{
+	uint8_t buf[128];
+	size_t len;
+
+	airtime_acct_init(&acct);
+
+	len = coap_build(buf, CON, GET, 1, 0x22, 0, "4", "0", "2", 0);
+	airtime_acct_packet(&acct, AIRTIME_RX, buf, len);
+	len = coap_build(buf, CON, GET, 2, 0x22, 1, "4", "0", "2", 0);
+	ASSERT_EQ(4, airtime_acct_packet(&acct, AIRTIME_RX, buf, len));
+
+	len = coap_build(buf, NON, CONTENT, 50, 0x22, 4, NULL, NULL, NULL, 4);
+	/* Falls back to the token of the last exchange, still object 4 */
+	ASSERT_EQ(4, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+	ASSERT_EQ(0, acct.token_count);
+}
+
+void test_airtime_registration_and_ack(void)
+{
+	uint8_t buf[128];
+	size_t len;
+
+	airtime_acct_init(&acct);
+
+	len = coap_build(buf, CON, POST, 300, 0x33, -1, "rd", "abc", NULL, 60);
+	ASSERT_EQ(AIRTIME_ID_REGISTER,
+		  airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+	len = coap_build(buf, ACK, CHANGED, 300, 0x33, -1, NULL, NULL, NULL, 0);
+	ASSERT_EQ(AIRTIME_ID_REGISTER,
+		  airtime_acct_packet(&acct, AIRTIME_RX, buf, len));
+}
+
+void test_airtime_server_read_and_response(void)
+{
+	uint8_t buf[128];
+	size_t len;
+
+	airtime_acct_init(&acct);
+
+	len = coap_build(buf, CON, GET, 0x4000, 0x44, -1, "3", "0", NULL, 0);
+	ASSERT_EQ(3, airtime_acct_packet(&acct, AIRTIME_RX, buf, len));
+	len = coap_build(buf, ACK, CONTENT, 0x4000, 0x44, -1, NULL, NULL, NULL, 40);
+	ASSERT_EQ(3, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+}
+
+void test_airtime_send_hint_and_retransmission(void)
+{
+	uint8_t buf[128];
+	size_t len;
+
+	airtime_acct_init(&acct);
+	airtime_acct_hint_send(&acct, 10242);
+
+	len = coap_build(buf, CON, POST, 500, 0x55, -1, "dp", NULL, NULL, 90);
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+	/* Retransmission: same MID and token, must not consume a hint */
+	ASSERT_EQ(10242, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+
+	len = coap_build(buf, CON, POST, 501, 0x56, -1, "dp", NULL, NULL, 90);
+	ASSERT_EQ(AIRTIME_ID_SEND, airtime_acct_packet(&acct, AIRTIME_TX, buf, len));
+
+	const struct airtime_class *c = find_class(10242);
+
+	ASSERT_TRUE(c != NULL);
+	ASSERT_EQ(2, c->tx_msgs);
+	ASSERT_EQ(4, c->tx_frames);
+}
+
+void test_airtime_malformed_is_other(void)
+{
+	uint8_t junk[3] = { 0xFF, 0xFF, 0xFF };
+
+	airtime_acct_init(&acct);
+	ASSERT_EQ(AIRTIME_ID_OTHER,
+		  airtime_acct_packet(&acct, AIRTIME_RX, junk, sizeof(junk)));
+	ASSERT_TRUE(find_class(AIRTIME_ID_OTHER) != NULL);
+}
+
+void test_airtime_class_overflow_goes_to_other(void)
+{
+	uint8_t buf[64];
+	char obj[8];
+	size_t len;
+
+	airtime_acct_init(&acct);
+	for (int i = 0; i < AIRTIME_MAX_CLASSES + 3; i++) {
+		snprintf(obj, sizeof(obj), "%d", 100 + i);
+		len = coap_build(buf, CON, GET, (uint16_t)i, 0x60, -1,
+				 obj, NULL, NULL, 0);
+		airtime_acct_packet(&acct, AIRTIME_RX, buf, len);
+	}
+
+	ASSERT_EQ(AIRTIME_MAX_CLASSES, acct.class_count);
+	const struct airtime_class *other = find_class(AIRTIME_ID_OTHER);
+
+	ASSERT_TRUE(other != NULL);
+	ASSERT_EQ(4, other->rx_msgs);
+}
+
+void test_airtime_reset_keeps_slots(void)
+{
+	uint8_t buf[64];
+	size_t len;
+
+	airtime_acct_init(&acct);
+	len = coap_build(buf, CON, GET, 1, 0x70, 0, "3303", "0", NULL, 0);
+	airtime_acct_packet(&acct, AIRTIME_RX, buf, len);
+
+	airtime_acct_reset_counters(&acct);
+
+	ASSERT_EQ(1, acct.class_count);
+	ASSERT_EQ(3303, acct.classes[0].id);
+	ASSERT_EQ(0, acct.classes[0].rx_msgs);
+	ASSERT_EQ(1, acct.token_count);
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_airtime_tests(void)
+{
+	TEST_SUITE_BEGIN("Airtime");
+
+	/* Parser */
+	RUN_TEST(test_airtime_parse_rejects_malformed);
+	RUN_TEST(test_airtime_parse_path_and_observe);
+
+	/* Airtime model */
+	RUN_TEST(test_airtime_frames_fragmentation);
+	RUN_TEST(test_airtime_estimate_single_frame);
+
+	/* Attribution */
+	RUN_TEST(test_airtime_notification_follows_observe_token);
+	RUN_TEST(test_airtime_observe_cancel_forgets_token);
+	RUN_TEST(test_airtime_registration_and_ack);
+	RUN_TEST(test_airtime_server_read_and_response);
+	RUN_TEST(test_airtime_send_hint_and_retransmission);
+	RUN_TEST(test_airtime_malformed_is_other);
+	RUN_TEST(test_airtime_class_overflow_goes_to_other);
+	RUN_TEST(test_airtime_reset_keeps_slots);
+
+	TEST_SUITE_END("Airtime");
+}
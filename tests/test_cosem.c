@@ -6,6 +6,7 @@
  * GET.response parsing, and RLRQ building.
  */
 #include "test_framework.h"
+#include <errno.h>
 #include "dlms_cosem.h"
 
 /* ==== AARQ Build Tests ==== */
@@ -146,6 +147,23 @@ void test_aare_too_short(void)
 	ASSERT_TRUE(ret < 0);  /* Too short to find A2 */
 }
 
+void test_aare_short_no_overread(void)
+{
+	/* len - 4 on a size_t used to wrap for len < 4 and scan past the
+	 * buffer; 3–4 bytes can never hold A2 03 02 01 <result>
+	 */
+	uint8_t data[] = { 0x61, 0x02, 0xA2, 0x03 };
+	ASSERT_EQ(-EPROTO, cosem_parse_aare(data, 3));
+	ASSERT_EQ(-EPROTO, cosem_parse_aare(data, 4));
+}
+
+void test_aare_result_at_end(void)
+{
+	/* Association result in the last 5 bytes is still found */
+	uint8_t aare[] = { 0x61, 0x05, 0xA2, 0x03, 0x02, 0x01, 0x01 };
+	ASSERT_EQ(-EACCES, cosem_parse_aare(aare, sizeof(aare)));
+}
+
 /* ==== GET.request Build Tests ==== */
 
 void test_get_request_normal(void)
@@ -324,6 +342,16 @@ void test_decode_int64(void)
 	ASSERT_EQ(-42, (int)result.value.i64);
 }
 
+void test_decode_int64_min(void)
+{
+	uint8_t data[] = { COSEM_TYPE_INT64,
+		0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	struct cosem_get_result result;
+
+	ASSERT_EQ(9, cosem_decode_data(data, sizeof(data), &result));
+	ASSERT_TRUE(result.value.i64 == INT64_MIN);
+}
+
 void test_decode_float32(void)
 {
 	/* IEEE 754 float32: 3.14f = 0x4048F5C3 */
@@ -563,6 +591,8 @@ void run_cosem_tests(void)
 	RUN_TEST(test_aare_wrong_tag);
 	RUN_TEST(test_aare_null);
 	RUN_TEST(test_aare_too_short);
+	RUN_TEST(test_aare_short_no_overread);
+	RUN_TEST(test_aare_result_at_end);
 
 	/* GET.request */
 	RUN_TEST(test_get_request_normal);
@@ -581,6 +611,7 @@ void run_cosem_tests(void)
 	RUN_TEST(test_decode_int32);
 	RUN_TEST(test_decode_uint64);
 	RUN_TEST(test_decode_int64);
+	RUN_TEST(test_decode_int64_min);
 	RUN_TEST(test_decode_float32);
 	RUN_TEST(test_decode_float64);
 	RUN_TEST(test_decode_octet_string);
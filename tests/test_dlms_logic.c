@@ -1,7 +1,7 @@
 /*
  * Unit Tests — DLMS Meter Logic (dlms_meter.c)
  *
- * Tests value_to_double conversion, OBIS table completeness,
+ * Tests value_to_raw conversion, OBIS table completeness,
  * meter_readings struct layout, and configuration defaults.
  *
  * Strategy: #include dlms_meter.c directly so we can test
@@ -11,18 +11,25 @@
 #include "test_framework.h"
 
 /*
- * RS485 stubs — must be defined BEFORE including dlms_meter.c
- * because "rs485_uart.h" resolves to ../src/rs485_uart.h (declarations only).
- * We provide the implementations here so the linker is happy.
+ * RS485: "rs485_uart.h" resolves to ../src/rs485_uart.h (declarations
+ * only); the implementations come from meter_sim.c, which stays silent
+ * (no data received) unless a test enables the virtual meter.
  */
 #include <stdint.h>
 #include <stddef.h>
-int rs485_init(void) { return 0; }
-int rs485_send(const uint8_t *data, size_t len) { (void)data; return (int)len; }
-int rs485_recv(uint8_t *buf, size_t buf_size, int timeout_ms) {
-	(void)buf; (void)buf_size; (void)timeout_ms; return 0;
+
+/*
+ * Telemetry uplink stub — records Send calls so push tests can verify
+ * that one poll produces one composite Send (or falls back to notify).
+ */
+static int stub_send_count;
+static int stub_send_ret;
+int uplink_send_inst(uint16_t obj_id, uint16_t obj_inst_id)
+{
+	(void)obj_id; (void)obj_inst_id;
+	stub_send_count++;
+	return stub_send_ret;
 }
-void rs485_flush_rx(void) {}
 
 /*
  * Include the dlms_meter.c source directly.
@@ -30,6 +37,7 @@ void rs485_flush_rx(void) {}
  * and zephyr/net/lwm2m.h are found.
  */
 #include "../src/dlms_meter.c"
+#include "meter_sim.h"
 
 /* ==== OBIS Table Completeness ==== */
 
@@ -95,14 +103,15 @@ void test_obis_table_all_have_names(void)
 
 void test_readings_voltage_r_first_field(void)
 {
-	/* voltage_r should be the first double field */
+	/* voltage_r should be the first raw field */
 	ASSERT_EQ(0, (int)MR_OFF(voltage_r));
 }
 
-void test_readings_all_doubles_8_bytes(void)
+void test_readings_raw_fields_4_bytes(void)
 {
-	/* Each measurement field is a double = 8 bytes */
-	ASSERT_EQ(8, (int)sizeof(double));
+	/* Each measurement field is a raw int32 = 4 bytes */
+	ASSERT_EQ(4, (int)sizeof(((struct meter_readings *)0)->voltage_r));
+	ASSERT_EQ(4 * 26, (int)MR_OFF(neutral_current));
 }
 
 void test_readings_struct_has_metadata(void)
@@ -129,7 +138,7 @@ void test_readings_struct_has_metadata(void)
 void test_readings_field_count(void)
 {
 	/*
-	 * 27 double fields:
+	 * 27 raw int32 fields:
 	 *  3 voltages + 3 currents + 3 active + 3 reactive +
 	 *  3 apparent + 3 pf + 4 totals + 3 energy + 1 freq + 1 neutral
 	 */
@@ -139,117 +148,221 @@ void test_readings_field_count(void)
 	ASSERT_EQ(MR_OFF(neutral_current), obis_table[26].offset);
 }
 
-/* ==== value_to_double Conversion ==== */
+/* ==== value_to_raw / field_value Conversion ==== */
 
-void test_vtod_unsigned_no_scaler(void)
+void test_vtor_unsigned(void)
 {
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_UINT32,
 		.value = { .u64 = 1320 },
 	};
 
-	/* No scaler cached → raw value returned */
-	double val = value_to_double(&r, 0);
-	ASSERT_FLOAT_EQ(1320.0, val, 0.001);
+	/* Raw value is stored as-is, scaler is never applied here */
+	ASSERT_EQ(1320, value_to_raw(&r, 0));
 }
 
-void test_vtod_signed_negative(void)
+void test_vtor_signed_negative(void)
 {
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_INT32,
 		.value = { .i64 = -500 },
 	};
 
-	double val = value_to_double(&r, 0);
-	ASSERT_FLOAT_EQ(-500.0, val, 0.001);
+	ASSERT_EQ(-500, value_to_raw(&r, 0));
 }
 
-void test_vtod_float64_direct(void)
+void test_vtor_float64_keeps_decimals(void)
 {
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_FLOAT64,
-		.value = { .f64 = 131.9 },
+		.value = { .f64 = 0.98 },
 	};
+	struct meter_readings m = {0};
 
-	double val = value_to_double(&r, 0);
-	ASSERT_FLOAT_EQ(131.9, val, 0.001);
+	scaler_exp[0] = 0;
+	scaler_float[0] = false;
+
+	/* A float power factor of 0.98 must not become 1 */
+	m.voltage_r = value_to_raw(&r, 0);
+	ASSERT_EQ(980, m.voltage_r);
+	ASSERT_EQ(-FLOAT_DECIMALS, scaler_exp[0]);
+	ASSERT_FLOAT_EQ(0.98, field_value(&m, 0), 1e-9);
+
+	/* The exponent is lowered once, not per value */
+	r.value.f64 = 131.6;
+	m.voltage_r = value_to_raw(&r, 0);
+	ASSERT_EQ(131600, m.voltage_r);
+	ASSERT_FLOAT_EQ(131.6, field_value(&m, 0), 1e-9);
+
+	scaler_exp[0] = 0;
+	scaler_float[0] = false;
 }
 
-void test_vtod_with_scaler(void)
+void test_vtor_float_shift_stops_at_scaler_min(void)
 {
-	/* Cache scaler = 10^(-1) = 0.1 for table index 0 */
-	scaler_cache[0] = 0.1;
-	scaler_cached[0] = true;
-
 	struct cosem_get_result r = {
-		.data_type = COSEM_TYPE_UINT32,
-		.value = { .u64 = 1320 },
+		.data_type = COSEM_TYPE_FLOAT32,
+		.value = { .f64 = 12.5 },
 	};
 
-	double val = value_to_double(&r, 0);
+	scaler_exp[0] = SCALER_MIN + 1;
+	scaler_float[0] = false;
+	ASSERT_EQ(125, value_to_raw(&r, 0));
+	ASSERT_EQ(SCALER_MIN, scaler_exp[0]);
 
-	/* 1320 * 0.1 = 132.0 */
-	ASSERT_FLOAT_EQ(132.0, val, 0.001);
-
-	/* Cleanup */
-	scaler_cached[0] = false;
+	scaler_exp[0] = 0;
+	scaler_float[0] = false;
 }
 
-void test_vtod_scaler_negative_exponent(void)
+void test_vtor_saturates(void)
 {
-	/* scaler = 10^(-3) for energy values */
-	scaler_cache[1] = pow(10.0, -3.0);  /* 0.001 */
-	scaler_cached[1] = true;
-
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_UINT64,
-		.value = { .u64 = 56893000 },
+		.value = { .u64 = 5000000000ULL },
 	};
 
-	double val = value_to_double(&r, 1);
-
-	/* 56893000 * 0.001 = 56893.0 */
-	ASSERT_FLOAT_EQ(56893.0, val, 0.1);
+	ASSERT_EQ(INT32_MAX, value_to_raw(&r, 0));
 
-	scaler_cached[1] = false;
+	r.data_type = COSEM_TYPE_INT64;
+	r.value.i64 = -5000000000LL;
+	ASSERT_EQ(INT32_MIN, value_to_raw(&r, 0));
 }
 
-void test_vtod_enum_type(void)
+void test_vtor_enum_type(void)
 {
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_ENUM,
 		.value = { .u64 = 27 },  /* W unit */
 	};
 
-	double val = value_to_double(&r, 0);
-	ASSERT_FLOAT_EQ(27.0, val, 0.001);
+	ASSERT_EQ(27, value_to_raw(&r, 0));
 }
 
-void test_vtod_unknown_type_returns_zero(void)
+void test_vtor_unknown_type_returns_zero(void)
 {
 	struct cosem_get_result r = {
 		.data_type = COSEM_TYPE_OCTET_STRING,
 		.value = { .u64 = 42 },
 	};
 
-	double val = value_to_double(&r, 0);
-	ASSERT_FLOAT_EQ(0.0, val, 0.001);
+	ASSERT_EQ(0, value_to_raw(&r, 0));
+	ASSERT_EQ(0, value_to_raw(&r, -1));
 }
 
-void test_vtod_out_of_bounds_index(void)
+void test_field_value_no_scaler(void)
 {
-	struct cosem_get_result r = {
-		.data_type = COSEM_TYPE_UINT32,
-		.value = { .u64 = 100 },
-	};
+	struct meter_readings m;
+	memset(&m, 0, sizeof(m));
+	m.voltage_r = 1320;
+
+	/* No scaler cached → raw value returned */
+	ASSERT_FLOAT_EQ(1320.0, field_value(&m, 0), 0.001);
+}
 
-	/* Index -1 → scaler not applied */
-	double val = value_to_double(&r, -1);
-	ASSERT_FLOAT_EQ(100.0, val, 0.001);
+void test_field_value_with_scaler(void)
+{
+	struct meter_readings m;
+	memset(&m, 0, sizeof(m));
+	m.voltage_r = 1320;
+
+	/* Cache scaler = -1 (x0.1) for table index 0 */
+	scaler_exp[0] = -1;
+	scaler_cached[0] = true;
 
-	/* Index beyond table → scaler not applied */
-	val = value_to_double(&r, 999);
-	ASSERT_FLOAT_EQ(100.0, val, 0.001);
+	/* 1320 * 0.1 = 132.0 */
+	ASSERT_FLOAT_EQ(132.0, field_value(&m, 0), 0.001);
+	ASSERT_FLOAT_EQ(132.0, meter_reading_value(&m, 0), 0.001);
+
+	/* Cleanup */
+	scaler_exp[0] = 0;
+	scaler_cached[0] = false;
+}
+
+void test_field_value_scaler_negative_exponent(void)
+{
+	struct meter_readings m;
+	memset(&m, 0, sizeof(m));
+	m.active_energy = 56893000;
+
+	/* scaler = -3 for energy values (Wh → kWh) */
+	scaler_exp[22] = -3;
+	scaler_cached[22] = true;
+
+	/* 56893000 * 0.001 = 56893.0 */
+	ASSERT_FLOAT_EQ(56893.0, field_value(&m, 22), 0.1);
+
+	scaler_exp[22] = 0;
+	scaler_cached[22] = false;
+}
+
+void test_reading_value_out_of_bounds_index(void)
+{
+	struct meter_readings m;
+	memset(&m, 0, sizeof(m));
+
+	ASSERT_FLOAT_EQ(0.0, meter_reading_value(&m, -1), 0.001);
+	ASSERT_FLOAT_EQ(0.0, meter_reading_value(&m, 999), 0.001);
+}
+
+/* ==== Power-of-ten table & integer fixed-point path ==== */
+
+void test_pow10_tables_exact(void)
+{
+	/* Every table entry must match 10^n (no pow() at runtime) */
+	for (int e = SCALER_MIN; e <= SCALER_MAX; e++) {
+		ASSERT_FLOAT_EQ(pow(10.0, e), pow10_f64[e - SCALER_MIN],
+				pow(10.0, e) * 1e-12);
+	}
+	for (int n = 1; n < 19; n++) {
+		ASSERT_TRUE(pow10_i64[n] == pow10_i64[n - 1] * 10);
+	}
+}
+
+void test_rescale_fixed_rounding(void)
+{
+	ASSERT_EQ(12300, rescale_fixed(123, 2));     /* 123 → x100 */
+	ASSERT_EQ(2457, rescale_fixed(24567, -1));   /* 2456.7 → 2457 */
+	ASSERT_EQ(-2457, rescale_fixed(-24567, -1)); /* half away from zero */
+	ASSERT_EQ(0, rescale_fixed(4, -1));
+	ASSERT_EQ(1, rescale_fixed(5, -1));
+	ASSERT_EQ(0, rescale_fixed(123, -19));
+}
+
+void test_rescale_fixed_saturates(void)
+{
+	ASSERT_EQ(INT32_MAX, rescale_fixed(3, 9));
+	ASSERT_EQ(INT32_MIN, rescale_fixed(-1, 12));
+	ASSERT_EQ(0, rescale_fixed(0, 12));
+}
+
+void test_fixed_in_range(void)
+{
+	/* 1220 × 10^-1 = 122.0 V */
+	ASSERT_TRUE(fixed_in_range(1220, -1, 50, 500));
+	/* 499 × 10^-1 = 49.9 V — exact compare, not rounded to 50 */
+	ASSERT_FALSE(fixed_in_range(499, -1, 50, 500));
+	ASSERT_TRUE(fixed_in_range(500, -1, 50, 500));
+	/* 6 × 10^1 = 60 Hz */
+	ASSERT_TRUE(fixed_in_range(6, 1, 40, 70));
+	ASSERT_FALSE(fixed_in_range(8, 1, 40, 70));
+}
+
+void test_reading_fixed_pair(void)
+{
+	struct meter_readings m;
+	int32_t mant = 0;
+	int8_t exp = 0;
+
+	memset(&m, 0, sizeof(m));
+	m.frequency = 6001;
+	scaler_exp[25] = -2;
+
+	ASSERT_EQ(0, meter_reading_fixed(&m, 25, &mant, &exp));
+	ASSERT_EQ(6001, mant);
+	ASSERT_EQ(-2, exp);
+	ASSERT_EQ(-EINVAL, meter_reading_fixed(&m, 27, &mant, &exp));
+
+	scaler_exp[25] = 0;
 }
 
 /* ==== Default Configuration ==== */
@@ -374,26 +487,26 @@ void test_failed_reads_stay_zero(void)
 {
 	/*
 	 * v0.17.0: Failed reads are NOT filled with last_good.
-	 * They stay at 0.0 and their field_mask bit is NOT set.
+	 * They stay at 0 and their field_mask bit is NOT set.
 	 * PUSH_FIELD skips them, so they never reach the server.
 	 */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
 
 	/* Only voltage_r and frequency were successfully read */
-	r.voltage_r = 123.0;
-	r.frequency = 60.1;
+	r.voltage_r = 1230;   /* raw, scaler -1 */
+	r.frequency = 601;    /* raw, scaler -1 */
 	r.field_mask = (1u << 0) | (1u << 25);  /* bits 0, 25 */
 	r.read_count = 2;
 	r.error_count = 25;
 
 	/* Verify: successfully read fields have real values */
-	ASSERT_FLOAT_EQ(123.0, r.voltage_r, 0.001);
-	ASSERT_FLOAT_EQ(60.1,  r.frequency, 0.001);
+	ASSERT_EQ(1230, r.voltage_r);
+	ASSERT_EQ(601,  r.frequency);
 
 	/* Verify: failed reads are zero (NOT last_good) */
-	ASSERT_FLOAT_EQ(0.0, r.current_r, 0.001);
-	ASSERT_FLOAT_EQ(0.0, r.active_energy, 0.001);
+	ASSERT_EQ(0, r.current_r);
+	ASSERT_EQ(0, r.active_energy);
 
 	/* Verify: field_mask only has bits for successful reads */
 	ASSERT_TRUE(r.field_mask & (1u << 0));     /* voltage_r: read */
@@ -411,9 +524,9 @@ void test_first_poll_zeros_without_last_good(void)
 	memset(&r, 0, sizeof(r));
 	r.field_mask = 0;
 
-	ASSERT_FLOAT_EQ(0.0, r.voltage_r, 0.001);
-	ASSERT_FLOAT_EQ(0.0, r.current_r, 0.001);
-	ASSERT_FLOAT_EQ(0.0, r.frequency, 0.001);
+	ASSERT_EQ(0, r.voltage_r);
+	ASSERT_EQ(0, r.current_r);
+	ASSERT_EQ(0, r.frequency);
 	ASSERT_EQ(0, (int)r.field_mask);
 }
 
@@ -425,12 +538,12 @@ void test_last_good_updated_per_field(void)
 	 */
 	last_good_valid = true;
 	memset(&last_good, 0, sizeof(last_good));
-	last_good.voltage_r = 120.0;
-	last_good.current_r = 5.0;
+	last_good.voltage_r = 120;
+	last_good.current_r = 5;
 
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 122.0;  /* New reading */
+	r.voltage_r = 122;  /* New reading */
 	r.field_mask = (1u << 0);  /* Only voltage_r was read */
 	r.valid = true;
 	r.read_target = 27;
@@ -438,18 +551,18 @@ void test_last_good_updated_per_field(void)
 	/* Simulate per-field update logic from meter_read_all() */
 	for (size_t j = 0; j < OBIS_TABLE_SIZE; j++) {
 		if (r.field_mask & (1u << j)) {
-			double *src = (double *)((uint8_t *)&r +
-						  obis_table[j].offset);
-			double *dst = (double *)((uint8_t *)&last_good +
-						  obis_table[j].offset);
+			int32_t *src = (int32_t *)((uint8_t *)&r +
+						   obis_table[j].offset);
+			int32_t *dst = (int32_t *)((uint8_t *)&last_good +
+						   obis_table[j].offset);
 			*dst = *src;
 		}
 	}
 
 	/* voltage_r updated to new value */
-	ASSERT_FLOAT_EQ(122.0, last_good.voltage_r, 0.001);
+	ASSERT_EQ(122, last_good.voltage_r);
 	/* current_r NOT in field_mask → retains old value */
-	ASSERT_FLOAT_EQ(5.0, last_good.current_r, 0.001);
+	ASSERT_EQ(5, last_good.current_r);
 }
 
 void test_last_good_not_updated_on_invalid_read(void)
@@ -457,8 +570,8 @@ void test_last_good_not_updated_on_invalid_read(void)
 	/* If reads are invalid (below min coverage), last_good untouched */
 	struct meter_readings old_good;
 	memset(&old_good, 0, sizeof(old_good));
-	old_good.voltage_r = 120.0;
-	old_good.frequency = 60.0;
+	old_good.voltage_r = 120;
+	old_good.frequency = 60;
 
 	memcpy(&last_good, &old_good, sizeof(last_good));
 	last_good_valid = true;
@@ -476,8 +589,8 @@ void test_last_good_not_updated_on_invalid_read(void)
 
 	/* last_good should still hold old values */
 	ASSERT_TRUE(last_good_valid);
-	ASSERT_FLOAT_EQ(120.0, last_good.voltage_r, 0.001);
-	ASSERT_FLOAT_EQ(60.0,  last_good.frequency, 0.001);
+	ASSERT_EQ(120, last_good.voltage_r);
+	ASSERT_EQ(60,  last_good.frequency);
 }
 
 /* ==== Field Mask (v0.17.0) ==== */
@@ -554,8 +667,8 @@ void test_sanity_check_accepts_valid_readings(void)
 {
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 122.0;
-	r.frequency = 60.0;
+	r.voltage_r = 122;
+	r.frequency = 60;
 	r.valid = true;
 	r.read_target = 4;
 	r.field_mask = (1u << 0) | (1u << 1) | (1u << 25) | (1u << 26);
@@ -568,9 +681,9 @@ void test_sanity_check_accepts_zero_current(void)
 	/* Current CAN legitimately be 0.0 (no load) */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 122.0;
-	r.frequency = 60.0;
-	r.current_r = 0.0;
+	r.voltage_r = 122;
+	r.frequency = 60;
+	r.current_r = 0;
 	r.valid = true;
 	r.read_target = 3;
 	r.field_mask = (1u << 0) | (1u << 1) | (1u << 25);
@@ -582,15 +695,15 @@ void test_sanity_check_rejects_voltage_out_of_range(void)
 	/* Voltage outside [50, 500] → should FAIL */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 600.0;  /* Way too high */
-	r.frequency = 60.0;
+	r.voltage_r = 600;  /* Way too high */
+	r.frequency = 60;
 	r.valid = true;
 	r.read_target = 2;
 	r.field_mask = (1u << 0) | (1u << 25);
 	ASSERT_FALSE(readings_sanity_check(&r));
 
 	/* Too low */
-	r.voltage_r = 30.0;
+	r.voltage_r = 30;
 	ASSERT_FALSE(readings_sanity_check(&r));
 }
 
@@ -599,15 +712,15 @@ void test_sanity_check_rejects_frequency_out_of_range(void)
 	/* Frequency outside [40, 70] → should FAIL */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 120.0;
-	r.frequency = 80.0;  /* Too high */
+	r.voltage_r = 120;
+	r.frequency = 80;  /* Too high */
 	r.valid = true;
 	r.read_target = 2;
 	r.field_mask = (1u << 0) | (1u << 25);
 	ASSERT_FALSE(readings_sanity_check(&r));
 
 	/* Too low */
-	r.frequency = 30.0;
+	r.frequency = 30;
 	ASSERT_FALSE(readings_sanity_check(&r));
 }
 
@@ -616,8 +729,8 @@ void test_sanity_check_requires_field_coverage(void)
 	/* Even with valid voltage/frequency, too few fields → FAIL */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 120.0;
-	r.frequency = 60.0;
+	r.voltage_r = 120;
+	r.frequency = 60;
 	r.valid = true;
 	r.read_target = 27;
 	r.field_mask = (1u << 0) | (1u << 25);  /* Only 2/27 = 7% < 50% */
@@ -629,7 +742,7 @@ void test_sanity_check_voltage_only_no_frequency(void)
 	/* Voltage read but not frequency → passes check 3 (at least one read) */
 	struct meter_readings r;
 	memset(&r, 0, sizeof(r));
-	r.voltage_r = 120.0;
+	r.voltage_r = 120;
 	r.valid = true;
 	r.read_target = 2;
 	r.field_mask = (1u << 0) | (1u << 1);  /* voltage_r + current_r */
@@ -637,6 +750,32 @@ void test_sanity_check_voltage_only_no_frequency(void)
 	ASSERT_TRUE(readings_sanity_check(&r));
 }
 
+void test_sanity_check_applies_scaler(void)
+{
+	/* Range checks are on engineering units, not raw register values */
+	struct meter_readings r;
+	memset(&r, 0, sizeof(r));
+	r.voltage_r = 1220;   /* 122.0 V with scaler -1 */
+	r.frequency = 6000;   /* 60.00 Hz with scaler -2 */
+	r.valid = true;
+	r.read_target = 2;
+	r.field_mask = (1u << 0) | (1u << 25);
+
+	/* Without scalers the raw values are out of range */
+	ASSERT_FALSE(readings_sanity_check(&r));
+
+	scaler_exp[0] = -1;
+	scaler_cached[0] = true;
+	scaler_exp[25] = -2;
+	scaler_cached[25] = true;
+	ASSERT_TRUE(readings_sanity_check(&r));
+
+	scaler_exp[0] = 0;
+	scaler_cached[0] = false;
+	scaler_exp[25] = 0;
+	scaler_cached[25] = false;
+}
+
 /* ==== Periodic push (v0.18.0) — field_mask guard tests ==== */
 
 void test_push_field_skips_when_bit_not_set(void)
@@ -678,6 +817,167 @@ void test_push_field_all_27_bits(void)
 	ASSERT_TRUE((r.field_mask & (1u << 27)) == 0);
 }
 
+/* ==== Composite Send batching ==== */
+
+static void make_pushable_readings(struct meter_readings *r)
+{
+	memset(r, 0, sizeof(*r));
+	r->voltage_r = 121;      /* No scaler cached → raw = engineering */
+	r->current_r = 2;
+	r->frequency = 60;
+	r->active_energy = 1234;
+	r->valid = true;
+	r->read_target = 4;
+	r->field_mask = (1u << 0) | (1u << 1) | (1u << 22) | (1u << 25);
+}
+
+void test_push_composite_single_send(void)
+{
+	struct meter_readings r;
+	make_pushable_readings(&r);
+
+	stub_send_count = 0;
+	stub_send_ret = 0;
+	stub_notify_count = 0;
+	stub_set_f64_count = 0;
+	memset(stub_res_f64, 0, sizeof(stub_res_f64));
+	meter_push_to_lwm2m(&r);
+
+	/* Whole instance in one Send, no per-resource notifications */
+	ASSERT_EQ(1, stub_send_count);
+	ASSERT_EQ(0, stub_notify_count);
+	/* Values stored without lwm2m_set_f64(), which would notify */
+	ASSERT_EQ(0, stub_set_f64_count);
+	ASSERT_FLOAT_EQ(121.0, stub_res_f64[obis_table[0].rid], 0.001);
+	ASSERT_FLOAT_EQ(1234.0, stub_res_f64[obis_table[22].rid], 0.001);
+}
+
+void test_push_composite_fallback_notifies(void)
+{
+	struct meter_readings r;
+	make_pushable_readings(&r);
+
+	stub_send_count = 0;
+	stub_send_ret = -ENOTCONN;   /* Not registered */
+	stub_notify_count = 0;
+	stub_set_f64_count = 0;
+	meter_push_to_lwm2m(&r);
+
+	/* Send refused → every pushed field notified individually, once */
+	ASSERT_EQ(1, stub_send_count);
+	ASSERT_EQ(4, stub_notify_count);
+	ASSERT_EQ(0, stub_set_f64_count);
+	stub_send_ret = 0;
+}
+
+void test_push_invalid_sends_nothing(void)
+{
+	struct meter_readings r;
+	make_pushable_readings(&r);
+	r.valid = false;
+
+	stub_send_count = 0;
+	stub_notify_count = 0;
+	meter_push_to_lwm2m(&r);
+
+	ASSERT_EQ(0, stub_send_count);
+	ASSERT_EQ(0, stub_notify_count);
+}
+
+/* ==== Store-and-forward record packing ==== */
+
+void test_record_pack_roundtrip(void)
+{
+	struct meter_readings r;
+	struct meter_record rec;
+	make_pushable_readings(&r);
+	r.current_r = 24567;          /* scaler -4 → 2.4567 A */
+	r.active_energy = 12345;      /* scaler -1 → 1234.5 Wh */
+	scaler_exp[1] = -4;
+	scaler_cached[1] = true;
+	scaler_exp[22] = -1;
+	scaler_cached[22] = true;
+
+	meter_record_pack(&r, 1700000000u, &rec);
+
+	ASSERT_EQ(1700000000u, rec.timestamp);
+	ASSERT_EQ(r.field_mask, rec.field_mask);
+	ASSERT_EQ(12100, rec.value[0]);         /* V kept at 0.01 */
+	ASSERT_EQ(2457, rec.value[1]);          /* A kept at 0.001 */
+	ASSERT_FLOAT_EQ(121.0, meter_record_value(&rec, 0), 0.001);
+	ASSERT_FLOAT_EQ(2.457, meter_record_value(&rec, 1), 0.0001);
+	ASSERT_EQ(1235, rec.value[22]);         /* Energy kept in whole Wh */
+	ASSERT_FLOAT_EQ(1235.0, meter_record_value(&rec, 22), 0.001);
+	ASSERT_FLOAT_EQ(60.0, meter_record_value(&rec, 25), 0.001);
+
+	scaler_exp[1] = 0;
+	scaler_cached[1] = false;
+	scaler_exp[22] = 0;
+	scaler_cached[22] = false;
+}
+
+void test_record_pack_skips_unread_fields(void)
+{
+	struct meter_readings r;
+	struct meter_record rec;
+	make_pushable_readings(&r);
+	r.active_power_r = 33;   /* Bit 2 not set — must not be encoded */
+
+	meter_record_pack(&r, 0, &rec);
+
+	ASSERT_EQ(0, rec.value[2]);
+}
+
+void test_record_pack_large_energy(void)
+{
+	struct meter_readings r;
+	struct meter_record rec;
+	memset(&r, 0, sizeof(r));
+	/* 98.7654321 MWh: above 2^31/100 Wh, a meter years in service */
+	r.active_energy = 98765432;
+	r.reactive_energy = 2147483647;    /* Register at its int32 limit */
+	r.field_mask = (1u << 22) | (1u << 23);
+
+	meter_record_pack(&r, 0, &rec);
+
+	ASSERT_EQ(98765432, rec.value[22]);
+	ASSERT_FLOAT_EQ(98765432.0, meter_record_value(&rec, 22), 0.5);
+	ASSERT_EQ(2147483647, rec.value[23]);
+}
+
+void test_record_pack_saturates(void)
+{
+	struct meter_readings r;
+	struct meter_record rec;
+	memset(&r, 0, sizeof(r));
+	r.active_energy = 2000000000;      /* scaler +3 → 2e12 kWh */
+	r.reactive_energy = -2000000000;
+	r.field_mask = (1u << 22) | (1u << 23);
+	scaler_exp[22] = 3;
+	scaler_cached[22] = true;
+	scaler_exp[23] = 3;
+	scaler_cached[23] = true;
+
+	meter_record_pack(&r, 0, &rec);
+
+	ASSERT_EQ(INT32_MAX, rec.value[22]);
+	ASSERT_EQ(INT32_MIN, rec.value[23]);
+
+	scaler_exp[22] = 0;
+	scaler_cached[22] = false;
+	scaler_exp[23] = 0;
+	scaler_cached[23] = false;
+}
+
+void test_field_rid_mapping(void)
+{
+	ASSERT_EQ(PM_TENSION_R_RID, meter_field_rid(0));
+	ASSERT_EQ(PM_ACTIVE_ENERGY_RID, meter_field_rid(22));
+	ASSERT_EQ(PM_NEUTRAL_CURRENT_RID, meter_field_rid(26));
+	ASSERT_EQ(0xFFFF, meter_field_rid(-1));
+	ASSERT_EQ(0xFFFF, meter_field_rid(METER_FIELD_COUNT));
+}
+
 /* ==== v0.19.0: OBIS Retry & Diagnostics ==== */
 
 void test_retry_constants(void)
@@ -755,6 +1055,153 @@ void test_poll_duration_tracking(void)
 	poll_duration_sum_ms = 0;
 }
 
+void test_obis_diag_timing_virtual_clock(void)
+{
+	struct meter_readings r;
+
+	/* Per-OBIS read time comes from k_uptime_get(): non-zero now that
+	 * the stubs keep virtual time
+	 */
+	memset(obis_diag, 0, sizeof(obis_diag));
+	meter_sim_reset(NULL);
+	meter_init();
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_disable();
+
+	/* One GET: ~250 ms meter latency plus bus and polling time */
+	ASSERT_GT(obis_diag[0].total_ms, 250);
+	ASSERT_LT(obis_diag[0].total_ms, 400);
+	ASSERT_EQ(0, (int)obis_diag[6].total_ms);   /* pre-skipped phase S */
+	ASSERT_GT(last_read_cycle_ms, 0);
+	ASSERT_LT(last_read_cycle_ms, last_poll_duration_ms);
+}
+
+void test_latency_histograms_per_phase(void)
+{
+	struct meter_readings r;
+	struct lat_hist h;
+	uint32_t errors;
+
+	/* Warm-up poll caches the scalers: the second one only reads values */
+	meter_sim_reset(NULL);
+	meter_init();
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_reset(NULL);
+	meter_reset_latency();
+	ASSERT_EQ(0, meter_sim_inject(METER_SIM_FAULT_DROP));
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_disable();
+
+	/* One transaction each for link and association setup/teardown */
+	ASSERT_EQ(0, meter_get_phase_latency(DLMS_PHASE_SNRM, &h, &errors));
+	ASSERT_EQ(1, (int)h.count);
+	ASSERT_EQ(0, (int)errors);
+	ASSERT_EQ(9, lat_hist_bucket(h.max_ms));    /* [256, 384) ms */
+	meter_get_phase_latency(DLMS_PHASE_AARQ, &h, NULL);
+	ASSERT_EQ(1, (int)h.count);
+	meter_get_phase_latency(DLMS_PHASE_RLRQ, &h, NULL);
+	ASSERT_EQ(1, (int)h.count);
+	meter_get_phase_latency(DLMS_PHASE_DISC, &h, NULL);
+	ASSERT_EQ(1, (int)h.count);
+
+	/* Value GETs plus the retry of the dropped one, which timed out */
+	meter_get_phase_latency(DLMS_PHASE_GET, &h, &errors);
+	ASSERT_EQ(r.read_count + 1, (int)h.count);
+	ASSERT_EQ(1, (int)errors);
+	ASSERT_EQ(1, (int)h.bucket[LAT_HIST_BUCKETS - 1]);
+
+	/* One sample per OBIS entry read, retries included; none for
+	 * pre-skipped ones
+	 */
+	ASSERT_EQ(0, meter_get_obis_latency(0, &h));
+	ASSERT_EQ(1, (int)h.count);
+	ASSERT_EQ(LAT_HIST_BUCKETS - 1, lat_hist_bucket(h.max_ms));
+	ASSERT_EQ(0, meter_get_obis_latency(6, &h));
+	ASSERT_EQ(0, (int)h.count);
+
+	ASSERT_EQ(-EINVAL, meter_get_obis_latency(-1, &h));
+	ASSERT_EQ(-EINVAL, meter_get_obis_latency(METER_FIELD_COUNT, &h));
+	ASSERT_EQ(-EINVAL, meter_get_phase_latency(DLMS_PHASE_COUNT, &h, NULL));
+	ASSERT_STR_EQ("GET", meter_phase_name(DLMS_PHASE_GET));
+	ASSERT_STR_EQ("Voltage_R", meter_field_name(0));
+	ASSERT_TRUE(meter_field_name(METER_FIELD_COUNT) == NULL);
+
+	meter_reset_latency();
+	meter_get_phase_latency(DLMS_PHASE_GET, &h, &errors);
+	ASSERT_EQ(0, (int)h.count);
+	ASSERT_EQ(0, (int)errors);
+}
+
+void test_scaler_out_of_range_marks_field_unavailable(void)
+{
+	struct meter_readings r;
+	const struct obis_code energy = { 1, 1, 1, 8, 0, 255 };
+
+	memset(obis_diag, 0, sizeof(obis_diag));
+	meter_sim_reset(NULL);
+	/* Scaler 12: a clamped 10^9 would report the register 1000x low */
+	ASSERT_EQ(0, meter_sim_set_register(&energy, COSEM_TYPE_UINT32,
+					    1234567, 12, 30));
+	meter_init();
+	ASSERT_EQ(0, meter_poll(&r));
+
+	/* Field 22 is never read or pushed; the others are unaffected */
+	ASSERT_TRUE((r.field_mask & (1u << 22)) == 0);
+	ASSERT_TRUE((r.field_mask & (1u << 23)) != 0);
+	ASSERT_EQ(0, r.active_energy);
+	ASSERT_EQ(1, (int)obis_diag[22].bad_scaler);
+	ASSERT_EQ(0, (int)obis_diag[22].success);
+	ASSERT_EQ(1, (int)obis_diag[22].skip);
+	ASSERT_EQ(r.read_count, r.read_target);
+
+	/* Not re-read on the next poll: the bad scaler stays cached */
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_disable();
+	ASSERT_EQ(1, (int)obis_diag[22].bad_scaler);
+	ASSERT_TRUE((r.field_mask & (1u << 22)) == 0);
+
+	/* A fresh meter_init() reads the scaler again */
+	meter_init();
+	ASSERT_FALSE(scaler_bad[22]);
+}
+
+void test_last_poll_stats(void)
+{
+	struct meter_sim_config sc;
+	struct meter_sim_stats st;
+	struct meter_poll_stats ps;
+	struct meter_readings r;
+
+	meter_sim_reset(NULL);
+	meter_init();
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_get_stats(&st);
+	meter_get_last_poll(&ps);
+
+	ASSERT_EQ(0, ps.result);
+	ASSERT_TRUE(ps.associated);
+	ASSERT_EQ(r.read_count, (int)ps.read_count);
+	ASSERT_EQ(r.read_target, (int)ps.read_target);
+	ASSERT_EQ((int)meter_get_poll_duration_ms(), (int)ps.duration_ms);
+	ASSERT_EQ((int)st.bytes_rx, (int)ps.tx_bytes);
+	ASSERT_EQ((int)st.bytes_tx, (int)ps.rx_bytes);
+
+	/* A refused link still yields a cycle time, with nothing read */
+	meter_sim_default_config(&sc);
+	sc.dm_on_snrm = true;
+	meter_sim_reset(&sc);
+	ASSERT_TRUE(meter_poll(&r) < 0);
+	meter_sim_disable();
+	meter_get_last_poll(&ps);
+
+	ASSERT_TRUE(ps.result < 0);
+	ASSERT_FALSE(ps.associated);
+	ASSERT_GT(ps.duration_ms, 0);
+	ASSERT_EQ(0, (int)ps.read_count);
+	ASSERT_EQ(0, (int)ps.read_target);
+	ASSERT_GT(ps.tx_bytes, 0);
+}
+
 void test_obis_diag_api_bounds(void)
 {
 	/* meter_get_obis_diag should handle out-of-bounds gracefully */
@@ -811,19 +1258,29 @@ void run_dlms_logic_tests(void)
 
 	/* meter_readings struct */
 	RUN_TEST(test_readings_voltage_r_first_field);
-	RUN_TEST(test_readings_all_doubles_8_bytes);
+	RUN_TEST(test_readings_raw_fields_4_bytes);
 	RUN_TEST(test_readings_struct_has_metadata);
 	RUN_TEST(test_readings_field_count);
 
-	/* value_to_double */
-	RUN_TEST(test_vtod_unsigned_no_scaler);
-	RUN_TEST(test_vtod_signed_negative);
-	RUN_TEST(test_vtod_float64_direct);
-	RUN_TEST(test_vtod_with_scaler);
-	RUN_TEST(test_vtod_scaler_negative_exponent);
-	RUN_TEST(test_vtod_enum_type);
-	RUN_TEST(test_vtod_unknown_type_returns_zero);
-	RUN_TEST(test_vtod_out_of_bounds_index);
+	/* value_to_raw / field_value */
+	RUN_TEST(test_vtor_unsigned);
+	RUN_TEST(test_vtor_signed_negative);
+	RUN_TEST(test_vtor_float64_keeps_decimals);
+	RUN_TEST(test_vtor_float_shift_stops_at_scaler_min);
+	RUN_TEST(test_vtor_saturates);
+	RUN_TEST(test_vtor_enum_type);
+	RUN_TEST(test_vtor_unknown_type_returns_zero);
+	RUN_TEST(test_field_value_no_scaler);
+	RUN_TEST(test_field_value_with_scaler);
+	RUN_TEST(test_field_value_scaler_negative_exponent);
+	RUN_TEST(test_reading_value_out_of_bounds_index);
+
+	/* Power-of-ten table & integer fixed-point path */
+	RUN_TEST(test_pow10_tables_exact);
+	RUN_TEST(test_rescale_fixed_rounding);
+	RUN_TEST(test_rescale_fixed_saturates);
+	RUN_TEST(test_fixed_in_range);
+	RUN_TEST(test_reading_fixed_pair);
 
 	/* Config defaults */
 	RUN_TEST(test_default_config);
@@ -863,18 +1320,35 @@ void run_dlms_logic_tests(void)
 	RUN_TEST(test_sanity_check_rejects_frequency_out_of_range);
 	RUN_TEST(test_sanity_check_requires_field_coverage);
 	RUN_TEST(test_sanity_check_voltage_only_no_frequency);
+	RUN_TEST(test_sanity_check_applies_scaler);
 
 	/* Periodic push — field_mask guard (v0.18.0) */
 	RUN_TEST(test_push_field_skips_when_bit_not_set);
 	RUN_TEST(test_push_field_pushes_when_bit_set);
 	RUN_TEST(test_push_field_all_27_bits);
 
+	/* Composite Send batching */
+	RUN_TEST(test_push_composite_single_send);
+	RUN_TEST(test_push_composite_fallback_notifies);
+	RUN_TEST(test_push_invalid_sends_nothing);
+
+	/* Store-and-forward record packing */
+	RUN_TEST(test_record_pack_roundtrip);
+	RUN_TEST(test_record_pack_skips_unread_fields);
+	RUN_TEST(test_record_pack_large_energy);
+	RUN_TEST(test_record_pack_saturates);
+	RUN_TEST(test_field_rid_mapping);
+
 	/* OBIS retry & diagnostics (v0.19.0) */
 	RUN_TEST(test_retry_constants);
 	RUN_TEST(test_obis_diag_struct_size);
 	RUN_TEST(test_obis_diag_initially_zero);
 	RUN_TEST(test_obis_diag_counters_writable);
 	RUN_TEST(test_poll_duration_tracking);
+	RUN_TEST(test_obis_diag_timing_virtual_clock);
+	RUN_TEST(test_latency_histograms_per_phase);
+	RUN_TEST(test_scaler_out_of_range_marks_field_unavailable);
+	RUN_TEST(test_last_poll_stats);
 	RUN_TEST(test_obis_diag_api_bounds);
 	RUN_TEST(test_obis_diag_api_valid_index);
 	RUN_TEST(test_avg_poll_duration_zero_polls);
@@ -5,6 +5,7 @@
  * frame parsing, and frame finding in byte streams.
  */
 #include "test_framework.h"
+#include <errno.h>
 #include "dlms_hdlc.h"
 
 /* ==== CRC-16/CCITT Tests ==== */
@@ -28,6 +29,39 @@ void test_crc16_known_vector(void)
 	ASSERT_EQ(0x906E, crc);
 }
 
+void test_crc16_variants_known_vector(void)
+{
+	const uint8_t data[] = "123456789";
+
+	ASSERT_EQ(0x906E, hdlc_crc16_table(data, 9));
+	ASSERT_EQ(0x906E, hdlc_crc16_slice4(data, 9));
+	ASSERT_EQ(0x906E, hdlc_crc16_nibble(data, 9));
+	ASSERT_EQ(0x906E, hdlc_crc16_bitwise(data, 9));
+}
+
+void test_crc16_variants_agree(void)
+{
+	/* Every length 0..300 (slicing tail 0-3) and every start offset
+	 * 0-3 (alignment), over pseudo-random data
+	 */
+	static uint8_t buf[304];
+	uint32_t x = 0x12345678;
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		x = x * 1103515245u + 12345u;
+		buf[i] = (uint8_t)(x >> 16);
+	}
+	for (size_t off = 0; off < 4; off++) {
+		for (size_t len = 0; len <= 300; len++) {
+			uint16_t ref = hdlc_crc16_bitwise(&buf[off], len);
+
+			ASSERT_EQ(ref, hdlc_crc16_table(&buf[off], len));
+			ASSERT_EQ(ref, hdlc_crc16_slice4(&buf[off], len));
+			ASSERT_EQ(ref, hdlc_crc16_nibble(&buf[off], len));
+		}
+	}
+}
+
 void test_crc16_single_byte(void)
 {
 	uint8_t data[] = { 0x00 };
@@ -245,6 +279,36 @@ void test_parse_invalid_no_flags(void)
 	ASSERT_TRUE(ret < 0);
 }
 
+void test_parse_truncated_info(void)
+{
+	/* DISC header (HCS valid) followed by 1–2 stray bytes: too short
+	 * for info + FCS, must not underflow the info length
+	 */
+	uint8_t buf[16];
+	struct hdlc_frame frame;
+	int len = hdlc_build_disc(buf, sizeof(buf), 0x03, 0x21);
+
+	ASSERT_EQ(9, len);
+	buf[8] = 0x00;
+	buf[9] = HDLC_FLAG;
+	ASSERT_EQ(-EINVAL, hdlc_parse_frame(buf, 10, &frame));
+	buf[9] = 0x00;
+	buf[10] = HDLC_FLAG;
+	ASSERT_EQ(-EINVAL, hdlc_parse_frame(buf, 11, &frame));
+}
+
+void test_parse_oversize_info(void)
+{
+	static uint8_t buf[HDLC_MAX_INFO_LEN + 64];
+	struct hdlc_frame frame;
+	int len = hdlc_build_disc(buf, sizeof(buf), 0x03, 0x21);
+
+	ASSERT_EQ(9, len);
+	memset(&buf[8], 0x00, sizeof(buf) - 9);
+	buf[sizeof(buf) - 1] = HDLC_FLAG;
+	ASSERT_EQ(-ENOMEM, hdlc_parse_frame(buf, sizeof(buf), &frame));
+}
+
 void test_parse_null_args(void)
 {
 	struct hdlc_frame frame;
@@ -407,6 +471,8 @@ void run_hdlc_tests(void)
 	/* CRC-16 */
 	RUN_TEST(test_crc16_empty);
 	RUN_TEST(test_crc16_known_vector);
+	RUN_TEST(test_crc16_variants_known_vector);
+	RUN_TEST(test_crc16_variants_agree);
 	RUN_TEST(test_crc16_single_byte);
 	RUN_TEST(test_crc16_consistency);
 	RUN_TEST(test_crc16_different_inputs);
@@ -431,6 +497,8 @@ void run_hdlc_tests(void)
 	RUN_TEST(test_parse_iframe_roundtrip);
 	RUN_TEST(test_parse_invalid_too_short);
 	RUN_TEST(test_parse_invalid_no_flags);
+	RUN_TEST(test_parse_truncated_info);
+	RUN_TEST(test_parse_oversize_info);
 	RUN_TEST(test_parse_null_args);
 
 	/* Frame find */
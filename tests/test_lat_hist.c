@@ -0,0 +1,149 @@
+/*
+ * Unit Tests — Latency Histogram (lat_hist.c)
+ *
+ * Tests half-octave bucket edges, percentile estimates, mean/max and
+ * the comma-separated bucket format served by Object 33003.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "lat_hist.h"
+
+/* ==== Buckets ==== */
+
+void test_lat_hist_bucket_edges(void)
+{
+	ASSERT_EQ(0, lat_hist_bucket(0));
+	ASSERT_EQ(0, lat_hist_bucket(15));
+	ASSERT_EQ(1, lat_hist_bucket(16));
+	ASSERT_EQ(1, lat_hist_bucket(23));
+	ASSERT_EQ(2, lat_hist_bucket(24));
+	ASSERT_EQ(2, lat_hist_bucket(31));
+	ASSERT_EQ(3, lat_hist_bucket(32));
+	ASSERT_EQ(8, lat_hist_bucket(255));
+	ASSERT_EQ(9, lat_hist_bucket(256));
+	ASSERT_EQ(10, lat_hist_bucket(384));
+	ASSERT_EQ(14, lat_hist_bucket(2047));
+	ASSERT_EQ(15, lat_hist_bucket(2048));
+	ASSERT_EQ(15, lat_hist_bucket(5000));
+	ASSERT_EQ(15, lat_hist_bucket(UINT32_MAX));
+}
+
+void test_lat_hist_bucket_upper_matches_bucket(void)
+{
+	/* Every bound is the first value of the next bucket */
+	for (int b = 0; b < LAT_HIST_BUCKETS - 1; b++) {
+		uint32_t upper = lat_hist_bucket_upper_ms(b);
+
+		ASSERT_EQ(b, lat_hist_bucket(upper - 1));
+		ASSERT_EQ(b + 1, lat_hist_bucket(upper));
+	}
+	ASSERT_EQ(UINT32_MAX, lat_hist_bucket_upper_ms(LAT_HIST_BUCKETS - 1));
+	ASSERT_EQ(UINT32_MAX, lat_hist_bucket_upper_ms(-1));
+}
+
+/* ==== Statistics ==== */
+
+void test_lat_hist_empty(void)
+{
+	struct lat_hist h;
+
+	lat_hist_reset(&h);
+	ASSERT_EQ(0, lat_hist_mean_ms(&h));
+	ASSERT_EQ(0, lat_hist_percentile_ms(&h, 95));
+	ASSERT_EQ(0, h.max_ms);
+}
+
+void test_lat_hist_record_mean_max(void)
+{
+	struct lat_hist h;
+
+	lat_hist_reset(&h);
+	lat_hist_record(&h, 250);
+	lat_hist_record(&h, 270);
+	lat_hist_record(&h, 5100);
+
+	ASSERT_EQ(3, h.count);
+	ASSERT_EQ(5100, h.max_ms);
+	ASSERT_EQ(1873, lat_hist_mean_ms(&h));
+	ASSERT_EQ(1, h.bucket[8]);    /* [192, 256) */
+	ASSERT_EQ(1, h.bucket[9]);    /* [256, 384) */
+	ASSERT_EQ(1, h.bucket[15]);   /* timeout */
+}
+
+void test_lat_hist_percentiles(void)
+{
+	struct lat_hist h;
+
+	lat_hist_reset(&h);
+	for (int i = 0; i < 95; i++) {
+		lat_hist_record(&h, 300);   /* [256, 384) */
+	}
+	for (int i = 0; i < 5; i++) {
+		lat_hist_record(&h, 900);   /* [768, 1024) */
+	}
+
+	ASSERT_EQ(384, lat_hist_percentile_ms(&h, 50));
+	ASSERT_EQ(384, lat_hist_percentile_ms(&h, 95));
+	/* Capped at the largest sample, not the bucket bound (1024) */
+	ASSERT_EQ(900, lat_hist_percentile_ms(&h, 96));
+	ASSERT_EQ(900, lat_hist_percentile_ms(&h, 100));
+}
+
+void test_lat_hist_percentile_last_bucket_is_max(void)
+{
+	struct lat_hist h;
+
+	lat_hist_reset(&h);
+	lat_hist_record(&h, 5000);
+	ASSERT_EQ(5000, lat_hist_percentile_ms(&h, 50));
+}
+
+/* ==== Format ==== */
+
+void test_lat_hist_format(void)
+{
+	struct lat_hist h;
+	char buf[96];
+
+	lat_hist_reset(&h);
+	lat_hist_record(&h, 1);
+	lat_hist_record(&h, 300);
+	lat_hist_record(&h, 300);
+	lat_hist_record(&h, 9000);
+
+	ASSERT_EQ(31, lat_hist_format(&h, buf, sizeof(buf)));
+	ASSERT_STR_EQ("1,0,0,0,0,0,0,0,0,2,0,0,0,0,0,1", buf);
+}
+
+void test_lat_hist_format_too_small(void)
+{
+	struct lat_hist h;
+	char buf[16];
+
+	lat_hist_reset(&h);
+	ASSERT_EQ(-ENOMEM, lat_hist_format(&h, buf, sizeof(buf)));
+	ASSERT_EQ(-ENOMEM, lat_hist_format(&h, buf, 0));
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_lat_hist_tests(void)
+{
+	TEST_SUITE_BEGIN("Latency Histogram");
+
+	/* Buckets */
+	RUN_TEST(test_lat_hist_bucket_edges);
+	RUN_TEST(test_lat_hist_bucket_upper_matches_bucket);
+
+	/* Statistics */
+	RUN_TEST(test_lat_hist_empty);
+	RUN_TEST(test_lat_hist_record_mean_max);
+	RUN_TEST(test_lat_hist_percentiles);
+	RUN_TEST(test_lat_hist_percentile_last_bucket_is_max);
+
+	/* Format */
+	RUN_TEST(test_lat_hist_format);
+	RUN_TEST(test_lat_hist_format_too_small);
+
+	TEST_SUITE_END("Latency Histogram");
+}
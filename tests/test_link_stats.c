@@ -0,0 +1,161 @@
+/*
+ * Unit Tests — Neighbor Link Statistics (link_stats.c)
+ *
+ * Tests the fixed-memory sample ring (push, wrap, reset) and the
+ * min/max/mean/p95 RSSI and error-rate aggregates.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "link_stats.h"
+
+/* ==== Ring Tests ==== */
+
+void test_link_ring_empty_is_nodata(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	ASSERT_EQ(-ENODATA, link_ring_summarize(&ring, &sum));
+}
+
+void test_link_ring_null_args(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	ASSERT_EQ(-EINVAL, link_ring_summarize(NULL, &sum));
+	ASSERT_EQ(-EINVAL, link_ring_summarize(&ring, NULL));
+}
+
+void test_link_ring_single_sample(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, -70, 0, 0);
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_EQ(1, sum.samples);
+	ASSERT_EQ(-70, sum.rssi_min);
+	ASSERT_EQ(-70, sum.rssi_max);
+	ASSERT_EQ(-70, sum.rssi_p95);
+	ASSERT_FLOAT_EQ(-70.0, sum.rssi_mean, 0.001);
+}
+
+void test_link_ring_min_max_mean(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, -80, 0, 0);
+	link_ring_push(&ring, -60, 0, 0);
+	link_ring_push(&ring, -70, 0, 0);
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_EQ(3, sum.samples);
+	ASSERT_EQ(-80, sum.rssi_min);
+	ASSERT_EQ(-60, sum.rssi_max);
+	ASSERT_FLOAT_EQ(-70.0, sum.rssi_mean, 0.001);
+}
+
+void test_link_ring_p95_nearest_rank(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	/* -100..-81: rank ceil(0.95 * 20) = 19 → -82 */
+	link_ring_reset(&ring);
+	for (int i = 0; i < 20; i++) {
+		link_ring_push(&ring, (int8_t)(-100 + i), 0, 0);
+	}
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_EQ(-82, sum.rssi_p95);
+}
+
+void test_link_ring_wraps_oldest_out(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, -120, 0xFFFF, 0);
+	for (int i = 0; i < LINK_STATS_WINDOW; i++) {
+		link_ring_push(&ring, -50, 0, 0);
+	}
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_EQ(LINK_STATS_WINDOW, sum.samples);
+	ASSERT_EQ(-50, sum.rssi_min);
+	ASSERT_FLOAT_EQ(0.0, sum.frame_err_max, 0.001);
+}
+
+void test_link_ring_reset_clears(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, -60, 0, 0);
+	link_ring_reset(&ring);
+
+	ASSERT_EQ(-ENODATA, link_ring_summarize(&ring, &sum));
+}
+
+/* ==== Error Rate Tests ==== */
+
+void test_link_ring_error_rates_percent(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, -70, 0xFFFF, 0);
+	link_ring_push(&ring, -70, 0, 0xFFFF);
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_FLOAT_EQ(50.0, sum.frame_err_mean, 0.001);
+	ASSERT_FLOAT_EQ(100.0, sum.frame_err_max, 0.001);
+	ASSERT_FLOAT_EQ(50.0, sum.msg_err_mean, 0.001);
+}
+
+void test_link_ring_rssi_extremes(void)
+{
+	struct link_ring ring;
+	struct link_summary sum;
+
+	link_ring_reset(&ring);
+	link_ring_push(&ring, INT8_MIN, 0, 0);
+	link_ring_push(&ring, INT8_MAX, 0, 0);
+
+	ASSERT_EQ(0, link_ring_summarize(&ring, &sum));
+	ASSERT_EQ(INT8_MIN, sum.rssi_min);
+	ASSERT_EQ(INT8_MAX, sum.rssi_max);
+	ASSERT_EQ(INT8_MAX, sum.rssi_p95);
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_link_stats_tests(void)
+{
+	TEST_SUITE_BEGIN("Link Stats");
+
+	/* Ring */
+	RUN_TEST(test_link_ring_empty_is_nodata);
+	RUN_TEST(test_link_ring_null_args);
+	RUN_TEST(test_link_ring_single_sample);
+	RUN_TEST(test_link_ring_min_max_mean);
+	RUN_TEST(test_link_ring_p95_nearest_rank);
+	RUN_TEST(test_link_ring_wraps_oldest_out);
+	RUN_TEST(test_link_ring_reset_clears);
+
+	/* Error rates */
+	RUN_TEST(test_link_ring_error_rates_percent);
+	RUN_TEST(test_link_ring_rssi_extremes);
+
+	TEST_SUITE_END("Link Stats");
+}
@@ -0,0 +1,240 @@
+/*
+ * Unit Tests — MAC Counter Rates (mac_rate.c)
+ *
+ * Tests sliding-window frame rates, error ratios, 32-bit wrap
+ * handling and counter-reset detection.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "mac_rate.h"
+
+static struct mac_sample sample(int64_t t_ms, uint32_t tx, uint32_t rx,
+				uint32_t tx_err, uint32_t rx_err)
+{
+	struct mac_sample s = {
+		.t_ms = t_ms, .tx_total = tx, .rx_total = rx,
+		.tx_err = tx_err, .rx_err = rx_err,
+	};
+	return s;
+}
+
+/* ==== Window Tests ==== */
+
+void test_mac_rate_needs_two_samples(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample s = sample(0, 10, 10, 0, 0);
+
+	mac_rate_init(&w);
+	ASSERT_EQ(-ENODATA, mac_rate_get(&w, &r));
+	mac_rate_push(&w, &s);
+	ASSERT_EQ(-ENODATA, mac_rate_get(&w, &r));
+}
+
+void test_mac_rate_null_args(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+
+	mac_rate_init(&w);
+	ASSERT_EQ(-EINVAL, mac_rate_get(NULL, &r));
+	ASSERT_EQ(-EINVAL, mac_rate_get(&w, NULL));
+}
+
+void test_mac_rate_fps(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(0, 100, 200, 0, 0);
+	struct mac_sample b = sample(10000, 150, 300, 0, 0);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	mac_rate_push(&w, &b);
+
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_EQ(10000, r.span_ms);
+	ASSERT_FLOAT_EQ(5.0, r.tx_fps, 0.001);
+	ASSERT_FLOAT_EQ(10.0, r.rx_fps, 0.001);
+}
+
+void test_mac_rate_error_ratio(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(0, 0, 0, 0, 0);
+	struct mac_sample b = sample(1000, 200, 90, 20, 10);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	mac_rate_push(&w, &b);
+
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_FLOAT_EQ(10.0, r.tx_err_pct, 0.001);
+	ASSERT_FLOAT_EQ(10.0, r.rx_err_pct, 0.001);
+}
+
+void test_mac_rate_idle_error_ratio_zero(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(0, 50, 50, 1, 1);
+	struct mac_sample b = sample(1000, 50, 50, 1, 1);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	mac_rate_push(&w, &b);
+
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_FLOAT_EQ(0.0, r.tx_fps, 0.001);
+	ASSERT_FLOAT_EQ(0.0, r.tx_err_pct, 0.001);
+	ASSERT_FLOAT_EQ(0.0, r.rx_err_pct, 0.001);
+}
+
+void test_mac_rate_window_slides(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+
+	/* Burst in the first interval, then steady 1 fps */
+	mac_rate_init(&w);
+	struct mac_sample first = sample(0, 0, 0, 0, 0);
+	mac_rate_push(&w, &first);
+	for (int i = 1; i <= MAC_RATE_WINDOW + 2; i++) {
+		uint32_t tx = 1000 + (uint32_t)(i - 1);
+		struct mac_sample s = sample(i * 1000, tx, 0, 0, 0);
+		mac_rate_push(&w, &s);
+	}
+
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_EQ(MAC_RATE_WINDOW * 1000, r.span_ms);
+	ASSERT_FLOAT_EQ(1.0, r.tx_fps, 0.001);
+}
+
+/* ==== Wrap / Reset Tests ==== */
+
+void test_mac_rate_wrap_is_not_reset(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(0, 0xFFFFFFF0u, 0, 0, 0);
+	struct mac_sample b = sample(1000, 0x00000010u, 0, 0, 0);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	ASSERT_FALSE(mac_rate_push(&w, &b));
+
+	ASSERT_EQ(0, w.resets);
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_FLOAT_EQ(32.0, r.tx_fps, 0.001);
+}
+
+void test_mac_rate_reset_detected(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(0, 5000, 5000, 0, 0);
+	struct mac_sample b = sample(1000, 10, 20, 0, 0);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	ASSERT_TRUE(mac_rate_push(&w, &b));
+
+	ASSERT_EQ(1, w.resets);
+	/* Window restarts from the post-reset sample */
+	ASSERT_EQ(-ENODATA, mac_rate_get(&w, &r));
+
+	struct mac_sample c = sample(2000, 20, 40, 0, 0);
+	ASSERT_FALSE(mac_rate_push(&w, &c));
+	ASSERT_EQ(0, mac_rate_get(&w, &r));
+	ASSERT_FLOAT_EQ(10.0, r.tx_fps, 0.001);
+}
+
+void test_mac_rate_zero_span_nodata(void)
+{
+	struct mac_rate_window w;
+	struct mac_rates r;
+	struct mac_sample a = sample(500, 1, 1, 0, 0);
+
+	mac_rate_init(&w);
+	mac_rate_push(&w, &a);
+	mac_rate_push(&w, &a);
+	ASSERT_EQ(-ENODATA, mac_rate_get(&w, &r));
+}
+
+/* ==== Publish Threshold Tests ==== */
+
+void test_mac_rate_changes_steady_traffic(void)
+{
+	struct mac_rates last = { .tx_fps = 10.0, .rx_fps = 20.0,
+				  .tx_err_pct = 1.0, .rx_err_pct = 3.0 };
+	struct mac_rates now = { .tx_fps = 11.5, .rx_fps = 17.0,
+				 .tx_err_pct = 2.5, .rx_err_pct = 1.5 };
+
+	/* 15 % and 1.5 points: noise, nothing to publish */
+	ASSERT_EQ(0, (int)mac_rate_changes(&last, &now));
+}
+
+void test_mac_rate_changes_fps_step(void)
+{
+	struct mac_rates last = { .tx_fps = 10.0, .rx_fps = 20.0 };
+	struct mac_rates now = { .tx_fps = 12.5, .rx_fps = 20.0 };
+
+	ASSERT_EQ((int)MAC_RATE_TX_FPS, (int)mac_rate_changes(&last, &now));
+	now.rx_fps = 15.0;
+	ASSERT_EQ((int)(MAC_RATE_TX_FPS | MAC_RATE_RX_FPS),
+		  (int)mac_rate_changes(&last, &now));
+}
+
+void test_mac_rate_changes_fps_floor(void)
+{
+	struct mac_rates last = { 0 };
+	struct mac_rates now = { .tx_fps = 0.05 };
+
+	/* Idle link: a stray frame is not a change */
+	ASSERT_EQ(0, (int)mac_rate_changes(&last, &now));
+	now.tx_fps = 0.2;
+	ASSERT_EQ((int)MAC_RATE_TX_FPS, (int)mac_rate_changes(&last, &now));
+}
+
+void test_mac_rate_changes_error_spike(void)
+{
+	struct mac_rates last = { .tx_fps = 10.0, .rx_fps = 10.0,
+				  .tx_err_pct = 0.5, .rx_err_pct = 0.5 };
+	struct mac_rates now = last;
+
+	now.rx_err_pct = 4.0;
+	ASSERT_EQ((int)MAC_RATE_RX_ERR_PCT, (int)mac_rate_changes(&last, &now));
+	now.tx_err_pct = 0.0;
+	now.rx_err_pct = 0.5;
+	ASSERT_EQ(0, (int)mac_rate_changes(&last, &now));
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_mac_rate_tests(void)
+{
+	TEST_SUITE_BEGIN("MAC Rate");
+
+	/* Window */
+	RUN_TEST(test_mac_rate_needs_two_samples);
+	RUN_TEST(test_mac_rate_null_args);
+	RUN_TEST(test_mac_rate_fps);
+	RUN_TEST(test_mac_rate_error_ratio);
+	RUN_TEST(test_mac_rate_idle_error_ratio_zero);
+	RUN_TEST(test_mac_rate_window_slides);
+
+	/* Wrap / reset */
+	RUN_TEST(test_mac_rate_wrap_is_not_reset);
+	RUN_TEST(test_mac_rate_reset_detected);
+	RUN_TEST(test_mac_rate_zero_span_nodata);
+
+	/* Publish thresholds */
+	RUN_TEST(test_mac_rate_changes_steady_traffic);
+	RUN_TEST(test_mac_rate_changes_fps_step);
+	RUN_TEST(test_mac_rate_changes_fps_floor);
+	RUN_TEST(test_mac_rate_changes_error_spike);
+
+	TEST_SUITE_END("MAC Rate");
+}
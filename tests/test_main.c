@@ -4,12 +4,21 @@
  * Compile (Windows, GCC/MinGW):
  *   cd tests
  *   gcc -o run_tests.exe test_main.c test_hdlc.c test_cosem.c \
- *       ../src/dlms_hdlc.c ../src/dlms_cosem.c \
+ *       test_link_stats.c test_mac_rate.c test_airtime.c test_reg_coord.c \
+ *       test_send_window.c test_meter_sim.c test_trace_ring.c test_lat_hist.c \
+ *       test_poll_health.c meter_sim.c \
+ *       ../src/dlms_hdlc.c ../src/dlms_cosem.c ../src/link_stats.c \
+ *       ../src/mac_rate.c ../src/airtime_acct.c ../src/reg_coord.c \
+ *       ../src/trace_ring.c ../src/lat_hist.c ../src/poll_health.c \
+ *       stubs/zephyr_stubs.c \
  *       -I../src -Istubs -DUNIT_TEST -lm -Wall -Wextra
  *
  * Run:
  *   .\run_tests.exe
  *
+ * test_send_window.c #includes send_window.c, so send_window.c is not
+ * listed either.
+ *
  * Note: test_dlms_logic.c is NOT listed as a separate compilation unit
  * because it #includes dlms_meter.c directly to access static functions.
  * Instead, test_dlms_logic.c is #included from this file.
@@ -20,6 +29,15 @@
 /* Test suite runners — defined in each test file */
 extern void run_hdlc_tests(void);
 extern void run_cosem_tests(void);
+extern void run_link_stats_tests(void);
+extern void run_mac_rate_tests(void);
+extern void run_airtime_tests(void);
+extern void run_reg_coord_tests(void);
+extern void run_send_window_tests(void);
+extern void run_meter_sim_tests(void);
+extern void run_trace_ring_tests(void);
+extern void run_lat_hist_tests(void);
+extern void run_poll_health_tests(void);
 
 /*
  * DLMS logic tests include dlms_meter.c directly (static function access).
@@ -39,6 +57,15 @@ int main(void)
 	run_hdlc_tests();
 	run_cosem_tests();
 	run_dlms_logic_tests();
+	run_link_stats_tests();
+	run_mac_rate_tests();
+	run_airtime_tests();
+	run_reg_coord_tests();
+	run_send_window_tests();
+	run_meter_sim_tests();
+	run_trace_ring_tests();
+	run_lat_hist_tests();
+	run_poll_health_tests();
 
 	TEST_SUMMARY();
 	return TEST_EXIT_CODE();
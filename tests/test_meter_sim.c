@@ -0,0 +1,429 @@
+/*
+ * Unit Tests — DLMS poll cycle against the virtual meter (meter_sim.c)
+ *
+ * Drives meter_connect(), meter_read_all() and meter_poll() end to end
+ * over HDLC + COSEM: happy path, Data-Access-Result auto-skip, link and
+ * association refusals, lossy and corrupting buses, segmentation and
+ * datablock responses, and poll-cycle timing on the virtual clock.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include <stdint.h>
+#include "dlms_meter.h"
+#include "meter_sim.h"
+
+/* Single-phase build (CONFIG_AMI_SINGLE_PHASE): 15 OBIS codes polled */
+#define SP_TARGET  15
+
+static const struct obis_code obis_voltage_r = { 1, 1, 32, 7, 0, 255 };
+static const struct obis_code obis_current_r = { 1, 1, 31, 7, 0, 255 };
+static const struct obis_code obis_neutral   = { 1, 1, 91, 7, 0, 255 };
+
+static void sim_start(const struct meter_sim_config *cfg)
+{
+	meter_sim_reset(cfg);
+	meter_init();
+}
+
+/* ==== Happy Path ==== */
+
+void test_sim_poll_reads_all_registers(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_TRUE(r.valid);
+	ASSERT_EQ(SP_TARGET, r.read_target);
+	ASSERT_EQ(SP_TARGET, r.read_count);
+	ASSERT_EQ(0, r.error_count);
+	ASSERT_EQ(23045, r.voltage_r);
+	ASSERT_EQ(5123, r.current_r);
+	ASSERT_EQ(5001, r.frequency);
+	ASSERT_EQ(1234567, r.active_energy);
+	ASSERT_TRUE(meter_readings_usable(&r));
+
+	/* SNRM + AARQ + 15 scalers + 15 values + RLRQ + DISC, plus one
+	 * retry per misframed response (see test_sim_inner_flag_retry)
+	 */
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(2 + 2 * SP_TARGET + 2 + st.inner_flags, st.round_trips);
+	ASSERT_EQ(1, st.associations);
+	ASSERT_EQ(0, st.bad_frames);
+}
+
+void test_sim_scalers_applied(void)
+{
+	struct meter_readings r;
+
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_FLOAT_EQ(230.45, meter_reading_value(&r, 0), 0.0001);
+	ASSERT_FLOAT_EQ(50.01, meter_reading_value(&r, 25), 0.0001);
+	ASSERT_FLOAT_EQ(12345670.0, meter_reading_value(&r, 22), 0.01);
+}
+
+void test_sim_scalers_cached_across_polls(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_reset(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+
+	/* Second poll: values only */
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(2 + SP_TARGET + 2 + st.inner_flags, st.round_trips);
+}
+
+void test_sim_three_phase_meter_single_phase_build(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	meter_sim_default_config(&cfg);
+	cfg.three_phase = false;
+	sim_start(&cfg);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET, r.read_count);
+
+	/* Pre-skipped phases are never asked for */
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(2 * SP_TARGET + st.inner_flags, st.gets);
+}
+
+/* ==== COSEM Errors ==== */
+
+void test_sim_data_access_error_auto_skips(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	sim_start(NULL);
+	meter_sim_set_error(&obis_neutral, METER_SIM_DAR_OBJECT_UNDEFINED);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET - 1, r.read_count);
+	ASSERT_EQ(1, r.error_count);
+
+	/* -EACCES is not retried and the register is skipped next time */
+	meter_sim_reset(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET - 1, r.read_target);
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(SP_TARGET - 1 + st.inner_flags, st.gets);
+}
+
+void test_sim_wrong_password_rejected(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r;
+
+	meter_sim_default_config(&cfg);
+	strncpy(cfg.password, "12345678", sizeof(cfg.password) - 1);
+	sim_start(&cfg);
+	ASSERT_EQ(-EACCES, meter_poll(&r));
+}
+
+void test_sim_aare_rejected_transient(void)
+{
+	struct meter_sim_config cfg;
+
+	meter_sim_default_config(&cfg);
+	cfg.aare_result = 2;
+	sim_start(&cfg);
+	ASSERT_EQ(-EACCES, meter_connect());
+	meter_disconnect();
+}
+
+void test_sim_dm_refuses_link(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r;
+
+	meter_sim_default_config(&cfg);
+	cfg.dm_on_snrm = true;
+	sim_start(&cfg);
+	ASSERT_EQ(-EPROTO, meter_poll(&r));
+}
+
+void test_sim_wrong_address_times_out(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	meter_sim_default_config(&cfg);
+	cfg.server_addr = 0x05;
+	sim_start(&cfg);
+	ASSERT_EQ(-EAGAIN, meter_poll(&r));
+
+	/* SNRM, RLRQ and DISC each wait the full 5 s response timeout:
+	 * METER_ERROR sorts above METER_ASSOCIATED, so meter_disconnect()
+	 * also releases an association that never existed.
+	 */
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(3, st.recv_timeouts);
+	ASSERT_GE(st.now_us, 15000000);
+}
+
+/* ==== Faulty Bus ==== */
+
+void test_sim_dropped_response_retried(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	/* Cache the scalers, then lose the first value read */
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_reset(NULL);
+	meter_sim_inject(METER_SIM_FAULT_DROP);
+
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET, r.read_count);
+	ASSERT_EQ(23045, r.voltage_r);
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(1, st.dropped);
+	ASSERT_EQ(1, st.recv_timeouts);
+}
+
+void test_sim_corrupt_and_truncated_retried(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	meter_sim_reset(NULL);
+	meter_sim_inject(METER_SIM_FAULT_CORRUPT);
+	meter_sim_inject(METER_SIM_FAULT_TRUNCATE);
+
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET, r.read_count);
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(2, st.corrupted);
+}
+
+void test_sim_lossy_bus_reproducible(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r1, r2;
+	struct meter_sim_stats a, b;
+	int rc1, rc2;
+
+	memset(&r1, 0, sizeof(r1));
+	memset(&r2, 0, sizeof(r2));
+	meter_sim_default_config(&cfg);
+	cfg.loss_permille = 100;
+	cfg.corrupt_permille = 50;
+	cfg.jitter_us = 50000;
+	cfg.seed = 42;
+
+	/* The poll may fail outright (SNRM is not retried): only
+	 * reproducibility is asserted here.
+	 */
+	sim_start(&cfg);
+	rc1 = meter_poll(&r1);
+	meter_sim_get_stats(&a);
+
+	sim_start(&cfg);
+	rc2 = meter_poll(&r2);
+	meter_sim_get_stats(&b);
+
+	ASSERT_EQ(rc1, rc2);
+	ASSERT_EQ(a.now_us, b.now_us);
+	ASSERT_EQ(a.round_trips, b.round_trips);
+	ASSERT_EQ(r1.read_count, r2.read_count);
+	ASSERT_GT(a.dropped + a.corrupted, 0);
+}
+
+void test_sim_inner_flag_retry(void)
+{
+	struct meter_readings r;
+	struct meter_sim_stats st;
+
+	/*
+	 * Known client limitation: frames are delimited by scanning for
+	 * 0x7E rather than by the format length, so a response whose FCS
+	 * or data contains 0x7E is cut short and the GET is retried. The
+	 * default register set hits this once on the first poll.
+	 */
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_EQ(SP_TARGET, r.read_count);
+	meter_sim_get_stats(&st);
+	ASSERT_EQ(1, st.inner_flags);
+	ASSERT_EQ(0, st.recv_timeouts);
+}
+
+/* ==== Segmentation / Block Transfer ==== */
+
+void test_sim_segmented_response_fails_cleanly(void)
+{
+	struct meter_readings r;
+
+	sim_start(NULL);
+	meter_sim_set_flags(&obis_current_r, METER_SIM_REG_SEGMENTED);
+	ASSERT_EQ(0, meter_poll(&r));
+	/* No RR is sent for the next segment: the read fails, no crash */
+	ASSERT_FALSE(r.field_mask & (1u << 1));
+	ASSERT_EQ(SP_TARGET - 1, r.read_count);
+}
+
+void test_sim_datablock_not_supported(void)
+{
+	struct meter_readings r;
+
+	sim_start(NULL);
+	meter_sim_set_flags(&obis_voltage_r, METER_SIM_REG_DATABLOCK);
+	ASSERT_EQ(0, meter_poll(&r));
+	ASSERT_FALSE(r.field_mask & (1u << 0));
+	ASSERT_EQ(SP_TARGET - 1, r.read_count);
+}
+
+/* ==== Timing ==== */
+
+void test_sim_bus_time_model(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_sim_stats st;
+	uint64_t t0;
+
+	meter_sim_default_config(&cfg);
+	cfg.latency_us = 100000;
+	sim_start(&cfg);
+
+	/* SNRM 9 B out, 100 ms latency, 34 B UA polled in 10 ms steps */
+	ASSERT_EQ(0, meter_connect());
+	meter_sim_get_stats(&st);
+	ASSERT_GT(st.bytes_rx, 0);
+	ASSERT_GT(st.bytes_tx, 0);
+
+	t0 = meter_sim_now_us();
+	meter_disconnect();
+	/* RLRQ + DISC: two latencies plus bytes and poll granularity */
+	ASSERT_GE(meter_sim_now_us() - t0, 2 * 100000);
+	ASSERT_LT(meter_sim_now_us() - t0, 2 * 100000 + 2 * 60000);
+}
+
+void test_sim_slower_baud_costs_more(void)
+{
+	struct meter_sim_config cfg;
+	struct meter_readings r;
+	uint64_t fast, slow;
+
+	meter_sim_default_config(&cfg);
+	sim_start(&cfg);
+	ASSERT_EQ(0, meter_poll(&r));
+	fast = meter_sim_now_us();
+
+	cfg.baud = 4800;
+	sim_start(&cfg);
+	ASSERT_EQ(0, meter_poll(&r));
+	slow = meter_sim_now_us();
+
+	ASSERT_GT(slow, fast);
+	meter_sim_disable();
+}
+
+void test_sim_poll_duration_on_virtual_clock(void)
+{
+	struct meter_readings r;
+
+	sim_start(NULL);
+	ASSERT_EQ(0, meter_poll(&r));
+
+	/* T_cycle is measured by the firmware itself, on the virtual clock */
+	ASSERT_GT(meter_get_poll_duration_ms(), 0);
+	ASSERT_EQ((int64_t)(meter_sim_now_us() / 1000),
+		  meter_get_poll_duration_ms());
+	/* Readings are stamped after connect, before the value reads */
+	ASSERT_GT(r.timestamp_ms, 0);
+	ASSERT_LT(r.timestamp_ms, meter_get_poll_duration_ms());
+}
+
+void test_sim_thousand_polls(void)
+{
+	struct meter_readings r;
+	uint32_t polls0;
+	int64_t sum_ms = 0, min_ms = INT64_MAX, max_ms = 0;
+	int failed = 0;
+
+	sim_start(NULL);
+	polls0 = meter_get_poll_count();
+
+	for (int i = 0; i < 1000; i++) {
+		int64_t t;
+
+		if (meter_poll(&r) != 0) {
+			failed++;
+		}
+		t = meter_get_poll_duration_ms();
+		sum_ms += t;
+		if (t < min_ms) {
+			min_ms = t;
+		}
+		if (t > max_ms) {
+			max_ms = t;
+		}
+	}
+
+	ASSERT_EQ(0, failed);
+	ASSERT_EQ(polls0 + 1000, meter_get_poll_count());
+
+	/* Polls run back to back: their durations add up to the clock,
+	 * less at most 1 ms of truncation each
+	 */
+	ASSERT_GE((int64_t)(meter_sim_now_us() / 1000), sum_ms);
+	ASSERT_GE(sum_ms + 1000, (int64_t)(meter_sim_now_us() / 1000));
+
+	/* Steady state is 19 round trips at ~250 ms meter latency; only
+	 * the first poll (scalers) and misframing retries take longer
+	 */
+	ASSERT_GT(min_ms, 19 * 250);
+	ASSERT_LT(min_ms, 19 * 400);
+	ASSERT_GT(max_ms, min_ms);
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_meter_sim_tests(void)
+{
+	TEST_SUITE_BEGIN("DLMS Poll (virtual meter)");
+
+	/* Happy path */
+	RUN_TEST(test_sim_poll_reads_all_registers);
+	RUN_TEST(test_sim_scalers_applied);
+	RUN_TEST(test_sim_scalers_cached_across_polls);
+	RUN_TEST(test_sim_three_phase_meter_single_phase_build);
+
+	/* COSEM errors */
+	RUN_TEST(test_sim_data_access_error_auto_skips);
+	RUN_TEST(test_sim_wrong_password_rejected);
+	RUN_TEST(test_sim_aare_rejected_transient);
+	RUN_TEST(test_sim_dm_refuses_link);
+	RUN_TEST(test_sim_wrong_address_times_out);
+
+	/* Faulty bus */
+	RUN_TEST(test_sim_dropped_response_retried);
+	RUN_TEST(test_sim_corrupt_and_truncated_retried);
+	RUN_TEST(test_sim_lossy_bus_reproducible);
+	RUN_TEST(test_sim_inner_flag_retry);
+
+	/* Segmentation / block transfer */
+	RUN_TEST(test_sim_segmented_response_fails_cleanly);
+	RUN_TEST(test_sim_datablock_not_supported);
+
+	/* Timing */
+	RUN_TEST(test_sim_bus_time_model);
+	RUN_TEST(test_sim_slower_baud_costs_more);
+	RUN_TEST(test_sim_poll_duration_on_virtual_clock);
+	RUN_TEST(test_sim_thousand_polls);
+
+	meter_sim_disable();
+	TEST_SUITE_END("DLMS Poll (virtual meter)");
+}
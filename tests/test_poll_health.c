@@ -0,0 +1,204 @@
+/*
+ * Unit Tests — DLMS Poll Health (poll_health.c)
+ *
+ * Tests the poll window (wrap, reset), the T_cycle last/mean/p95 and
+ * coverage aggregates, and the failure and reconnect counters.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "poll_health.h"
+
+static void record(struct poll_health *h, uint32_t ms, uint16_t read,
+		   uint16_t target, uint32_t bytes, bool associated, bool ok)
+{
+	struct poll_health_sample s = {
+		.cycle_ms = ms, .bytes = bytes, .read = read,
+		.target = target, .associated = associated, .ok = ok,
+	};
+
+	poll_health_record(h, &s);
+}
+
+/* ==== Window Tests ==== */
+
+void test_poll_health_empty_is_nodata(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	ASSERT_EQ(-ENODATA, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(-EINVAL, poll_health_summarize(NULL, &sum));
+	ASSERT_EQ(-EINVAL, poll_health_summarize(&h, NULL));
+}
+
+void test_poll_health_single_poll(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	record(&h, 5200, 9, 9, 780, true, true);
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(1, sum.samples);
+	ASSERT_EQ(1, (int)sum.polls);
+	ASSERT_EQ(5200, (int)sum.last_cycle_ms);
+	ASSERT_EQ(5200, (int)sum.mean_cycle_ms);
+	ASSERT_EQ(5200, (int)sum.p95_cycle_ms);
+	ASSERT_EQ(780, (int)sum.bytes_per_poll);
+	ASSERT_FLOAT_EQ(100.0, sum.coverage_pct, 0.001);
+	ASSERT_EQ(0, (int)sum.failures);
+	ASSERT_EQ(0, (int)sum.consec_failures);
+}
+
+void test_poll_health_p95_nearest_rank(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	/* 1..20 s, recorded out of order: rank ceil(0.95 × 20) = 19 */
+	poll_health_reset(&h);
+	for (int i = 0; i < 20; i++) {
+		record(&h, 1000 * (uint32_t)((i * 7) % 20 + 1), 1, 1, 0,
+		       true, true);
+	}
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(19000, (int)sum.p95_cycle_ms);
+	ASSERT_EQ(10500, (int)sum.mean_cycle_ms);
+	ASSERT_EQ(1000 * ((19 * 7) % 20 + 1), (int)sum.last_cycle_ms);
+}
+
+void test_poll_health_wraps_oldest_out(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	record(&h, 60000, 0, 9, 5000, true, false);
+	for (int i = 0; i < POLL_HEALTH_WINDOW; i++) {
+		record(&h, 5000, 9, 9, 800, true, true);
+	}
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(POLL_HEALTH_WINDOW, sum.samples);
+	ASSERT_EQ(POLL_HEALTH_WINDOW + 1, (int)sum.polls);
+	ASSERT_EQ(5000, (int)sum.p95_cycle_ms);
+	ASSERT_EQ(800, (int)sum.bytes_per_poll);
+	ASSERT_FLOAT_EQ(100.0, sum.coverage_pct, 0.001);
+	/* Lifetime counters keep the failure that left the window */
+	ASSERT_EQ(1, (int)sum.failures);
+}
+
+void test_poll_health_reset_clears(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	record(&h, 5000, 9, 9, 800, false, false);
+	poll_health_reset(&h);
+	ASSERT_EQ(-ENODATA, poll_health_summarize(&h, &sum));
+	record(&h, 5000, 9, 9, 800, true, true);
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(0, (int)sum.failures);
+	ASSERT_EQ(0, (int)sum.reconnects);
+}
+
+/* ==== Coverage and Failure Tests ==== */
+
+void test_poll_health_partial_coverage(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	record(&h, 5000, 9, 9, 800, true, true);
+	record(&h, 5000, 6, 9, 800, true, true);
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_FLOAT_EQ(100.0 * 15 / 18, sum.coverage_pct, 0.001);
+}
+
+void test_poll_health_lost_link_counts_as_unread(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	/* A failed connect attempts the last known target and reads none,
+	 * whatever the caller passed
+	 */
+	poll_health_reset(&h);
+	record(&h, 5000, 9, 9, 800, true, true);
+	record(&h, 15000, 3, 0, 40, false, false);
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_FLOAT_EQ(50.0, sum.coverage_pct, 0.001);
+	ASSERT_EQ(15000, (int)sum.last_cycle_ms);
+	ASSERT_EQ(10000, (int)sum.mean_cycle_ms);
+}
+
+void test_poll_health_no_target_yet(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	/* Never associated: nothing attempted, coverage reads 0 */
+	poll_health_reset(&h);
+	record(&h, 15000, 0, 0, 40, false, false);
+
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_FLOAT_EQ(0.0, sum.coverage_pct, 0.001);
+	ASSERT_EQ(1, (int)sum.consec_failures);
+	ASSERT_EQ(0, (int)sum.reconnects);
+}
+
+void test_poll_health_consecutive_failures_and_reconnects(void)
+{
+	struct poll_health h;
+	struct poll_health_summary sum;
+
+	poll_health_reset(&h);
+	record(&h, 5000, 9, 9, 800, true, true);
+	record(&h, 15000, 0, 0, 40, false, false);
+	record(&h, 15000, 0, 0, 40, false, false);
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(2, (int)sum.consec_failures);
+	ASSERT_EQ(0, (int)sum.reconnects);
+
+	/* Associated again, but the read failed: a reconnect, no success */
+	record(&h, 9000, 0, 9, 300, true, false);
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(3, (int)sum.consec_failures);
+	ASSERT_EQ(1, (int)sum.reconnects);
+
+	record(&h, 5000, 9, 9, 800, true, true);
+	ASSERT_EQ(0, poll_health_summarize(&h, &sum));
+	ASSERT_EQ(0, (int)sum.consec_failures);
+	ASSERT_EQ(1, (int)sum.reconnects);
+	ASSERT_EQ(3, (int)sum.failures);
+	ASSERT_EQ(5, (int)sum.polls);
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_poll_health_tests(void)
+{
+	TEST_SUITE_BEGIN("Poll Health");
+
+	/* Window */
+	RUN_TEST(test_poll_health_empty_is_nodata);
+	RUN_TEST(test_poll_health_single_poll);
+	RUN_TEST(test_poll_health_p95_nearest_rank);
+	RUN_TEST(test_poll_health_wraps_oldest_out);
+	RUN_TEST(test_poll_health_reset_clears);
+
+	/* Coverage and failures */
+	RUN_TEST(test_poll_health_partial_coverage);
+	RUN_TEST(test_poll_health_lost_link_counts_as_unread);
+	RUN_TEST(test_poll_health_no_target_yet);
+	RUN_TEST(test_poll_health_consecutive_failures_and_reconnects);
+
+	TEST_SUITE_END("Poll Health");
+}
@@ -0,0 +1,131 @@
+/*
+ * Unit Tests — Registration Coordinator (reg_coord.c)
+ *
+ * Tests piggybacking of registration updates onto data windows and
+ * their suppression when a recent exchange proved liveness.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "reg_coord.h"
+
+#define REFRESH_S   1800
+#define LIVENESS_S  300
+
+/* ==== Data Window Tests ==== */
+
+void test_reg_coord_first_send_updates(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	ASSERT_EQ(REG_COORD_UPDATE, reg_coord_on_send(&rc, 1000));
+	ASSERT_EQ(1, rc.piggybacked);
+}
+
+void test_reg_coord_send_suppressed_when_fresh(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 0);
+
+	/* A 15 s poll cadence: no update for the whole refresh interval */
+	for (int64_t t = 15000; t < REFRESH_S * 1000LL; t += 15000) {
+		ASSERT_EQ(REG_COORD_NONE, reg_coord_on_send(&rc, t));
+	}
+	ASSERT_EQ(0, rc.piggybacked);
+	ASSERT_EQ(REFRESH_S / 15 - 1, rc.suppressed);
+}
+
+void test_reg_coord_send_piggybacks_when_stale(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 0);
+	ASSERT_EQ(REG_COORD_UPDATE, reg_coord_on_send(&rc, REFRESH_S * 1000LL));
+	ASSERT_EQ(1, rc.piggybacked);
+
+	/* Once it completes the next windows are quiet again */
+	reg_coord_update_done(&rc, REFRESH_S * 1000LL + 200);
+	ASSERT_EQ(REG_COORD_NONE,
+		  reg_coord_on_send(&rc, REFRESH_S * 1000LL + 15000));
+}
+
+/* ==== Idle Window Tests ==== */
+
+void test_reg_coord_idle_suppressed_by_recent_ack(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 0);
+	reg_coord_exchange_acked(&rc, 100000);
+	ASSERT_EQ(REG_COORD_NONE, reg_coord_on_idle(&rc, 160000));
+	ASSERT_EQ(1, rc.suppressed);
+	ASSERT_EQ(0, rc.forced);
+}
+
+void test_reg_coord_idle_forces_after_liveness(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 0);
+	reg_coord_exchange_acked(&rc, 100000);
+	ASSERT_EQ(REG_COORD_UPDATE,
+		  reg_coord_on_idle(&rc, 100000 + LIVENESS_S * 1000LL));
+	ASSERT_EQ(1, rc.forced);
+}
+
+void test_reg_coord_idle_forces_when_stale(void)
+{
+	struct reg_coord rc;
+	int64_t t = REFRESH_S * 1000LL;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 0);
+	/* A fresh ACK does not replace the registration refresh */
+	reg_coord_exchange_acked(&rc, t - 1000);
+	ASSERT_EQ(REG_COORD_UPDATE, reg_coord_on_idle(&rc, t));
+}
+
+void test_reg_coord_idle_without_history_updates(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	ASSERT_EQ(REG_COORD_UPDATE, reg_coord_on_idle(&rc, 0));
+}
+
+void test_reg_coord_update_counts_as_ack(void)
+{
+	struct reg_coord rc;
+
+	reg_coord_init(&rc, REFRESH_S, LIVENESS_S);
+	reg_coord_update_done(&rc, 5000);
+	ASSERT_TRUE(rc.have_ack);
+	ASSERT_EQ(5000, rc.last_ack_ms);
+	ASSERT_EQ(REG_COORD_NONE, reg_coord_on_idle(&rc, 65000));
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_reg_coord_tests(void)
+{
+	TEST_SUITE_BEGIN("Registration Coordinator");
+
+	/* Data windows */
+	RUN_TEST(test_reg_coord_first_send_updates);
+	RUN_TEST(test_reg_coord_send_suppressed_when_fresh);
+	RUN_TEST(test_reg_coord_send_piggybacks_when_stale);
+
+	/* Idle windows */
+	RUN_TEST(test_reg_coord_idle_suppressed_by_recent_ack);
+	RUN_TEST(test_reg_coord_idle_forces_after_liveness);
+	RUN_TEST(test_reg_coord_idle_forces_when_stale);
+	RUN_TEST(test_reg_coord_idle_without_history_updates);
+	RUN_TEST(test_reg_coord_update_counts_as_ack);
+
+	TEST_SUITE_END("Registration Coordinator");
+}
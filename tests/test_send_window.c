@@ -0,0 +1,157 @@
+/*
+ * Unit Tests — Send Window (send_window.c)
+ *
+ * Drives the send window with the registration coordinator through
+ * hours of poll cycles against a small model of the queue-mode engine
+ * and counts the registration updates it requests. send_window.c is
+ * #included for access to its static work items and coordinator.
+ */
+#include "test_framework.h"
+
+#define CONFIG_AMI_REG_COORD                  1
+#define CONFIG_AMI_REG_REFRESH_S              1800
+#define CONFIG_AMI_REG_LIVENESS_S             300
+#define CONFIG_AMI_LWM2M_LIFETIME             3600
+#define CONFIG_LWM2M_SECONDS_TO_UPDATE_EARLY  30
+#define CONFIG_AMI_SEND_WINDOW_MAX_GAP_S      60
+#define CONFIG_LWM2M_QUEUE_MODE_UPTIME        10
+
+#include "../src/send_window.c"
+
+#define POLL_S  30
+#define HOUR_S  3600
+
+/* ==== Engine Model ==== */
+
+static int64_t rx_off_at_ms;   /* 0: RX is off */
+static int updates_seen;
+
+static void sw_reset(void)
+{
+	vclock_reset();
+	initialized = false;
+	atomic_clear(&registered);
+	atomic_clear(&window_open);
+	atomic_clear(&idle_open);
+	atomic_clear(&coord_update_pending);
+	stub_rd_update_count = 0;
+	updates_seen = 0;
+	rx_off_at_ms = 0;
+}
+
+/* Any exchange keeps RX on for QUEUE_MODE_UPTIME */
+static void engine_exchange(void)
+{
+	rx_off_at_ms = k_uptime_get() + CONFIG_LWM2M_QUEUE_MODE_UPTIME * 1000;
+}
+
+static void engine_register(void)
+{
+	send_window_set_registered(true);
+	engine_exchange();
+}
+
+/*
+ * Run the engine second by second. A poll every @p poll_s seconds (0:
+ * none) sends its notifications and opens a window; updates the window
+ * requested complete at once, and RX goes off once the link has been
+ * quiet for QUEUE_MODE_UPTIME.
+ */
+static void engine_run(int seconds, int poll_s)
+{
+	for (int i = 0; i < seconds; i++) {
+		vclock_advance_us(1000000);
+		if (poll_s && (k_uptime_get() / 1000) % poll_s == 0) {
+			engine_exchange();
+			send_window_open();
+		}
+		k_work_run_due(&gap_work);
+		while (updates_seen < stub_rd_update_count) {
+			updates_seen++;
+			engine_exchange();
+			send_window_update_done();
+		}
+		if (rx_off_at_ms && k_uptime_get() >= rx_off_at_ms) {
+			rx_off_at_ms = 0;
+			send_window_rx_off();
+		}
+	}
+}
+
+/* ==== Data Window Tests ==== */
+
+void test_send_window_one_update_per_refresh(void)
+{
+	sw_reset();
+	engine_register();
+
+	/* 360 polls, one update per refresh period rides along */
+	engine_run(3 * HOUR_S, POLL_S);
+	ASSERT_EQ(3 * HOUR_S / CONFIG_AMI_REG_REFRESH_S, stub_rd_update_count);
+	ASSERT_EQ(stub_rd_update_count, coord.piggybacked);
+	ASSERT_EQ(3 * HOUR_S / POLL_S - stub_rd_update_count, coord.suppressed);
+	ASSERT_EQ(0, coord.forced);
+}
+
+void test_send_window_engine_update_not_counted(void)
+{
+	sw_reset();
+	engine_register();
+	engine_run(900, POLL_S);
+
+	/* The engine's own update does not move the coordinator's refresh */
+	send_window_update_done();
+	engine_run(900, POLL_S);
+	ASSERT_EQ(1, stub_rd_update_count);
+}
+
+/* ==== Idle Window Tests ==== */
+
+void test_send_window_idle_updates_per_liveness(void)
+{
+	sw_reset();
+	engine_register();
+
+	/*
+	 * No polls: a gap window every 60 s, 70 s after each exchange. The
+	 * first one past LIVENESS_S comes 310 s after the last update.
+	 */
+	engine_run(HOUR_S, 0);
+	ASSERT_EQ(HOUR_S / (CONFIG_AMI_REG_LIVENESS_S + 10), stub_rd_update_count);
+	ASSERT_EQ(stub_rd_update_count, coord.forced);
+	ASSERT_GT(coord.suppressed, coord.forced);
+}
+
+void test_send_window_acked_sends_keep_idle_quiet(void)
+{
+	sw_reset();
+	engine_register();
+
+	/* A Send ACKed every 2 minutes proves liveness; only the refresh
+	 * at 1800 s still needs an update.
+	 */
+	for (int t = 0; t < HOUR_S; t += 120) {
+		engine_run(120, 0);
+		engine_exchange();
+		send_window_exchange_acked();
+	}
+	ASSERT_EQ(1, stub_rd_update_count);
+	ASSERT_EQ(0, coord.piggybacked);
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_send_window_tests(void)
+{
+	TEST_SUITE_BEGIN("Send Window");
+
+	/* Data windows */
+	RUN_TEST(test_send_window_one_update_per_refresh);
+	RUN_TEST(test_send_window_engine_update_not_counted);
+
+	/* Idle windows */
+	RUN_TEST(test_send_window_idle_updates_per_liveness);
+	RUN_TEST(test_send_window_acked_sends_keep_idle_quiet);
+
+	TEST_SUITE_END("Send Window");
+}
@@ -0,0 +1,291 @@
+/*
+ * Unit Tests — Binary Trace Ring (trace_ring.c)
+ *
+ * Tests recording, overwrite of the oldest records, in-place freeze
+ * into the dump layout (header + ordered records), data events and
+ * clear.
+ */
+#include "test_framework.h"
+#include <errno.h>
+#include "trace_ring.h"
+
+#define RING_CAP  8
+
+static uint32_t ring_buf[TRACE_RING_BUF_LEN(RING_CAP) / 4];
+
+static struct trace_ring ring_new(void)
+{
+	struct trace_ring r;
+
+	memset(ring_buf, 0xA5, sizeof(ring_buf));
+	trace_ring_init(&r, (uint8_t *)ring_buf, sizeof(ring_buf));
+	return r;
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static const struct trace_rec *dump_rec(const uint8_t *dump, int i)
+{
+	return (const struct trace_rec *)
+		&dump[TRACE_RING_HDR_LEN + i * TRACE_RING_REC_LEN];
+}
+
+/* ==== Init ==== */
+
+void test_trace_ring_init_capacity(void)
+{
+	struct trace_ring r = ring_new();
+
+	ASSERT_EQ(RING_CAP, r.capacity);
+	ASSERT_EQ(0, trace_ring_count(&r));
+	ASSERT_TRUE(r.enabled);
+	ASSERT_FALSE(r.frozen);
+}
+
+void test_trace_ring_init_rejects_small_buffer(void)
+{
+	struct trace_ring r;
+
+	ASSERT_EQ(-EINVAL, trace_ring_init(&r, (uint8_t *)ring_buf,
+					   TRACE_RING_HDR_LEN + 7));
+	ASSERT_EQ(-EINVAL, trace_ring_init(&r, (uint8_t *)ring_buf + 1,
+					   sizeof(ring_buf) - 4));
+	ASSERT_EQ(-EINVAL, trace_ring_init(&r, NULL, sizeof(ring_buf)));
+}
+
+/* ==== Recording ==== */
+
+void test_trace_ring_put_and_freeze(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+	size_t len;
+
+	trace_ring_put(&r, 100, 1, 0, 9);
+	trace_ring_put(&r, 250, 2, TRACE_FLAG_ISR, 0xFFFB);
+	trace_ring_put(&r, 400, 3, 0, 0);
+	ASSERT_EQ(3, trace_ring_count(&r));
+
+	len = trace_ring_freeze(&r, 16000000);
+	ASSERT_EQ(TRACE_RING_BUF_LEN(3), len);
+	ASSERT_MEM_EQ(TRACE_RING_MAGIC, d, 4);
+	ASSERT_EQ(TRACE_RING_VERSION, d[4]);
+	ASSERT_EQ(TRACE_RING_REC_LEN, d[5]);
+	ASSERT_EQ(16000000, get_le32(&d[8]));
+	ASSERT_EQ(3, get_le32(&d[12]));
+	ASSERT_EQ(0, get_le32(&d[16]));
+
+	ASSERT_EQ(100, dump_rec(d, 0)->cycles);
+	ASSERT_EQ(1, dump_rec(d, 0)->id);
+	ASSERT_EQ(9, dump_rec(d, 0)->arg);
+	ASSERT_EQ(TRACE_FLAG_ISR, dump_rec(d, 1)->flags);
+	ASSERT_EQ(-5, (int16_t)dump_rec(d, 1)->arg);
+	ASSERT_EQ(400, dump_rec(d, 2)->cycles);
+}
+
+void test_trace_ring_record_wire_layout(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+	const uint8_t want[] = { 0x78, 0x56, 0x34, 0x12, 0x0B, 0x01, 0xCD, 0xAB };
+
+	trace_ring_put(&r, 0x12345678, 0x0B, TRACE_FLAG_ISR, 0xABCD);
+	trace_ring_freeze(&r, 1);
+	ASSERT_MEM_EQ(want, &d[TRACE_RING_HDR_LEN], sizeof(want));
+}
+
+void test_trace_ring_wrap_keeps_newest_in_order(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+
+	for (uint32_t i = 0; i < RING_CAP + 3; i++) {
+		trace_ring_put(&r, i * 10, (uint8_t)i, 0, (uint16_t)i);
+	}
+	ASSERT_EQ(RING_CAP, trace_ring_count(&r));
+	ASSERT_EQ(3, trace_ring_overwritten(&r));
+
+	ASSERT_EQ(TRACE_RING_BUF_LEN(RING_CAP), trace_ring_freeze(&r, 1));
+	ASSERT_EQ(RING_CAP, get_le32(&d[12]));
+	ASSERT_EQ(3, get_le32(&d[16]));
+	for (int i = 0; i < RING_CAP; i++) {
+		ASSERT_EQ(i + 3, dump_rec(d, i)->id);
+		ASSERT_EQ((i + 3) * 10, dump_rec(d, i)->cycles);
+	}
+}
+
+void test_trace_ring_wrap_exact_multiple(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+
+	/* Write position back at 0: no rotation needed */
+	for (uint32_t i = 0; i < 2 * RING_CAP; i++) {
+		trace_ring_put(&r, i, (uint8_t)i, 0, 0);
+	}
+	trace_ring_freeze(&r, 1);
+	for (int i = 0; i < RING_CAP; i++) {
+		ASSERT_EQ(RING_CAP + i, dump_rec(d, i)->id);
+	}
+}
+
+void test_trace_ring_every_wrap_offset(void)
+{
+	/* Rotation must be right for every write position */
+	for (uint32_t extra = 1; extra < RING_CAP; extra++) {
+		struct trace_ring r = ring_new();
+		const uint8_t *d = (const uint8_t *)ring_buf;
+
+		for (uint32_t i = 0; i < RING_CAP + extra; i++) {
+			trace_ring_put(&r, i, (uint8_t)i, 0, 0);
+		}
+		trace_ring_freeze(&r, 1);
+		for (int i = 0; i < RING_CAP; i++) {
+			ASSERT_EQ(extra + i, dump_rec(d, i)->id);
+		}
+	}
+}
+
+/* ==== Data Events ==== */
+
+void test_trace_ring_data_layout(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+	const uint8_t frame[10] = { 0x7E, 0xA0, 0x08, 0x03, 0x21, 0x93,
+				    0xC1, 0xE2, 0x7E, 0x55 };
+	const uint8_t want[2][8] = {
+		{ 0x7E, 0xA0, 0x08, 0x03, TRACE_RING_ID_DATA, 0x21, 0x93, 0xC1 },
+		{ 0xE2, 0x7E, 0x55, 0x00, TRACE_RING_ID_DATA, 0x00, 0x00, 0x00 },
+	};
+
+	trace_ring_put_data(&r, 500, 0x18, 0, frame, sizeof(frame), 32);
+	ASSERT_EQ(3, trace_ring_count(&r));
+
+	trace_ring_freeze(&r, 1);
+	ASSERT_EQ(500, dump_rec(d, 0)->cycles);
+	ASSERT_EQ(0x18, dump_rec(d, 0)->id);
+	ASSERT_EQ(10, dump_rec(d, 0)->arg);
+	ASSERT_MEM_EQ(want[0], dump_rec(d, 1), 8);
+	ASSERT_MEM_EQ(want[1], dump_rec(d, 2), 8);
+}
+
+void test_trace_ring_data_truncated_to_whole_records(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+	uint8_t frame[40];
+
+	for (int i = 0; i < (int)sizeof(frame); i++) {
+		frame[i] = (uint8_t)(i + 1);
+	}
+
+	/* max 8 rounds up to two full payload records (14 bytes) */
+	trace_ring_put_data(&r, 1, 0x19, 0, frame, sizeof(frame), 8);
+	ASSERT_EQ(3, trace_ring_count(&r));
+
+	trace_ring_freeze(&r, 1);
+	ASSERT_EQ(40, dump_rec(d, 0)->arg);
+	ASSERT_EQ(14, ((const uint8_t *)dump_rec(d, 2))[7]);
+
+	/* max 0: the event alone */
+	trace_ring_clear(&r);
+	trace_ring_put_data(&r, 1, 0x19, 0, frame, sizeof(frame), 0);
+	ASSERT_EQ(1, trace_ring_count(&r));
+}
+
+void test_trace_ring_data_disabled_ignored(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t frame[3] = { 1, 2, 3 };
+
+	r.enabled = false;
+	trace_ring_put_data(&r, 1, 0x18, 0, frame, sizeof(frame), 32);
+	ASSERT_EQ(0, trace_ring_count(&r));
+
+	r.enabled = true;
+	trace_ring_freeze(&r, 1);
+	trace_ring_put_data(&r, 1, 0x18, 0, frame, sizeof(frame), 32);
+	ASSERT_EQ(0, trace_ring_count(&r));
+}
+
+/* ==== Freeze / Clear ==== */
+
+void test_trace_ring_frozen_ignores_puts(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+
+	for (uint32_t i = 0; i < RING_CAP + 5; i++) {
+		trace_ring_put(&r, i, (uint8_t)i, 0, 0);
+	}
+	trace_ring_freeze(&r, 1);
+	trace_ring_put(&r, 999, 0xEE, 0, 0);
+
+	/* Freezing again serves the same dump, not a second rotation */
+	ASSERT_EQ(TRACE_RING_BUF_LEN(RING_CAP), trace_ring_freeze(&r, 1));
+	ASSERT_EQ(5, dump_rec(d, 0)->id);
+	ASSERT_EQ(RING_CAP + 4, dump_rec(d, RING_CAP - 1)->id);
+}
+
+void test_trace_ring_clear_resumes(void)
+{
+	struct trace_ring r = ring_new();
+	const uint8_t *d = (const uint8_t *)ring_buf;
+
+	for (uint32_t i = 0; i < RING_CAP + 2; i++) {
+		trace_ring_put(&r, i, 1, 0, 0);
+	}
+	trace_ring_freeze(&r, 1);
+	trace_ring_clear(&r);
+	ASSERT_FALSE(r.frozen);
+	ASSERT_EQ(0, trace_ring_count(&r));
+	ASSERT_EQ(0, trace_ring_overwritten(&r));
+
+	trace_ring_put(&r, 7, 42, 0, 0);
+	ASSERT_EQ(TRACE_RING_BUF_LEN(1), trace_ring_freeze(&r, 1));
+	ASSERT_EQ(42, dump_rec(d, 0)->id);
+}
+
+void test_trace_ring_disabled_ignores_puts(void)
+{
+	struct trace_ring r = ring_new();
+
+	r.enabled = false;
+	trace_ring_put(&r, 1, 1, 0, 0);
+	ASSERT_EQ(0, trace_ring_count(&r));
+	ASSERT_EQ(TRACE_RING_HDR_LEN, trace_ring_freeze(&r, 1));
+}
+
+/* ==== Test Suite Runner ==== */
+
+void run_trace_ring_tests(void)
+{
+	TEST_SUITE_BEGIN("Trace Ring");
+
+	/* Init */
+	RUN_TEST(test_trace_ring_init_capacity);
+	RUN_TEST(test_trace_ring_init_rejects_small_buffer);
+
+	/* Recording */
+	RUN_TEST(test_trace_ring_put_and_freeze);
+	RUN_TEST(test_trace_ring_record_wire_layout);
+	RUN_TEST(test_trace_ring_wrap_keeps_newest_in_order);
+	RUN_TEST(test_trace_ring_wrap_exact_multiple);
+	RUN_TEST(test_trace_ring_every_wrap_offset);
+
+	/* Data events */
+	RUN_TEST(test_trace_ring_data_layout);
+	RUN_TEST(test_trace_ring_data_truncated_to_whole_records);
+	RUN_TEST(test_trace_ring_data_disabled_ignored);
+
+	/* Freeze / clear */
+	RUN_TEST(test_trace_ring_frozen_ignores_puts);
+	RUN_TEST(test_trace_ring_clear_resumes);
+	RUN_TEST(test_trace_ring_disabled_ignores_puts);
+
+	TEST_SUITE_END("Trace Ring");
+}
@@ -0,0 +1,374 @@
+#!/usr/bin/env python3
+"""
+footprint_report.py — Per-module RAM/flash report and budget check
+==================================================================
+
+Reads the linker map of a build (build/zephyr/zephyr.map) and sums the
+input sections of every module:
+
+  * application sources (libapp.a) one by one: dlms_meter.c, ...
+  * other archives as a whole: subsys__net__lib__lwm2m, ...
+
+RAM is what lands in a RAM memory region (.bss, .data, IRAM code);
+flash is everything stored in flash, initialized .data included.
+Memory regions, their sizes and whether they are RAM or flash are read
+from the map's "Memory Configuration" table.
+
+Runtime figures are added from a console log of the "mem_audit" shell
+command (src/mem_audit.h): stack high-water marks per thread and the
+system heap peak.
+
+The report is checked against a budget (footprint_budget.json):
+
+  {
+    "measured_from": null,          # build the ceilings came from
+    "regions_max_pct": 90,          # any RAM/flash region
+    "modules": {"dlms_meter.c": {"ram": 5120, "flash": 16384}},
+    "stacks_max_pct": 80,           # default per thread
+    "stacks": {                     # per thread: percent, or
+      "dlms_tid": {"size": 4096},   # size ceiling and/or max_pct
+      "lwm2m-sock-recv": 85
+    },
+    "heap_max_pct": 75
+  }
+
+While "measured_from" is null the ceilings are estimates, and the check
+says so.
+
+and, with --baseline, compared to an earlier report (-o) so a change
+shows its footprint delta per module.
+
+Usage:
+  python3 footprint_report.py build/zephyr/zephyr.map \\
+      [--budget footprint_budget.json] [--stacks console.log] \\
+      [--baseline old.json] [-o footprint.json] [--top N]
+
+Exits with 1 when a budget is exceeded.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+APP_ARCHIVE = "libapp.a"
+
+HEX = re.compile(r"0x[0-9a-fA-F]+$")
+REGION_RE = re.compile(r"^(\S+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)")
+ARCHIVE_RE = re.compile(r"([^/\\(]+)\(([^)]+)\)$")
+STACK_RE = re.compile(r"stk (\d+)/(\d+) \d+% (.+?)\s*$")
+HEAP_RE = re.compile(r"heap (\d+)/(\d+) \d+% (.+?)\s*$")
+LOAD_RE = re.compile(r"load address (0x[0-9a-fA-F]+)")
+
+
+def is_hex(s):
+    return bool(HEX.match(s))
+
+
+def region_kind(name):
+    """'flash', 'ram' or None from a memory region name"""
+    n = name.lower()
+    if "rom" in n or "flash" in n:
+        return "flash"
+    if "ram" in n:
+        return "ram"
+    return None
+
+
+def module_of(path):
+    """Module name of an input file: source for the app, else archive"""
+    m = ARCHIVE_RE.search(path)
+    if not m:
+        return os.path.basename(path)
+    archive, obj = m.groups()
+    if archive == APP_ARCHIVE:
+        return re.sub(r"\.obj$|\.o$", "", obj)
+    return re.sub(r"^lib|\.a$", "", archive)
+
+
+def parse_map(path):
+    """Memory regions and (output section, vma, lma, module, size) rows"""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        lines = f.read().splitlines()
+
+    regions = []
+    rows = []
+    i = 0
+    # Memory Configuration: Name Origin Length [Attributes]
+    while i < len(lines) and not lines[i].startswith("Memory Configuration"):
+        i += 1
+    while i < len(lines) and not lines[i].startswith("Linker script"):
+        m = REGION_RE.match(lines[i])
+        if m and m.group(1) != "*default*":
+            name, origin, length = m.groups()
+            regions.append({"name": name, "origin": int(origin, 16),
+                            "length": int(length, 16),
+                            "kind": region_kind(name), "used": 0})
+        i += 1
+
+    out = None          # current output section: name, vma, lma
+    pending = None      # name of a section whose numbers wrap
+    for line in lines[i:]:
+        if not line.strip():
+            continue
+        f = line.split()
+
+        # Output section: name in column 0
+        if not line[0].isspace():
+            if len(f) >= 3 and is_hex(f[1]) and is_hex(f[2]):
+                lm = LOAD_RE.search(line)
+                vma = int(f[1], 16)
+                out = (f[0], vma, int(lm.group(1), 16) if lm else vma,
+                       int(f[2], 16))
+                pending = None
+            elif len(f) == 1:
+                out = None
+                pending = ("out", f[0])
+            continue
+
+        if pending and pending[0] == "out":
+            if len(f) >= 2 and is_hex(f[0]) and is_hex(f[1]):
+                lm = LOAD_RE.search(line)
+                vma = int(f[0], 16)
+                out = (pending[1], vma, int(lm.group(1), 16) if lm else vma,
+                       int(f[1], 16))
+            pending = None
+            continue
+
+        if out is None:
+            continue
+
+        # Input section: " .bss.name 0xaddr 0xsize file", possibly with
+        # the numbers on the next line when the name is long
+        if len(f) == 1 and f[0].startswith("."):
+            pending = ("in", f[0])
+            continue
+        if pending and len(f) >= 3 and is_hex(f[0]) and is_hex(f[1]):
+            f = [pending[1]] + f
+        pending = None
+        if len(f) < 4 or not is_hex(f[1]) or not is_hex(f[2]):
+            continue  # symbol assignment, *fill*, pattern, ...
+        size = int(f[2], 16)
+        if size == 0 or f[0] == "*fill*":
+            continue
+        rows.append((out[0], out[1], out[2], module_of(" ".join(f[3:])),
+                     size))
+
+    return regions, rows
+
+
+def region_at(regions, addr):
+    for r in regions:
+        if r["origin"] <= addr < r["origin"] + r["length"]:
+            return r
+    return None
+
+
+def is_noload(section):
+    s = section.lower()
+    return "bss" in s or "noinit" in s or "noload" in s
+
+
+def summarize(regions, rows):
+    """Per-module RAM/flash and per-region usage"""
+    modules = {}
+    for sec, vma, lma, mod, size in rows:
+        where = region_at(regions, vma)
+        if where is None or where["kind"] is None:
+            continue  # Debug info, or an address outside every region
+        where["used"] += size
+        m = modules.setdefault(mod, {"ram": 0, "flash": 0})
+        if where["kind"] == "ram":
+            m["ram"] += size
+            load = region_at(regions, lma)
+            if not is_noload(sec) and load is not where and load:
+                m["flash"] += size     # Initializer or IRAM code image
+                load["used"] += size
+        else:
+            m["flash"] += size
+    return modules
+
+
+def parse_runtime(path):
+    """Last stack and heap high-water marks from a mem_audit log"""
+    stacks, heaps = {}, {}
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            m = STACK_RE.search(line)
+            if m:
+                used, size, name = m.groups()
+                stacks[name] = {"used": int(used), "size": int(size)}
+                continue
+            m = HEAP_RE.search(line)
+            if m:
+                used, size, name = m.groups()
+                heaps[name] = {"used": int(used), "size": int(size)}
+    return stacks, heaps
+
+
+def pct(used, size):
+    return 100.0 * used / size if size else 0.0
+
+
+def check_budget(report, budget):
+    """List of budget violations (strings)"""
+    fails = []
+    limit = budget.get("regions_max_pct")
+    if limit is not None:
+        for r in report["regions"]:
+            p = pct(r["used"], r["length"])
+            if r["kind"] and p > limit:
+                fails.append(f"region {r['name']}: {p:.1f}% > {limit}%")
+
+    for mod, lim in budget.get("modules", {}).items():
+        got = report["modules"].get(mod)
+        if got is None:
+            continue  # Not in this build (Kconfig option off)
+        for kind in ("ram", "flash"):
+            if kind in lim and got[kind] > lim[kind]:
+                fails.append(f"{mod}: {kind} {got[kind]} B > {lim[kind]} B")
+
+    default = budget.get("stacks_max_pct")
+    per_thread = budget.get("stacks", {})
+    for name, st in report.get("stacks", {}).items():
+        lim = per_thread.get(name, {})
+        if not isinstance(lim, dict):
+            lim = {"max_pct": lim}
+        limit = lim.get("max_pct", default)
+        p = pct(st["used"], st["size"])
+        if limit is not None and p > limit:
+            fails.append(f"stack {name}: {p:.0f}% "
+                         f"({st['used']}/{st['size']} B) > {limit}%")
+        if "size" in lim and st["size"] > lim["size"]:
+            fails.append(f"stack {name}: size {st['size']} B "
+                         f"> {lim['size']} B")
+
+    limit = budget.get("heap_max_pct")
+    for name, h in report.get("heaps", {}).items():
+        p = pct(h["used"], h["size"])
+        if limit is not None and p > limit:
+            fails.append(f"heap {name}: peak {p:.0f}% > {limit}%")
+    return fails
+
+
+def delta(new, old):
+    d = new - old
+    return f"{d:+d}" if d else ""
+
+
+def print_report(report, baseline, top):
+    mods = report["modules"]
+    old = baseline["modules"] if baseline else {}
+
+    print(f"{'region':<20} {'kind':<6} {'used':>9} {'size':>9} {'%':>6}")
+    for r in report["regions"]:
+        if r["kind"] is None or r["length"] == 0:
+            continue
+        print(f"{r['name']:<20} {r['kind']:<6} {r['used']:>9} "
+              f"{r['length']:>9} {pct(r['used'], r['length']):>6.1f}")
+    print()
+
+    hdr = f"{'module':<36} {'RAM':>8} {'flash':>8}"
+    if baseline:
+        hdr += f" {'ΔRAM':>8} {'Δflash':>8}"
+    print(hdr)
+    names = sorted(mods, key=lambda k: (-mods[k]["ram"], -mods[k]["flash"]))
+    if baseline:
+        names += sorted(k for k in old if k not in mods)
+    shown = names if top is None else names[:top]
+    for name in shown:
+        m = mods.get(name, {"ram": 0, "flash": 0})
+        o = old.get(name, {"ram": 0, "flash": 0})
+        line = f"{name:<36} {m['ram']:>8} {m['flash']:>8}"
+        if baseline:
+            line += (f" {delta(m['ram'], o['ram']):>8}"
+                     f" {delta(m['flash'], o['flash']):>8}")
+        print(line)
+    if len(shown) < len(names):
+        print(f"... {len(names) - len(shown)} more (--top)")
+
+    tot = report["totals"]
+    line = f"{'total':<36} {tot['ram']:>8} {tot['flash']:>8}"
+    if baseline:
+        bt = baseline["totals"]
+        line += (f" {delta(tot['ram'], bt['ram']):>8}"
+                 f" {delta(tot['flash'], bt['flash']):>8}")
+    print(line)
+
+    if report.get("stacks"):
+        print()
+        print(f"{'thread':<28} {'used':>7} {'size':>7} {'%':>5}")
+        for name, st in sorted(report["stacks"].items(),
+                               key=lambda kv: -pct(kv[1]["used"],
+                                                   kv[1]["size"])):
+            print(f"{name:<28} {st['used']:>7} {st['size']:>7} "
+                  f"{pct(st['used'], st['size']):>5.0f}")
+        for name, h in report.get("heaps", {}).items():
+            print(f"heap {name:<23} {h['used']:>7} {h['size']:>7} "
+                  f"{pct(h['used'], h['size']):>5.0f}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("map", help="linker map (build/zephyr/zephyr.map)")
+    ap.add_argument("--budget", help="budget JSON (footprint_budget.json)")
+    ap.add_argument("--stacks", help="console log with mem_audit output")
+    ap.add_argument("--baseline", help="earlier report (-o) to diff against")
+    ap.add_argument("-o", "--output", help="write the report as JSON")
+    ap.add_argument("--top", type=int, help="only the N largest modules")
+    args = ap.parse_args()
+
+    regions, rows = parse_map(args.map)
+    if not regions or not rows:
+        sys.exit(f"{args.map}: not a GNU ld map (no memory regions "
+                 "or input sections)")
+    modules = summarize(regions, rows)
+
+    report = {
+        "map": os.path.abspath(args.map),
+        "regions": regions,
+        "modules": modules,
+        "totals": {
+            "ram": sum(m["ram"] for m in modules.values()),
+            "flash": sum(m["flash"] for m in modules.values()),
+        },
+    }
+    if args.stacks:
+        report["stacks"], report["heaps"] = parse_runtime(args.stacks)
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    print_report(report, baseline, args.top)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+        print(f"\nreport written to {args.output}")
+
+    if args.budget:
+        with open(args.budget, encoding="utf-8") as f:
+            budget = json.load(f)
+        fails = check_budget(report, budget)
+        print()
+        if not budget.get("measured_from"):
+            print(f"note: {args.budget} has no measured_from; its ceilings "
+                  "are estimates, not taken from a measured build")
+        if "stacks" in report:
+            missing = sorted(set(budget.get("stacks", {}))
+                             - set(report["stacks"]))
+            if missing:
+                print(f"note: no mem_audit line for budgeted thread(s) "
+                      f"{', '.join(missing)}")
+        if fails:
+            for msg in fails:
+                print(f"OVER BUDGET: {msg}")
+            sys.exit(1)
+        print(f"within budget ({args.budget})")
+
+
+if __name__ == "__main__":
+    main()
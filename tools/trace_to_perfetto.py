@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""
+trace_to_perfetto.py — Poll pipeline trace dump → Chrome/Perfetto trace
+=======================================================================
+
+Decodes a trace ring dump (src/trace_ring.h) taken with either
+
+  * "trace dump" on the device shell: save the console output, log
+    lines in between are ignored (the last complete dump is used), or
+  * a read of the opaque resource /33002/0/0: save the raw bytes,
+
+and writes a Chrome trace-event JSON file that opens in
+https://ui.perfetto.dev or chrome://tracing. _BEGIN/_END event pairs
+become slices, other events instants; the DLMS/RS485 path, the LwM2M
+push and the UART ISR each get a track. Event names are read from the
+enum in src/trace.h, so the script follows new probes without edits.
+Frame bytes recorded with CONFIG_AMI_TRACE_HEXDUMP appear as the
+"data" argument (hex) of the FRAME_TX/FRAME_RX events.
+
+A per-phase summary (count, mean, p50, p95, max in µs) is printed,
+plus the meter response latency: end of an RS485 transmission to the
+first UART RX interrupt of the reply.
+
+Usage:
+  python3 trace_to_perfetto.py DUMP [-o OUT.json] [--header trace.h]
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(os.path.dirname(HERE), "src", "trace.h")
+
+MAGIC = b"AMTR"
+HDR = struct.Struct("<4sBBHIII")
+REC = struct.Struct("<IBBH")
+FLAG_ISR = 0x01
+ID_DATA = 0xFF          # Payload record (TRACE_RING_ID_DATA)
+
+ENUM_RE = re.compile(r"TRACE_EV_(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)")
+LINE_RE = re.compile(r"trc ([0-9a-f]{4}): ([0-9a-f]+)")
+END_RE = re.compile(r"trc end (\d+)")
+
+# Track (Perfetto thread) per event name prefix; first match wins
+TRACKS = [
+    ("PUSH", 2, "lwm2m push"),
+    ("LWM2M", 2, "lwm2m push"),
+    ("", 1, "dlms poll"),
+]
+ISR_TRACK = (3, "uart isr")
+
+
+def load_event_names(header):
+    with open(header, encoding="utf-8") as f:
+        return {int(v, 0): name for name, v in ENUM_RE.findall(f.read())}
+
+
+def read_dump(path):
+    """Raw dump bytes from a binary file or a console log."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data.startswith(MAGIC):
+        return data
+
+    text = data.decode("utf-8", errors="replace")
+    last = None
+    cur = bytearray()
+    for line in text.splitlines():
+        m = LINE_RE.search(line)
+        if m:
+            off = int(m.group(1), 16)
+            if off == 0:
+                cur = bytearray()
+            if off == len(cur):
+                cur += bytes.fromhex(m.group(2))
+            continue
+        m = END_RE.search(line)
+        if m and len(cur) == int(m.group(1)):
+            last = bytes(cur)
+    if last is None:
+        sys.exit(f"{path}: no complete trace dump found")
+    return last
+
+
+def parse_dump(dump):
+    magic, ver, rec_len, _, hz, count, lost = HDR.unpack_from(dump)
+    if magic != MAGIC or ver != 1 or rec_len != REC.size:
+        sys.exit(f"unsupported dump (magic {magic!r}, version {ver})")
+    if len(dump) < HDR.size + count * REC.size:
+        sys.exit(f"dump truncated: {count} records announced")
+    recs = []
+    for i in range(count):
+        off = HDR.size + i * REC.size
+        cycles, ev, flags, arg = REC.unpack_from(dump, off)
+        if ev == ID_DATA:
+            # 7 payload bytes around the ID; orphans (event overwritten)
+            # at the start of a wrapped ring are dropped
+            if recs:
+                raw = dump[off:off + REC.size]
+                recs[-1][4].extend(raw[:4] + raw[5:])
+            continue
+        recs.append((cycles, ev, flags, arg, bytearray()))
+    return hz, lost, recs
+
+
+def signed16(v):
+    return v - 0x10000 if v & 0x8000 else v
+
+
+def track_of(name, flags):
+    if flags & FLAG_ISR:
+        return ISR_TRACK
+    for prefix, tid, tname in TRACKS:
+        if name.startswith(prefix):
+            return tid, tname
+    return TRACKS[-1][1:]
+
+
+def convert(hz, recs, names):
+    """Chrome trace events and slice/latency durations (µs)"""
+    events, durations = [], {}
+    stacks = {}
+    track_names = {}
+    t_cycles = 0
+    prev = None
+    last_tx_end = None
+
+    for cycles, ev, flags, arg, data in recs:
+        # Unwrap the 32-bit counter: consecutive records < 1 wrap apart
+        if prev is not None:
+            t_cycles += (cycles - prev) & 0xFFFFFFFF
+        prev = cycles
+        ts = t_cycles * 1e6 / hz
+
+        name = names.get(ev, f"EV_{ev:02X}")
+        tid, tname = track_of(name, flags)
+        track_names[tid] = tname
+        stack = stacks.setdefault(tid, [])
+        sarg = signed16(arg)
+
+        if name.endswith("_BEGIN"):
+            stem = name[:-6].lower()
+            label = f"{stem}[{arg}]" if stem in ("obis", "scaler") else stem
+            stack.append((stem, ts))
+            events.append({"name": label, "ph": "B", "ts": ts, "pid": 1,
+                           "tid": tid, "args": {"arg": sarg}})
+        elif name.endswith("_END"):
+            stem = name[:-4].lower()
+            if not any(s == stem for s, _ in stack):
+                continue  # Its BEGIN was overwritten
+            # Close anything left open inside it (lost END records)
+            while stack:
+                s, t0 = stack.pop()
+                events.append({"name": s, "ph": "E", "ts": ts, "pid": 1,
+                               "tid": tid, "args": {"result": sarg}})
+                if s == stem:
+                    durations.setdefault(s, []).append(ts - t0)
+                    break
+            if name == "RS485_TX_END":
+                last_tx_end = ts
+        else:
+            if name == "UART_RX_ISR" and last_tx_end is not None:
+                durations.setdefault("meter_response", []).append(
+                    ts - last_tx_end)
+                last_tx_end = None
+            iargs = {"arg": sarg}
+            if data:
+                # Zero padding only ever follows the end of a frame
+                iargs["data"] = bytes(data[:arg]).hex()
+            events.append({"name": name.lower(), "ph": "i", "s": "t",
+                           "ts": ts, "pid": 1, "tid": tid,
+                           "args": iargs})
+
+    for tid, tname in track_names.items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 1,
+                       "tid": tid, "args": {"name": tname}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1,
+                   "args": {"name": "ami-node"}})
+    return events, durations
+
+
+def pct(sorted_vals, p):
+    rank = max(1, (p * len(sorted_vals) + 99) // 100)
+    return sorted_vals[rank - 1]
+
+
+def print_summary(durations, hz, lost, n):
+    print(f"{n} events at {hz} Hz ({1e6 / hz:.3f} µs/cycle), "
+          f"{lost} overwritten before the first")
+    print(f"{'phase':<16} {'count':>6} {'mean':>10} {'p50':>10} "
+          f"{'p95':>10} {'max':>10}   (µs)")
+    for name in sorted(durations, key=lambda k: -sum(durations[k])):
+        d = sorted(durations[name])
+        print(f"{name:<16} {len(d):>6} {sum(d) / len(d):>10.1f} "
+              f"{pct(d, 50):>10.1f} {pct(d, 95):>10.1f} {d[-1]:>10.1f}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("dump", help="console log or raw /33002/0/0 bytes")
+    ap.add_argument("-o", "--output", help="trace JSON (default DUMP.json)")
+    ap.add_argument("--header", default=DEFAULT_HEADER,
+                    help="trace.h with the event enum")
+    args = ap.parse_args()
+
+    names = load_event_names(args.header)
+    hz, lost, recs = parse_dump(read_dump(args.dump))
+    if hz == 0:
+        sys.exit("dump has no cycle frequency")
+
+    events, durations = convert(hz, recs, names)
+    out = args.output or os.path.splitext(args.dump)[0] + ".json"
+    with open(out, "w", encoding="utf-8") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns",
+                   "otherData": {"cycle_hz": hz, "overwritten": lost}}, f)
+
+    print_summary(durations, hz, lost, len(recs))
+    print(f"trace written to {out}")
+
+
+if __name__ == "__main__":
+    main()